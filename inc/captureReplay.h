@@ -0,0 +1,86 @@
+/**
+ * @file captureReplay.h
+ * @brief Replays a traffic capture against a server with its original timing
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef CAPTUREREPLAY_H
+#define CAPTUREREPLAY_H
+
+//System Includes
+#include <atomic>
+#include <string>
+
+//Ours
+#include "CaptureLog.h"
+#include "LatencyHistogram.h"
+#include "TcpClient.h"
+#include "UdpClient.h"
+
+
+/** Sends the messages of a capture made with startCapture() of UdpServer or
+ *  TcpServer to a server again.
+ *
+ *  Messages are sent at the offsets they were received at in the capture,
+ *  divided by the speed factor, so a capture of the control link replays the
+ *  same bursts and gaps at the same or a multiplied rate. UDP records become
+ *  datagrams, TCP records are written to a connection that is reopened
+ *  wherever the capture saw a client connect. How late every message went
+ *  out against its schedule is recorded in a histogram, to tell whether the
+ *  replaying host kept up.
+ */
+class captureReplay
+{
+public:
+
+	captureReplay(std::string ipAddr, int port);
+
+	~captureReplay();
+
+	//Maps the capture file
+	bool load(std::string path);
+
+	//Sends every message of the capture once. A speed of 1 keeps the
+	//original timing, 2 sends twice as fast and 0 as fast as possible
+	bool replay(double speed);
+
+	//Stops a replay in progress
+	void stop();
+
+	//Lateness of each message against its schedule in microseconds
+	const LatencyHistogram& getHistogram() const;
+
+	//Messages and bytes sent since load
+	uint64_t getSentCount() const;
+	uint64_t getSentBytes() const;
+
+private:
+
+	//Sends one record over its protocol
+	bool sendRecord(const Capture::Record& record);
+
+	// Get the current monotonic time in nanoseconds
+	uint64_t getTime_ns();
+
+	std::string ipAddr;
+	int port;
+
+	CaptureReader reader;
+
+	UdpClient udpClient;
+
+	//Connection of the TCP records, reopened at every captured connect
+	TcpClient* tcpClient;
+
+	std::atomic<bool> isRunning;
+
+	std::atomic<uint64_t> sentCount;
+	std::atomic<uint64_t> sentBytes;
+
+	LatencyHistogram latenessHistogram;
+};
+
+
+#endif //CAPTUREREPLAY_H
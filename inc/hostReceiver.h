@@ -12,6 +12,12 @@
 //System Includes
 #include <string.h>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
 #include <memory>
 #include <termios.h>
 #include <sys/stat.h>
@@ -21,7 +27,48 @@
 
 //Ours
 #include "UdpServer.h"
-#include "messageStructure.h"
+#include "ProcessSupervisor.h"
+#include "ThreadConfig.h"
+#include "LatencyHistogram.h"
+#include "SequenceStats.h"
+#include "StreamFramer.h"
+#include "SendQueue.h"
+#include "messageCodec.h"
+#include "messageEnvelope.h"
+#include "recorderMonitor.h"
+#include "streamCapture.h"
+
+//Recorder started on a start command. A stop sends the signal to it and
+//everything it started, and kills them if they have not exited in time
+#define RECORDER_COMMAND "/home/msardonini/Videos/record_on_boot.sh"
+#define RECORDER_STOP_SIGNAL SIGINT
+#define RECORDER_STOP_TIMEOUT_S 5.0
+
+//Pre-warming runs the recorder with this argument while in standby. It opens its
+//devices, then waits for this line on its standard input before it records.
+//A recorder that fails while armed is armed again after this long
+#define RECORDER_ARMED_ARG "--armed"
+#define RECORDER_RESUME "start\n"
+#define RECORDER_REARM_PERIOD_US 5000000
+
+//Script running rfcomm, told to restart it when the link is lost. The serial port
+//it creates is opened again once the restart had this long
+#define BLUETOOTH_SERVER_SCRIPT "hostBluetoothServer.sh"
+#define BLUETOOTH_DEVICE "/dev/rfcomm0"
+#define BLUETOOTH_REOPEN_DELAY_US 4000000
+
+//Where the recorder writes its files, its process name, and the file it reports
+//its progress to (ffmpeg -progress), read for the telemetry sent to the remote
+#define RECORDING_DIR "/home/msardonini/Videos"
+#define RECORDER_PROCESS "ffmpeg"
+#define RECORDER_PROGRESS "/tmp/recorder.progress"
+
+//Where the stream pre-roll capture writes its segments. Kept out of RECORDING_DIR,
+//whose newest file is taken for the recorder's output
+#define STREAM_DIR RECORDING_DIR "/stream"
+
+//How often the recorder is sampled for telemetry
+#define TELEMETRY_PERIOD_US 1000000
 
 
 enum HOST_STATES_t
@@ -48,34 +95,100 @@ public:
 	int readThread();
 	int writeThread();
 
-	/** Function that reads data from the other device */
-	ssize_t receiveData();
+	//Returns the next frame received from the other device, or nullptr once
+	//nothing more arrived. The frame stays valid until the next call
+	const uint8_t* receiveFrame(size_t* length);
 
 	//Thread the monitors the states of the buttons to issue commands
 	int buttonThread();
 
+	//Thread that samples the recorder for the remote while it asks for telemetry
+	int telemetryThread();
+
+	//Fills sndbuf with the next frame, called with statusMutex held
 	int createSendMessage();
 
-	bool onMessageReceived();
+	//Wakes the write thread to send a status frame right away
+	void sendStatusNow();
+
+	//Lets the heartbeat back off while nothing changes, doubling up to the ceiling.
+	//0 keeps the fixed heartbeat
+	void setKeepaliveCeiling(uint64_t ceiling_us);
+
+	//Interval to announce after a frame that announced interval_us
+	uint64_t getNextKeepalive(uint64_t interval_us);
+
+	//How long the link may stay silent before it counts as lost
+	uint64_t getLinkTimeout() const;
+
+	//Blocks until the link has data to read or the timeout in seconds expires
+	bool waitForData(double timeout);
+
+	bool onMessageReceived(const uint8_t* frame, size_t length);
 
-	//Resets the bluetooth interface connection
+	//Sends an envelope with the features agreed on, called by the write thread
+	void sendEnvelope(uint8_t type, const uint8_t* payload, size_t length, SendQueue::Priority priority);
+
+	//Sends our HELLO while the remote has not answered it, called by the write thread
+	void sendHelloIfDue();
+
+	//Sends the newest recorder sample not sent yet, called by the write thread
+	void sendTelemetryIfDue();
+
+	//Handler of the HELLO envelope
+	void onHello(const MessageEnvelope::Header& header);
+
+	//Resets the bluetooth interface connection, the port is opened again by the read thread
 	int resetConnection();
+
+	//Opens and configures the bluetooth serial port, false if it could not be opened
+	bool openSerial();
+
+	//Writes the queued frames to the serial port, called by the write thread
+	SendQueue::Result flushSerial();
 	int stopRecording();
 	int startRecording();
 
+	//Starts or stops the recorder if the remote commanded a state it is not in
+	void applyCommandedState();
+
+	//Forgets the last command applied, for a remote that numbers its commands from 1 again
+	void forgetCommands();
+
+	//Arms a recorder while in standby with pre-warming on, stops it with pre-warming off
+	void updateArmedRecorder();
+
+	//Keeps a recorder armed in standby, so a start command only tells it to go ahead
+	void setPrewarm(bool enable);
+
 	// Get the current time in microseconds
 	uint64_t getTimeUsec();
 
-	bool getNeedsReset();
+	//Number of frames received that failed the magic number or CRC check
+	uint64_t getBadFrames() const;
+
+	//Bad frames, sequence loss and reordering, and round trip times of the link
+	std::string getLinkStats();
+
+	//Records every frame received over UDP to a file for captureReplay
+	bool startCapture(std::string path);
+
+	//Keeps the last preroll_s seconds of the UDP stream arriving on a port, and writes
+	//it to the recording directory from then on while recording
+	bool startStreamCapture(int port, double preroll_s);
 
 private:
 	//Simple bool to show if object is running
 	bool isRunning;
 	bool useBluetooth;
 	bool useUDP;
-	bool needsReset;
 
-	int fd; //file descriptor for bluetooth serial
+	//File descriptor for bluetooth serial, -1 while the link is reset until it is
+	//opened again at reopen_us. Changed by the read thread only, under serialMutex,
+	//which the write thread holds while it writes to it
+	int fd;
+	std::mutex serialMutex;
+	uint64_t reopen_us;
 
 	//Enum to describe what state the program is reading from the host
 	enum HOST_STATES_t commandedState;
@@ -86,6 +199,7 @@ private:
 	//threads to handle the incoming and outgoing of messages
 	std::thread readThread_h;
 	std::thread writeThread_h;
+	std::thread telemetryThread_h;
 
 	//Current state of this program
 	uint64_t timestamp_us;
@@ -95,14 +209,95 @@ private:
 	uint64_t lastTimestampReceived_us;
 	uint64_t lastModeReceived;
 
+	//Local time the newest frame arrived, echoed back with its timestamp
+	uint64_t lastReceivedAt_us;
+
+	//Guards the echoed timestamp pair between the read and write threads
+	std::mutex echoMutex;
+
+	//Sequence number of the next frame sent
+	uint32_t sndSequence;
+
+	//Loss and reordering of the frames received, round trip times of ours
+	SequenceStats rcvSequence;
+	LatencyHistogram rttHistogram;
+
+	//Frames dropped as corrupt or incomplete
+	uint64_t badFrames;
+
+	//Last command applied, acknowledged in every status frame. The write thread
+	//sleeps on the condition until a heartbeat or an acknowledgement is due
+	std::mutex statusMutex;
+	std::condition_variable statusCondition;
+	uint32_t ackCommandId;
+	bool statusDue;
+
+	//Set by the read thread when a new command needs acknowledging
+	bool ackDue;
+
+	//Interval announced in the next frame, guarded by statusMutex, and the
+	//most it may grow to while idle
+	uint64_t keepalive_us;
+	std::atomic<uint64_t> keepaliveCeiling_us;
+
+	//Interval the remote announced in its newest frame, read thread only
+	uint32_t peerKeepalive_us;
+
 	//Object for handling the sending and reading of UDP packets
 	UdpServer server;
 
+	//Frames are encoded into and parsed out of the buffers directly
 	messageStructure_t sndMessage;
 	uint8_t sndbuf[256];
 	
-	messageStructure_t rcvMessage;
-	uint8_t rcvbuf[256];
+	uint8_t rcvbuf[MessageEnvelope::maxLinkFrameSize];
+
+	//Cuts frames out of the bluetooth byte stream, which has no message
+	//boundaries, and parses them where they were read
+	StreamFramer framer;
+
+	//Frames waiting for room on the serial port, written by the write thread only.
+	//The event wakes the write thread while it waits for that room
+	SendQueue sendQueue;
+	int writeWakeFd;
+
+	//Features agreed with the remote, and the handlers of the envelopes it sends
+	MessageEnvelope::Negotiation negotiation;
+	MessageEnvelope::Dispatcher dispatcher;
+
+	//Envelopes are laid out here by the write thread, numbered per direction
+	uint8_t envelopeBuf[MessageEnvelope::maxFrameSize];
+	uint32_t envelopeSequence;
+
+	//Recorder process, used by the read thread only once the threads run
+	ProcessSupervisor recorderProcess;
+
+	//Whether to pre-warm, whether the running recorder is armed rather than recording,
+	//and when the next one may be armed, the latter two read thread only
+	std::atomic<bool> prewarm;
+	bool recorderArmed;
+	uint64_t nextArm_us;
+
+	//Sampled by the telemetry thread only, which looks for a new output file
+	//once a recording starts
+	recorderMonitor recorder;
+	std::atomic<bool> recorderStarted;
+
+	//Newest sample waiting for the write thread, 0 bytes once sent
+	std::mutex telemetryMutex;
+	uint8_t telemetryPayload[MessageEnvelope::maxTelemetrySize];
+	size_t telemetryLength;
+
+	//When the pending start command arrived, 0 once its first frame was seen. The
+	//event wakes the telemetry thread to look for that frame
+	std::atomic<uint64_t> startCommand_us;
+	int telemetryWakeFd;
+
+	//Time from a start command to the first frame recorded
+	LatencyHistogram startLatency;
+
+	//Stream recorded with pre-roll, if opened
+	streamCapture stream;
 
 protected:
 
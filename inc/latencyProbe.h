@@ -0,0 +1,92 @@
+/**
+ * @file latencyProbe.h
+ * @brief Measures round trip latency of the control link with heartbeat sized frames
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+//System Includes
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+//Ours
+#include "UdpServer.h"
+#include "LatencyHistogram.h"
+#include "messageCodec.h"
+
+#define LATENCY_PROBE_PORT 202
+
+
+/** One end of a latency measurement.
+ *
+ *  In echo mode every valid frame received is sent straight back to whoever
+ *  sent it. In probe mode heartbeat frames stamped with the local monotonic
+ *  time are sent at a fixed rate and the round trip time of every echo is
+ *  recorded in a histogram. Run the echo end on the peer of the link under
+ *  test and the probe end locally.
+ */
+class latencyProbe
+{
+public:
+
+	latencyProbe(std::string ipAddrPeer, int portLocal = LATENCY_PROBE_PORT, int portPeer = LATENCY_PROBE_PORT);
+
+	~latencyProbe();
+
+	//Reflects every received frame back to its sender
+	bool startEcho();
+
+	//Sends timestamped frames at rateHz and records the round trip of each echo
+	bool startProbe(double rateHz);
+
+	//Stops echoing or probing
+	void stop();
+
+	//Round trip time statistics in microseconds
+	const LatencyHistogram& getHistogram() const;
+	LatencyHistogram::Summary getSummary() const;
+
+	//Frames sent and echoes received since start
+	uint64_t getSentCount() const;
+	uint64_t getReceivedCount() const;
+
+	// Get the current time in microseconds
+	uint64_t getTimeUsec();
+
+private:
+
+	//Called by the server for every datagram
+	bool onEchoReceived(int fd, char* buff, size_t length);
+	bool onProbeReceived(int fd, char* buff, size_t length);
+
+	//Sends probe frames until stopped
+	int sendThread();
+
+	//Returns true if the buffer holds a complete frame with valid magic numbers
+	bool isValidFrame(const char* buff, size_t length);
+
+	std::string ipAddrPeer;
+	int portLocal;
+	int portPeer;
+
+	std::atomic<bool> isRunning;
+	double rateHz;
+
+	//Object for handling the sending and reading of UDP packets
+	UdpServer server;
+
+	std::thread sendThread_h;
+
+	std::atomic<uint64_t> sentCount;
+	std::atomic<uint64_t> receivedCount;
+
+	LatencyHistogram rttHistogram;
+};
+
+
+#endif //LATENCYPROBE_H
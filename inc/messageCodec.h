@@ -0,0 +1,246 @@
+/**
+ * @file messageCodec.h
+ * @brief Fixed wire layout of messageStructure_t, independent of compiler and architecture
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef MESSAGECODEC_H
+#define MESSAGECODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Crc32c.h"
+#include "messageStructure.h"
+
+
+/** Encodes and decodes control frames directly in the send and receive buffers.
+ *
+ *  messageStructure_t is padded around timestamp_us and laid out by the ABI,
+ *  so it is 24 bytes and differs between the Pi and the host. On the wire a
+ *  frame is the fields back to back with no padding, multi-byte fields little
+ *  endian, followed by the CRC32C of everything before it:
+ *
+ *    0  magicHeader1   1  magicHeader2   2-9   timestamp_us
+ *    10 isCommandMsg   11 isStatusMsg    12    mode
+ *    13-16 sequence    17-24 echoTimestamp_us  25-28 echoDelay_us
+ *    29-32 commandId   33-36 ackCommandId    37-40 keepalive_us
+ *    41 magicFooter1   42 magicFooter2   43-46 crc
+ *
+ *  The magic numbers only find the frame, the CRC is what keeps a frame
+ *  garbled on the serial link from starting or stopping a recording.
+ *
+ *  The getters read a field straight out of a received buffer, so a frame
+ *  never has to be copied into a messageStructure_t to be parsed.
+ */
+namespace MessageCodec {
+
+// Offsets of the fields in a frame
+constexpr size_t offsetMagicHeader1 = 0;
+constexpr size_t offsetMagicHeader2 = 1;
+constexpr size_t offsetTimestamp = 2;
+constexpr size_t offsetIsCommandMsg = 10;
+constexpr size_t offsetIsStatusMsg = 11;
+constexpr size_t offsetMode = 12;
+constexpr size_t offsetSequence = 13;
+constexpr size_t offsetEchoTimestamp = 17;
+constexpr size_t offsetEchoDelay = 25;
+constexpr size_t offsetCommandId = 29;
+constexpr size_t offsetAckCommandId = 33;
+constexpr size_t offsetKeepalive = 37;
+constexpr size_t offsetMagicFooter1 = 41;
+constexpr size_t offsetMagicFooter2 = 42;
+constexpr size_t offsetCrc = 43;
+
+// Bytes of an encoded frame
+constexpr size_t frameSize = 47;
+
+// Bytes every frame starts with, what a stream is scanned for
+constexpr uint8_t magicHeader[] = {MAGIC_H1, MAGIC_H2};
+
+static_assert(sizeof(magicHeader) == offsetTimestamp, "The header must be the magic numbers");
+static_assert(offsetTimestamp + sizeof(uint64_t) == offsetIsCommandMsg, "timestamp_us must be 8 bytes on the wire");
+static_assert(offsetMode + 1 == offsetSequence, "sequence must follow mode");
+static_assert(offsetSequence + sizeof(uint32_t) == offsetEchoTimestamp, "sequence must be 4 bytes on the wire");
+static_assert(offsetEchoTimestamp + sizeof(uint64_t) == offsetEchoDelay, "echoTimestamp_us must be 8 bytes on the wire");
+static_assert(offsetEchoDelay + sizeof(uint32_t) == offsetCommandId, "echoDelay_us must be 4 bytes on the wire");
+static_assert(offsetCommandId + sizeof(uint32_t) == offsetAckCommandId, "commandId must be 4 bytes on the wire");
+static_assert(offsetAckCommandId + sizeof(uint32_t) == offsetKeepalive, "ackCommandId must be 4 bytes on the wire");
+static_assert(offsetKeepalive + sizeof(uint32_t) == offsetMagicFooter1, "keepalive_us must be 4 bytes on the wire");
+static_assert(offsetMagicFooter2 + 1 == offsetCrc, "CRC must follow the second footer byte");
+static_assert(offsetCrc + sizeof(uint32_t) == frameSize, "Frame must end with the CRC");
+static_assert(frameSize < sizeof(messageStructure_t), "Wire frame must not carry the struct padding");
+
+
+//Reads a little endian integer of the given number of bytes
+constexpr uint64_t readLittleEndian(const uint8_t* buf, size_t bytes)
+{
+	return bytes == 0 ? 0 : (static_cast<uint64_t>(buf[bytes - 1]) << (8 * (bytes - 1))) | readLittleEndian(buf, bytes - 1);
+}
+
+//Writes a little endian integer of the given number of bytes
+inline void writeLittleEndian(uint8_t* buf, uint64_t value, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; i++)
+		buf[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+
+//Returns true if the buffer holds a complete frame with valid magic numbers,
+//without checking the CRC
+constexpr bool hasValidMagic(const uint8_t* buf, size_t length)
+{
+	return length >= frameSize
+		&& buf[offsetMagicHeader1] == MAGIC_H1
+		&& buf[offsetMagicHeader2] == MAGIC_H2
+		&& buf[offsetMagicFooter1] == MAGIC_F1
+		&& buf[offsetMagicFooter2] == MAGIC_F2;
+}
+
+//Returns true if the buffer holds a complete frame that arrived intact
+inline bool isValidFrame(const uint8_t* buf, size_t length)
+{
+	return hasValidMagic(buf, length)
+		&& Crc32c::compute(buf, offsetCrc) == readLittleEndian(buf + offsetCrc, sizeof(uint32_t));
+}
+
+//Field getters, only meaningful on a buffer that passed isValidFrame
+constexpr uint64_t getTimestamp(const uint8_t* buf)
+{
+	return readLittleEndian(buf + offsetTimestamp, sizeof(uint64_t));
+}
+
+constexpr uint8_t getIsCommandMsg(const uint8_t* buf)
+{
+	return buf[offsetIsCommandMsg];
+}
+
+constexpr uint8_t getIsStatusMsg(const uint8_t* buf)
+{
+	return buf[offsetIsStatusMsg];
+}
+
+constexpr uint8_t getMode(const uint8_t* buf)
+{
+	return buf[offsetMode];
+}
+
+constexpr uint32_t getSequence(const uint8_t* buf)
+{
+	return static_cast<uint32_t>(readLittleEndian(buf + offsetSequence, sizeof(uint32_t)));
+}
+
+constexpr uint64_t getEchoTimestamp(const uint8_t* buf)
+{
+	return readLittleEndian(buf + offsetEchoTimestamp, sizeof(uint64_t));
+}
+
+constexpr uint32_t getEchoDelay(const uint8_t* buf)
+{
+	return static_cast<uint32_t>(readLittleEndian(buf + offsetEchoDelay, sizeof(uint32_t)));
+}
+
+constexpr uint32_t getCommandId(const uint8_t* buf)
+{
+	return static_cast<uint32_t>(readLittleEndian(buf + offsetCommandId, sizeof(uint32_t)));
+}
+
+constexpr uint32_t getAckCommandId(const uint8_t* buf)
+{
+	return static_cast<uint32_t>(readLittleEndian(buf + offsetAckCommandId, sizeof(uint32_t)));
+}
+
+constexpr uint32_t getKeepalive(const uint8_t* buf)
+{
+	return static_cast<uint32_t>(readLittleEndian(buf + offsetKeepalive, sizeof(uint32_t)));
+}
+
+constexpr uint32_t getCrc(const uint8_t* buf)
+{
+	return static_cast<uint32_t>(readLittleEndian(buf + offsetCrc, sizeof(uint32_t)));
+}
+
+
+/** Writes a frame holding the message to buf, which needs frameSize bytes.
+ *  The magic numbers are always the protocol ones.
+ *
+ *  @return Bytes of the frame
+ */
+inline size_t encode(const messageStructure_t& message, uint8_t* buf)
+{
+	buf[offsetMagicHeader1] = MAGIC_H1;
+	buf[offsetMagicHeader2] = MAGIC_H2;
+	writeLittleEndian(buf + offsetTimestamp, message.timestamp_us, sizeof(uint64_t));
+	buf[offsetIsCommandMsg] = message.isCommandMsg;
+	buf[offsetIsStatusMsg] = message.isStatusMsg;
+	buf[offsetMode] = message.mode;
+	writeLittleEndian(buf + offsetSequence, message.sequence, sizeof(uint32_t));
+	writeLittleEndian(buf + offsetEchoTimestamp, message.echoTimestamp_us, sizeof(uint64_t));
+	writeLittleEndian(buf + offsetEchoDelay, message.echoDelay_us, sizeof(uint32_t));
+	writeLittleEndian(buf + offsetCommandId, message.commandId, sizeof(uint32_t));
+	writeLittleEndian(buf + offsetAckCommandId, message.ackCommandId, sizeof(uint32_t));
+	writeLittleEndian(buf + offsetKeepalive, message.keepalive_us, sizeof(uint32_t));
+	buf[offsetMagicFooter1] = MAGIC_F1;
+	buf[offsetMagicFooter2] = MAGIC_F2;
+	writeLittleEndian(buf + offsetCrc, Crc32c::compute(buf, offsetCrc), sizeof(uint32_t));
+	return frameSize;
+}
+
+/** Reads a frame into a message.
+ *
+ *  @return False, leaving the message untouched, if the buffer is not a valid frame
+ */
+inline bool decode(const uint8_t* buf, size_t length, messageStructure_t& message)
+{
+	if (!isValidFrame(buf, length))
+		return false;
+
+	message.magicHeader1 = MAGIC_H1;
+	message.magicHeader2 = MAGIC_H2;
+	message.timestamp_us = getTimestamp(buf);
+	message.isCommandMsg = getIsCommandMsg(buf);
+	message.isStatusMsg = getIsStatusMsg(buf);
+	message.mode = getMode(buf);
+	message.sequence = getSequence(buf);
+	message.echoTimestamp_us = getEchoTimestamp(buf);
+	message.echoDelay_us = getEchoDelay(buf);
+	message.commandId = getCommandId(buf);
+	message.ackCommandId = getAckCommandId(buf);
+	message.keepalive_us = getKeepalive(buf);
+	message.magicFooter1 = MAGIC_F1;
+	message.magicFooter2 = MAGIC_F2;
+	return true;
+}
+
+
+//The layout checked at compile time against a known frame. Crc32c is not
+//constexpr, the CRC is checked by TestMessageCodec
+constexpr uint8_t referenceFrame[frameSize] = {MAGIC_H1, MAGIC_H2,
+	0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 1u, 0u, MODE_RECORDING,
+	0x44, 0x33, 0x22, 0x11,
+	0x18, 0x17, 0x16, 0x15, 0x14, 0x13, 0x12, 0x11,
+	0x24, 0x23, 0x22, 0x21,
+	0x34, 0x33, 0x32, 0x31,
+	0x44, 0x43, 0x42, 0x41,
+	0x54, 0x53, 0x52, 0x51,
+	MAGIC_F1, MAGIC_F2,
+	0x17, 0x32, 0x89, 0x35};
+
+static_assert(hasValidMagic(referenceFrame, frameSize), "Reference frame must have valid magic numbers");
+static_assert(!hasValidMagic(referenceFrame, frameSize - 1), "Short frames must be rejected");
+static_assert(getTimestamp(referenceFrame) == 0x0102030405060708ull, "Timestamp must be little endian");
+static_assert(getIsCommandMsg(referenceFrame) == 1u && getIsStatusMsg(referenceFrame) == 0u, "Flags out of place");
+static_assert(getMode(referenceFrame) == MODE_RECORDING, "Mode out of place");
+static_assert(getSequence(referenceFrame) == 0x11223344u, "Sequence out of place");
+static_assert(getEchoTimestamp(referenceFrame) == 0x1112131415161718ull, "Echo timestamp out of place");
+static_assert(getEchoDelay(referenceFrame) == 0x21222324u, "Echo delay out of place");
+static_assert(getCommandId(referenceFrame) == 0x31323334u, "Command id out of place");
+static_assert(getAckCommandId(referenceFrame) == 0x41424344u, "Ack command id out of place");
+static_assert(getKeepalive(referenceFrame) == 0x51525354u, "Keepalive out of place");
+
+}  // MessageCodec
+
+
+#endif //MESSAGECODEC_H
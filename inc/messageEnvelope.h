@@ -0,0 +1,511 @@
+/**
+ * @file messageEnvelope.h
+ * @brief Versioned envelope for every message besides the control frame, and the handshake agreeing on its features
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef MESSAGEENVELOPE_H
+#define MESSAGEENVELOPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include "Crc32c.h"
+#include "messageCodec.h"
+
+
+/** Encodes, decodes and dispatches message envelopes.
+ *
+ *  The control frame keeps its fixed layout, so a Pi running an older build
+ *  still talks to the host. Anything else is sent in an envelope, which
+ *  starts with MAGIC_H1 like the control frame, so both share one stream, but
+ *  has MAGIC_E2 second where the control frame has MAGIC_H2:
+ *
+ *    0  MAGIC_H1   1  MAGIC_E2   2  version   3  type   4  flags
+ *    5-6 payload length
+ *    then the sequence (4 bytes) if flags has flagSequence,
+ *    the payload,
+ *    and the CRC32C of everything before it (4 bytes) if flags has flagCrc
+ *
+ *  Multi-byte fields are little endian. The header layout is the same in every
+ *  version, so any build can size, check and skip any envelope; the version
+ *  only says how to read the payload. The flags make each envelope describe
+ *  itself, so the receiver needs no state to parse it.
+ *
+ *  After the link comes up both ends send a HELLO with the protocol version,
+ *  the features and the telemetry types they support. Each end then sends
+ *  envelopes with only the features both support. An older peer never
+ *  answers, so once the HELLO attempts run out it is only sent control frames.
+ */
+namespace MessageEnvelope {
+
+// Version of the envelope payloads this build writes
+constexpr uint8_t protocolVersion = 1;
+
+// Message types. New types get new numbers, a type never changes meaning
+constexpr uint8_t typeHello = 1;
+constexpr uint8_t typeTelemetry = 2;
+
+// Telemetry types named in the handshake, a bit each
+constexpr uint32_t telemetryRecorder = 1u << 0;
+
+// Features agreed on in the handshake
+constexpr uint32_t featureCrc = 1u << 0;
+constexpr uint32_t featureSequence = 1u << 1;
+// Reserved for compressed payloads, not implemented by this build
+constexpr uint32_t featureCompression = 1u << 2;
+
+// Features this build implements
+constexpr uint32_t supportedFeatures = featureCrc | featureSequence;
+
+// Optional parts an envelope carries
+constexpr uint8_t flagSequence = 0x01;
+constexpr uint8_t flagCrc = 0x02;
+constexpr uint8_t flagCompressed = 0x04;
+
+// Offsets of the header fields
+constexpr size_t offsetMagicHeader1 = 0;
+constexpr size_t offsetMagicHeader2 = 1;
+constexpr size_t offsetVersion = 2;
+constexpr size_t offsetType = 3;
+constexpr size_t offsetFlags = 4;
+constexpr size_t offsetLength = 5;
+
+// Bytes of the header, and all the bytes needed to size an envelope
+constexpr size_t headerSize = 7;
+
+// Largest payload, keeps an envelope well inside the ring of a StreamFramer
+constexpr size_t maxPayload = 512;
+
+// Bytes of the largest envelope
+constexpr size_t maxFrameSize = headerSize + sizeof(uint32_t) + maxPayload + sizeof(uint32_t);
+
+// Byte a control frame and an envelope both start with, what a stream is scanned for
+constexpr uint8_t linkMagic[] = {MAGIC_H1};
+
+// Largest frame either kind may be, what receive buffers are sized for
+constexpr size_t maxLinkFrameSize = maxFrameSize > MessageCodec::frameSize ? maxFrameSize : MessageCodec::frameSize;
+
+static_assert(MAGIC_E2 != MAGIC_H2, "Envelopes must be told apart from control frames by their second byte");
+static_assert(offsetLength + sizeof(uint16_t) == headerSize, "The header must end with the payload length");
+static_assert(MessageCodec::frameSize >= headerSize, "A control frame must be sizeable from the bytes that size an envelope");
+
+
+//Returns true if the buffer starts with the magic numbers of an envelope
+constexpr bool isEnvelope(const uint8_t* buf, size_t length)
+{
+	return length >= headerSize
+		&& buf[offsetMagicHeader1] == MAGIC_H1
+		&& buf[offsetMagicHeader2] == MAGIC_E2;
+}
+
+//Bytes of the envelope whose header is in buf, 0 if the payload is too long
+constexpr size_t getFrameSize(const uint8_t* buf)
+{
+	return MessageCodec::readLittleEndian(buf + offsetLength, sizeof(uint16_t)) > maxPayload ? 0
+		: headerSize
+			+ ((buf[offsetFlags] & flagSequence) ? sizeof(uint32_t) : 0)
+			+ MessageCodec::readLittleEndian(buf + offsetLength, sizeof(uint16_t))
+			+ ((buf[offsetFlags] & flagCrc) ? sizeof(uint32_t) : 0);
+}
+
+//Returns true if the buffer holds exactly one envelope that arrived intact,
+//as far as its flags let us tell
+inline bool isValidFrame(const uint8_t* buf, size_t length)
+{
+	if (!isEnvelope(buf, length) || getFrameSize(buf) != length)
+		return false;
+	if (!(buf[offsetFlags] & flagCrc))
+		return true;
+	size_t offsetCrc = length - sizeof(uint32_t);
+	return Crc32c::compute(buf, offsetCrc) == MessageCodec::readLittleEndian(buf + offsetCrc, sizeof(uint32_t));
+}
+
+
+//Sizer for a StreamFramer scanning for linkMagic: sizes a control frame or an envelope
+constexpr size_t getLinkFrameSize(const uint8_t* buf)
+{
+	return buf[offsetMagicHeader2] == MAGIC_H2 ? MessageCodec::frameSize
+		: buf[offsetMagicHeader2] == MAGIC_E2 ? getFrameSize(buf)
+		: 0;
+}
+
+//Validator for a StreamFramer scanning for linkMagic. Noise on a byte stream
+//can look like an envelope without a CRC, so only ones carrying it are taken
+inline bool isValidLinkFrame(const uint8_t* buf, size_t length)
+{
+	return MessageCodec::isValidFrame(buf, length)
+		|| (isValidFrame(buf, length) && (buf[offsetFlags] & flagCrc));
+}
+
+
+//Fields of a received envelope, the payload still in the receive buffer
+struct Header
+{
+	uint8_t version;
+	uint8_t type;
+	uint8_t flags;
+
+	//0 if the envelope carries none
+	uint32_t sequence;
+
+	const uint8_t* payload;
+	size_t payloadLength;
+};
+
+/** Reads the header of an envelope.
+ *
+ *  @return False, leaving the header untouched, if the buffer is not a valid envelope
+ */
+inline bool parse(const uint8_t* buf, size_t length, Header& header)
+{
+	if (!isValidFrame(buf, length))
+		return false;
+
+	size_t offset = headerSize;
+	header.version = buf[offsetVersion];
+	header.type = buf[offsetType];
+	header.flags = buf[offsetFlags];
+	header.sequence = 0;
+	if (header.flags & flagSequence)
+	{
+		header.sequence = static_cast<uint32_t>(MessageCodec::readLittleEndian(buf + offset, sizeof(uint32_t)));
+		offset += sizeof(uint32_t);
+	}
+	header.payloadLength = MessageCodec::readLittleEndian(buf + offsetLength, sizeof(uint16_t));
+	header.payload = buf + offset;
+	return true;
+}
+
+//Flags of an envelope sent with the given agreed features
+constexpr uint8_t getFlags(uint32_t features)
+{
+	return ((features & featureSequence) ? flagSequence : 0)
+		| ((features & featureCrc) ? flagCrc : 0);
+}
+
+/** Writes an envelope to buf, which needs maxFrameSize bytes. The sequence is
+ *  only written if the flags ask for it.
+ *
+ *  @return Bytes of the envelope, 0 if the payload is too long
+ */
+inline size_t encode(uint8_t type, uint8_t flags, uint32_t sequence,
+	const uint8_t* payload, size_t payloadLength, uint8_t* buf)
+{
+	if (payloadLength > maxPayload)
+		return 0;
+
+	size_t offset = headerSize;
+	buf[offsetMagicHeader1] = MAGIC_H1;
+	buf[offsetMagicHeader2] = MAGIC_E2;
+	buf[offsetVersion] = protocolVersion;
+	buf[offsetType] = type;
+	buf[offsetFlags] = flags & (flagSequence | flagCrc);
+	MessageCodec::writeLittleEndian(buf + offsetLength, payloadLength, sizeof(uint16_t));
+	if (flags & flagSequence)
+	{
+		MessageCodec::writeLittleEndian(buf + offset, sequence, sizeof(uint32_t));
+		offset += sizeof(uint32_t);
+	}
+	memcpy(buf + offset, payload, payloadLength);
+	offset += payloadLength;
+	if (flags & flagCrc)
+	{
+		MessageCodec::writeLittleEndian(buf + offset, Crc32c::compute(buf, offset), sizeof(uint32_t));
+		offset += sizeof(uint32_t);
+	}
+	return offset;
+}
+
+
+//Payload of a HELLO:
+//  0 version   1-4 features   5-8 telemetry types   9 helloReceived
+//A newer peer may append fields, which are ignored
+struct Hello
+{
+	uint8_t version;
+	uint32_t features;
+
+	//Bit per telemetry type the sender produces or wants
+	uint32_t telemetryTypes;
+
+	//Whether the sender already has our HELLO
+	bool helloReceived;
+};
+
+constexpr size_t helloSize = 10;
+
+inline size_t encodeHello(const Hello& hello, uint8_t* payload)
+{
+	payload[0] = hello.version;
+	MessageCodec::writeLittleEndian(payload + 1, hello.features, sizeof(uint32_t));
+	MessageCodec::writeLittleEndian(payload + 5, hello.telemetryTypes, sizeof(uint32_t));
+	payload[9] = hello.helloReceived ? 1u : 0u;
+	return helloSize;
+}
+
+inline bool decodeHello(const uint8_t* payload, size_t length, Hello& hello)
+{
+	if (length < helloSize)
+		return false;
+	hello.version = payload[0];
+	hello.features = static_cast<uint32_t>(MessageCodec::readLittleEndian(payload + 1, sizeof(uint32_t)));
+	hello.telemetryTypes = static_cast<uint32_t>(MessageCodec::readLittleEndian(payload + 5, sizeof(uint32_t)));
+	hello.helloReceived = payload[9] != 0;
+	return true;
+}
+
+
+//Writes an unsigned integer 7 bits a byte, low bits first, the top bit set
+//on every byte but the last. Returns the bytes written, at most 10
+inline size_t writeVarint(uint8_t* buf, uint64_t value)
+{
+	size_t i = 0;
+	while (value >= 0x80)
+	{
+		buf[i++] = static_cast<uint8_t>(value) | 0x80;
+		value >>= 7;
+	}
+	buf[i++] = static_cast<uint8_t>(value);
+	return i;
+}
+
+//Reads an integer written by writeVarint. Returns the bytes read, 0 if the
+//buffer ends inside it or it is longer than 10 bytes
+inline size_t readVarint(const uint8_t* buf, size_t length, uint64_t& value)
+{
+	value = 0;
+	for (size_t i = 0; i < length && i < 10; i++)
+	{
+		value |= static_cast<uint64_t>(buf[i] & 0x7F) << (7 * i);
+		if (!(buf[i] & 0x80))
+			return i + 1;
+	}
+	return 0;
+}
+
+
+//Payload of a recorder TELEMETRY, the flags byte followed by the counters as
+//varints in the order below, so a typical sample takes about 12 bytes.
+//A newer peer may append fields, which are ignored
+struct Telemetry
+{
+	static constexpr uint8_t flagRecorderRunning = 0x01;
+	static constexpr uint8_t flagOutputFound = 0x02;
+	static constexpr uint8_t flagFreeSpaceKnown = 0x04;
+	uint8_t flags;
+
+	//Size of the newest output file and how fast it grew since the last sample
+	uint64_t bytesWritten;
+	uint64_t writeRate_Bps;
+
+	//Space left on the disk of the output, in MiB, 0 unless flagFreeSpaceKnown
+	uint64_t freeSpace_MiB;
+
+	//CPU the recorder used since the last sample, in thousandths of a core
+	uint64_t recorderCpu_permille;
+
+	//Frames the recorder reported dropped
+	uint64_t droppedFrames;
+};
+
+constexpr size_t maxTelemetrySize = 1 + 5 * 10;
+
+inline size_t encodeTelemetry(const Telemetry& telemetry, uint8_t* payload)
+{
+	size_t length = 0;
+	payload[length++] = telemetry.flags;
+	length += writeVarint(payload + length, telemetry.bytesWritten);
+	length += writeVarint(payload + length, telemetry.writeRate_Bps);
+	length += writeVarint(payload + length, telemetry.freeSpace_MiB);
+	length += writeVarint(payload + length, telemetry.recorderCpu_permille);
+	length += writeVarint(payload + length, telemetry.droppedFrames);
+	return length;
+}
+
+inline bool decodeTelemetry(const uint8_t* payload, size_t length, Telemetry& telemetry)
+{
+	if (length < 1)
+		return false;
+	uint64_t* fields[] = {&telemetry.bytesWritten, &telemetry.writeRate_Bps, &telemetry.freeSpace_MiB,
+		&telemetry.recorderCpu_permille, &telemetry.droppedFrames};
+	size_t offset = 1;
+	for (uint64_t* field : fields)
+	{
+		size_t read = readVarint(payload + offset, length - offset, *field);
+		if (read == 0)
+			return false;
+		offset += read;
+	}
+	telemetry.flags = payload[0];
+	return true;
+}
+
+
+/** Tracks the handshake with the peer.
+ *
+ *  The read thread hands it every HELLO received and resets it when the link
+ *  is lost; the write thread asks it whether a HELLO is due. A HELLO is sent
+ *  until the peer says it has ours, at most maxAttempts times per link up, and
+ *  answered once when the peer's first one arrives or whenever the peer says
+ *  it has not seen ours, so a lost HELLO in either direction is made up for.
+ */
+class Negotiation
+{
+public:
+	static constexpr int maxAttempts = 5;
+
+	Negotiation(uint32_t features, uint32_t telemetryTypes)
+		: features(features),
+		telemetryTypes(telemetryTypes),
+		peerVersion(0),
+		peerFeatures(0),
+		peerTelemetryTypes(0),
+		peerHelloReceived(false),
+		helloAcknowledged(false),
+		replyDue(false),
+		attempts(0) {}
+
+	//Read thread: a HELLO arrived from the peer
+	void onHello(const Hello& hello)
+	{
+		this->peerVersion = hello.version;
+		this->peerFeatures = hello.features;
+		this->peerTelemetryTypes = hello.telemetryTypes;
+		bool first = !this->peerHelloReceived.exchange(true);
+		if (hello.helloReceived)
+			this->helloAcknowledged = true;
+		if (first || !hello.helloReceived)
+			this->replyDue = true;
+	}
+
+	//Read thread: the link was lost, the next link up negotiates again
+	void reset()
+	{
+		this->peerHelloReceived = false;
+		this->helloAcknowledged = false;
+		this->replyDue = false;
+		this->peerFeatures = 0;
+		this->peerTelemetryTypes = 0;
+		this->attempts = 0;
+	}
+
+	//Write thread: fills in our HELLO and returns true if one should go out now
+	bool takeHelloDue(Hello& hello)
+	{
+		bool due = this->replyDue.exchange(false);
+		if (!due && !this->helloAcknowledged && this->attempts < maxAttempts)
+		{
+			this->attempts++;
+			due = true;
+		}
+		if (!due)
+			return false;
+
+		hello.version = protocolVersion;
+		hello.features = this->features;
+		hello.telemetryTypes = this->telemetryTypes;
+		hello.helloReceived = this->peerHelloReceived;
+		return true;
+	}
+
+	//Features both ends support, none before the peer's HELLO arrived
+	uint32_t getFeatures() const
+	{
+		return this->features & this->peerFeatures;
+	}
+
+	//Telemetry types both ends named
+	uint32_t getTelemetryTypes() const
+	{
+		return this->telemetryTypes & this->peerTelemetryTypes;
+	}
+
+	//Lower of the two protocol versions, 0 before the peer's HELLO arrived
+	uint8_t getVersion() const
+	{
+		return this->peerHelloReceived ? std::min<uint8_t>(protocolVersion, this->peerVersion) : 0;
+	}
+
+	//Whether the peer sent a HELLO since the link came up
+	bool isAgreed() const
+	{
+		return this->peerHelloReceived;
+	}
+
+private:
+	const uint32_t features;
+	const uint32_t telemetryTypes;
+
+	std::atomic<uint8_t> peerVersion;
+	std::atomic<uint32_t> peerFeatures;
+	std::atomic<uint32_t> peerTelemetryTypes;
+	std::atomic<bool> peerHelloReceived;
+	std::atomic<bool> helloAcknowledged;
+	std::atomic<bool> replyDue;
+	std::atomic<int> attempts;
+};
+
+
+/** Table from message type to handler, run on the read thread. Envelopes of a
+ *  type with no handler are counted and skipped, so a newer peer may send
+ *  types this build does not know.
+ */
+class Dispatcher
+{
+public:
+	typedef std::function<void(const Header& header)> Handler;
+
+	Dispatcher() : unknown(0) {}
+
+	void setHandler(uint8_t type, Handler handler)
+	{
+		this->handlers[type] = handler;
+	}
+
+	//Returns false if the frame is not a valid envelope
+	bool dispatch(const uint8_t* frame, size_t length)
+	{
+		Header header;
+		if (!parse(frame, length, header))
+			return false;
+		if (this->handlers[header.type])
+			this->handlers[header.type](header);
+		else
+			this->unknown++;
+		return true;
+	}
+
+	//Envelopes of a type with no handler
+	uint64_t getUnknown() const
+	{
+		return this->unknown;
+	}
+
+private:
+	Handler handlers[256];
+	uint64_t unknown;
+};
+
+
+//The layout checked at compile time against a known envelope
+constexpr uint8_t referenceFrame[] = {MAGIC_H1, MAGIC_E2, protocolVersion, typeHello,
+	flagSequence | flagCrc, 0x03, 0x00,
+	0x44, 0x33, 0x22, 0x11,
+	0x01, 0x02, 0x03,
+	0x00, 0x00, 0x00, 0x00};
+
+static_assert(isEnvelope(referenceFrame, sizeof(referenceFrame)), "Reference envelope must have valid magic numbers");
+static_assert(getFrameSize(referenceFrame) == sizeof(referenceFrame), "Envelope size must count the optional parts");
+static_assert(getLinkFrameSize(MessageCodec::referenceFrame) == MessageCodec::frameSize, "Control frames must size as before");
+
+}  // MessageEnvelope
+
+
+#endif //MESSAGEENVELOPE_H
@@ -6,17 +6,33 @@
  * @date 09/10/2018
  */
 
+#ifndef MESSAGESTRUCTURE_H
+#define MESSAGESTRUCTURE_H
+
 #include "string.h"
+#include <stdint.h>
 
 #define MAGIC_H1 0xAA
 #define MAGIC_H2 0xF7
 #define MAGIC_F1 0x8B
 #define MAGIC_F2 0x4E
 
+//Second byte of a message envelope, which starts with MAGIC_H1 like a control frame
+#define MAGIC_E2 0xE5
+
 #define MODE_RECORDING 0x05
 #define MODE_STANDBY 0x00
 
+//Both ends send a frame at least this often, unless keepalives back off while idle
+#define HEARTBEAT_PERIOD_US 100000
+
+//The link counts as lost after this long without a frame, or after the peer
+//missed this many of the keepalives it announced, whichever is longer
+#define LINK_TIMEOUT_US 1000000
+#define KEEPALIVES_MISSED 3
 
+
+//In memory form of a control frame, sent and received through messageCodec.h
 typedef struct messageStructure_t
 {
 	uint8_t magicHeader1;
@@ -25,7 +41,26 @@ typedef struct messageStructure_t
 	uint8_t isCommandMsg;
 	uint8_t isStatusMsg;
 	uint8_t mode;
+
+	//Counts up by one with every frame sent in this direction
+	uint32_t sequence;
+
+	//timestamp_us of the last frame received from the peer, 0 before any, and
+	//how long ago it arrived, so the peer can take its round trip time
+	uint64_t echoTimestamp_us;
+	uint32_t echoDelay_us;
+
+	//Command frames: changes whenever a new command is issued, 0 before the first.
+	//Status frames: commandId of the last command applied, acknowledging it
+	uint32_t commandId;
+	uint32_t ackCommandId;
+
+	//Longest the sender will wait before its next frame, 0 if it does not say
+	uint32_t keepalive_us;
+
 	uint8_t magicFooter1;
 	uint8_t magicFooter2;
 
-}messageStructure_t;
\ No newline at end of file
+}messageStructure_t;
+
+#endif //MESSAGESTRUCTURE_H
@@ -0,0 +1,106 @@
+/**
+ * @file recorderMonitor.h
+ * @brief Samples the progress of the video recorder for the telemetry sent to the remote
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef RECORDERMONITOR_H
+#define RECORDERMONITOR_H
+
+//System Includes
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+//Ours
+#include "messageEnvelope.h"
+
+//How often /proc is scanned for the recorder while it is not running
+#define RECORDER_SEARCH_PERIOD_US 10000000
+
+
+/** Tells whether the recorder is actually writing, without running a shell.
+ *
+ *  The output file is the newest regular file in the output directory. It is
+ *  kept open and sized with fstat, so the directory is only scanned again when
+ *  a recording starts or the file stops growing. Free space comes from statvfs
+ *  of the directory. The recorder is the first process whose /proc comm is the
+ *  given name, looked for at most every RECORDER_SEARCH_PERIOD_US while none
+ *  runs, and its CPU comes from the utime and stime in its /proc stat. Dropped
+ *  frames are the last drop_frames= line of the progress file the recorder
+ *  writes (ffmpeg -progress), of which only the tail is read.
+ *
+ *  The output directory is only watched while asked to, so a recording does
+ *  not wake the sampling thread at every write.
+ *
+ *  Used by a single thread.
+ */
+class recorderMonitor
+{
+public:
+
+	recorderMonitor(std::string outputDir, std::string processName, std::string progressPath);
+
+	~recorderMonitor();
+
+	//Takes a sample, rates are over the time since the previous one
+	MessageEnvelope::Telemetry sample();
+
+	//Looks for a new output file and recorder at the next sample, e.g. as a recording starts
+	void restart();
+
+	//Watches the output directory for writes with inotify, the first write after
+	//a start command is taken as the first recorded frame
+	bool watchOutput();
+	void unwatchOutput();
+
+	//Readable once a file in the output directory was written, -1 while not watched
+	int getWatchFd() const;
+
+	//Drains the watch, returns true if a file was written since the previous call
+	bool readWrites();
+
+private:
+
+	//Opens the newest regular file of the output directory
+	bool openOutputFile();
+
+	//Finds the pid of the recorder, -1 if it is not running
+	pid_t findRecorder();
+
+	//Reads utime + stime of a process in clock ticks
+	bool readCpuTicks(pid_t pid, uint64_t& ticks);
+
+	//Reads the newest dropped frame count of the progress file
+	bool readDroppedFrames(uint64_t& droppedFrames);
+
+	// Get the current time in microseconds
+	uint64_t getTimeUsec();
+
+	std::string outputDir;
+	std::string processName;
+	std::string progressPath;
+
+	//Output file, its size at the previous sample and when that was taken
+	int outputFd;
+	uint64_t lastSize;
+	uint64_t lastSample_us;
+	bool outputGrowing;
+
+	//Recorder process and its CPU ticks at the previous sample
+	pid_t recorderPid;
+	uint64_t lastTicks;
+	long ticksPerSecond;
+	uint64_t nextRecorderSearch_us;
+
+	uint64_t droppedFrames;
+
+	//inotify instance and its watch on the output directory, -1 if none
+	int watchFd;
+	int watch;
+};
+
+
+#endif //RECORDERMONITOR_H
@@ -12,6 +12,12 @@
 //System Includes
 #include <string.h>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -24,13 +30,28 @@
 
 //Ours
 #include "UdpServer.h"
-#include "messageStructure.h"
+#include "ThreadConfig.h"
+#include "LatencyHistogram.h"
+#include "SequenceStats.h"
+#include "StreamFramer.h"
+#include "SendQueue.h"
+#include "messageCodec.h"
+#include "messageEnvelope.h"
 
 #define GPIO_RED_LED 4
 #define GPIO_RED_BUTTON 5
 #define GPIO_GREEN_LED 0
 #define GPIO_GREEN_BUTTON 2
 
+//First retransmission of an unacknowledged command, doubling up to the maximum
+#define COMMAND_RETRANSMIT_MIN_US 20000
+#define COMMAND_RETRANSMIT_MAX_US 160000
+
+//Telemetry samples in a row with nothing written before a recording counts as
+//stalled, and the free space below which the host disk counts as nearly full
+#define TELEMETRY_STALL_SAMPLES 3
+#define LOW_DISK_MIB 2048
+
 enum REMOTE_STATES_t
 {
 	DISCONNECTED,
@@ -65,7 +86,9 @@ public:
 
 	~remoteSender();
 
-	ssize_t receiveData();
+	//Returns the next frame received from the other device, or nullptr once
+	//nothing more arrived. The frame stays valid until the next call
+	const uint8_t* receiveFrame(size_t* length);
 
 	//Threads that monintor reads and writes from network interfaces
 	int readThread();
@@ -74,10 +97,42 @@ public:
 	//Thread the monitors the states of the buttons to issue commands
 	int buttonThread();
 
+	//Fills sndbuf with the next frame, called with commandMutex held
 	int createSendMessage();
 
+	//Sends a command to the host right away and retransmits it until acknowledged
+	void sendCommand(enum REMOTE_STATES_t state);
+
+	//Lets the heartbeat back off while nothing changes, doubling up to the ceiling.
+	//0 keeps the fixed heartbeat
+	void setKeepaliveCeiling(uint64_t ceiling_us);
+
+	//Interval to announce after a frame that announced interval_us
+	uint64_t getNextKeepalive(uint64_t interval_us);
+
+	//How long the link may stay silent before it counts as lost
+	uint64_t getLinkTimeout() const;
+
+	//Blocks until the link has data to read or the timeout in seconds expires
+	bool waitForData(double timeout);
+
 	//Returns true if the message was parsed correctly
-	bool onMessageReceived();
+	bool onMessageReceived(const uint8_t* frame, size_t length);
+
+	//Sends an envelope with the features agreed on, called by the write thread
+	void sendEnvelope(uint8_t type, const uint8_t* payload, size_t length, SendQueue::Priority priority);
+
+	//Sends our HELLO while the host has not answered it, called by the write thread
+	void sendHelloIfDue();
+
+	//Handler of the HELLO envelope
+	void onHello(const MessageEnvelope::Header& header);
+
+	//Handler of the recorder telemetry the host sends
+	void onTelemetry(const MessageEnvelope::Header& header);
+
+	//Newest recorder telemetry as key=value pairs
+	std::string getTelemetryString() const;
 
 	//Functions to control IO with onboard LED lights
 	int LedControlThread(enum LED_COLORS_t);
@@ -88,6 +143,15 @@ public:
 	// Get the current time in microseconds
 	uint64_t getTimeUsec();
 
+	//Number of frames received that failed the magic number or CRC check
+	uint64_t getBadFrames() const;
+
+	//Bad frames, sequence loss and reordering, round trip and command times of the link
+	std::string getLinkStats();
+
+	//Records every frame received over UDP to a file for captureReplay
+	bool startCapture(std::string path);
+
 
 private:
 	//Simple bool to show if object is running
@@ -118,14 +182,75 @@ private:
 	uint64_t lastTimestampReceived_us;
 	uint64_t lastModeReceived;
 
+	//Local time the newest frame arrived, echoed back with its timestamp
+	uint64_t lastReceivedAt_us;
+
+	//Guards the echoed timestamp pair between the read and write threads
+	std::mutex echoMutex;
+
+	//Sequence number of the next frame sent
+	uint32_t sndSequence;
+
+	//Loss and reordering of the frames received, round trip times of ours
+	SequenceStats rcvSequence;
+	LatencyHistogram rttHistogram;
+
+	//Frames dropped as corrupt or incomplete
+	uint64_t badFrames;
+
+	//Newest command, shared by the button, write and read threads. The write
+	//thread sleeps on the condition until a frame is due
+	std::mutex commandMutex;
+	std::condition_variable commandCondition;
+	uint32_t commandId;
+	bool commandPending;
+	uint64_t commandIssued_us;
+	uint64_t commandRetransmit_us;
+	uint64_t commandBackoff_us;
+
+	//Time from a button push to the acknowledgement of its command
+	LatencyHistogram commandHistogram;
+
+	//Interval announced in the next frame, guarded by commandMutex, and the
+	//most it may grow to while idle
+	uint64_t keepalive_us;
+	std::atomic<uint64_t> keepaliveCeiling_us;
+
+	//Interval the host announced in its newest frame, read thread only
+	uint32_t peerKeepalive_us;
+
 	//Object for handling the sending and reading of UDP packets
 	UdpServer server;
 
+	//Frames are encoded into and parsed out of the buffers directly
 	messageStructure_t sndMessage;
 	uint8_t sndbuf[256];
 	
-	messageStructure_t rcvMessage;
-	uint8_t rcvbuf[256];
+	uint8_t rcvbuf[MessageEnvelope::maxLinkFrameSize];
+
+	//Cuts frames out of the bluetooth byte stream, which has no message
+	//boundaries, and parses them where they were read
+	StreamFramer framer;
+
+	//Frames waiting for room on the serial port, written by the write thread only.
+	//The event wakes the write thread while it waits for that room
+	SendQueue sendQueue;
+	int writeWakeFd;
+
+	//Features agreed with the host, and the handlers of the envelopes it sends
+	MessageEnvelope::Negotiation negotiation;
+	MessageEnvelope::Dispatcher dispatcher;
+
+	//Envelopes are laid out here by the write thread, numbered per direction
+	uint8_t envelopeBuf[MessageEnvelope::maxFrameSize];
+	uint32_t envelopeSequence;
+
+	//Newest recorder telemetry from the host, read thread only. Cleared when
+	//the link is lost
+	MessageEnvelope::Telemetry telemetry;
+	bool hasTelemetry;
+	int stalledSamples;
+	bool recorderWarning;
 
 	//Thread to control the status of the LEDs
 	std::thread redLedThread;
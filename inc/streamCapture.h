@@ -0,0 +1,130 @@
+/**
+ * @file streamCapture.h
+ * @brief Keeps the last seconds of an incoming stream so a recording starts before the command
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef STREAMCAPTURE_H
+#define STREAMCAPTURE_H
+
+//System Includes
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//Ours
+#include "UdpServer.h"
+#include "PrerollRing.h"
+#include "SegmentWriter.h"
+
+//Largest datagram kept, longer ones are counted and dropped. ffmpeg sends 1316
+//bytes (7 MPEG-TS packets) or up to 1472 by default
+#define STREAM_MAX_DATAGRAM 1500
+
+//Highest rate the ring is sized for, and the smallest datagram expected at that rate
+#define STREAM_MAX_RATE_BPS (25 * 1000 * 1000 / 8)
+#define STREAM_MIN_DATAGRAM 1316
+
+//Socket receive buffer, absorbs bursts while the ingest thread is not scheduled
+#define STREAM_RECEIVE_BUFFER (4 * 1024 * 1024)
+
+//How often the writer drains the ring while writing
+#define STREAM_WRITE_PERIOD_MS 20
+
+//Each of the two buffers written to disk at a time. Together they hold 170 ms at
+//the highest rate, which is lost if the host is killed
+#define STREAM_BUFFER_SIZE (256 * 1024)
+
+//A recording is split into segments of this size or age, whichever comes first
+#define STREAM_SEGMENT_SIZE (1024ull * 1024 * 1024)
+#define STREAM_SEGMENT_SECONDS 600
+
+//Set to 1 to write around the page cache with O_DIRECT
+#define STREAM_DIRECT_IO 0
+
+
+/** Records a UDP stream, e.g. MPEG-TS from a camera, with pre-roll.
+ *
+ *  An ingest thread receives every datagram into a PrerollRing for as long as
+ *  the capture is open, whether recording or not. start() makes the writer
+ *  thread open a SegmentWriter and append the ring from preroll seconds before
+ *  the command, then keep appending live until stop(). The ingest thread only
+ *  ever copies into the ring, so opening and writing files never holds it up,
+ *  and a writer that falls behind loses the oldest data rather than the newest.
+ *  Datagrams are written back to back as received, a recording split into
+ *  segments of STREAM_SEGMENT_SIZE bytes or STREAM_SEGMENT_SECONDS seconds.
+ *
+ *  start(), stop() and getStats() may be called from any one thread.
+ */
+class streamCapture
+{
+public:
+
+	streamCapture();
+
+	~streamCapture();
+
+	//Receives the stream arriving on a UDP port, keeping preroll_s seconds of it
+	bool open(int port, double preroll_s);
+
+	bool isOpen() const;
+
+	//Starts writing to new segments in the directory, named after the time and created
+	//if missing. Returns at once
+	void start(const std::string& directory);
+
+	//Stops once everything received so far is written. Returns at once
+	void stop();
+
+	//Ring, segment and file counters on one line
+	std::string getStats();
+
+private:
+
+	//Thread that writes the ring to the segments
+	int writerThread();
+
+	//Appends the ring up to a position, or as far as it goes, to the segments
+	void drain(uint64_t end);
+
+	// Get the current time in nanoseconds
+	static uint64_t getTimeNsec();
+
+	//Allocated once by open()
+	std::unique_ptr<PrerollRing> ring;
+	UdpServer server;
+	uint64_t preroll_ns;
+	std::atomic<bool> opened;
+
+	//Commands to the writer thread
+	std::mutex commandMutex;
+	std::condition_variable commandCondition;
+	bool isRunning;
+	bool startDue;
+	bool stopDue;
+	std::string nextDirectory;
+	uint64_t startAt_ns;
+	uint64_t stopPosition;
+	std::thread writerThread_h;
+
+	//Segments written, next position read from the ring and the datagram read,
+	//writer thread only
+	SegmentWriter segments;
+	uint64_t position;
+	uint64_t endPosition;
+	std::unique_ptr<char[]> datagram;
+
+	std::atomic<uint64_t> files;
+	std::atomic<uint64_t> bytesWritten;
+	std::atomic<uint64_t> prerollBytes;
+	std::atomic<uint64_t> writeErrors;
+};
+
+
+#endif //STREAMCAPTURE_H
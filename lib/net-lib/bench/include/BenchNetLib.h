@@ -0,0 +1,63 @@
+/**
+ * @file BenchNetLib.h
+ * @brief Shared helpers for the networking library benchmarks.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef BENCH_NETLIB_H
+#define BENCH_NETLIB_H
+
+#include <atomic>
+#include <string>
+#include <unistd.h>
+
+// Benchmark
+#include <benchmark/benchmark.h>
+
+// Ours
+#include "Networking.h"
+
+
+namespace Bench {
+
+
+// All benchmarks talk over the loopback interface.
+static const std::string loopback = "127.0.0.1";
+
+// Each benchmark family gets its own port so sockets lingering from a previous
+// family never collide with the next one.
+static const int udpPort = 4101;
+static const int tcpThroughputPort = 4102;
+static const int tcpLatencyPort = 4103;
+static const int syscallPort = 4104;
+
+// Abstract Unix socket name for the same host benchmarks.
+static const std::string unixPath = "@netlib-bench";
+
+
+/** Waits until a counter reaches an expected value or the timeout expires.
+ *
+ *  @param[in] counter  Counter updated by another thread.
+ *  @param[in] expected Value to wait for.
+ *  @param[in] timeout  Maximum time to wait in seconds.
+ *  @return             True if the counter reached the expected value.
+ */
+inline bool waitForCount(const std::atomic<uint64_t>& counter, uint64_t expected, double timeout)
+{
+    const double start = Networking::getWallTime();
+    while (counter.load() < expected)
+    {
+        if (Networking::getWallTime() - start > timeout)
+            return false;
+        usleep(1000);
+    }
+    return true;
+}
+
+
+}  // BENCH
+
+
+#endif  // BENCH_NETLIB_H
@@ -0,0 +1,46 @@
+/**
+ * @file BenchCrc.cpp
+ * @brief Cost of the CRC32C checksum on control frames and larger buffers.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <vector>
+
+#include "BenchNetLib.h"
+#include "Crc32c.h"
+
+
+/** Checksum of state.range(0) bytes with the implementation picked for the
+ *  CPU, reported in the label.
+ */
+static void BM_Crc32c(benchmark::State& state)
+{
+    std::vector<uint8_t> buff(static_cast<size_t>(state.range(0)), 0x5A);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buff.data());
+        benchmark::DoNotOptimize(Crc32c::compute(buff.data(), buff.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * buff.size());
+    state.SetLabel(Crc32c::getImplementation());
+}
+BENCHMARK(BM_Crc32c)
+    ->Arg(15)->Arg(64)->Arg(4096);
+
+
+/** The same with slicing-by-8, what a Pi Zero runs.
+ */
+static void BM_Crc32cSoftware(benchmark::State& state)
+{
+    std::vector<uint8_t> buff(static_cast<size_t>(state.range(0)), 0x5A);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buff.data());
+        benchmark::DoNotOptimize(Crc32c::computeSoftware(buff.data(), buff.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_Crc32cSoftware)
+    ->Arg(15)->Arg(64)->Arg(4096);
@@ -0,0 +1,42 @@
+/**
+ * @file BenchMain.cpp
+ * @brief Entry point for the networking library benchmarks.
+ *
+ * Results are printed as JSON unless a format is given on the command line so
+ * runs on the desktop and on the Pi can be archived and compared directly.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "BenchNetLib.h"
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    static char jsonFormat[] = "--benchmark_format=json";
+
+    std::vector<char*> args(argv, argv + argc);
+    bool hasFormat = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--benchmark_format", strlen("--benchmark_format")) == 0)
+            hasFormat = true;
+    }
+    if (!hasFormat)
+        args.push_back(jsonFormat);
+
+    int numArgs = static_cast<int>(args.size());
+    benchmark::Initialize(&numArgs, args.data());
+    if (benchmark::ReportUnrecognizedArguments(numArgs, args.data()))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
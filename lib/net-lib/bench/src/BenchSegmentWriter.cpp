@@ -0,0 +1,84 @@
+/**
+ * @file BenchSegmentWriter.cpp
+ * @brief Sustained recording rate of the segment writer.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "BenchNetLib.h"
+#include "SegmentWriter.h"
+
+
+namespace {
+
+// Removes the segments written and their directory.
+void removeDirectory(const std::string& directory)
+{
+    if (DIR* dir = opendir(directory.c_str()))
+    {
+        while (struct dirent* entry = readdir(dir))
+        {
+            if (entry->d_name[0] != '.')
+                unlink((directory + "/" + entry->d_name).c_str());
+        }
+        closedir(dir);
+    }
+    rmdir(directory.c_str());
+}
+
+}  // ANONYMOUS
+
+
+/** Appends MPEG-TS sized datagrams to 64 MiB segments in the working
+ *  directory, buffered or with O_DIRECT if state.range(0) is 1. The time
+ *  includes writing out the last buffers, and the counters show how often
+ *  and how long append() waited for the disk.
+ */
+static void BM_SegmentWriter(benchmark::State& state)
+{
+    char path[] = "netlib-bench-XXXXXX";
+    if (!mkdtemp(path))
+    {
+        state.SkipWithError("Could not create a directory");
+        return;
+    }
+
+    SegmentWriter::Options options;
+    options.directory = path;
+    options.prefix = "bench";
+    options.segmentSize = 64 * 1024 * 1024;
+    options.directIo = state.range(0) != 0;
+
+    SegmentWriter writer;
+    if (!writer.open(options))
+    {
+        state.SkipWithError("Could not open the writer");
+        removeDirectory(path);
+        return;
+    }
+
+    const std::vector<char> message(1316, 'x');
+    for (auto _ : state)
+        writer.append(message.data(), message.size());
+    writer.close();
+
+    const SegmentWriter::Snapshot snapshot = writer.getSnapshot();
+    state.SetBytesProcessed(static_cast<int64_t>(snapshot.bytesWritten));
+    state.counters["segments"] = snapshot.segments;
+    state.counters["stalls"] = snapshot.stalls;
+    state.counters["stall_ms"] = snapshot.stallTime_ns / 1e6;
+    state.counters["write_p99_us"] = snapshot.writeTime.p99;
+    state.SetLabel(snapshot.directIo ? "O_DIRECT" : "buffered");
+    removeDirectory(path);
+}
+BENCHMARK(BM_SegmentWriter)
+    ->Arg(0)->Arg(1)
+    ->UseRealTime();
@@ -0,0 +1,60 @@
+/**
+ * @file BenchShm.cpp
+ * @brief Same host throughput through the shared memory ring.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <thread>
+#include <vector>
+
+#include "BenchNetLib.h"
+#include "ShmRing.h"
+
+
+/** Streams messages of state.range(0) bytes through a ShmRing to a consumer
+ *  thread reading them in place, to set against BM_TcpThroughput.
+ */
+static void BM_ShmRingThroughput(benchmark::State& state)
+{
+    const size_t chunk = static_cast<size_t>(state.range(0));
+    std::atomic<uint64_t> received(0);
+
+    ShmRing producer, consumer;
+    if (!producer.create("netlib-bench", 64, chunk) || !consumer.attach(producer.getFd()) || !consumer.subscribe())
+    {
+        state.SkipWithError("Could not create the shared memory ring");
+        return;
+    }
+
+    std::thread reader([&consumer, &received]() {
+        size_t length;
+        while (consumer.peek(length))
+        {
+            received.fetch_add(length, std::memory_order_relaxed);
+            consumer.release();
+        }
+    });
+
+    std::vector<char> buff(chunk, 'x');
+    uint64_t sent = 0;
+    for (auto _ : state)
+    {
+        if (!producer.send(buff.data(), chunk, 1.0))
+        {
+            state.SkipWithError("Send failed");
+            break;
+        }
+        sent += chunk;
+    }
+
+    Bench::waitForCount(received, sent, 2.0);
+    consumer.interrupt();
+    reader.join();
+
+    state.SetBytesProcessed(static_cast<int64_t>(received.load()));
+}
+BENCHMARK(BM_ShmRingThroughput)
+    ->Arg(64)->Arg(1024)->Arg(16384)->Arg(65536)
+    ->UseRealTime();
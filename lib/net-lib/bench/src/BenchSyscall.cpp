@@ -0,0 +1,161 @@
+/**
+ * @file BenchSyscall.cpp
+ * @brief Cost of the individual socket calls made once per message.
+ *
+ * These isolate the kernel entry cost that the UdpServer/TcpServer loops pay
+ * for every datagram or poll, independent of any thread hand-off.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "BenchNetLib.h"
+
+
+/** Pair of loopback UDP sockets, the receiver bound to Bench::syscallPort.
+ */
+struct LoopbackPair
+{
+    int sender;
+    int receiver;
+    struct sockaddr_in address;
+
+    LoopbackPair()
+        : sender(::socket(AF_INET, SOCK_DGRAM, 0)),
+          receiver(::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0))
+    {
+        memset(&this->address, 0, sizeof(this->address));
+        this->address.sin_family = AF_INET;
+        this->address.sin_port = htons(Bench::syscallPort);
+        this->address.sin_addr.s_addr = inet_addr(Bench::loopback.c_str());
+        if (::bind(this->receiver, (struct sockaddr*)&this->address, sizeof(this->address)) == -1)
+        {
+            ::close(this->receiver);
+            this->receiver = -1;
+        }
+    }
+
+    ~LoopbackPair()
+    {
+        if (this->sender != -1)
+            ::close(this->sender);
+        if (this->receiver != -1)
+            ::close(this->receiver);
+    }
+
+    bool isValid() const
+    {
+        return this->sender != -1 && this->receiver != -1;
+    }
+};
+
+
+/** sendto(2) with a full destination address, as UdpServer::send does.
+ */
+static void BM_SyscallSendto(benchmark::State& state)
+{
+    LoopbackPair pair;
+    if (!pair.isValid())
+    {
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    char buff[64] = {0};
+    for (auto _ : state)
+    {
+        // Receiver is never read, once it is full the kernel drops the datagram
+        // after the send path has done all of its work
+        benchmark::DoNotOptimize(::sendto(pair.sender, buff, sizeof(buff), 0,
+            (struct sockaddr*)&pair.address, sizeof(pair.address)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SyscallSendto);
+
+
+/** send(2) on a connected datagram socket, skipping the per-call route lookup.
+ */
+static void BM_SyscallSendConnected(benchmark::State& state)
+{
+    LoopbackPair pair;
+    if (!pair.isValid()
+        || ::connect(pair.sender, (struct sockaddr*)&pair.address, sizeof(pair.address)) == -1)
+    {
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    char buff[64] = {0};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(::send(pair.sender, buff, sizeof(buff), 0));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SyscallSendConnected);
+
+
+/** One datagram sent and received, the minimum work per message.
+ */
+static void BM_SyscallSendRecv(benchmark::State& state)
+{
+    LoopbackPair pair;
+    if (!pair.isValid())
+    {
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    char buff[64] = {0};
+    struct sockaddr_in from;
+    for (auto _ : state)
+    {
+        socklen_t addrlen = sizeof(from);
+        ::sendto(pair.sender, buff, sizeof(buff), 0, (struct sockaddr*)&pair.address, sizeof(pair.address));
+        benchmark::DoNotOptimize(::recvfrom(pair.receiver, buff, sizeof(buff), 0, (struct sockaddr*)&from, &addrlen));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SyscallSendRecv);
+
+
+/** recvfrom(2) on an empty non-blocking socket, the cost of one idle spin of
+ *  the UdpServer receive loop.
+ */
+static void BM_SyscallRecvEmpty(benchmark::State& state)
+{
+    LoopbackPair pair;
+    if (!pair.isValid())
+    {
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    char buff[64];
+    struct sockaddr_in from;
+    for (auto _ : state)
+    {
+        socklen_t addrlen = sizeof(from);
+        benchmark::DoNotOptimize(::recvfrom(pair.receiver, buff, sizeof(buff), 0, (struct sockaddr*)&from, &addrlen));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SyscallRecvEmpty);
+
+
+/** Networking::hasInput with a zero timeout, the select(2) call made by the
+ *  TcpServer accept loop.
+ */
+static void BM_SyscallSelectZero(benchmark::State& state)
+{
+    LoopbackPair pair;
+    if (!pair.isValid())
+    {
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Networking::hasInput(pair.receiver, 0));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SyscallSelectZero);
@@ -0,0 +1,126 @@
+/**
+ * @file BenchTcp.cpp
+ * @brief Loopback throughput and request/response latency through TcpServer
+ *        and TcpClient.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <vector>
+
+#include "BenchNetLib.h"
+#include "TcpClient.h"
+#include "TcpServer.h"
+
+
+/** Server task which reads and discards everything until the client hangs up.
+ */
+static bool sinkTask(int sockClient, std::atomic<uint64_t>& bytesReceived)
+{
+    char buff[65536];
+    while (true)
+    {
+        ssize_t n = ::recv(sockClient, buff, sizeof(buff), 0);
+        if (n <= 0)
+            return n == 0;
+        bytesReceived.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    }
+}
+
+
+/** Server task which echoes every byte back to the client until it hangs up.
+ */
+static bool echoTask(int sockClient)
+{
+    char buff[65536];
+    while (true)
+    {
+        ssize_t n = ::recv(sockClient, buff, sizeof(buff), 0);
+        if (n <= 0)
+            return n == 0;
+        if (!Networking::sendData(sockClient, buff, static_cast<int>(n)))
+            return false;
+    }
+}
+
+
+/** Streams writes of state.range(0) bytes from a TcpClient to a TcpServer.
+ */
+static void BM_TcpThroughput(benchmark::State& state)
+{
+    const size_t chunk = static_cast<size_t>(state.range(0));
+    std::atomic<uint64_t> received(0);
+
+    TcpServer server([&received](int sockClient) { return sinkTask(sockClient, received); },
+        Bench::loopback, Bench::tcpThroughputPort, 0.1);
+    TcpClient client(Bench::loopback, Bench::tcpThroughputPort);
+    if (!server.isServerAlive() || !client.isAlive())
+    {
+        server.disconnect();
+        state.SkipWithError("Could not open loopback TCP sockets");
+        return;
+    }
+
+    std::vector<char> buff(chunk, 'x');
+    uint64_t sent = 0;
+    for (auto _ : state)
+    {
+        if (!Networking::sendData(client.getSocket(), buff.data(), static_cast<int>(chunk)))
+        {
+            state.SkipWithError("Send failed");
+            break;
+        }
+        sent += chunk;
+    }
+
+    // Count only what made it to the server task
+    Bench::waitForCount(received, sent, 2.0);
+    client.disconnect();
+    server.disconnect();
+
+    state.SetBytesProcessed(static_cast<int64_t>(received.load()));
+}
+BENCHMARK(BM_TcpThroughput)
+    ->Arg(64)->Arg(1024)->Arg(16384)->Arg(65536)
+    ->UseRealTime();
+
+
+/** Sends state.range(0) bytes and waits for the server to echo them back.
+ *
+ *  Iteration time is the request/response round trip as seen by the client.
+ */
+static void BM_TcpRequestResponse(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+
+    TcpServer server(echoTask, Bench::loopback, Bench::tcpLatencyPort, 0.1);
+    TcpClient client(Bench::loopback, Bench::tcpLatencyPort);
+    if (!server.isServerAlive() || !client.isAlive())
+    {
+        server.disconnect();
+        state.SkipWithError("Could not open loopback TCP sockets");
+        return;
+    }
+
+    std::vector<char> request(size, 'x');
+    std::vector<char> response(size + 1);
+    for (auto _ : state)
+    {
+        int bytes = 0;
+        if (!Networking::sendData(client.getSocket(), request.data(), size)
+            || !Networking::read(response.data(), bytes, client.getSocket(), size))
+        {
+            state.SkipWithError("Round trip failed");
+            break;
+        }
+    }
+
+    client.disconnect();
+    server.disconnect();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TcpRequestResponse)
+    ->Arg(16)->Arg(256)->Arg(4096)
+    ->UseRealTime();
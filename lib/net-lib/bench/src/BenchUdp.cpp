@@ -0,0 +1,178 @@
+/**
+ * @file BenchUdp.cpp
+ * @brief Loopback packet rate through UdpServer and UdpClient.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <vector>
+
+#include "BenchNetLib.h"
+#include "UdpClient.h"
+#include "UdpServer.h"
+#include "PeerTable.h"
+
+
+/** Server task counting the datagrams it sees.
+ */
+struct CountDatagrams
+{
+    std::atomic<uint64_t>* received;
+
+    bool operator()(int, char*, size_t) const
+    {
+        received->fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+
+/** Streams datagrams of state.range(0) bytes from a UdpClient to a Server.
+ *
+ *  Every iteration is one send. Items processed are the datagrams the server
+ *  task actually saw, so the reported rate is the delivered packet rate and
+ *  the "dropped" counter shows how far the sender outran the receive loop.
+ */
+template <typename Server>
+static void runPacketsPerSecond(benchmark::State& state)
+{
+    const size_t payload = static_cast<size_t>(state.range(0));
+    std::atomic<uint64_t> received(0);
+
+    CountDatagrams task = {&received};
+    Server server(task, Bench::loopback, Bench::udpPort, 65536, 4 * 1024 * 1024, 0.1);
+    UdpClient client(Bench::loopback, Bench::udpPort);
+    if (!server.isServerAlive() || !client.isAlive())
+    {
+        server.disconnect();
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    std::vector<char> buff(payload, 'x');
+    uint64_t sent = 0;
+    for (auto _ : state)
+    {
+        client.send(buff.data(), payload);
+        sent++;
+    }
+
+    // Give the receive loop a moment to drain whatever is still queued
+    Bench::waitForCount(received, sent, 1.0);
+    server.disconnect();
+
+    const uint64_t delivered = received.load();
+    state.SetItemsProcessed(static_cast<int64_t>(delivered));
+    state.SetBytesProcessed(static_cast<int64_t>(delivered * payload));
+    state.counters["dropped"] = static_cast<double>(sent - delivered);
+    state.counters["kernelDrops"] = static_cast<double>(server.getStats().kernelDrops);
+}
+
+
+/** Packet rate with the task behind a std::function.
+ */
+static void BM_UdpPacketsPerSecond(benchmark::State& state)
+{
+    runPacketsPerSecond<UdpServer>(state);
+}
+BENCHMARK(BM_UdpPacketsPerSecond)
+    ->Arg(16)->Arg(64)->Arg(256)->Arg(1024)->Arg(1472)->Arg(8192)
+    ->UseRealTime();
+
+
+/** Packet rate with the task type known to the receive loop.
+ */
+static void BM_UdpPacketsPerSecondInline(benchmark::State& state)
+{
+    runPacketsPerSecond<BasicUdpServer<CountDatagrams> >(state);
+}
+BENCHMARK(BM_UdpPacketsPerSecondInline)
+    ->Arg(16)->Arg(64)->Arg(1472)
+    ->UseRealTime();
+
+
+/** Round trip of a 64 byte datagram echoed by the UdpServer task.
+ *
+ *  state.range(0) selects the receive mode of the server: 0 for the default
+ *  blocking loop, 1 for the low-latency spinning loop.
+ */
+static void BM_UdpRoundTrip(benchmark::State& state)
+{
+    UdpServer server;
+    if (state.range(0))
+    {
+        UdpServer::LowLatencyOptions options;
+        options.spinTime = 0.001;
+        server.setLowLatency(options);
+    }
+
+    int sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(Bench::udpPort);
+    address.sin_addr.s_addr = inet_addr(Bench::loopback.c_str());
+    if (sock == -1 || !server.connect(Bench::loopback, Bench::udpPort, 0)
+        || ::connect(sock, (struct sockaddr*)&address, sizeof(address)) == -1
+        || !Networking::setTimeoutReceive(sock, 1.0))
+    {
+        server.disconnect();
+        if (sock != -1)
+            ::close(sock);
+        state.SkipWithError("Could not open loopback UDP sockets");
+        return;
+    }
+
+    server.runInThread([&server](int, char* buff, size_t length) {
+            return server.send(buff, length) == (ssize_t)length;
+        }, 2048, 0.1);
+
+    char buff[64] = {0};
+    for (auto _ : state)
+    {
+        if (::send(sock, buff, sizeof(buff), 0) == -1 || ::recv(sock, buff, sizeof(buff), 0) == -1)
+        {
+            state.SkipWithError("Echo lost");
+            break;
+        }
+    }
+
+    server.disconnect();
+    ::close(sock);
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(state.range(0) ? "lowLatency" : "default");
+}
+BENCHMARK(BM_UdpRoundTrip)->Arg(0)->Arg(1)->UseRealTime();
+
+
+/** Cost of recording one datagram in a PeerTable holding state.range(0) peers,
+ *  cycling through all of them so lookups miss the cache as they would with
+ *  real traffic.
+ */
+static void BM_PeerTableLookup(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    PeerTable table(count, 10.0);
+
+    std::vector<struct sockaddr_in> addresses(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        memset(&addresses[i], 0, sizeof(addresses[i]));
+        addresses[i].sin_family = AF_INET;
+        addresses[i].sin_addr.s_addr = htonl(0x0A000000 + (uint32_t)(i / 16));
+        addresses[i].sin_port = htons(5000 + (uint16_t)(i % 16));
+    }
+
+    uint64_t now_ns = 1000000000000ull;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(table.onReceive(addresses[next], 64, now_ns++));
+        if (++next == count)
+            next = 0;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PeerTableLookup)->Arg(16)->Arg(1024)->Arg(16384);
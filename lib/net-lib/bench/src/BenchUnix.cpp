@@ -0,0 +1,46 @@
+/**
+ * @file BenchUnix.cpp
+ * @brief Same host round trip through the Unix domain socket server.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "BenchNetLib.h"
+#include "UnixClient.h"
+#include "UnixDatagramServer.h"
+
+
+/** Round trip of a 64 byte datagram echoed by a UnixDatagramServer, to set
+ *  against BM_UdpRoundTrip/0 which does the same over loopback UDP.
+ */
+static void BM_UnixRoundTrip(benchmark::State& state)
+{
+    UnixDatagramServer server;
+    UnixClient client;
+    if (!server.connect(Bench::unixPath, 0) || !client.connect(Bench::unixPath, SOCK_DGRAM)
+        || !Networking::setTimeoutReceive(client.getSocket(), 1.0))
+    {
+        state.SkipWithError("Could not open Unix sockets");
+        return;
+    }
+
+    server.runInThread([&server](int, char* buff, size_t length) {
+            return server.send(buff, length) == (ssize_t)length;
+        }, 2048, 0);
+
+    char buff[64] = {0};
+    for (auto _ : state)
+    {
+        if (::send(client.getSocket(), buff, sizeof(buff), 0) == -1
+            || ::recv(client.getSocket(), buff, sizeof(buff), 0) == -1)
+        {
+            state.SkipWithError("Echo lost");
+            break;
+        }
+    }
+
+    server.disconnect();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UnixRoundTrip)->UseRealTime();
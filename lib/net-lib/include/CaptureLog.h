@@ -0,0 +1,238 @@
+/**
+ * @file CaptureLog.h
+ * @brief Memory mapped binary log of received messages, for replaying traffic.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef CAPTURE_LOG_H
+#define CAPTURE_LOG_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Network
+#include <netinet/in.h>
+
+
+/** Layout of a capture file.
+ *
+ *  The file starts with a FileHeader followed by records, each a
+ *  RecordHeader and the message padded to 8 bytes. Fields are in the byte
+ *  order of the capturing host, except the address and port which are in
+ *  network order as in sockaddr_in. A record with a zero flags field ends
+ *  the log, which is where a capture cut short by a crash stops.
+ */
+namespace Capture {
+
+// Protocol a record was received over.
+const uint8_t protocolUdp = 1;
+const uint8_t protocolTcp = 2;
+
+// Record flags.
+const uint8_t flagValid = 0x01;
+
+// A TCP client connected, the record carries no data.
+const uint8_t flagConnect = 0x02;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+
+    // Wall time the capture started.
+    uint64_t start_ns;
+};
+
+struct RecordHeader
+{
+    // Kernel receive time of the message, CLOCK_REALTIME.
+    uint64_t timestamp_ns;
+
+    // Source of the message.
+    uint32_t address;
+    uint16_t port;
+
+    uint8_t protocol;
+    uint8_t flags;
+
+    // Length of the message following the header.
+    uint32_t length;
+    uint32_t reserved;
+};
+
+// One record read back from a capture.
+struct Record
+{
+    RecordHeader header;
+    const char* data;
+};
+
+}  // CAPTURE
+
+
+/** CaptureLog appends received messages to a capture file.
+ *
+ *  The file is mapped into memory and grown in large steps, so appending a
+ *  message is a copy into the page cache under a mutex, without a system
+ *  call per message. The file is trimmed to its contents on close().
+ */
+class CaptureLog
+{
+
+public:
+
+    /** Default constructor, see open().
+     */
+    CaptureLog();
+
+
+    /** Destructor, closes the log.
+     */
+    ~CaptureLog();
+
+
+    /** Creates a capture file, replacing any file at the path.
+     *
+     *  @param[in] path     Path of the file.
+     *  @return             True if the file was created.
+     */
+    bool open(const std::string& path);
+
+
+    /** Trims the file to its contents and closes it.
+     */
+    void close();
+
+
+    /** Determines if a capture file is open. Cheap enough to call per
+     *  message.
+     */
+    bool isOpen() const;
+
+
+    /** Appends a message.
+     *
+     *  @param[in] protocol     Capture::protocolUdp or Capture::protocolTcp.
+     *  @param[in] source       Sender of the message.
+     *  @param[in] data         Message.
+     *  @param[in] length       Length of the message.
+     *  @param[in] timestamp_ns Receive time, CLOCK_REALTIME.
+     *  @param[in] flags        Flags besides Capture::flagValid.
+     *  @return                 True if the message was recorded.
+     */
+    bool append(uint8_t protocol, const struct sockaddr_in& source, const char* data, size_t length,
+        uint64_t timestamp_ns, uint8_t flags = 0);
+
+
+    /** Gets the number of records appended since open().
+     */
+    uint64_t getRecords() const;
+
+
+    /** Gets the current wall time in nanoseconds, for messages without a
+     *  kernel timestamp.
+     */
+    static uint64_t getWallTime_ns();
+
+
+private:
+
+    /** Grows the file and its mapping to hold at least size bytes.
+     */
+    bool reserve(size_t size);
+
+    // Step the file grows by.
+    static const size_t growStep = 8 * 1024 * 1024;
+
+    // Capture file.
+    int fd;
+
+    // Mapping of the file.
+    char* mapping;
+    size_t capacity;
+
+    // Bytes written.
+    size_t used;
+
+    // Records written.
+    std::atomic<uint64_t> records;
+
+    // Whether a file is open, checked without the lock.
+    std::atomic<bool> opened;
+
+    // Serializes appends, open and close.
+    std::mutex mutex;
+
+};  // CAPTURE_LOG
+
+
+/** CaptureReader walks the records of a capture file.
+ */
+class CaptureReader
+{
+
+public:
+
+    /** Default constructor, see open().
+     */
+    CaptureReader();
+
+
+    /** Destructor, closes the file.
+     */
+    ~CaptureReader();
+
+
+    /** Maps a capture file.
+     *
+     *  @param[in] path     Path of the file.
+     *  @return             True if the file is a capture.
+     */
+    bool open(const std::string& path);
+
+
+    /** Unmaps the file.
+     */
+    void close();
+
+
+    /** Reads the next record. Its data stays valid until close().
+     *
+     *  @param[out] record  The record.
+     *  @return             False at the end of the log.
+     */
+    bool next(Capture::Record& record);
+
+
+    /** Goes back to the first record.
+     */
+    void rewind();
+
+
+    /** Gets the header of the file.
+     */
+    const Capture::FileHeader& getHeader() const;
+
+
+private:
+
+    // Mapping of the file.
+    const char* mapping;
+    size_t size;
+
+    // Offset of the next record.
+    size_t offset;
+
+};  // CAPTURE_READER
+
+
+#endif  // CAPTURE_LOG_H
@@ -0,0 +1,56 @@
+/**
+ * @file Crc32c.h
+ * @brief CRC32C (Castagnoli) checksums using the CPU instructions when present.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+
+
+/** CRC32C as used by iSCSI, ext4 and SCTP: reflected polynomial 0x82F63B78,
+ *  initial value and final xor 0xFFFFFFFF.
+ *
+ *  compute() picks an implementation once, on first use: the SSE4.2 crc32
+ *  instruction on x86, the ARMv8 CRC32 extension on ARM cores that have it,
+ *  and table driven slicing-by-8 everywhere else, such as the ARMv6 of the Pi
+ *  Zero. All of them give the same result.
+ */
+namespace Crc32c {
+
+
+/** Computes the checksum of a buffer.
+ *
+ *  @param[in] data     Bytes to checksum.
+ *  @param[in] length   Number of bytes.
+ *  @param[in] crc      Checksum of the preceding bytes when checksumming a
+ *                      buffer in pieces, 0 to start.
+ *  @return             Checksum of the preceding bytes and the buffer.
+ */
+uint32_t compute(const void* data, size_t length, uint32_t crc = 0);
+
+
+/** Computes the checksum with slicing-by-8 regardless of the CPU, see
+ *  compute().
+ */
+uint32_t computeSoftware(const void* data, size_t length, uint32_t crc = 0);
+
+
+/** Gets the name of the implementation compute() uses, "sse4.2", "armv8" or
+ *  "slicing-by-8".
+ */
+const char* getImplementation();
+
+
+}  // CRC32C
+
+
+#endif  // CRC32C_H
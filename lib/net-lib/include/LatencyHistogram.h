@@ -0,0 +1,154 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Log-bucketed latency histogram with lock-free recording.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+/** LatencyHistogram counts samples in HDR-style log-linear buckets.
+ *
+ *  Values below 2^subBucketBits are counted exactly. Above that every power of
+ *  two range is split into 2^(subBucketBits - 1) linear sub-buckets, so the
+ *  reported value of any sample is within 1 / 2^(subBucketBits - 1) of the
+ *  real one regardless of magnitude. Values above the configured maximum are
+ *  counted in the last bucket.
+ *
+ *  record() only does relaxed atomic updates and may be called from any
+ *  number of threads while another thread reads percentiles. Reads taken
+ *  while samples are being recorded are consistent to within the samples in
+ *  flight.
+ *
+ *  Jitter is the RFC 3550 smoothed mean of the difference between consecutive
+ *  samples, in the same unit as the samples.
+ */
+class LatencyHistogram
+{
+
+public:
+
+    // Point in time view of the histogram.
+    struct Summary
+    {
+        uint64_t count;
+        uint64_t min;
+        uint64_t max;
+        double mean;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t p999;
+        double jitter;
+    };
+
+
+    /** Constructor.
+     *
+     *  @param[in] maxValue         Largest value tracked with full precision.
+     *  @param[in] subBucketBits    Precision of the buckets, between 2 and 16.
+     */
+    explicit LatencyHistogram(uint64_t maxValue = 60000000, int subBucketBits = 7);
+
+
+    /** Records a sample.
+     *
+     *  @param[in] value    Sample, usually a latency in microseconds.
+     */
+    void record(uint64_t value);
+
+
+    /** Clears all samples.
+     *
+     *  Must not race with record() if an exact reset is required.
+     */
+    void reset();
+
+
+    /** Gets the number of samples recorded.
+     */
+    uint64_t getCount() const;
+
+
+    /** Gets the value below which the given percentage of samples fall.
+     *
+     *  @param[in] percentile   Percentile between 0 and 100.
+     *  @return                 Highest value equivalent to the bucket holding
+     *                          the percentile, 0 if there are no samples.
+     */
+    uint64_t getValueAtPercentile(double percentile) const;
+
+
+    /** Gets count, extremes, mean, p50, p99, p99.9 and jitter in one pass.
+     */
+    Summary getSummary() const;
+
+
+    /** Formats a summary as a single line of key=value pairs.
+     *
+     *  @param[in] summary  Summary to format.
+     *  @param[in] unit     Unit suffix appended to every value.
+     */
+    static std::string toString(const Summary& summary, const std::string& unit = "us");
+
+
+private:
+
+    /** Maps a value to its bucket.
+     */
+    size_t bucketIndex(uint64_t value) const;
+
+
+    /** Gets the highest value that maps to a bucket.
+     */
+    uint64_t bucketValue(size_t index) const;
+
+
+    /** Walks the buckets to find the value at each requested percentile.
+     */
+    void percentiles(const double* percentiles, uint64_t* values, size_t n) const;
+
+    // Number of bits of linear precision.
+    int subBucketBits;
+
+    // 2^subBucketBits.
+    uint64_t subBucketCount;
+
+    // Total number of buckets.
+    size_t bucketCount;
+
+    // Per-bucket sample counts.
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+
+    // Total number of samples.
+    std::atomic<uint64_t> count;
+
+    // Sum of all samples, for the mean.
+    std::atomic<uint64_t> sum;
+
+    // Smallest sample.
+    std::atomic<uint64_t> min;
+
+    // Largest sample.
+    std::atomic<uint64_t> max;
+
+    // Previous sample, for jitter.
+    std::atomic<uint64_t> last;
+
+    // Smoothed jitter scaled by 16.
+    std::atomic<uint64_t> jitter16;
+
+};  // LATENCY_HISTOGRAM
+
+
+#endif  // LATENCY_HISTOGRAM_H
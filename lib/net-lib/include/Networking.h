@@ -6,17 +6,24 @@
  *
  * Updates:
  * 01/31/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Added eventfd wakeups
+ * 10/18/2026 [msardonini] Added Unix domain socket helpers
+ * 10/18/2026 [msardonini] Added waitForOutput
+ * 10/19/2026 [msardonini] Added removeStaleUnixSocket
  */
 
 #ifndef NETWORKING_H
 #define NETWORKING_H
 
 // STL
+#include <cstddef>
 #include <cstring>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <iostream>
 #include <unistd.h>
+#include <errno.h>
 
 // Time
 #include <time.h>
@@ -28,6 +35,11 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/un.h>
+
+// Event
+#include <poll.h>
+#include <sys/eventfd.h>
 
 
 namespace Networking {
@@ -136,6 +148,134 @@ bool read(char* data, int& bytes, int fd, int size);
 bool hasInput(int fd, double timeout);
 
 
+/** Waits until a socket has input or a wakeup event is signalled.
+ *
+ *  @param[in]  fd       File descriptor of the socket.
+ *  @param[in]  wakeFd   Event from createWakeup(), -1 for none.
+ *  @param[in]  timeout  Amount of time to block, 0 or less blocks until
+ *                       input or a wakeup.
+ *  @return              True if the socket has input, false on timeout,
+ *                       wakeup or error.
+ */
+bool waitForInput(int fd, int wakeFd, double timeout);
+
+
+/** Waits until a socket has room for output or a wakeup event is signalled.
+ *
+ *  @param[in]  fd       File descriptor of the socket.
+ *  @param[in]  wakeFd   Event from createWakeup(), -1 for none.
+ *  @param[in]  timeout  Amount of time to block, 0 or less blocks until
+ *                       the socket is writable or a wakeup.
+ *  @return              True if the socket is writable, false on timeout,
+ *                       wakeup or error.
+ */
+bool waitForOutput(int fd, int wakeFd, double timeout);
+
+
+/** Creates an eventfd(2) used to wake a thread blocked in waitForInput() or
+ *  waitForOutput().
+ *
+ *  @return              File descriptor of the event, -1 on error.
+ */
+int createWakeup();
+
+
+/** Signals a wakeup event. The event stays signalled until cleared.
+ *
+ *  @param[in]  wakeFd   Event from createWakeup().
+ *  @return              True if the event was signalled.
+ */
+bool signalWakeup(int wakeFd);
+
+
+/** Clears a signalled wakeup event.
+ *
+ *  @param[in]  wakeFd   Event from createWakeup().
+ */
+void clearWakeup(int wakeFd);
+
+
+/** Most descriptors passed with one message by sendWithRights() and
+ *  receiveWithRights().
+ */
+const size_t maxPassedFds = 16;
+
+
+/** Builds a Unix domain socket address.
+ *
+ *  A path starting with '@' names the abstract namespace: the socket exists
+ *  only while it is open, leaves no file behind and needs no writable
+ *  directory. Any other path is a file in the filesystem.
+ *
+ *  @param[in]  path     Path of the socket, or "@name" for an abstract one.
+ *  @param[out] address  Address of the socket.
+ *  @param[out] length   Length of the address to pass to bind(2)/connect(2).
+ *  @return              True if the path fits in an address.
+ */
+bool makeUnixAddress(const std::string& path, struct sockaddr_un& address, socklen_t& length);
+
+
+/** Removes the socket file of a server that exited without removing it.
+ *
+ *  The file is only removed if nothing answers on it: a server still bound
+ *  to the path keeps it, and the bind(2) that follows fails with EADDRINUSE
+ *  instead of taking the path over. Abstract names leave no file and are
+ *  left alone.
+ *
+ *  @param[in] path     Path of the socket.
+ *  @param[in] address  Address of the socket, see makeUnixAddress().
+ *  @param[in] length   Length of the address.
+ *  @param[in] type     SOCK_STREAM or SOCK_DGRAM, as the server binds it.
+ */
+void removeStaleUnixSocket(const std::string& path, const struct sockaddr_un& address, socklen_t length, int type);
+
+
+/** Sends a message over a Unix domain socket together with file descriptors.
+ *
+ *  The receiver gets its own descriptors for the same open files.
+ *
+ *  @param[in]  fd       File descriptor of the socket.
+ *  @param[in]  data     Data to send, at least one byte.
+ *  @param[in]  length   Length of the data.
+ *  @param[in]  fds      Descriptors to pass, may be NULL.
+ *  @param[in]  count    Number of descriptors, at most maxPassedFds.
+ *  @param[in]  to       Destination of a datagram, NULL on a connected socket.
+ *  @param[in]  toLength Length of the destination.
+ *  @return              Bytes sent, -1 on error.
+ */
+ssize_t sendWithRights(int fd, const void* data, size_t length, const int* fds, size_t count,
+    const struct sockaddr_un* to = NULL, socklen_t toLength = 0);
+
+
+/** Receives a message from a Unix domain socket along with any descriptors
+ *  and credentials attached to it.
+ *
+ *  Descriptors are received close-on-exec and belong to the caller.
+ *  Credentials are only attached when SO_PASSCRED is set on the socket.
+ *
+ *  @param[in]  fd          File descriptor of the socket.
+ *  @param[out] data        Buffer for the message.
+ *  @param[in]  length      Size of the buffer.
+ *  @param[out] fds         Received descriptors are appended here.
+ *  @param[out] credentials Credentials of the sender if attached, may be NULL.
+ *  @param[out] from        Address of the sender, may be NULL.
+ *  @param[out] fromLength  Length of the sender address, may be NULL.
+ *  @return                 Bytes received, -1 on error.
+ */
+ssize_t receiveWithRights(int fd, void* data, size_t length, std::vector<int>& fds,
+    struct ucred* credentials = NULL, struct sockaddr_un* from = NULL, socklen_t* fromLength = NULL);
+
+
+/** Gets the credentials of the process at the other end of a connected Unix
+ *  domain socket, as they were when it connected.
+ *
+ *  @param[in]  fd          File descriptor of the socket.
+ *  @param[out] credentials Process, user and group id of the peer.
+ *  @return                 True if the credentials were read.
+ */
+bool getPeerCredentials(int fd, struct ucred& credentials);
+
+
 /** Flushes a socket.
  *  
  *  @param[in] fd       File descriptor of the socket to flush.
@@ -0,0 +1,231 @@
+/**
+ * @file PeerTable.h
+ * @brief Table of the peers a datagram socket hears from, keyed by address.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef PEER_TABLE_H
+#define PEER_TABLE_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Network
+#include <netinet/in.h>
+
+
+/** PeerTable keeps one entry per (ip, port) a datagram socket receives from.
+ *
+ *  Entries live in a pool allocated once at construction and are found through
+ *  an open addressing index with linear probing, so a lookup per datagram is a
+ *  hash and usually one or two probes, without allocating. Removal shifts the
+ *  following entries of the probe run back, which keeps lookups short without
+ *  tombstones.
+ *
+ *  Entries idle for longer than the timeout are removed by a hashed timer
+ *  wheel. A datagram only updates the last seen time of its entry; the entry
+ *  is checked when its wheel slot comes due and moved to a later slot if it
+ *  was heard from in the meantime. Expiry therefore costs nothing per datagram
+ *  and happens at most one tick late.
+ *
+ *  Peers are referred to by an id that stays valid while the entry exists and
+ *  never matches a later entry reusing the same slot.
+ *
+ *  The table is not thread safe, UdpServer guards it with a mutex.
+ */
+class PeerTable
+{
+
+public:
+
+    // Identifies an entry, 0 is never a valid id.
+    typedef uint64_t PeerId;
+
+    // An entry of the table.
+    struct Peer
+    {
+        // Id of the entry.
+        PeerId id;
+
+        // Address and port of the peer.
+        struct sockaddr_in address;
+
+        // Monotonic times the peer was first and last heard from.
+        uint64_t firstSeen_ns;
+        uint64_t lastSeen_ns;
+
+        // Traffic from and to the peer.
+        uint64_t rxPackets;
+        uint64_t rxBytes;
+        uint64_t txPackets;
+        uint64_t txBytes;
+
+        // Free for the application, zero when the entry is created.
+        uint64_t userData;
+    };
+
+
+    /** Constructor.
+     *
+     *  @param[in] capacity     Most peers held at once.
+     *  @param[in] idleTimeout  Seconds without traffic before a peer expires.
+     */
+    PeerTable(size_t capacity, double idleTimeout);
+
+
+    /** Records a datagram from a peer, creating its entry if needed.
+     *
+     *  Also expires idle entries whose time has come.
+     *
+     *  @param[in] address  Source of the datagram.
+     *  @param[in] bytes    Size of the datagram.
+     *  @param[in] now_ns   Current monotonic time.
+     *  @return             The entry, or NULL if the table is full.
+     */
+    Peer* onReceive(const struct sockaddr_in& address, size_t bytes, uint64_t now_ns);
+
+
+    /** Finds the entry of an address.
+     *
+     *  @return             The entry, or NULL if the address is not known.
+     */
+    Peer* find(const struct sockaddr_in& address);
+
+
+    /** Finds an entry by id.
+     *
+     *  @return             The entry, or NULL if it expired or was removed.
+     */
+    Peer* get(PeerId id);
+
+
+    /** Removes an entry.
+     *
+     *  @return             True if the entry existed.
+     */
+    bool remove(PeerId id);
+
+
+    /** Removes every entry idle for longer than the timeout.
+     *
+     *  @param[in] now_ns   Current monotonic time.
+     *  @return             Number of entries removed.
+     */
+    size_t expire(uint64_t now_ns);
+
+
+    /** Copies out every entry.
+     */
+    std::vector<Peer> getPeers() const;
+
+
+    /** Gets the number of entries.
+     */
+    size_t size() const;
+
+
+    /** Gets the most entries the table holds.
+     */
+    size_t capacity() const;
+
+
+    /** Gets the number of datagrams from new peers dropped on a full table.
+     */
+    uint64_t getRejected() const;
+
+
+    /** Gets the number of entries removed for being idle.
+     */
+    uint64_t getExpired() const;
+
+
+private:
+
+    // Marks an empty index slot or the end of a list.
+    static const uint32_t none = 0xFFFFFFFF;
+
+    // Slots of the timer wheel, a power of two.
+    static const uint32_t wheelSize = 256;
+
+    // Pool entry with the links the table needs.
+    struct Entry
+    {
+        Peer peer;
+
+        // Bumped on every reuse so stale ids do not match.
+        uint32_t generation;
+
+        // Whether the entry is in use.
+        bool used;
+
+        // Doubly linked wheel slot list, or the free list through next.
+        uint32_t next;
+        uint32_t prev;
+
+        // Absolute tick of the wheel slot the entry is in.
+        uint64_t dueTick;
+    };
+
+    /** Hashes an address and port into the index.
+     */
+    uint32_t hash(uint32_t addr, uint16_t port) const;
+
+    /** Finds the index slot of an address, or the empty slot ending its run.
+     */
+    uint32_t findSlot(uint32_t addr, uint16_t port) const;
+
+    /** Removes an entry from the index, the wheel and the pool.
+     */
+    void release(uint32_t entry);
+
+    /** Puts an entry in the wheel slot of its deadline.
+     */
+    void schedule(uint32_t entry);
+
+    /** Takes an entry out of its wheel slot.
+     */
+    void unschedule(uint32_t entry);
+
+    /** Converts an id to its pool index, none if stale.
+     */
+    uint32_t toIndex(PeerId id) const;
+
+    // Pool of entries, never resized.
+    std::vector<Entry> entries;
+
+    // Open addressing index into entries, a power of two at least twice the
+    // capacity so probe runs stay short.
+    std::vector<uint32_t> index;
+
+    // Head of the free entry list.
+    uint32_t freeList;
+
+    // First entry of every wheel slot.
+    std::vector<uint32_t> wheel;
+
+    // Length of a wheel tick.
+    uint64_t tick_ns;
+
+    // Idle time after which an entry expires.
+    uint64_t timeout_ns;
+
+    // Last tick the wheel was advanced to.
+    uint64_t currentTick;
+
+    // Number of entries in use.
+    size_t count;
+
+    uint64_t rejected;
+
+    uint64_t expired;
+
+};  // PEER_TABLE
+
+
+#endif  // PEER_TABLE_H
@@ -0,0 +1,207 @@
+/**
+ * @file PrerollRing.h
+ * @brief Lock-free ring keeping the most recent messages of a stream.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef PREROLL_RING_H
+#define PREROLL_RING_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// System
+#include <sys/types.h>
+
+
+/** PrerollRing keeps the newest messages of a stream in fixed size slots,
+ *  each stamped with its receive time, so the seconds before a trigger can
+ *  be written out after it.
+ *
+ *  One producer pushes every message and never waits: when the ring is full
+ *  the oldest message is overwritten. One consumer reads messages by their
+ *  position, a count of messages pushed, starting from seek(). Each slot is
+ *  guarded by a sequence number like a seqlock. A consumer that is lapped
+ *  by the producer sees the sequence change, skips to the oldest message
+ *  still in the ring, and counts the messages it lost. A slow consumer
+ *  never slows the producer down.
+ *
+ *  The slots are mapped and touched once in the constructor and never
+ *  reallocated, so pushing is a copy without a page fault or system call.
+ *
+ *  push() is for a single producer thread and seek() and read() for a single
+ *  consumer thread. getHead() and getSnapshot() may be called from any
+ *  thread.
+ */
+class PrerollRing
+{
+
+public:
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        // Messages pushed and their bytes.
+        uint64_t pushed;
+        uint64_t pushedBytes;
+
+        // Messages longer than a slot, not pushed.
+        uint64_t tooLong;
+
+        // Messages overwritten before the consumer read them.
+        uint64_t overruns;
+
+        // Messages read by the consumer.
+        uint64_t read;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Constructor, maps and touches every slot. See isValid().
+     *
+     *  @param[in] slotCount    Number of messages the ring holds.
+     *  @param[in] slotSize     Largest message in bytes.
+     */
+    PrerollRing(size_t slotCount, size_t slotSize);
+
+
+    /** Destructor, unmaps the slots.
+     */
+    ~PrerollRing();
+
+
+    /** Gets the number of slots needed to keep a stream for some time, with
+     *  as much again as headroom for a consumer that falls behind.
+     *
+     *  @param[in] seconds      Time to keep.
+     *  @param[in] rate_Bps     Highest rate of the stream in bytes per second.
+     *  @param[in] messageSize  Smallest typical message of the stream.
+     *  @return                 Number of slots, at least 2.
+     */
+    static size_t getSlotCount(double seconds, uint64_t rate_Bps, size_t messageSize);
+
+
+    /** Determines if the slots were mapped.
+     */
+    bool isValid() const { return this->slots != nullptr; }
+
+
+    /** Gets the largest message the ring holds.
+     */
+    size_t getSlotSize() const { return this->slotSize; }
+
+
+    /** Gets the number of slots of the ring.
+     */
+    size_t getSlotCount() const { return this->slotCount; }
+
+
+    /** Copies a message into the ring, overwriting the oldest one if full.
+     *  Producer only.
+     *
+     *  @param[in] data         Message.
+     *  @param[in] length       Length of the message, at most getSlotSize().
+     *  @param[in] timestamp_ns Receive time of the message.
+     *  @return                 True if the message was pushed.
+     */
+    bool push(const char* data, size_t length, uint64_t timestamp_ns);
+
+
+    /** Gets the position the next message will be pushed at.
+     */
+    uint64_t getHead() const { return this->head.load(std::memory_order_acquire); }
+
+
+    /** Finds the oldest message still in the ring received at or after a
+     *  time. Consumer only.
+     *
+     *  @param[in] since_ns     Time in the clock of the timestamps pushed.
+     *  @return                 Position of the message, getHead() if none.
+     */
+    uint64_t seek(uint64_t since_ns);
+
+
+    /** Copies the message at a position out of the ring. Consumer only.
+     *
+     *  @param[in,out] position     Message to read, moved past it on success.
+     *                              Moved to the oldest message in the ring
+     *                              first if the one asked for was overwritten.
+     *  @param[out]    buff         Buffer of at least getSlotSize() bytes.
+     *  @param[out]    timestamp_ns Receive time of the message.
+     *  @return                     Length of the message, -1 if there is no
+     *                              message at the position yet.
+     */
+    ssize_t read(uint64_t& position, char* buff, uint64_t& timestamp_ns);
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+private:
+
+    // Keeps the producer and consumer counters on separate cache lines.
+    static const size_t cacheLine = 64;
+
+    // Header of every slot, followed by the message.
+    struct Slot
+    {
+        // 2 * position + 1 while the message at position is written,
+        // 2 * position + 2 once it is complete.
+        std::atomic<uint64_t> sequence;
+        uint64_t timestamp_ns;
+        uint32_t length;
+    };
+
+    /** Gets the slot of a position.
+     */
+    Slot* getSlot(uint64_t position) const
+    {
+        return reinterpret_cast<Slot*>(this->slots + (position % this->slotCount) * this->slotStride);
+    }
+
+    /** Gets the oldest position that may still be read, given the head.
+     */
+    uint64_t getOldest(uint64_t head_) const
+    {
+        return head_ >= this->slotCount ? head_ - this->slotCount + 1 : 0;
+    }
+
+    /** Adds to a counter that only one thread writes.
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    char* slots;
+    size_t slotCount;
+    size_t slotSize;
+    size_t slotStride;
+    size_t mappedSize;
+
+    // Written by the producer.
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> pushedBytes;
+    std::atomic<uint64_t> tooLong;
+    char producerPadding[cacheLine];
+
+    // Written by the consumer.
+    std::atomic<uint64_t> overruns;
+    std::atomic<uint64_t> reads;
+
+};  // PREROLL_RING
+
+
+#endif  // PREROLL_RING_H
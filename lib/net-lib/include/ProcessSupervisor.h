@@ -0,0 +1,204 @@
+/**
+ * @file ProcessSupervisor.h
+ * @brief Starts, watches and stops a child process without a shell.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/18/2026 [msardonini] Optional pipe to the standard input of the child
+ */
+
+#ifndef PROCESS_SUPERVISOR_H
+#define PROCESS_SUPERVISOR_H
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// System
+#include <sys/types.h>
+
+
+/** ProcessSupervisor runs one child process at a time, e.g. a recorder.
+ *
+ *  start() launches the program with posix_spawn(), which shares the memory
+ *  of the parent until the exec instead of copying its page tables like
+ *  fork() and skips the /bin/sh that system() starts. The child leads a
+ *  process group of its own with default signal handling and an empty signal
+ *  mask, so a script and everything it starts are stopped together, and no
+ *  realtime priority or blocked signal of the calling thread leaks into it.
+ *
+ *  The exit of the child is seen through a pidfd, which a poll() loop can
+ *  watch with getFd(). Kernels before 5.3 have no pidfd; getFd() is then -1
+ *  and update() has to be called now and then instead. stop() only sends the
+ *  signal and returns, update() sends SIGKILL to the group once the timeout
+ *  given to stop() has passed, so stopping never blocks the caller.
+ *
+ *  Not thread safe, except for getState(), getPid() and getSnapshot() which
+ *  may be called from any thread at any time.
+ */
+class ProcessSupervisor
+{
+
+public:
+
+    // What the child is doing.
+    enum State
+    {
+        // Never started, or reaped after stop().
+        STOPPED,
+
+        // Started and not exited.
+        RUNNING,
+
+        // Signalled by stop() and not exited yet.
+        STOPPING,
+
+        // Exited without being asked to, getSnapshot() tells how.
+        EXITED
+    };
+
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        State state;
+
+        // Child running now, -1 if none.
+        pid_t pid;
+
+        // Wait status of the last child reaped, see waitpid(2).
+        int lastStatus;
+
+        // Children started, children that exited without stop(), and
+        // children that ignored the stop signal and were killed.
+        uint64_t starts;
+        uint64_t unexpectedExits;
+        uint64_t kills;
+
+        // Time the last posix_spawn() took, and the longest one.
+        uint64_t lastSpawn_ns;
+        uint64_t maxSpawn_ns;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Default constructor, no child running.
+     */
+    ProcessSupervisor();
+
+
+    /** Destructor, kills a child still running and reaps it.
+     */
+    ~ProcessSupervisor();
+
+
+    /** Starts a child. Fails if one is running or stopping.
+     *
+     *  @param[in] argv         Path of the program, then its arguments.
+     *  @param[in] withInput    Connects the standard input of the child to a
+     *                          pipe written with writeInput(), e.g. to tell a
+     *                          child waiting on it to go ahead. The child
+     *                          reads end of file once the supervisor is gone.
+     *  @return                 True if the program was started.
+     */
+    bool start(const std::vector<std::string>& argv, bool withInput = false);
+
+
+    /** Writes to the standard input of the child without blocking. A child
+     *  that exited fails the write, it does not raise SIGPIPE.
+     *
+     *  @param[in] data     Bytes to write.
+     *  @param[in] length   Number of bytes, at most PIPE_BUF to go in whole.
+     *  @return             True if all bytes were written.
+     */
+    bool writeInput(const void* data, size_t length);
+
+
+    /** Asks the child to stop. Returns at once, see update().
+     *
+     *  @param[in] signal   Signal sent to the process group of the child.
+     *  @param[in] timeout  Seconds to wait for it before killing the group.
+     *  @return             True if a child was running.
+     */
+    bool stop(int signal, double timeout);
+
+
+    /** Reaps a child that exited and kills one that outlived its stop
+     *  timeout. Call whenever getFd() is readable, or periodically without one.
+     *
+     *  @return     True if the state changed.
+     */
+    bool update();
+
+
+    /** Gets the descriptor that becomes readable when the child exits, -1 if
+     *  no child is running or the kernel has no pidfd.
+     */
+    int getFd() const { return this->pidFd; }
+
+
+    /** Gets what the child is doing.
+     */
+    State getState() const { return this->state.load(std::memory_order_acquire); }
+
+
+    /** Gets the pid of the child, -1 if none is running.
+     */
+    pid_t getPid() const { return this->pid.load(std::memory_order_acquire); }
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+    /** Finds a running process the way pidof -x does, by the name of its
+     *  executable or of the script it runs, without starting a shell.
+     *
+     *  @param[in] name     File name of the program or script, without path.
+     *  @return             Pid of the first match, -1 if none.
+     */
+    static pid_t findByName(const std::string& name);
+
+
+private:
+
+    /** Reaps the child if it exited. Returns true if it did.
+     */
+    bool reap();
+
+    /** Adds to a counter that only the supervising thread writes.
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<State> state;
+    std::atomic<pid_t> pid;
+    int pidFd;
+
+    // Write end of the pipe to the standard input of the child, -1 if none.
+    int inputFd;
+
+    // When update() escalates to SIGKILL, monotonic nanoseconds.
+    uint64_t killDeadline_ns;
+
+    std::atomic<int> lastStatus;
+    std::atomic<uint64_t> starts;
+    std::atomic<uint64_t> unexpectedExits;
+    std::atomic<uint64_t> kills;
+    std::atomic<uint64_t> lastSpawn_ns;
+    std::atomic<uint64_t> maxSpawn_ns;
+
+};  // PROCESS_SUPERVISOR
+
+
+#endif  // PROCESS_SUPERVISOR_H
@@ -0,0 +1,267 @@
+/**
+ * @file SegmentWriter.h
+ * @brief Writes a long recording to disk in segments at a steady rate.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef SEGMENT_WRITER_H
+#define SEGMENT_WRITER_H
+
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Ours
+#include "LatencyHistogram.h"
+
+
+/** SegmentWriter appends a byte stream to a series of segment files.
+ *
+ *  append() copies into one of two large page aligned buffers. A full
+ *  buffer is handed to a thread of the writer's own and the caller goes on
+ *  filling the other one, so the caller only waits if the disk falls a
+ *  whole buffer behind. Each segment is reserved with fallocate() as it is
+ *  opened, and further ahead as it grows, so the file system does not
+ *  allocate blocks write by write.
+ *
+ *  Writes go through the page cache unless Options::directIo is set, in
+ *  which case the segments are opened with O_DIRECT where the file system
+ *  supports it. Buffered writes are paced with sync_file_range(): writeback
+ *  of each new Options::syncSize range is started at once, and the range
+ *  before it is waited for and dropped from the cache. Dirty pages thus
+ *  never pile up until the kernel throttles every writer at once.
+ *
+ *  A new segment starts once the current one would grow past
+ *  Options::segmentSize or is older than Options::segmentDuration, always
+ *  between two appends so a message is never split across segments.
+ *
+ *  open(), append(), rotate() and close() are for one thread at a time.
+ *  getSnapshot() may be called from any thread.
+ */
+class SegmentWriter
+{
+
+public:
+
+    // How to write the segments.
+    struct Options
+    {
+        // Directory of the segments, and the start and end of their names.
+        // Segments are named <prefix>-<date>-<time>-<number><extension>.
+        std::string directory;
+        std::string prefix;
+        std::string extension;
+
+        // Size of each of the two buffers, rounded up to whole blocks.
+        size_t bufferSize;
+
+        // Bytes or seconds after which a segment ends, 0 for no limit.
+        uint64_t segmentSize;
+        double segmentDuration;
+
+        // Space reserved in one fallocate() call.
+        uint64_t preallocateSize;
+
+        // Range of buffered writes written back at a time.
+        uint64_t syncSize;
+
+        // Writes around the page cache with O_DIRECT.
+        bool directIo;
+
+        // Role the writing thread configures itself with, see ThreadConfig.h.
+        std::string threadRole;
+
+        /** Defaults: 1 MiB buffers, 1 GiB segments without time limit,
+         *  reserved 64 MiB and written back 8 MiB at a time, buffered.
+         */
+        Options();
+    };
+
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        // Segments opened and bytes written to them.
+        uint64_t segments;
+        uint64_t bytesWritten;
+
+        // Average rate from open() until now or close(), bytes per second.
+        uint64_t rate_Bps;
+
+        // Appends that waited for the disk, and the time they waited.
+        uint64_t stalls;
+        uint64_t stallTime_ns;
+
+        // Failed writes, whose buffer was lost, and failed reservations.
+        uint64_t writeErrors;
+        uint64_t preallocateErrors;
+
+        // Whether the segments are written with O_DIRECT.
+        bool directIo;
+
+        // Time each buffer took to write, in microseconds.
+        LatencyHistogram::Summary writeTime;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Default constructor, see open().
+     */
+    SegmentWriter();
+
+
+    /** Destructor, closes the writer.
+     */
+    ~SegmentWriter();
+
+
+    /** Allocates the buffers and starts the writing thread. The first
+     *  segment is created with the first buffer written.
+     *
+     *  @param[in] options  How to write the segments.
+     *  @return             True if the writer was opened.
+     */
+    bool open(const Options& options);
+
+
+    /** Appends bytes to the current segment, or to a new one if the current
+     *  one is full or too old.
+     *
+     *  @param[in] data     Bytes to append.
+     *  @param[in] length   Number of bytes.
+     *  @return             True if the writer is open.
+     */
+    bool append(const char* data, size_t length);
+
+
+    /** Ends the current segment, the next append() starts a new one.
+     */
+    void rotate();
+
+
+    /** Writes what is buffered, trims the last segment to its contents and
+     *  stops the writing thread. Blocks until everything is written.
+     */
+    void close();
+
+
+    /** Determines if the writer is open.
+     */
+    bool isOpen() const { return this->buffers[0].data != nullptr; }
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+private:
+
+    // Alignment of O_DIRECT buffers, offsets and lengths.
+    static const size_t blockSize = 4096;
+
+    // One of the two buffers.
+    struct Buffer
+    {
+        char* data;
+        size_t length;
+
+        // Path of the segment this buffer starts, empty to continue the
+        // current one, and whether the segment ends with it.
+        std::string newSegment;
+        bool endsSegment;
+
+        // Handed to the writing thread and not written yet.
+        bool full;
+    };
+
+    /** Hands the buffer being filled to the writing thread and waits until
+     *  the other one is free to fill.
+     */
+    void handOff(bool endsSegment);
+
+    /** Starts a new segment with the buffer being filled.
+     */
+    void startSegment();
+
+    /** Writes the buffers handed off until close().
+     */
+    void writeThread();
+
+    /** Writes one buffer to the current segment. Writing thread only.
+     */
+    void writeBuffer(Buffer& buffer);
+
+    /** Creates a segment. Writing thread only.
+     */
+    bool openSegment(const std::string& path);
+
+    /** Reserves the current segment up to an offset. Writing thread only.
+     */
+    void preallocate(uint64_t end);
+
+    /** Starts writeback of the range written since the last one, then waits
+     *  for the range before it and drops it from the cache. Writing thread
+     *  only.
+     */
+    void writeBack();
+
+    /** Trims and closes the current segment. Writing thread only.
+     */
+    void closeSegment();
+
+    Options options;
+    Buffer buffers[2];
+    size_t bufferSize;
+
+    // Buffer being filled, and the bytes and age of the current segment.
+    int filling;
+    uint64_t segmentBytes;
+    uint64_t segmentStart_ns;
+    bool segmentStarted;
+    uint32_t segmentNumber;
+
+    // Hand off between the caller and the writing thread.
+    std::mutex mutex;
+    std::condition_variable bufferFull;
+    std::condition_variable bufferFree;
+    bool stopping;
+    std::thread thread;
+
+    // Current segment, writing thread only.
+    int fd;
+    bool segmentDirect;
+    uint64_t offset;
+    uint64_t fileSize;
+    uint64_t reserved;
+    uint64_t syncedTo;
+    uint64_t previousSync;
+
+    // Counters.
+    std::atomic<uint64_t> open_ns;
+    std::atomic<uint64_t> close_ns;
+    std::atomic<uint64_t> segments;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> stalls;
+    std::atomic<uint64_t> stallTime_ns;
+    std::atomic<uint64_t> writeErrors;
+    std::atomic<uint64_t> preallocateErrors;
+    std::atomic<bool> directIo;
+    LatencyHistogram writeTime;
+
+};  // SEGMENT_WRITER
+
+
+#endif  // SEGMENT_WRITER_H
@@ -0,0 +1,185 @@
+/**
+ * @file SendQueue.h
+ * @brief Prioritized queue of frames waiting to go out on a slow byte stream.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+/** SendQueue holds the frames waiting to be written to a non-blocking stream,
+ *  e.g. a serial port, in three priority classes.
+ *
+ *  flush() writes as much as the descriptor takes, always from the highest
+ *  class that has a frame. A frame cut short by a partial write is resumed
+ *  where it stopped before anything else is written, so frames are never
+ *  interleaved; that frame is the longest any frame waits behind a lower
+ *  class. Bulk frames are also held back while the kernel still buffers
+ *  more than the bulk watermark for the descriptor, so an urgent frame
+ *  pushed later does not queue up behind them in the kernel either.
+ *
+ *  A frame pushed with replace drops the frames of its class that are still
+ *  waiting, for state where only the newest frame matters. Each class holds
+ *  a bounded number of frames and drops its oldest when full. Frame buffers
+ *  are reused, so a steady stream of frames does not allocate.
+ *
+ *  Not thread safe, except for getSnapshot() which may be called from any
+ *  thread at any time.
+ */
+class SendQueue
+{
+
+public:
+
+    // Priority classes, highest first.
+    enum Priority
+    {
+        // Commands and their acknowledgements.
+        URGENT,
+
+        // Periodic status and keepalives.
+        STATUS,
+
+        // Telemetry and anything else that may wait.
+        BULK,
+
+        PRIORITY_COUNT
+    };
+
+
+    // Outcome of a flush().
+    enum Result
+    {
+        // Every frame was written.
+        FLUSHED,
+
+        // The descriptor is full, wait until it is writable.
+        BLOCKED,
+
+        // Only bulk frames are left and the kernel buffer is above the watermark.
+        THROTTLED,
+
+        // The write failed, errno tells why. The frame is kept.
+        FAILED
+    };
+
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        // Frames written in full, per class.
+        uint64_t sent[PRIORITY_COUNT];
+
+        // Frames dropped for a newer one of the same class.
+        uint64_t replaced;
+
+        // Frames dropped because their class was full.
+        uint64_t dropped;
+
+        // Writes that took only part of a frame.
+        uint64_t partialWrites;
+
+        // Flushes that stopped on a full descriptor.
+        uint64_t blocked;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Constructor.
+     *
+     *  @param[in] maxFrames        Frames each class holds before dropping.
+     *  @param[in] bulkWatermark    Bytes the kernel may buffer for the
+     *                              descriptor before bulk frames wait, 0 to
+     *                              never hold them back.
+     */
+    SendQueue(size_t maxFrames = 32, size_t bulkWatermark = 256);
+
+
+    /** Queues a copy of a frame.
+     *
+     *  @param[in] priority Class of the frame.
+     *  @param[in] data     Bytes of the frame.
+     *  @param[in] length   Number of bytes.
+     *  @param[in] replace  Drop the frames of this class still waiting.
+     */
+    void push(Priority priority, const void* data, size_t length, bool replace = false);
+
+
+    /** Writes queued frames to a non-blocking descriptor until it is full or
+     *  the queue is empty.
+     *
+     *  @param[in] fd   Descriptor to write to.
+     *  @return         Why the flush stopped.
+     */
+    Result flush(int fd);
+
+
+    /** Returns true if no frame is waiting or partly written.
+     */
+    bool isEmpty() const;
+
+
+    /** Drops every waiting frame, e.g. after the link was reset. A partly
+     *  written frame is dropped too. The counters are kept.
+     */
+    void clear();
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+private:
+
+    /** Adds to a counter that only the sending thread writes.
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /** Keeps a frame buffer for reuse.
+     */
+    void recycle(std::vector<uint8_t>& frame);
+
+    const size_t maxFrames;
+    const size_t bulkWatermark;
+
+    std::deque<std::vector<uint8_t> > queues[PRIORITY_COUNT];
+
+    // Frame being written, the bytes of it written so far, and its class.
+    std::vector<uint8_t> current;
+    size_t currentOffset;
+    Priority currentPriority;
+    bool hasCurrent;
+
+    // Buffers of frames already written.
+    std::vector<std::vector<uint8_t> > spares;
+
+    std::atomic<uint64_t> sent[PRIORITY_COUNT];
+    std::atomic<uint64_t> replaced;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> partialWrites;
+    std::atomic<uint64_t> blocked;
+
+};  // SEND_QUEUE
+
+
+#endif  // SEND_QUEUE_H
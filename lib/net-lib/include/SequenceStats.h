@@ -0,0 +1,121 @@
+/**
+ * @file SequenceStats.h
+ * @brief Loss, reordering and duplicate counters for a sequence numbered stream.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef SEQUENCE_STATS_H
+#define SEQUENCE_STATS_H
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+
+/** SequenceStats follows the sequence numbers of the messages a peer sends,
+ *  one greater for every message, and classifies each one as it arrives.
+ *
+ *  The sequence numbers below the highest one seen are tracked in a 64 wide
+ *  window. A gap counts as lost until the missing message turns up, which then
+ *  counts as reordered instead. A number already in the window is a duplicate.
+ *  A number from before the window means the peer restarted its sequence, and
+ *  tracking starts over from it. Sequence numbers may wrap around.
+ *
+ *  record() must only be called from one thread. getSnapshot() may be called
+ *  from any thread at any time.
+ */
+class SequenceStats
+{
+
+public:
+
+    // How a sequence number was classified.
+    enum Result
+    {
+        // Newer than any before, possibly after a gap.
+        NEW,
+
+        // Older than the newest but not seen before.
+        REORDERED,
+
+        // Seen before.
+        DUPLICATE,
+
+        // Too old for the window, tracking started over from it.
+        RESTARTED
+    };
+
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        uint64_t received;
+        uint64_t lost;
+        uint64_t reordered;
+        uint64_t duplicates;
+        uint64_t restarts;
+
+        // Highest sequence number received.
+        uint32_t highest;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Constructor, all counters start at zero.
+     */
+    SequenceStats();
+
+
+    /** Classifies and counts a received sequence number.
+     */
+    Result record(uint32_t sequence);
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+    /** Sets all counters back to zero and forgets the sequence numbers seen.
+     *  Not safe against a concurrent record().
+     */
+    void reset();
+
+
+private:
+
+    /** Adds to a counter that only the recording thread writes.
+     */
+    static void add(std::atomic<uint64_t>& counter, int64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Sequence numbers tracked below and including the highest.
+    static const uint32_t windowSize = 64;
+
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> lost;
+    std::atomic<uint64_t> reordered;
+    std::atomic<uint64_t> duplicates;
+    std::atomic<uint64_t> restarts;
+    std::atomic<uint32_t> highest;
+
+    // Bit n set if highest - n was received. Recording thread only.
+    uint64_t window;
+
+    // Whether any sequence number was received yet. Recording thread only.
+    bool started;
+
+};  // SEQUENCE_STATS
+
+
+#endif  // SEQUENCE_STATS_H
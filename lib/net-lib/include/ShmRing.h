@@ -0,0 +1,302 @@
+/**
+ * @file ShmRing.h
+ * @brief Shared memory ring of messages between processes on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// System
+#include <sys/types.h>
+
+
+/** ShmRing passes messages through a ring of fixed size slots in a memfd
+ *  shared by every process attached to it.
+ *
+ *  One endpoint creates the ring and is its only producer. It hands the file
+ *  descriptor from getFd() to consumers, e.g. over a Unix socket with
+ *  Networking::sendWithRights() or by fork(), and each consumer attaches
+ *  its own ShmRing to it and subscribes. Every subscribed consumer sees every
+ *  message; the producer waits for the slowest one rather than overwrite a
+ *  message not yet read, so nothing is lost. A consumer process that dies
+ *  without unsubscribing is dropped once the producer finds it gone.
+ *
+ *  claim()/publish() and peek()/release() work on the slot in place, so a
+ *  message is written once by the producer and read where it lies by the
+ *  consumers. send() and receive() are the copying equivalents of UdpClient
+ *  and UdpServer. Waiting sides sleep on futexes in the shared memory and
+ *  are woken only when someone actually waits, so an uncontended message
+ *  costs no system call.
+ */
+class ShmRing
+{
+
+public:
+
+    // Most consumers subscribed to a ring at once.
+    static const uint32_t maxConsumers = 8;
+
+
+    /** Default constructor, see create() and attach().
+     */
+    ShmRing();
+
+
+    /** Destructor, unsubscribes and unmaps the ring.
+     */
+    ~ShmRing();
+
+
+    /** Creates a ring, making this endpoint its producer.
+     *
+     *  @param[in] name         Name of the memfd, shown in /proc/<pid>/fd.
+     *  @param[in] slotCount    Number of messages the ring holds.
+     *  @param[in] slotSize     Largest message in bytes.
+     *  @return                 True if the ring was created.
+     */
+    bool create(const std::string& name, size_t slotCount, size_t slotSize);
+
+
+    /** Attaches to a ring created elsewhere. The descriptor is duplicated, the
+     *  caller keeps its own.
+     *
+     *  @param[in] fd   Descriptor of the ring's memfd.
+     *  @return         True if fd holds a valid ring.
+     */
+    bool attach(int fd);
+
+
+    /** Unsubscribes, unmaps the ring and closes the descriptor.
+     */
+    void close();
+
+
+    /** Gets the descriptor to hand to consumers, -1 if not open.
+     */
+    int getFd() const;
+
+
+    /** Gets the largest message the ring holds.
+     */
+    size_t getSlotSize() const;
+
+
+    /** Gets the number of slots of the ring.
+     */
+    size_t getSlotCount() const;
+
+
+    /** Gets a slot to write the next message into. Producer only.
+     *
+     *  @param[in] timeout  Time to wait for the slowest consumer to free a
+     *                      slot, 0 to wait indefinitely.
+     *  @return             getSlotSize() bytes to write the message into,
+     *                      NULL on timeout or interrupt().
+     */
+    char* claim(double timeout = 0);
+
+
+    /** Makes the claimed slot visible to the consumers. Producer only.
+     *
+     *  @param[in] length   Length of the message written into the slot.
+     *  @return             True if the message was published.
+     */
+    bool publish(size_t length);
+
+
+    /** Copies a message into the ring. Producer only.
+     *
+     *  @param[in] buff     Message to send.
+     *  @param[in] length   Length of the message, at most getSlotSize().
+     *  @param[in] timeout  Time to wait for a free slot, 0 to wait
+     *                      indefinitely.
+     *  @return             True if the message was sent.
+     */
+    bool send(const char* buff, size_t length, double timeout = 0);
+
+
+    /** Subscribes this endpoint as a consumer. It receives every message
+     *  published from now on.
+     *
+     *  @return             True if a consumer place was free.
+     */
+    bool subscribe();
+
+
+    /** Gives the consumer place back so the producer stops waiting for it.
+     */
+    void unsubscribe();
+
+
+    /** Gets the next message in place. Consumer only.
+     *
+     *  @param[out] length  Length of the message.
+     *  @param[in]  timeout Time to wait for a message, 0 to wait
+     *                      indefinitely.
+     *  @return             The message, valid until release(), NULL on
+     *                      timeout or interrupt().
+     */
+    const char* peek(size_t& length, double timeout = 0);
+
+
+    /** Frees the message returned by peek() for the producer to reuse.
+     */
+    void release();
+
+
+    /** Copies the next message out of the ring. Consumer only.
+     *
+     *  @param[out] buff    Buffer for the message, longer messages are cut
+     *                      short.
+     *  @param[in]  size    Size of the buffer.
+     *  @param[in]  timeout Time to wait for a message, 0 to wait
+     *                      indefinitely.
+     *  @return             Length of the message, -1 on timeout or
+     *                      interrupt().
+     */
+    ssize_t receive(char* buff, size_t size, double timeout = 0);
+
+
+    /** Wakes and fails the waits of this endpoint, e.g. to stop a thread
+     *  blocked in peek(). Waits keep failing until clearInterrupt().
+     */
+    void interrupt();
+
+
+    /** Lets waits of this endpoint block again after interrupt().
+     */
+    void clearInterrupt();
+
+
+    /** Gets the number of messages published since the ring was created.
+     */
+    uint64_t getPublished() const;
+
+
+private:
+
+    // Slot stride and cursors are laid out on separate cache lines so the
+    // producer and each consumer only write lines of their own.
+    static const size_t cacheLine = 64;
+
+    // Position of one consumer.
+    struct Cursor
+    {
+        // Sequence number of the next message to read.
+        std::atomic<uint64_t> readSeq;
+
+        // Process of the consumer, to spot consumers that died.
+        std::atomic<int32_t> pid;
+
+        // 0 free, 1 joining, 2 subscribed.
+        std::atomic<uint32_t> state;
+
+        char padding[cacheLine - sizeof(uint64_t) - 2 * sizeof(uint32_t)];
+    };
+
+    // Start of the shared memory.
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t slotSize;
+        uint64_t mappedSize;
+        char padding0[cacheLine - 4 * sizeof(uint32_t) - sizeof(uint64_t)];
+
+        // Sequence number of the next message to publish.
+        std::atomic<uint64_t> writeSeq;
+
+        // Bumped on every publish, consumers sleep on it.
+        std::atomic<uint32_t> dataFutex;
+        std::atomic<uint32_t> dataWaiters;
+        char padding1[cacheLine - sizeof(uint64_t) - 2 * sizeof(uint32_t)];
+
+        // Bumped when a consumer frees a slot the producer waits for.
+        std::atomic<uint32_t> spaceFutex;
+        std::atomic<uint32_t> spaceWaiters;
+        char padding2[cacheLine - 2 * sizeof(uint32_t)];
+
+        Cursor consumers[maxConsumers];
+    };
+
+    // Header of every slot, followed by the message on a 16 byte boundary.
+    struct Slot
+    {
+        uint32_t length;
+        uint32_t reserved[3];
+    };
+
+    /** Maps the ring of a descriptor.
+     */
+    bool map(int fd, size_t size);
+
+    /** Gets the slot of a sequence number.
+     */
+    Slot* getSlot(uint64_t seq) const;
+
+    /** Gets the sequence number of the oldest message a consumer still
+     *  needs, dropping consumers whose process is gone when asked.
+     */
+    uint64_t getOldestRead(bool dropDead);
+
+    /** Sleeps on a futex while it holds value, for up to the time left
+     *  before deadline_ns (0 for no deadline).
+     *
+     *  @return False once the deadline passed.
+     */
+    bool wait(std::atomic<uint32_t>& futex, uint32_t value, uint64_t deadline_ns);
+
+    /** Wakes everyone sleeping on a futex.
+     */
+    static void wake(std::atomic<uint32_t>& futex);
+
+    /** Gets the monotonic time.
+     */
+    static uint64_t getTime_ns();
+
+    /** Converts a timeout to a deadline for wait(), 0 for none.
+     */
+    static uint64_t getDeadline(double timeout);
+
+    // Descriptor of the memfd.
+    int fd;
+
+    // Mapping of the ring.
+    Header* header;
+    size_t mappedSize;
+
+    // First slot and distance between slots.
+    char* slots;
+    size_t slotStride;
+
+    // Whether this endpoint created the ring.
+    bool producer;
+
+    // Cursor of this endpoint if subscribed, -1 otherwise.
+    int consumer;
+
+    // Whether a slot was claimed and not published yet.
+    bool claimed;
+
+    // Whether a message was peeked and not released yet.
+    bool peeked;
+
+    // Set by interrupt() to fail the waits of this endpoint.
+    std::atomic<bool> interrupted;
+
+};  // SHM_RING
+
+
+#endif  // SHM_RING_H
@@ -0,0 +1,178 @@
+/**
+ * @file SocketStats.h
+ * @brief Traffic, error and drop counters for a socket.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/19/2026 [msardonini] Padded the counter groups instead of over-aligning them
+ * 10/19/2026 [msardonini] Kernel drops accumulate across reset() and new sockets
+ */
+
+#ifndef SOCKET_STATS_H
+#define SOCKET_STATS_H
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+
+// Size of a cache line, counters written by different threads never share one.
+#define SOCKET_STATS_CACHE_LINE 64
+
+// errno values above this are counted together in the last slot.
+#define SOCKET_STATS_MAX_ERRNO 133
+
+
+/** SocketStats counts what happens on a socket.
+ *
+ *  Receive side counters are written only by the thread that reads the
+ *  socket, so updating them is a plain relaxed load and store with no locked
+ *  instruction. Send side counters may be written by several threads and use
+ *  atomic adds. The two groups live on separate cache lines so a sender never
+ *  invalidates the receive thread's line.
+ *
+ *  Kernel drops are the datagrams the kernel discarded because the receive
+ *  buffer was full, as reported by SO_RXQ_OVFL. If they grow while handler
+ *  time is low the receive buffer is too small; if handler time is high the
+ *  handler is the bottleneck; if neither grows the loss is on the network.
+ *
+ *  getSnapshot() may be called from any thread at any time.
+ */
+class SocketStats
+{
+
+public:
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        uint64_t rxPackets;
+        uint64_t rxBytes;
+        uint64_t rxErrors;
+        uint64_t kernelDrops;
+        uint64_t handlerCalls;
+        uint64_t handlerTime_ns;
+        uint64_t handlerMaxTime_ns;
+        uint64_t txPackets;
+        uint64_t txBytes;
+        uint64_t txErrors;
+
+        // Count of failed calls keyed by errno.
+        std::map<int, uint64_t> errors;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Constructor, all counters start at zero.
+     */
+    SocketStats();
+
+
+    /** Counts a received datagram. Receive thread only.
+     */
+    void onReceive(size_t bytes);
+
+
+    /** Counts a failed receive. Receive thread only.
+     */
+    void onReceiveError(int error);
+
+
+    /** Adds the drops since the kernel's running count of dropped datagrams
+     *  was last seen. Receive thread only.
+     */
+    void onKernelDrops(uint32_t dropped);
+
+
+    /** Starts over the kernel's running count for a new socket, keeping the
+     *  drops counted so far. Call while nothing receives.
+     */
+    void onSocketOpened();
+
+
+    /** Counts one handler call and the time it took. Receive thread only.
+     */
+    void onHandler(uint64_t elapsed_ns);
+
+
+    /** Counts a sent datagram. Any thread.
+     */
+    void onSend(size_t bytes);
+
+
+    /** Counts a failed send. Any thread.
+     */
+    void onSendError(int error);
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+    /** Sets all counters back to zero.
+     *
+     *  Updates racing with the reset may be lost.
+     */
+    void reset();
+
+
+private:
+
+    /** Adds to a counter that only one thread writes.
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /** Counts an errno in the shared table.
+     */
+    void countError(int error);
+
+    // Written only by the receive thread.
+    struct RxCounters
+    {
+        std::atomic<uint64_t> packets;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> errors;
+        std::atomic<uint64_t> kernelDrops;
+        std::atomic<uint64_t> handlerCalls;
+        std::atomic<uint64_t> handlerTime_ns;
+        std::atomic<uint64_t> handlerMaxTime_ns;
+
+        // Kernel's running count of drops when last seen, not a counter.
+        uint32_t kernelDropsSeen;
+    };
+
+    // Written by any sending thread.
+    struct TxCounters
+    {
+        std::atomic<uint64_t> packets;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> errors;
+    };
+
+    // Each group is kept off the cache lines of its neighbours by a whole
+    // line of padding. alignas() would not do: before C++17, new ignores
+    // alignment beyond that of max_align_t.
+    char rxPadding[SOCKET_STATS_CACHE_LINE];
+    RxCounters rx;
+    char txPadding[SOCKET_STATS_CACHE_LINE];
+    TxCounters tx;
+    char errnoPadding[SOCKET_STATS_CACHE_LINE];
+
+    // Failures by errno, rarely written.
+    std::atomic<uint64_t> errnoCounts[SOCKET_STATS_MAX_ERRNO + 1];
+
+};  // SOCKET_STATS
+
+
+#endif  // SOCKET_STATS_H
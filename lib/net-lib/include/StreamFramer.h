@@ -0,0 +1,213 @@
+/**
+ * @file StreamFramer.h
+ * @brief Finds frames in a byte stream, e.g. a serial port.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/18/2026 [msardonini] Added variable length frames
+ */
+
+#ifndef STREAM_FRAMER_H
+#define STREAM_FRAMER_H
+
+// STL
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// System
+#include <sys/types.h>
+
+
+/** StreamFramer cuts frames that start with a magic header out of a stream
+ *  with no message boundaries. A read may end in the middle of a frame, hold
+ *  several frames, or start with bytes of no frame at all. Frames are either
+ *  all the same size, or a sizer reads the size of each from its first bytes.
+ *
+ *  Bytes are read straight into a ring buffer with readFrom(), or written
+ *  into the space from getWriteBuffer() and committed. next() then scans for
+ *  the header and returns each complete frame that passes the validator as a
+ *  pointer into the ring, so a frame is never copied out to be parsed. The
+ *  ring is followed by a copy of its first maxFrameSize - 1 bytes, so a
+ *  frame wrapping around its end is still contiguous; those are the only
+ *  bytes copied. A header whose frame has no valid size or fails the
+ *  validator is skipped one byte at a time, so a real frame starting inside
+ *  a garbled one is still found. So is a header the sizer says starts no
+ *  frame, e.g. when several kinds of frame share its first byte.
+ *
+ *  Not thread safe, except for getSnapshot() which may be called from any
+ *  thread at any time.
+ */
+class StreamFramer
+{
+
+public:
+
+    /** Checks a complete candidate frame, e.g. its footer and checksum.
+     *
+     *  @param[in] frame    First byte of the frame.
+     *  @param[in] length   Bytes of the frame.
+     *  @return             True if the frame is valid.
+     */
+    typedef bool (*Validator)(const uint8_t* frame, size_t length);
+
+
+    /** Reads the size of a frame from its first bytes.
+     *
+     *  @param[in] frame    First byte of the frame, at least sizeBytes buffered.
+     *  @return             Bytes of the frame, 0 if no frame starts there.
+     */
+    typedef size_t (*Sizer)(const uint8_t* frame);
+
+
+    // Plain copy of all counters at one point in time.
+    struct Snapshot
+    {
+        // Frames returned by next().
+        uint64_t frames;
+
+        // Bytes skipped because they were not part of a valid frame.
+        uint64_t discardedBytes;
+
+        // Runs of skipped bytes, each a loss of sync with the stream.
+        uint64_t resyncs;
+
+        // Frames with a matching header that had no valid size or failed
+        // the validator.
+        uint64_t invalidFrames;
+
+        /** Formats the snapshot as a single line of key=value pairs.
+         */
+        std::string toString() const;
+    };
+
+
+    /** Constructor.
+     *
+     *  @param[in] frameSize    Bytes of every frame, header included.
+     *  @param[in] header       Magic bytes every frame starts with.
+     *  @param[in] headerSize   Bytes of the header, at least 1.
+     *  @param[in] validator    Check of a complete frame, or nullptr for none.
+     *  @param[in] capacity     Bytes the ring holds, rounded up to a power of
+     *                          two and to at least twice the frame size.
+     */
+    StreamFramer(size_t frameSize, const uint8_t* header, size_t headerSize,
+        Validator validator, size_t capacity = 4096);
+
+
+    /** Constructor for frames of different sizes.
+     *
+     *  @param[in] maxFrameSize Bytes of the largest frame, a larger size read
+     *                          by the sizer means no frame starts there.
+     *  @param[in] sizeBytes    Bytes the sizer needs, at least headerSize.
+     *  @param[in] header       Magic bytes every frame starts with.
+     *  @param[in] headerSize   Bytes of the header, at least 1.
+     *  @param[in] sizer        Reads the size of a frame.
+     *  @param[in] validator    Check of a complete frame, or nullptr for none.
+     *  @param[in] capacity     Bytes the ring holds, rounded up to a power of
+     *                          two and to at least twice the largest frame.
+     */
+    StreamFramer(size_t maxFrameSize, size_t sizeBytes, const uint8_t* header, size_t headerSize,
+        Sizer sizer, Validator validator, size_t capacity = 4096);
+
+
+    /** Gets the contiguous free space at the end of the stream.
+     *
+     *  @param[out] space   Bytes that may be written.
+     *  @return             Where to write them.
+     */
+    uint8_t* getWriteBuffer(size_t* space);
+
+
+    /** Appends bytes written into the buffer from getWriteBuffer().
+     *
+     *  @param[in] length   Bytes written, at most the space given.
+     */
+    void commitWrite(size_t length);
+
+
+    /** Reads what is available from a descriptor into the ring with a single
+     *  read().
+     *
+     *  @param[in] fd   Descriptor to read, usually non-blocking.
+     *  @return         Result of read(), 0 without calling it if the ring is full.
+     */
+    ssize_t readFrom(int fd);
+
+
+    /** Finds the next valid frame, skipping anything before it. The frame is
+     *  consumed; the pointer stays valid until the next write into the ring.
+     *
+     *  @return     First byte of the frame, or nullptr if no complete frame is
+     *              buffered yet.
+     */
+    const uint8_t* next();
+
+
+    /** Same as next(), also giving the size of the frame.
+     *
+     *  @param[out] length  Bytes of the frame returned.
+     */
+    const uint8_t* next(size_t* length);
+
+
+    /** Gets the number of bytes buffered and not yet consumed.
+     */
+    size_t getBuffered() const { return this->tail - this->head; }
+
+
+    /** Gets a copy of all counters.
+     */
+    Snapshot getSnapshot() const;
+
+
+    /** Drops all buffered bytes, e.g. after the link was lost. The counters
+     *  are kept.
+     */
+    void clear();
+
+
+private:
+
+    /** Adds to a counter that only the framing thread writes.
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /** Skips bytes that cannot start a frame.
+     */
+    void discard(size_t length);
+
+    // Largest frame, the size of every frame without a sizer.
+    const size_t frameSize;
+    const size_t sizeBytes;
+    const std::vector<uint8_t> header;
+    const Sizer sizer;
+    const Validator validator;
+
+    // Ring followed by the mirror of its first frameSize - 1 bytes.
+    std::vector<uint8_t> ring;
+    size_t mask;
+
+    // Stream offsets of the oldest unconsumed byte and of the end.
+    size_t head;
+    size_t tail;
+
+    // Whether the bytes just skipped already counted as a resync.
+    bool discarding;
+
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> discardedBytes;
+    std::atomic<uint64_t> resyncs;
+    std::atomic<uint64_t> invalidFrames;
+
+};  // STREAM_FRAMER
+
+
+#endif  // STREAM_FRAMER_H
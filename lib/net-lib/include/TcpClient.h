@@ -72,6 +72,13 @@ public:
      */
     bool isAlive() const;
 
+
+    /** Gets the file descriptor of the connection.
+     *
+     *  @return Socket file descriptor, -1 if not connected.
+     */
+    int getSocket() const;
+
 private:
 
     /** Constructs the server struct.
@@ -6,12 +6,15 @@
  *
  * Updates:
  * 01/30/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Split into TcpServerBase and BasicTcpServer<Handler>
+ * 10/18/2026 [msardonini] Added traffic capture
  */
 
 #ifndef TCP_SERVER_H
 #define TCP_SERVER_H
 
 // STL
+#include <atomic>
 #include <cstring>
 #include <string>
 #include <iostream>
@@ -33,68 +36,19 @@
     #include <gtest/gtest_prod.h>
 #endif
 
+#include "CaptureLog.h"
 #include "Networking.h"
+#include "ThreadConfig.h"
 
 
-/** Trampoline function for starting the running thread.
+/** Socket handling shared by every BasicTcpServer, independent of the type of
+ *  the task. Only the accept loop that calls the task is a template.
  */
-static void* tcpServerRunTrampoline(void* args);
-
-
-/** TcpServer encapsulates TCP connections.
- *
- *  The TcpServer class is created by passing in a function pointer to a task,
- *  which processes a client, the address of the address to bind to, the port to
- *  begin listening to connections on, and various timeout configuration
- *  parameters.
- *
- *  The task must be a function which accepts as a parameter the socket file
- *  descriptor, and returns a boolean indicating whether or not the function
- *  completed succesfully.
- */
-class TcpServer
+class TcpServerBase
 {
 
 public:
 
-    // Arguments to the thread.
-    struct ThreadArgs
-    {
-        TcpServer* thisPtr;
-        std::function<bool(int)> task;
-        double timeoutClientAccept;
-        double timeoutClientBoot;
-    };
-
-    /** Default constructor.
-     *
-     *  User needs to manually connect and begin running. Good for handling
-     *  errors.
-     */
-    TcpServer();
-
-
-    /** Constructor.
-     *
-     *  Establishes the connection and begins running immediately (in a thread).
-     *
-     *  @param[in] task     Function pointer to a task.
-     *  @param[in] address  Address to bind to. Use this parameter if you want
-     *                      to bind to a particular interface, otherwise leave
-     *                      it blank if you want to accept connections from any
-     *                      interface.
-     *  @param[in] port     Port to accept connections from.
-     *  @param[in] timeoutClientAccept  Timeout to use when accepting
-     *                                  connections to clients.
-     *  @param[in] timeoutClientBoot    Timeout to use when booting unresponsive
-     *                                  clients.
-     *  @param[in] mutlicast    Sets an option to reuse addressing.
-     */
-    TcpServer(std::function<bool(int)> task, const std::string& address,
-        int port, double timeoutClientAccept = 0, double timeoutClientBoot = 0,
-        bool multicast = false);
-
-
     /** Connects to the socket.
      *
      *  @param[in] address      Address of the server.
@@ -110,38 +64,42 @@ public:
     bool disconnect();
 
 
-    /** Runs the server.
+    /** Sets the role the server thread configures itself with when run()
+     *  starts, see Threading::configureThread(). Defaults to "server".
      *
-     *  The server begins waiting for a client to connect. Once a client
-     *  connects, the server spawns a thread to handle the client by running
-     *  the function pointer task.
-     *
-     *  The server will run until the time2Exit flag is true. In order to be
-     *  able to set the flag, you will need to run this function in a thread.
-     *  Alternatively, use runInThread().
-     *
-     *  @param task                     Task to execute once a client connects.
-     *  @param[in] timeoutClientAccept  Timeout to use when accepting
-     *                                  connections to clients.
-     *  @param[in] timeoutClientBoot    Timeout to use when booting unresponsive
-     *                                  clients.
+     *  @param[in] role     Thread role.
      */
-    void run(std::function<bool(int)> task, double timeoutClientAccept, double timeoutClientBoot);
+    void setThreadRole(const std::string& role);
 
 
-    /** Runs the server in a thread.
+    /** Reads what the current client sent, capturing it when capturing. Call
+     *  from the task instead of reading the client socket directly.
      *
-     *  The server creates a thread which calls the run function above.
+     *  @param[out] buff    Buffer for the data.
+     *  @param[in]  size    Size of the buffer.
+     *  @return             Bytes read, 0 once the client closed, -1 on error.
+     */
+    ssize_t receive(char* buff, size_t size);
+
+
+    /** Starts appending every client connection and everything read through
+     *  receive(), with kernel receive times, to a capture file for
+     *  captureReplay.
      *
-     *  @param[in] task                 Task to execute once a client connects.
-     *  @param[in] timeoutClientAccept  Timeout to use when accepting
-     *                                  connections to clients.
-     *  @param[in] timeoutClientBoot    Timeout to use when booting unresponsive
-     *                                  clients.
-     *  @return                         True if the thread was succesfully
-     *                                  created.
+     *  @param[in] path     Capture file, replaced if it exists.
+     *  @return             True if the capture file was created.
+     */
+    bool startCapture(const std::string& path);
+
+
+    /** Stops capturing and closes the capture file.
+     */
+    void stopCapture();
+
+
+    /** Gets the number of records captured since startCapture().
      */
-    bool runInThread(std::function<bool(int)> task, double timeoutClientAccept, double timeoutClientBoot);
+    uint64_t getCaptured() const;
 
 
     /** Determines if the connection to the server is currently alive.
@@ -172,7 +130,34 @@ public:
     int getClient() const;
 
 
-private:
+protected:
+
+    /** Default constructor, only servers with a task are created.
+     */
+    TcpServerBase();
+
+
+    /** Destructor, stops running and disconnects the server.
+     */
+    ~TcpServerBase();
+
+
+    /** Prepares the calling thread for the accept loop.
+     */
+    void beginRun(double timeoutClientAccept, double timeoutClientBoot);
+
+
+    /** Waits up to timeoutClientAccept for a client and accepts it into
+     *  sockClient.
+     *
+     *  @return True if a client was accepted.
+     */
+    bool acceptClient();
+
+
+    /** Flushes and closes the socket of the current client.
+     */
+    void closeClient();
 
     // Timeout to use when accepting connections to clients.
     double timeoutClientAccept;
@@ -186,9 +171,6 @@ private:
     // Socket file descriptor of the client.
     int sockClient;
 
-    // Function to execute when a client connects.
-    std::function<bool(int)> task;
-
     // Struct containing the address information of the server.
     struct sockaddr_in server;
 
@@ -211,24 +193,197 @@ private:
     bool clientAlive;
 
     // Whether the run loop started.
-    bool running;
+    std::atomic<bool> running;
 
     // Whether it is time to exit the run loop.
-    bool time2Exit;
+    std::atomic<bool> time2Exit;
+
+    // Event signalled by disconnect() to wake the run loop.
+    int wakeFd;
 
     // Thread ID.
 	pthread_t tid;
 
-    // Thread arguments
-    ThreadArgs threadArgs;
+    // Role whose thread settings run() applies.
+    std::string threadRole;
+
+    // Capture of client traffic, closed unless capturing.
+    CaptureLog capture;
 
     #ifdef WITH_TESTING
         friend class TestTcp;
         FRIEND_TEST(GlobalTest, TestTcpServerDefaultConstructor);
         FRIEND_TEST(TestTcp, TestTcpServerConstructor);
+        FRIEND_TEST(TestTcp, TestTcpServerDisconnectWakesAccept);
     #endif
 
-};  // TCP_SERVER
+};  // TCP_SERVER_BASE
+
+
+/** BasicTcpServer encapsulates TCP connections.
+ *
+ *  The BasicTcpServer class is created by passing in a task, which processes
+ *  a client, the address of the address to bind to, the port to begin
+ *  listening to connections on, and various timeout configuration parameters.
+ *
+ *  The task must be a function which accepts as a parameter the socket file
+ *  descriptor, and returns a boolean indicating whether or not the function
+ *  completed succesfully.
+ *
+ *  Handler is the type of the task, anything callable as bool(int). Passing a
+ *  lambda or function object type lets the compiler inline the task into the
+ *  accept loop. TcpServer takes any std::function.
+ */
+template <typename Handler>
+class BasicTcpServer : public TcpServerBase
+{
+
+public:
+
+    // Arguments to the thread.
+    struct ThreadArgs
+    {
+        BasicTcpServer* thisPtr;
+        Handler task;
+        double timeoutClientAccept;
+        double timeoutClientBoot;
+    };
+
+    /** Default constructor.
+     *
+     *  User needs to manually connect and begin running. Good for handling
+     *  errors.
+     */
+    BasicTcpServer() {}
+
+
+    /** Constructor.
+     *
+     *  Establishes the connection and begins running immediately (in a thread).
+     *
+     *  @param[in] task     Task called with every accepted client.
+     *  @param[in] address  Address to bind to. Use this parameter if you want
+     *                      to bind to a particular interface, otherwise leave
+     *                      it blank if you want to accept connections from any
+     *                      interface.
+     *  @param[in] port     Port to accept connections from.
+     *  @param[in] timeoutClientAccept  Timeout to use when accepting
+     *                                  connections to clients.
+     *  @param[in] timeoutClientBoot    Timeout to use when booting unresponsive
+     *                                  clients.
+     *  @param[in] mutlicast    Sets an option to reuse addressing.
+     */
+    BasicTcpServer(Handler task, const std::string& address,
+        int port, double timeoutClientAccept = 0, double timeoutClientBoot = 0,
+        bool multicast = false);
+
+
+    /** Runs the server.
+     *
+     *  The server begins waiting for a client to connect. Once a client
+     *  connects, the server spawns a thread to handle the client by running
+     *  the function pointer task.
+     *
+     *  The server will run until the time2Exit flag is true. In order to be
+     *  able to set the flag, you will need to run this function in a thread.
+     *  Alternatively, use runInThread(). disconnect() sets the flag and wakes
+     *  the loop, so it exits within microseconds whatever the timeout.
+     *
+     *  @param task                     Task to execute once a client connects.
+     *  @param[in] timeoutClientAccept  Timeout to use when accepting
+     *                                  connections to clients, 0 to wait
+     *                                  until a client connects.
+     *  @param[in] timeoutClientBoot    Timeout to use when booting unresponsive
+     *                                  clients.
+     */
+    void run(Handler task, double timeoutClientAccept, double timeoutClientBoot);
+
+
+    /** Runs the server in a thread.
+     *
+     *  The server creates a thread which calls the run function above.
+     *
+     *  @param[in] task                 Task to execute once a client connects.
+     *  @param[in] timeoutClientAccept  Timeout to use when accepting
+     *                                  connections to clients.
+     *  @param[in] timeoutClientBoot    Timeout to use when booting unresponsive
+     *                                  clients.
+     *  @return                         True if the thread was succesfully
+     *                                  created.
+     */
+    bool runInThread(Handler task, double timeoutClientAccept, double timeoutClientBoot);
+
+
+private:
+
+    /** Trampoline function for starting the running thread.
+     */
+    static void* runTrampoline(void* args);
+
+};  // BASIC_TCP_SERVER
+
+
+// Server taking its task as a std::function.
+typedef BasicTcpServer<std::function<bool(int)> > TcpServer;
+
+
+template <typename Handler>
+BasicTcpServer<Handler>::BasicTcpServer(Handler task_, const std::string& address_,
+    int port_, double timeoutClientAccept_, double timeoutClientBoot_,
+    bool multicast_)
+{
+    if (this->connect(address_, port_, multicast_))
+        this->runInThread(task_, timeoutClientAccept_, timeoutClientBoot_);
+    else
+        std::cerr << "Could not establish a connection on '" << address_ << "' port '" << port_ << "'" << std::endl;
+}
+
+
+template <typename Handler>
+void* BasicTcpServer<Handler>::runTrampoline(void* args)
+{
+    ThreadArgs* threadArgs = (ThreadArgs*)args;
+    threadArgs->thisPtr->run(threadArgs->task, threadArgs->timeoutClientAccept, threadArgs->timeoutClientBoot);
+    delete threadArgs;
+    return NULL;
+}
+
+
+template <typename Handler>
+void BasicTcpServer<Handler>::run(Handler task_, double timeoutClientAccept_, double timeoutClientBoot_)
+{
+    this->beginRun(timeoutClientAccept_, timeoutClientBoot_);
+
+    while (!this->time2Exit)
+    {
+        if (!this->acceptClient())
+            continue;
+
+        // Process this client
+        if (!task_(this->sockClient))
+            std::cerr << "Error in client task" << std::endl;
+
+        this->closeClient();
+    }
+    this->running = false;
+}
+
+
+template <typename Handler>
+bool BasicTcpServer<Handler>::runInThread(Handler task_, double timeoutClientAccept_, double timeoutClientBoot_)
+{
+    // The thread owns its copy of the task and frees it on exit
+    this->running = true;
+    ThreadArgs* threadArgs = new ThreadArgs{this, task_, timeoutClientAccept_, timeoutClientBoot_};
+    int result = pthread_create(&this->tid, NULL, &BasicTcpServer::runTrampoline, threadArgs);
+    if (result)
+    {
+        this->running = false;
+        delete threadArgs;
+        return false;
+    }
+    return true;
+}
 
 
 #endif  // TCP_SERVER_H
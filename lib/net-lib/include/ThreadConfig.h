@@ -0,0 +1,150 @@
+/**
+ * @file ThreadConfig.h
+ * @brief Scheduling, CPU affinity, memory locking and naming of threads.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef THREAD_CONFIG_H
+#define THREAD_CONFIG_H
+
+// STL
+#include <cstddef>
+#include <string>
+
+// Thread
+#include <pthread.h>
+#include <sched.h>
+
+
+/** Settings applied to a thread when it starts.
+ */
+struct ThreadConfig
+{
+    // Name shown by ps/top, truncated to 15 characters.
+    std::string name;
+
+    // SCHED_FIFO priority between 1 and 99, 0 keeps the default scheduler.
+    int priority;
+
+    // CPU to pin the thread to, -1 to leave it unpinned.
+    int cpu;
+
+    // Bytes of stack to touch when the thread starts so later page faults do
+    // not land on the control path, 0 to skip.
+    size_t prefaultStack;
+
+    ThreadConfig()
+        : priority(0),
+          cpu(-1),
+          prefaultStack(0) {}
+
+    ThreadConfig(const std::string& name_, int priority_, int cpu_ = -1, size_t prefaultStack_ = 64 * 1024)
+        : name(name_),
+          priority(priority_),
+          cpu(cpu_),
+          prefaultStack(prefaultStack_) {}
+};
+
+
+/** Thread configuration is kept in a process wide table keyed by the role of
+ *  the thread ("read", "write", "button", "led", "server", ...). The program
+ *  fills the table once at start up, then every thread calls
+ *  configureThread() with its role as its first action. Roles without an
+ *  entry only get their name set, so threads can call configureThread()
+ *  unconditionally.
+ *
+ *  SCHED_FIFO and mlockall need CAP_SYS_NICE and CAP_IPC_LOCK (or root).
+ *  Failures are reported and the thread keeps running with what could be
+ *  applied.
+ */
+namespace Threading {
+
+
+/** Stores the configuration for a thread role.
+ *
+ *  @param[in] role     Role the threads look themselves up by.
+ *  @param[in] config   Settings for the role. An empty name takes the role.
+ */
+void setConfig(const std::string& role, const ThreadConfig& config);
+
+
+/** Gets the configuration stored for a thread role.
+ *
+ *  @param[in]  role    Role to look up.
+ *  @param[out] config  Settings of the role if found.
+ *  @return             True if the role has a configuration.
+ */
+bool getConfig(const std::string& role, ThreadConfig& config);
+
+
+/** Removes every stored configuration.
+ */
+void clearConfig();
+
+
+/** Parses role settings of the form "role:priority[:cpu]" separated by commas
+ *  and stores them, e.g. "button:90:3,read:80:3,led:0". An entry without a
+ *  cpu keeps the pin of the role's existing setting.
+ *
+ *  @param[in] spec     Settings to parse.
+ *  @return             True if every entry parsed.
+ */
+bool parseConfig(const std::string& spec);
+
+
+/** Applies the configuration stored for a role to the calling thread.
+ *
+ *  @param[in] role     Role of the calling thread.
+ *  @return             True if everything configured was applied.
+ */
+bool configureThread(const std::string& role);
+
+
+/** Applies a configuration to the calling thread.
+ *
+ *  @param[in] config   Settings to apply.
+ *  @return             True if everything configured was applied.
+ */
+bool applyConfig(const ThreadConfig& config);
+
+
+/** Pins the calling thread to a single CPU.
+ *
+ *  @param[in] cpu      CPU index.
+ *  @return             True if the affinity was set.
+ */
+bool setAffinity(int cpu);
+
+
+/** Locks all current and future pages of the process in memory.
+ *
+ *  Every thread stack created afterwards is locked in full, so lower the
+ *  default stack size with setDefaultStackSize() first.
+ *
+ *  @return             True if the memory was locked.
+ */
+bool lockMemory();
+
+
+/** Sets the stack size of threads created from now on, including
+ *  std::thread.
+ *
+ *  @param[in] size     Stack size in bytes.
+ *  @return             True if the default was changed.
+ */
+bool setDefaultStackSize(size_t size);
+
+
+/** Gets the number of CPUs available to the process.
+ */
+int getCpuCount();
+
+
+}  // THREADING
+
+
+#endif  // THREAD_CONFIG_H
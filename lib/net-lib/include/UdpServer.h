@@ -6,12 +6,22 @@
  *
  * Updates:
  * 02/17/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Split into UdpServerBase and BasicUdpServer<Handler>
+ * 10/18/2026 [msardonini] Added the peer table
+ * 10/18/2026 [msardonini] Added traffic capture
+ * 10/19/2026 [msardonini] Spin only after traffic, clearLowLatency() undoes the options
+ * 10/19/2026 [msardonini] lastPeer is atomic, getLastPeer() may be called from any thread
+ * 10/19/2026 [msardonini] The receive thread only uses the peer table under its lock
+ * 10/19/2026 [msardonini] The receive thread reads the low-latency settings through atomics
  */
 
 #ifndef UDP_SERVER_H
 #define UDP_SERVER_H
 
 // STL
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include <cstring>
 #include <string>
 #include <iostream>
@@ -26,80 +36,78 @@
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+
+// Time
+#include <time.h>
 
 // Thread
 #include <pthread.h>
+#include <sched.h>
 
 #ifdef WITH_TESTING
     #include <gtest/gtest_prod.h>
 #endif
 
+#include "CaptureLog.h"
 #include "Networking.h"
+#include "PeerTable.h"
+#include "SocketStats.h"
+#include "ThreadConfig.h"
 
 
-/** Trampoline function for starting the running thread.
- */
-static void* udpServerRunTrampoline(void* args);
+// Older headers predate preferred busy polling (Linux 5.11).
+#ifndef SO_PREFER_BUSY_POLL
+    #define SO_PREFER_BUSY_POLL 69
+#endif
 
 
-/** UdpServer encapsulates a UDP server which is responsible for receiving data
- *  streams from clients.
- *
- *  The UdpServer class is created by passing in a function pointer to a task,
- *  which processes a received UDP message, as well as the port to begin
- *  listening to connections on.
- *
- *  The task must be a function which accepts as a parameter the file
- *  descriptor of the server, a buffer containing the received data, the size
- *  of the buffer, and returns a boolean indicating whether or not the function
- *  completed succesfully.
+/** Socket handling shared by every BasicUdpServer, independent of the type of
+ *  the task. Only the receive loop that calls the task is a template.
  */
-class UdpServer
+class UdpServerBase
 {
 
 public:
 
-    // Arguments to the thread.
-    struct ThreadArgs
-    {
-        UdpServer* thisPtr;
-        std::function<bool(int, char*, size_t)> task;
-        int readSize;
-        double timeoutRead;
-    };
-
-
-    /** Default constructor.
+    /** Options for the low-latency receive mode.
      *
-     *  User needs to manually connect and begin running. Good for handling
-     *  errors.
+     *  In the default mode the receive loop blocks in poll(2) between
+     *  datagrams and the scheduler wakes it when one arrives. In low-latency
+     *  mode the loop first spins on the empty socket for up to spinTime,
+     *  asking the driver to poll the device on every attempt (SO_BUSY_POLL),
+     *  and only blocks once the spin budget is used up. A datagram that
+     *  arrives while spinning skips the interrupt, softirq and wakeup path
+     *  entirely, at the cost of keeping one CPU busy for spinTime after every
+     *  datagram. The loop only spins right after a datagram; once it has
+     *  blocked without one, e.g. on an idle link, it blocks again straight
+     *  away until traffic resumes. Pin the thread to a core that has nothing
+     *  else to do.
+     *
+     *  Raising busyPoll above net.core.busy_read needs CAP_NET_ADMIN; without
+     *  it the socket option is skipped with a warning and the user space spin
+     *  still applies.
      */
-    UdpServer();
+    struct LowLatencyOptions
+    {
+        // Microseconds the driver may busy poll per receive call, 0 to skip.
+        int busyPoll_us;
 
+        // Prefer busy polling over interrupts for the device queue.
+        bool preferBusyPoll;
 
-    /** Constructor.
-     *
-     *  Establishes the connection and begins running immediately (in a thread).
-     *
-     *  @param[in] task         Function pointer to a task.
-     *  @param[in] address      Address to bind to. Use this parameter if you
-     *                          want to bind to a particular interface,
-     *                          otherwise leave it blank if you want to accept
-     *                          connections from any interface.
-     *  @param[in] port         Port to accept connections from.
-     *  @param[in] readSize     Max size of reads.
-     *  @param[in] recvBuffSize Size of the receive buffer.
-     *  @param[in] timeoutRead  Timeout to use when reading.
-     *  @param[in] mutlicast    Sets an option to reuse addressing.
-     */
-    UdpServer(std::function<bool(int, char*, size_t)> task,
-        const std::string& address, int port, int readSize, int recvBuffSize,
-        double timeoutRead, bool multicast = false);
+        // CPU to pin the receive thread to, -1 to leave it unpinned.
+        int cpu;
 
+        // Seconds to spin on an empty socket before blocking.
+        double spinTime;
 
-    /** Destructor.
-     */
-    ~UdpServer();
+        LowLatencyOptions()
+            : busyPoll_us(50),
+              preferBusyPoll(true),
+              cpu(-1),
+              spinTime(0.001) {}
+    };
 
 
     /** Connects to the socket.
@@ -119,34 +127,35 @@ public:
     bool disconnect();
 
 
-    /** Runs the server.
-     *
-     *  The server starts listening over the socket for incoming messages. Once
-     *  a UDP message is received, the server runs the function pointer task.
+    /** Enables the low-latency receive mode.
      *
-     *  The server will run until the time2Exit flag is true. In order to be
-     *  able to set the flag, you will need to run this function in a thread.
-     *  Alternatively, use runInThread().
+     *  Socket options are applied immediately if connected and again on every
+     *  connect. The thread is pinned the next time run() starts, a running
+     *  receive loop starts spinning when it next wakes up.
      *
-     *  @param[in] task         Task to execute once a client connects.
-     *  @param[in] readSize     Max size of reads.
-     *  @param[in] timeoutRead  Timeout to use when reading.
+     *  @param[in] options  Busy poll, pinning and spin settings.
+     *  @return             True if every socket option was applied.
      */
-    void run(std::function<bool(int, char*, size_t)> task, int readSize, double timeoutRead);
+    bool setLowLatency(const LowLatencyOptions& options);
 
 
-    /** Runs the server in a thread.
+    /** Returns the receive loop to the default blocking mode.
      *
-     *  The server creates a thread which calls the run function above.
+     *  Restores the busy poll socket options at once. The receive thread
+     *  restores the CPU affinity it had before it was pinned the next time
+     *  it wakes up.
+     */
+    void clearLowLatency();
+
+
+    /** Sets the role the receive thread configures itself with when run()
+     *  starts, see Threading::configureThread(). Defaults to "server".
      *
-     *  @param[in] task         Task to execute once a client connects.
-     *  @param[in] readSize     Max size of reads.
-     *  @param[in] timeoutRead  Timeout to use when reading.
-     *  @return                 True if the thread was succesfully created.
+     *  @param[in] role     Thread role.
      */
-    bool runInThread(std::function<bool(int, char*, size_t)> task, int readSize, double timeoutRead);
+    void setThreadRole(const std::string& role);
+
 
-    
     /** Sends data to the server.
      */
     ssize_t send(const char* buff, size_t length);
@@ -155,7 +164,74 @@ public:
     ssize_t receiveUdp(void* buf, int readSize_);
 
 
-    void setClientInfo(std::string address_, int port_);
+    /** Sets the peer that send() delivers to. Call after connect().
+     *
+     *  With connectPeer the socket is connected to the peer. Sends then skip
+     *  the per datagram route lookup, the kernel drops datagrams from any
+     *  other source, and an ICMP port or host unreachable coming back from the
+     *  peer fails the next send or receive, see isPeerUnreachable(). The
+     *  socket stays connected until the next connect().
+     *
+     *  @param[in] address      Address of the peer.
+     *  @param[in] port         Port of the peer.
+     *  @param[in] connectPeer  Connect the socket to the peer.
+     *  @return                 True if the peer was set.
+     */
+    bool setClientInfo(std::string address_, int port_, bool connectPeer = false);
+
+
+    /** Determines if the connected peer was reported unreachable since the
+     *  last datagram received from it.
+     *
+     *  @return True if nothing is listening at the peer's address.
+     */
+    bool isPeerUnreachable() const;
+
+
+    /** Starts keeping a table of every peer datagrams arrive from.
+     *
+     *  Needed when several peers share the server: each gets its own entry
+     *  with counters and last seen time, the task finds out who sent the
+     *  datagram it handles through getLastPeer(), and replies go out with
+     *  sendToPeer(). send() keeps replying to whoever spoke last. Peers
+     *  silent for idleTimeout are dropped.
+     *
+     *  @param[in] capacity     Most peers tracked at once, datagrams from
+     *                          further peers are still handled but not tracked.
+     *  @param[in] idleTimeout  Seconds without traffic before a peer is
+     *                          dropped, 0 to keep peers until removed.
+     *
+     *  May be called while running, the old table and its peers are dropped.
+     */
+    void setPeerTable(size_t capacity, double idleTimeout);
+
+
+    /** Gets the peer that sent the datagram being handled. Safe to call from
+     *  any thread, though only the task knows which datagram that is.
+     *
+     *  @return Id of the peer, 0 without a peer table or if the table is full.
+     */
+    PeerTable::PeerId getLastPeer() const;
+
+
+    /** Sends data to a peer from the peer table.
+     *
+     *  @return Number of bytes sent, -1 on error or if the peer is gone.
+     */
+    ssize_t sendToPeer(PeerTable::PeerId peer, const char* buff, size_t length);
+
+
+    /** Gets a copy of every entry of the peer table.
+     */
+    std::vector<PeerTable::Peer> getPeers();
+
+
+    /** Removes a peer from the peer table.
+     *
+     *  @return True if the peer was in the table.
+     */
+    bool removePeer(PeerTable::PeerId peer);
+
 
     /** Determines if the connection to the server is currently alive.
      *
@@ -183,7 +259,111 @@ public:
     std::string getClientAddress() const;
 
 
-private:
+    /** Starts appending every datagram received, with its kernel receive time
+     *  and sender, to a capture file for captureReplay.
+     *
+     *  @param[in] path     Capture file, replaced if it exists.
+     *  @return             True if the capture file was created.
+     */
+    bool startCapture(const std::string& path);
+
+
+    /** Stops capturing and closes the capture file.
+     */
+    void stopCapture();
+
+
+    /** Gets the number of datagrams captured since startCapture().
+     */
+    uint64_t getCaptured() const;
+
+
+    /** Gets a copy of the traffic, error and drop counters of the socket.
+     *
+     *  Counters accumulate across reconnects until resetStats() is called.
+     */
+    SocketStats::Snapshot getStats() const;
+
+
+    /** Sets all traffic, error and drop counters back to zero.
+     */
+    void resetStats();
+
+
+    /** Gets the size of the receive buffer actually granted by the kernel.
+     *
+     *  @return Receive buffer size in bytes, -1 if there is no socket.
+     */
+    int getReceiveBufferSize() const;
+
+
+protected:
+
+    /** Default constructor, only servers with a task are created.
+     */
+    UdpServerBase();
+
+
+    /** Destructor.
+     */
+    ~UdpServerBase();
+
+
+    /** Prepares the calling thread and the buffer for the receive loop.
+     */
+    void beginRun(int readSize, double timeoutRead);
+
+
+    /** Receives the next datagram into buff for the receive loop.
+     *
+     *  If the socket is empty, spins in low-latency mode and then blocks for
+     *  up to timeoutRead.
+     *
+     *  @return Number of bytes received, -1 if there was nothing to read.
+     */
+    ssize_t nextDatagram();
+
+
+    /** Gets the monotonic time used to time the task.
+     */
+    static uint64_t getTime_ns()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec * 1000000000ull + now.tv_nsec;
+    }
+
+
+    /** Receives one datagram and updates the counters.
+     *
+     *  Stores the sender in client and picks up the kernel drop count.
+     *
+     *  @return Number of bytes received, -1 on error with errno set.
+     */
+    ssize_t receiveMessage(void* buf, size_t size);
+
+
+    /** Notes a failed send or receive that reports the connected peer as
+     *  unreachable.
+     */
+    void onPeerError(int error);
+
+
+    /** Has the kernel timestamp received datagrams for the capture.
+     */
+    void enableTimestamps();
+
+
+    /** Applies the busy poll socket options of the low-latency mode.
+     */
+    bool applyLowLatencyOptions();
+
+
+    /** Spins on the empty socket for up to the low-latency spin time.
+     *
+     *  @return True if a datagram arrived while spinning.
+     */
+    bool spinForInput();
 
     // Buffer containing the last read message.
     char* buff;
@@ -209,32 +389,245 @@ private:
     // Address of the client we are connected to.
     std::string addressClient;
 
+    // Whether the socket is connected to the client.
+    bool peerConnected;
+
+    // Whether the connected client reported itself unreachable.
+    std::atomic<bool> peerUnreachable;
+
+    // Every peer heard from, NULL unless enabled with setPeerTable(). Only
+    // used under peersMutex, hasPeers spares the receive thread the lock
+    // while there is no table.
+    PeerTable* peers;
+    std::atomic<bool> hasPeers;
+
+    // Guards peers between the receive thread and senders.
+    std::mutex peersMutex;
+
+    // Peer of the last datagram received, read from any thread.
+    std::atomic<PeerTable::PeerId> lastPeer;
+
     // Port we are receiving connections from.
     int port;
 
-    // Function to execute when a client connects.
-    std::function<bool(int, char*, size_t)> task;
-
     // Whether the connection to the server is currently alive.
     bool serverAlive;
 
     // Whether the run loop started.
-    bool running;
+    std::atomic<bool> running;
 
     // Whether it is time to exit the run loop.
-    bool time2Exit;
+    std::atomic<bool> time2Exit;
+
+    // Event signalled by disconnect() to wake the run loop.
+    int wakeFd;
 
     // Thread ID.
 	pthread_t tid;
 
-    // Thread arguments
-    ThreadArgs threadArgs;
+    // Traffic, error and drop counters.
+    SocketStats stats;
+
+    // Capture of received datagrams, closed unless capturing.
+    CaptureLog capture;
+
+    // Settings of the low-latency receive mode, used by the caller's thread.
+    LowLatencyOptions lowLatencyOptions;
+
+    // What the receive thread reads of them while running: whether the mode
+    // is enabled, published after the CPU to pin to and the spin budget.
+    std::atomic<bool> lowLatency;
+    std::atomic<int> spinCpu;
+    std::atomic<uint64_t> spinTime_ns;
+
+    // Busy poll setting of the socket before the low-latency mode changed
+    // it, -1 if unchanged.
+    int socketBusyPoll;
+
+    // CPUs the receive thread ran on before it was pinned, whether it was
+    // pinned, and whether clearLowLatency() asked it to unpin.
+    cpu_set_t unpinnedCpus;
+    bool pinned;
+    std::atomic<bool> unpinDue;
+
+    // Whether the last receive returned a datagram. Receive thread only.
+    bool recentInput;
+
+    // Role whose thread settings run() applies.
+    std::string threadRole;
 
     #ifdef WITH_TESTING
         friend class TestUdp;
     #endif
 
-};  // UDP_SERVER
+};  // UDP_SERVER_BASE
+
+
+/** BasicUdpServer encapsulates a UDP server which is responsible for receiving data
+ *  streams from clients.
+ *
+ *  The BasicUdpServer class is created by passing in a function pointer to a task,
+ *  which processes a received UDP message, as well as the port to begin
+ *  listening to connections on.
+ *
+ *  The task must be a function which accepts as a parameter the file
+ *  descriptor of the server, a buffer containing the received data, the size
+ *  of the buffer, and returns a boolean indicating whether or not the function
+ *  completed succesfully.
+ *
+ *  Handler is the type of the task, anything callable as
+ *  bool(int, char*, size_t). Passing a lambda or function object type lets
+ *  the compiler inline the task into the receive loop. UdpServer takes any
+ *  std::function at the cost of an indirect call per datagram.
+ */
+template <typename Handler>
+class BasicUdpServer : public UdpServerBase
+{
+
+public:
+
+    // Arguments to the thread.
+    struct ThreadArgs
+    {
+        BasicUdpServer* thisPtr;
+        Handler task;
+        int readSize;
+        double timeoutRead;
+    };
+
+
+    /** Default constructor.
+     *
+     *  User needs to manually connect and begin running. Good for handling
+     *  errors.
+     */
+    BasicUdpServer() {}
+
+
+    /** Constructor.
+     *
+     *  Establishes the connection and begins running immediately (in a thread).
+     *
+     *  @param[in] task         Task called with every datagram.
+     *  @param[in] address      Address to bind to. Use this parameter if you
+     *                          want to bind to a particular interface,
+     *                          otherwise leave it blank if you want to accept
+     *                          connections from any interface.
+     *  @param[in] port         Port to accept connections from.
+     *  @param[in] readSize     Max size of reads.
+     *  @param[in] recvBuffSize Size of the receive buffer.
+     *  @param[in] timeoutRead  Timeout to use when reading.
+     *  @param[in] mutlicast    Sets an option to reuse addressing.
+     */
+    BasicUdpServer(Handler task,
+        const std::string& address, int port, int readSize, int recvBuffSize,
+        double timeoutRead, bool multicast = false);
+
+
+    /** Runs the server.
+     *
+     *  The server starts listening over the socket for incoming messages. Once
+     *  a UDP message is received, the server runs the function pointer task.
+     *  Between messages the server blocks for up to timeoutRead, or spins
+     *  first in low-latency mode. A timeoutRead of 0 blocks until the next
+     *  datagram.
+     *
+     *  The server will run until the time2Exit flag is true. In order to be
+     *  able to set the flag, you will need to run this function in a thread.
+     *  Alternatively, use runInThread(). disconnect() sets the flag and wakes
+     *  the loop, so it exits within microseconds whatever the timeout.
+     *
+     *  @param[in] task         Task to execute once a client connects.
+     *  @param[in] readSize     Max size of reads.
+     *  @param[in] timeoutRead  Timeout to use when reading.
+     */
+    void run(Handler task, int readSize, double timeoutRead);
+
+
+    /** Runs the server in a thread.
+     *
+     *  The server creates a thread which calls the run function above.
+     *
+     *  @param[in] task         Task to execute once a client connects.
+     *  @param[in] readSize     Max size of reads.
+     *  @param[in] timeoutRead  Timeout to use when reading.
+     *  @return                 True if the thread was succesfully created.
+     */
+    bool runInThread(Handler task, int readSize, double timeoutRead);
+
+    
+
+
+private:
+
+    /** Trampoline function for starting the running thread.
+     */
+    static void* runTrampoline(void* args);
+
+};  // BASIC_UDP_SERVER
+
+
+// Server taking its task as a std::function.
+typedef BasicUdpServer<std::function<bool(int, char*, size_t)> > UdpServer;
+
+
+template <typename Handler>
+BasicUdpServer<Handler>::BasicUdpServer(Handler task_,
+    const std::string& address_, int port_, int readSize_, int recvBuffSize_,
+    double timeoutRead_, bool multicast_)
+{
+    if (this->connect(address_, port_, recvBuffSize_, multicast_))
+        this->runInThread(task_, readSize_, timeoutRead_);
+    else
+        std::cerr << "Could not establish a connection on '" << address_ << "' port '" << port_ << "'" << std::endl;
+}
+
+
+template <typename Handler>
+void* BasicUdpServer<Handler>::runTrampoline(void* args)
+{
+    ThreadArgs* threadArgs = (ThreadArgs*)args;
+    threadArgs->thisPtr->run(threadArgs->task, threadArgs->readSize, threadArgs->timeoutRead);
+    delete threadArgs;
+    return NULL;
+}
+
+
+template <typename Handler>
+void BasicUdpServer<Handler>::run(Handler task_, int readSize_, double timeoutRead_)
+{
+    this->beginRun(readSize_, timeoutRead_);
+
+    while (!this->time2Exit)
+    {
+        ssize_t recvlen = this->nextDatagram();
+        if (recvlen == -1)
+            continue;
+
+        uint64_t start_ns = getTime_ns();
+        if (!task_(this->sockServer, this->buff, recvlen))
+            std::cerr << "Error in client task" << std::endl;
+        this->stats.onHandler(getTime_ns() - start_ns);
+    }
+    this->running = false;
+}
+
+
+template <typename Handler>
+bool BasicUdpServer<Handler>::runInThread(Handler task_, int readSize_, double timeoutRead_)
+{
+    // The thread owns its copy of the task and frees it on exit
+    this->running = true;
+    ThreadArgs* threadArgs = new ThreadArgs{this, task_, readSize_, timeoutRead_};
+    int result = pthread_create(&this->tid, NULL, &BasicUdpServer::runTrampoline, threadArgs);
+    if (result)
+    {
+        this->running = false;
+        delete threadArgs;
+        return false;
+    }
+    return true;
+}
 
 
 #endif  // UDP_SERVER_H
@@ -0,0 +1,135 @@
+/**
+ * @file UnixClient.h
+ * @brief Client of a Unix domain datagram or stream server on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef UNIX_CLIENT_H
+#define UNIX_CLIENT_H
+
+// STL
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Network
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+
+#include "Networking.h"
+
+
+/** UnixClient connects to a UnixDatagramServer (SOCK_DGRAM) or a
+ *  UnixStreamServer (SOCK_STREAM).
+ *
+ *  Datagram clients bind to an automatically chosen abstract address, so the
+ *  server can reply to them. The kernel identifies the client to the server,
+ *  nothing has to be sent for the server to see its credentials.
+ */
+class UnixClient
+{
+
+public:
+
+    /** Default constructor.
+     *
+     *  User needs to manually connect. Good for handling errors.
+     */
+    UnixClient();
+
+
+    /** Constructor, connects to a server.
+     *
+     *  @param[in] path     Path of the server socket, "@name" for the
+     *                      abstract namespace.
+     *  @param[in] type     SOCK_DGRAM or SOCK_STREAM.
+     */
+    UnixClient(const std::string& path, int type = SOCK_DGRAM);
+
+
+    /** Destructor.
+     *
+     *  Disconnects from the socket.
+     */
+    ~UnixClient();
+
+
+    /** Connects to a server.
+     *
+     *  @param[in] path     Path of the server socket, "@name" for the
+     *                      abstract namespace.
+     *  @param[in] type     SOCK_DGRAM or SOCK_STREAM.
+     *  @return             True if the connection was established.
+     */
+    bool connect(const std::string& path, int type = SOCK_DGRAM);
+
+
+    /** Disconnects from the socket.
+     */
+    bool disconnect();
+
+
+    /** Sends data to the server, optionally passing file descriptors along.
+     *
+     *  @param[in] buff     Data to send.
+     *  @param[in] length   Length of the data.
+     *  @param[in] fds      Descriptors to pass, may be NULL.
+     *  @param[in] count    Number of descriptors.
+     *  @return             True if all the data was sent.
+     */
+    bool send(const char* buff, size_t length, const int* fds = NULL, size_t count = 0);
+
+
+    /** Receives data from the server, waiting up to timeout.
+     *
+     *  @param[out] buff    Buffer for the data.
+     *  @param[in]  length  Size of the buffer.
+     *  @param[out] fds     Descriptors passed by the server are appended
+     *                      here, may be NULL to close them.
+     *  @param[in]  timeout Time to wait, 0 to block.
+     *  @return             Bytes received, -1 on timeout or error.
+     */
+    ssize_t receive(char* buff, size_t length, std::vector<int>* fds = NULL, double timeout = 0);
+
+
+    /** Gets the file descriptor of the socket.
+     */
+    int getSocket() const;
+
+
+    /** Determines if the connection is currently alive.
+     *
+     *  @return True if the connection is alive.
+     */
+    bool isAlive();
+
+private:
+
+    /** Sets the alive flag.
+     */
+    void setAlive(bool alive);
+
+    // Socket file descriptor.
+    int sock;
+
+    // Path of the server.
+    std::string path;
+
+    // Whether or not the connection is alive.
+    bool alive;
+
+    // Mutex for making thread safe calls.
+    std::mutex mutexUnix;
+
+};  // UNIX_CLIENT
+
+
+#endif  // UNIX_CLIENT_H
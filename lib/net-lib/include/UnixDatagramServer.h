@@ -0,0 +1,333 @@
+/**
+ * @file UnixDatagramServer.h
+ * @brief Datagram server on a Unix domain socket for processes on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef UNIX_DATAGRAM_SERVER_H
+#define UNIX_DATAGRAM_SERVER_H
+
+// STL
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Network
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+
+// Thread
+#include <pthread.h>
+
+#include "Networking.h"
+#include "ThreadConfig.h"
+
+
+/** Socket handling shared by every BasicUnixDatagramServer, independent of the
+ *  type of the task. Only the receive loop that calls the task is a template.
+ */
+class UnixDatagramServerBase
+{
+
+public:
+
+    /** Binds the socket.
+     *
+     *  @param[in] path         Path of the socket, "@name" for the abstract
+     *                          namespace. A stale socket file left at the path
+     *                          is replaced.
+     *  @param[in] recvBuffSize Size of the receive buffer, 0 for the default.
+     *  @return                 True if the socket was bound.
+     */
+    bool connect(const std::string& path, int recvBuffSize = 0);
+
+
+    /** Stops running, closes the socket and removes its file.
+     */
+    bool disconnect();
+
+
+    /** Sets the role the server thread configures itself with when run()
+     *  starts, see Threading::configureThread(). Defaults to "server".
+     *
+     *  @param[in] role     Thread role.
+     */
+    void setThreadRole(const std::string& role);
+
+
+    /** Receives one datagram without blocking, keeping the credentials and
+     *  descriptors that came with it.
+     *
+     *  @param[out] buf     Buffer for the datagram.
+     *  @param[in]  size    Size of the buffer.
+     *  @return             Bytes received, -1 if nothing was waiting or on
+     *                      error.
+     */
+    ssize_t receive(void* buf, size_t size);
+
+
+    /** Replies to the sender of the last datagram. Only works if the sender
+     *  bound its socket to an address, as UnixClient does.
+     *
+     *  @param[in] buff     Data to send.
+     *  @param[in] length   Length of the data.
+     *  @param[in] fds      Descriptors to pass along, may be NULL.
+     *  @param[in] count    Number of descriptors.
+     *  @return             Bytes sent, -1 on error.
+     */
+    ssize_t send(const char* buff, size_t length, const int* fds = NULL, size_t count = 0);
+
+
+    /** Gets the credentials of the sender of the last datagram, as checked by
+     *  the kernel.
+     */
+    struct ucred getLastCredentials() const;
+
+
+    /** Takes the descriptors passed with the last datagram. The caller owns
+     *  them; descriptors not taken are closed when the next datagram arrives.
+     *
+     *  @param[out] fds     Descriptors are appended here.
+     *  @return             Number of descriptors taken.
+     */
+    size_t takeFds(std::vector<int>& fds);
+
+
+    /** Determines if the server socket is bound.
+     */
+    bool isServerAlive() const;
+
+
+    /** Gets the file descriptor belonging to the server.
+     */
+    int getServer() const;
+
+
+    /** Gets the path the server is bound to.
+     */
+    const std::string& getPath() const;
+
+
+protected:
+
+    /** Default constructor, only servers with a task are created.
+     */
+    UnixDatagramServerBase();
+
+
+    /** Destructor, stops running and disconnects the server.
+     */
+    ~UnixDatagramServerBase();
+
+
+    /** Prepares the calling thread for the receive loop.
+     */
+    void beginRun(int readSize, double timeoutRead);
+
+
+    /** Receives the next datagram into buff, waiting up to timeoutRead when
+     *  the socket is empty.
+     *
+     *  @return Length of the datagram, -1 if none arrived.
+     */
+    ssize_t nextDatagram();
+
+
+    /** Closes descriptors received but not taken.
+     */
+    void closeFds();
+
+    // Receive buffer of the run loop.
+    char* buff;
+
+    // Max size of reads.
+    int readSize;
+
+    // Timeout to use when reading.
+    double timeoutRead;
+
+    // Socket file descriptor of the server.
+    int sockServer;
+
+    // Path the socket is bound to.
+    std::string path;
+
+    // Address of the sender of the last datagram.
+    struct sockaddr_un client;
+    socklen_t clientLength;
+
+    // Credentials of the sender of the last datagram.
+    struct ucred credentials;
+
+    // Descriptors passed with the last datagram.
+    std::vector<int> fds;
+
+    // Whether the socket is bound.
+    bool serverAlive;
+
+    // Whether the run loop started.
+    std::atomic<bool> running;
+
+    // Whether it is time to exit the run loop.
+    std::atomic<bool> time2Exit;
+
+    // Event signalled by disconnect() to wake the run loop.
+    int wakeFd;
+
+    // Thread ID.
+    pthread_t tid;
+
+    // Role whose thread settings run() applies.
+    std::string threadRole;
+
+};  // UNIX_DATAGRAM_SERVER_BASE
+
+
+/** BasicUnixDatagramServer receives datagrams from processes on the same host
+ *  over a Unix domain socket, without going through the IP stack.
+ *
+ *  The kernel checks and attaches the process, user and group id of the
+ *  sender to every datagram, see getLastCredentials(). Senders can pass open
+ *  file descriptors along, see takeFds().
+ *
+ *  The task has the same form as for BasicUdpServer: it is called with the
+ *  file descriptor of the server, the datagram and its length, and returns
+ *  whether it succeeded. Handler is the type of the task.
+ */
+template <typename Handler>
+class BasicUnixDatagramServer : public UnixDatagramServerBase
+{
+
+public:
+
+    // Arguments to the thread.
+    struct ThreadArgs
+    {
+        BasicUnixDatagramServer* thisPtr;
+        Handler task;
+        int readSize;
+        double timeoutRead;
+    };
+
+
+    /** Default constructor.
+     *
+     *  User needs to manually connect and begin running. Good for handling
+     *  errors.
+     */
+    BasicUnixDatagramServer() {}
+
+
+    /** Constructor.
+     *
+     *  Binds the socket and begins running immediately (in a thread).
+     *
+     *  @param[in] task         Task called with every datagram.
+     *  @param[in] path         Path of the socket, "@name" for the abstract
+     *                          namespace.
+     *  @param[in] readSize     Max size of reads.
+     *  @param[in] recvBuffSize Size of the receive buffer.
+     *  @param[in] timeoutRead  Timeout to use when reading, 0 to block.
+     */
+    BasicUnixDatagramServer(Handler task, const std::string& path, int readSize,
+        int recvBuffSize, double timeoutRead);
+
+
+    /** Runs the server until disconnect() is called from another thread.
+     *
+     *  @param[in] task         Task to execute for every datagram.
+     *  @param[in] readSize     Max size of reads.
+     *  @param[in] timeoutRead  Timeout to use when reading, 0 to block.
+     */
+    void run(Handler task, int readSize, double timeoutRead);
+
+
+    /** Runs the server in a thread.
+     *
+     *  @param[in] task         Task to execute for every datagram.
+     *  @param[in] readSize     Max size of reads.
+     *  @param[in] timeoutRead  Timeout to use when reading, 0 to block.
+     *  @return                 True if the thread was succesfully created.
+     */
+    bool runInThread(Handler task, int readSize, double timeoutRead);
+
+
+private:
+
+    /** Trampoline function for starting the running thread.
+     */
+    static void* runTrampoline(void* args);
+
+};  // BASIC_UNIX_DATAGRAM_SERVER
+
+
+// Server taking its task as a std::function.
+typedef BasicUnixDatagramServer<std::function<bool(int, char*, size_t)> > UnixDatagramServer;
+
+
+template <typename Handler>
+BasicUnixDatagramServer<Handler>::BasicUnixDatagramServer(Handler task_, const std::string& path_,
+    int readSize_, int recvBuffSize_, double timeoutRead_)
+{
+    if (this->connect(path_, recvBuffSize_))
+        this->runInThread(task_, readSize_, timeoutRead_);
+    else
+        std::cerr << "Could not bind Unix socket '" << path_ << "'" << std::endl;
+}
+
+
+template <typename Handler>
+void* BasicUnixDatagramServer<Handler>::runTrampoline(void* args)
+{
+    ThreadArgs* threadArgs = (ThreadArgs*)args;
+    threadArgs->thisPtr->run(threadArgs->task, threadArgs->readSize, threadArgs->timeoutRead);
+    delete threadArgs;
+    return NULL;
+}
+
+
+template <typename Handler>
+void BasicUnixDatagramServer<Handler>::run(Handler task_, int readSize_, double timeoutRead_)
+{
+    this->beginRun(readSize_, timeoutRead_);
+
+    while (!this->time2Exit)
+    {
+        ssize_t recvlen = this->nextDatagram();
+        if (recvlen == -1)
+            continue;
+
+        if (!task_(this->sockServer, this->buff, recvlen))
+            std::cerr << "Error in client task" << std::endl;
+    }
+    this->running = false;
+}
+
+
+template <typename Handler>
+bool BasicUnixDatagramServer<Handler>::runInThread(Handler task_, int readSize_, double timeoutRead_)
+{
+    // The thread owns its copy of the task and frees it on exit
+    this->running = true;
+    ThreadArgs* threadArgs = new ThreadArgs{this, task_, readSize_, timeoutRead_};
+    int result = pthread_create(&this->tid, NULL, &BasicUnixDatagramServer::runTrampoline, threadArgs);
+    if (result)
+    {
+        this->running = false;
+        delete threadArgs;
+        return false;
+    }
+    return true;
+}
+
+
+#endif  // UNIX_DATAGRAM_SERVER_H
@@ -0,0 +1,298 @@
+/**
+ * @file UnixStreamServer.h
+ * @brief Stream server on a Unix domain socket for processes on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#ifndef UNIX_STREAM_SERVER_H
+#define UNIX_STREAM_SERVER_H
+
+// STL
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+// Network
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+
+// Thread
+#include <pthread.h>
+
+#include "Networking.h"
+#include "ThreadConfig.h"
+
+
+/** Socket handling shared by every BasicUnixStreamServer, independent of the
+ *  type of the task. Only the accept loop that calls the task is a template.
+ */
+class UnixStreamServerBase
+{
+
+public:
+
+    /** Binds the socket and starts listening.
+     *
+     *  @param[in] path     Path of the socket, "@name" for the abstract
+     *                      namespace. A stale socket file left at the path is
+     *                      replaced.
+     *  @return             True if the socket is listening.
+     */
+    bool connect(const std::string& path);
+
+
+    /** Stops running, closes the socket and removes its file.
+     */
+    bool disconnect();
+
+
+    /** Sets the role the server thread configures itself with when run()
+     *  starts, see Threading::configureThread(). Defaults to "server".
+     *
+     *  @param[in] role     Thread role.
+     */
+    void setThreadRole(const std::string& role);
+
+
+    /** Gets the credentials of the connected client, as checked by the kernel
+     *  when it connected.
+     */
+    struct ucred getClientCredentials() const;
+
+
+    /** Determines if the server socket is listening.
+     */
+    bool isServerAlive() const;
+
+
+    /** Determines if a client is connected.
+     */
+    bool isClientAlive() const;
+
+
+    /** Gets the file descriptor belonging to the server.
+     */
+    int getServer() const;
+
+
+    /** Gets the file descriptor belonging to the currently connected client.
+     */
+    int getClient() const;
+
+
+    /** Gets the path the server is bound to.
+     */
+    const std::string& getPath() const;
+
+
+protected:
+
+    /** Default constructor, only servers with a task are created.
+     */
+    UnixStreamServerBase();
+
+
+    /** Destructor, stops running and disconnects the server.
+     */
+    ~UnixStreamServerBase();
+
+
+    /** Prepares the calling thread for the accept loop.
+     */
+    void beginRun(double timeoutClientAccept);
+
+
+    /** Waits up to timeoutClientAccept for a client and accepts it into
+     *  sockClient.
+     *
+     *  @return True if a client was accepted.
+     */
+    bool acceptClient();
+
+
+    /** Closes the socket of the current client.
+     */
+    void closeClient();
+
+    // Timeout to use when accepting connections to clients.
+    double timeoutClientAccept;
+
+    // Socket file descriptor of the server.
+    int sockServer;
+
+    // Socket file descriptor of the client.
+    int sockClient;
+
+    // Path the socket is bound to.
+    std::string path;
+
+    // Credentials of the connected client.
+    struct ucred credentials;
+
+    // Whether the socket is listening.
+    bool serverAlive;
+
+    // Whether a client is connected.
+    bool clientAlive;
+
+    // Whether the run loop started.
+    std::atomic<bool> running;
+
+    // Whether it is time to exit the run loop.
+    std::atomic<bool> time2Exit;
+
+    // Event signalled by disconnect() to wake the run loop.
+    int wakeFd;
+
+    // Thread ID.
+    pthread_t tid;
+
+    // Role whose thread settings run() applies.
+    std::string threadRole;
+
+};  // UNIX_STREAM_SERVER_BASE
+
+
+/** BasicUnixStreamServer serves one client at a time over a Unix domain
+ *  stream socket, without going through the IP stack.
+ *
+ *  The task has the same form as for BasicTcpServer: it is called with the
+ *  socket of each accepted client and returns whether it succeeded. The
+ *  credentials of the client are available from getClientCredentials() while
+ *  the task runs, and descriptors can be exchanged over the client socket
+ *  with Networking::sendWithRights() and Networking::receiveWithRights().
+ */
+template <typename Handler>
+class BasicUnixStreamServer : public UnixStreamServerBase
+{
+
+public:
+
+    // Arguments to the thread.
+    struct ThreadArgs
+    {
+        BasicUnixStreamServer* thisPtr;
+        Handler task;
+        double timeoutClientAccept;
+    };
+
+
+    /** Default constructor.
+     *
+     *  User needs to manually connect and begin running. Good for handling
+     *  errors.
+     */
+    BasicUnixStreamServer() {}
+
+
+    /** Constructor.
+     *
+     *  Binds the socket and begins running immediately (in a thread).
+     *
+     *  @param[in] task     Task called with every accepted client.
+     *  @param[in] path     Path of the socket, "@name" for the abstract
+     *                      namespace.
+     *  @param[in] timeoutClientAccept  Timeout to use when accepting clients,
+     *                                  0 to wait until a client connects.
+     */
+    BasicUnixStreamServer(Handler task, const std::string& path, double timeoutClientAccept = 0);
+
+
+    /** Runs the server until disconnect() is called from another thread.
+     *
+     *  @param[in] task                 Task to execute once a client connects.
+     *  @param[in] timeoutClientAccept  Timeout to use when accepting clients.
+     */
+    void run(Handler task, double timeoutClientAccept);
+
+
+    /** Runs the server in a thread.
+     *
+     *  @param[in] task                 Task to execute once a client connects.
+     *  @param[in] timeoutClientAccept  Timeout to use when accepting clients.
+     *  @return                         True if the thread was succesfully
+     *                                  created.
+     */
+    bool runInThread(Handler task, double timeoutClientAccept);
+
+
+private:
+
+    /** Trampoline function for starting the running thread.
+     */
+    static void* runTrampoline(void* args);
+
+};  // BASIC_UNIX_STREAM_SERVER
+
+
+// Server taking its task as a std::function.
+typedef BasicUnixStreamServer<std::function<bool(int)> > UnixStreamServer;
+
+
+template <typename Handler>
+BasicUnixStreamServer<Handler>::BasicUnixStreamServer(Handler task_, const std::string& path_,
+    double timeoutClientAccept_)
+{
+    if (this->connect(path_))
+        this->runInThread(task_, timeoutClientAccept_);
+    else
+        std::cerr << "Could not listen on Unix socket '" << path_ << "'" << std::endl;
+}
+
+
+template <typename Handler>
+void* BasicUnixStreamServer<Handler>::runTrampoline(void* args)
+{
+    ThreadArgs* threadArgs = (ThreadArgs*)args;
+    threadArgs->thisPtr->run(threadArgs->task, threadArgs->timeoutClientAccept);
+    delete threadArgs;
+    return NULL;
+}
+
+
+template <typename Handler>
+void BasicUnixStreamServer<Handler>::run(Handler task_, double timeoutClientAccept_)
+{
+    this->beginRun(timeoutClientAccept_);
+
+    while (!this->time2Exit)
+    {
+        if (!this->acceptClient())
+            continue;
+
+        // Process this client
+        if (!task_(this->sockClient))
+            std::cerr << "Error in client task" << std::endl;
+
+        this->closeClient();
+    }
+    this->running = false;
+}
+
+
+template <typename Handler>
+bool BasicUnixStreamServer<Handler>::runInThread(Handler task_, double timeoutClientAccept_)
+{
+    // The thread owns its copy of the task and frees it on exit
+    this->running = true;
+    ThreadArgs* threadArgs = new ThreadArgs{this, task_, timeoutClientAccept_};
+    int result = pthread_create(&this->tid, NULL, &BasicUnixStreamServer::runTrampoline, threadArgs);
+    if (result)
+    {
+        this->running = false;
+        delete threadArgs;
+        return false;
+    }
+    return true;
+}
+
+
+#endif  // UNIX_STREAM_SERVER_H
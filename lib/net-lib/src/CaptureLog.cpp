@@ -0,0 +1,286 @@
+/**
+ * @file CaptureLog.cpp
+ * @brief Memory mapped binary log of received messages, for replaying traffic.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "CaptureLog.h"
+
+// STL
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+// System
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+
+namespace {
+
+const char captureMagic[8] = {'N', 'L', 'C', 'A', 'P', 'T', 'R', '\0'};
+const uint32_t captureVersion = 1;
+
+/** Rounds a length up to the 8 byte alignment of records.
+ */
+size_t align8(size_t length)
+{
+    return (length + 7) & ~(size_t)7;
+}
+
+}  // ANONYMOUS
+
+
+const size_t CaptureLog::growStep;
+
+
+CaptureLog::CaptureLog()
+    : fd(-1),
+      mapping(nullptr),
+      capacity(0),
+      used(0),
+      records(0),
+      opened(false) {}
+
+
+CaptureLog::~CaptureLog()
+{
+    this->close();
+}
+
+
+bool CaptureLog::open(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->fd != -1)
+        return false;
+
+    this->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (this->fd == -1)
+    {
+        std::cerr << "Could not create capture '" << path << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    this->used = 0;
+    if (!this->reserve(sizeof(Capture::FileHeader)))
+    {
+        ::close(this->fd);
+        this->fd = -1;
+        return false;
+    }
+
+    Capture::FileHeader* header = (Capture::FileHeader*)this->mapping;
+    memcpy(header->magic, captureMagic, sizeof(captureMagic));
+    header->version = captureVersion;
+    header->headerSize = sizeof(Capture::FileHeader);
+    header->start_ns = getWallTime_ns();
+    this->used = sizeof(Capture::FileHeader);
+
+    this->records = 0;
+    this->opened = true;
+    return true;
+}
+
+
+void CaptureLog::close()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->fd == -1)
+        return;
+    this->opened = false;
+
+    ::munmap(this->mapping, this->capacity);
+    if (::ftruncate(this->fd, this->used) == -1)
+        std::cerr << "Could not trim capture: " << strerror(errno) << std::endl;
+    ::close(this->fd);
+
+    this->fd = -1;
+    this->mapping = nullptr;
+    this->capacity = 0;
+}
+
+
+bool CaptureLog::isOpen() const
+{
+    return this->opened.load(std::memory_order_relaxed);
+}
+
+
+bool CaptureLog::append(uint8_t protocol, const struct sockaddr_in& source, const char* data, size_t length,
+    uint64_t timestamp_ns, uint8_t flags)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->fd == -1)
+        return false;
+
+    // Keep room for the zeroed header that ends the log
+    const size_t recordSize = sizeof(Capture::RecordHeader) + align8(length);
+    if (!this->reserve(this->used + recordSize + sizeof(Capture::RecordHeader)))
+        return false;
+
+    Capture::RecordHeader* header = (Capture::RecordHeader*)(this->mapping + this->used);
+    header->timestamp_ns = timestamp_ns;
+    header->address = source.sin_addr.s_addr;
+    header->port = source.sin_port;
+    header->protocol = protocol;
+    header->length = length;
+    header->reserved = 0;
+    if (length > 0)
+        memcpy(this->mapping + this->used + sizeof(Capture::RecordHeader), data, length);
+
+    // Marked valid last, so a crash mid record leaves the log ending before it
+    header->flags = flags | Capture::flagValid;
+    this->used += recordSize;
+    this->records++;
+    return true;
+}
+
+
+uint64_t CaptureLog::getRecords() const
+{
+    return this->records;
+}
+
+
+uint64_t CaptureLog::getWallTime_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+
+bool CaptureLog::reserve(size_t size)
+{
+    if (size <= this->capacity)
+        return true;
+
+    size_t newCapacity = this->capacity;
+    while (newCapacity < size)
+        newCapacity += growStep;
+
+    // New pages of the file read as zero, which also ends the log
+    if (::ftruncate(this->fd, newCapacity) == -1)
+    {
+        std::cerr << "Could not grow capture: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    void* newMapping = this->mapping
+        ? ::mremap(this->mapping, this->capacity, newCapacity, MREMAP_MAYMOVE)
+        : ::mmap(NULL, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (newMapping == MAP_FAILED)
+    {
+        std::cerr << "Could not map capture: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    this->mapping = (char*)newMapping;
+    this->capacity = newCapacity;
+    return true;
+}
+
+
+CaptureReader::CaptureReader()
+    : mapping(nullptr),
+      size(0),
+      offset(0) {}
+
+
+CaptureReader::~CaptureReader()
+{
+    this->close();
+}
+
+
+bool CaptureReader::open(const std::string& path)
+{
+    this->close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        std::cerr << "Could not open capture '" << path << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1 || (size_t)status.st_size < sizeof(Capture::FileHeader))
+    {
+        std::cerr << "'" << path << "' is not a capture" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = ::mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        std::cerr << "Could not map capture: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Replay reads the file front to back once
+    ::madvise(mapped, status.st_size, MADV_SEQUENTIAL);
+
+    this->mapping = (const char*)mapped;
+    this->size = status.st_size;
+
+    const Capture::FileHeader& header = this->getHeader();
+    if (memcmp(header.magic, captureMagic, sizeof(captureMagic)) != 0 || header.version != captureVersion
+        || header.headerSize < sizeof(Capture::FileHeader) || header.headerSize > this->size)
+    {
+        std::cerr << "'" << path << "' is not a capture" << std::endl;
+        this->close();
+        return false;
+    }
+
+    this->rewind();
+    return true;
+}
+
+
+void CaptureReader::close()
+{
+    if (this->mapping)
+        ::munmap((void*)this->mapping, this->size);
+    this->mapping = nullptr;
+    this->size = 0;
+    this->offset = 0;
+}
+
+
+bool CaptureReader::next(Capture::Record& record)
+{
+    if (!this->mapping || this->offset + sizeof(Capture::RecordHeader) > this->size)
+        return false;
+
+    memcpy(&record.header, this->mapping + this->offset, sizeof(Capture::RecordHeader));
+    if (!(record.header.flags & Capture::flagValid)
+        || record.header.length > this->size - this->offset - sizeof(Capture::RecordHeader))
+        return false;
+
+    record.data = this->mapping + this->offset + sizeof(Capture::RecordHeader);
+    this->offset += sizeof(Capture::RecordHeader) + align8(record.header.length);
+    return true;
+}
+
+
+void CaptureReader::rewind()
+{
+    this->offset = this->mapping ? this->getHeader().headerSize : 0;
+}
+
+
+const Capture::FileHeader& CaptureReader::getHeader() const
+{
+    return *(const Capture::FileHeader*)this->mapping;
+}
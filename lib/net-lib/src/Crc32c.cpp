@@ -0,0 +1,220 @@
+/**
+ * @file Crc32c.cpp
+ * @brief CRC32C (Castagnoli) checksums using the CPU instructions when present.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "Crc32c.h"
+
+// STL
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <nmmintrin.h>
+    #define CRC32C_HAVE_SSE42
+#endif
+
+// The ARM instructions are only used when the build targets a core that has
+// them, e.g. -march=armv8-a+crc, since ARMv6 and ARMv7 cores never do
+#if defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define CRC32C_HAVE_ARMV8
+#endif
+
+
+namespace {
+
+// Reflected CRC32C polynomial.
+const uint32_t polynomial = 0x82F63B78;
+
+
+/** Lookup tables of slicing-by-8. Table 0 is the classic byte-at-a-time
+ *  table, table k advances a byte through k further zero bytes, so eight
+ *  input bytes are folded with eight independent lookups.
+ */
+struct SlicingTables
+{
+    uint32_t table[8][256];
+
+    SlicingTables()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1)));
+            this->table[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            for (int k = 1; k < 8; k++)
+                this->table[k][i] = (this->table[k - 1][i] >> 8) ^ this->table[0][this->table[k - 1][i] & 0xFF];
+        }
+    }
+};
+
+
+const SlicingTables& getTables()
+{
+    static const SlicingTables tables;
+    return tables;
+}
+
+
+/** Reads 8 bytes as a little endian integer, whatever the host byte order.
+ */
+inline uint64_t loadLittleEndian64(const uint8_t* p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+
+uint32_t computeSlicing(const uint8_t* p, size_t length, uint32_t crc)
+{
+    const SlicingTables& tables = getTables();
+    const uint32_t (*t)[256] = tables.table;
+
+    while (length >= 8)
+    {
+        uint64_t word = loadLittleEndian64(p) ^ crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF]
+            ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^ t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+        p += 8;
+        length -= 8;
+    }
+
+    while (length--)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+
+#ifdef CRC32C_HAVE_SSE42
+__attribute__((target("sse4.2")))
+uint32_t computeSse42(const uint8_t* p, size_t length, uint32_t crc)
+{
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (length >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+
+    while (length >= 4)
+    {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        length -= 4;
+    }
+
+    while (length--)
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif
+
+
+#ifdef CRC32C_HAVE_ARMV8
+uint32_t computeArmv8(const uint8_t* p, size_t length, uint32_t crc)
+{
+    while (length >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+        p += 8;
+        length -= 8;
+    }
+
+    while (length--)
+        crc = __crc32cb(crc, *p++);
+    return crc;
+}
+#endif
+
+
+typedef uint32_t (*Implementation)(const uint8_t*, size_t, uint32_t);
+
+
+/** Chooses the implementation for this CPU.
+ */
+Implementation selectImplementation(const char** name)
+{
+#ifdef CRC32C_HAVE_SSE42
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        *name = "sse4.2";
+        return computeSse42;
+    }
+#endif
+
+#ifdef CRC32C_HAVE_ARMV8
+    *name = "armv8";
+    return computeArmv8;
+#endif
+
+    *name = "slicing-by-8";
+    return computeSlicing;
+}
+
+
+struct Dispatch
+{
+    const char* name;
+    Implementation implementation;
+
+    Dispatch()
+        : name(nullptr),
+          implementation(selectImplementation(&name)) {}
+};
+
+
+const Dispatch& getDispatch()
+{
+    static const Dispatch dispatch;
+    return dispatch;
+}
+
+}  // ANONYMOUS
+
+
+namespace Crc32c {
+
+
+uint32_t compute(const void* data, size_t length, uint32_t crc)
+{
+    return ~getDispatch().implementation(static_cast<const uint8_t*>(data), length, ~crc);
+}
+
+
+uint32_t computeSoftware(const void* data, size_t length, uint32_t crc)
+{
+    return ~computeSlicing(static_cast<const uint8_t*>(data), length, ~crc);
+}
+
+
+const char* getImplementation()
+{
+    return getDispatch().name;
+}
+
+
+}  // CRC32C
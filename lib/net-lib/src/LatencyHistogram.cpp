@@ -0,0 +1,186 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Log-bucketed latency histogram with lock-free recording.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+
+LatencyHistogram::LatencyHistogram(uint64_t maxValue_, int subBucketBits_)
+    : subBucketBits(subBucketBits_ < 2 ? 2 : (subBucketBits_ > 16 ? 16 : subBucketBits_)),
+      subBucketCount(1ull << subBucketBits),
+      bucketCount(0),
+      count(0),
+      sum(0),
+      min(std::numeric_limits<uint64_t>::max()),
+      max(0),
+      last(0),
+      jitter16(0)
+{
+    // Size the table so the maximum value still lands in its own bucket
+    this->bucketCount = std::numeric_limits<size_t>::max();
+    this->bucketCount = this->bucketIndex(maxValue_ < this->subBucketCount ? this->subBucketCount : maxValue_) + 1;
+
+    this->counts.reset(new std::atomic<uint64_t>[this->bucketCount]);
+    for (size_t i = 0; i < this->bucketCount; i++)
+        this->counts[i].store(0, std::memory_order_relaxed);
+}
+
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) const
+{
+    if (value < this->subBucketCount)
+        return static_cast<size_t>(value);
+
+    // Position of the highest set bit decides the power of two range, the next
+    // subBucketBits - 1 bits decide the linear sub-bucket inside it
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - this->subBucketBits + 1;
+    const uint64_t half = this->subBucketCount / 2;
+    const uint64_t sub = value >> shift;
+
+    const uint64_t index = this->subBucketCount + (shift - 1) * half + (sub - half);
+    return index < this->bucketCount ? static_cast<size_t>(index) : this->bucketCount - 1;
+}
+
+
+uint64_t LatencyHistogram::bucketValue(size_t index) const
+{
+    if (index < this->subBucketCount)
+        return index;
+
+    const uint64_t half = this->subBucketCount / 2;
+    const uint64_t offset = index - this->subBucketCount;
+    const int shift = static_cast<int>(offset / half) + 1;
+    const uint64_t sub = offset % half + half;
+    return ((sub + 1) << shift) - 1;
+}
+
+
+void LatencyHistogram::record(uint64_t value)
+{
+    this->counts[this->bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    this->sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = this->min.load(std::memory_order_relaxed);
+    while (value < current && !this->min.compare_exchange_weak(current, value, std::memory_order_relaxed));
+
+    current = this->max.load(std::memory_order_relaxed);
+    while (value > current && !this->max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+
+    // Jitter needs a previous sample, skip the very first one
+    const uint64_t previous = this->last.exchange(value, std::memory_order_relaxed);
+    if (this->count.fetch_add(1, std::memory_order_relaxed) > 0)
+    {
+        const uint64_t delta = value > previous ? value - previous : previous - value;
+
+        // J += (|D| - J) / 16, kept scaled by 16 to stay in integers
+        current = this->jitter16.load(std::memory_order_relaxed);
+        while (!this->jitter16.compare_exchange_weak(current, current - current / 16 + delta, std::memory_order_relaxed));
+    }
+}
+
+
+void LatencyHistogram::reset()
+{
+    for (size_t i = 0; i < this->bucketCount; i++)
+        this->counts[i].store(0, std::memory_order_relaxed);
+    this->count.store(0, std::memory_order_relaxed);
+    this->sum.store(0, std::memory_order_relaxed);
+    this->min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    this->max.store(0, std::memory_order_relaxed);
+    this->last.store(0, std::memory_order_relaxed);
+    this->jitter16.store(0, std::memory_order_relaxed);
+}
+
+
+uint64_t LatencyHistogram::getCount() const
+{
+    return this->count.load(std::memory_order_relaxed);
+}
+
+
+void LatencyHistogram::percentiles(const double* percentiles_, uint64_t* values, size_t n) const
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < this->bucketCount; i++)
+        total += this->counts[i].load(std::memory_order_relaxed);
+
+    const uint64_t maxSeen = this->max.load(std::memory_order_relaxed);
+    for (size_t k = 0; k < n; k++)
+    {
+        values[k] = 0;
+        if (total == 0)
+            continue;
+
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentiles_[k] / 100.0 * total));
+        if (target < 1)
+            target = 1;
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < this->bucketCount; i++)
+        {
+            cumulative += this->counts[i].load(std::memory_order_relaxed);
+            if (cumulative >= target)
+            {
+                // Never report more than was actually seen
+                values[k] = std::min(this->bucketValue(i), maxSeen);
+                break;
+            }
+        }
+    }
+}
+
+
+uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+    uint64_t value;
+    this->percentiles(&percentile, &value, 1);
+    return value;
+}
+
+
+LatencyHistogram::Summary LatencyHistogram::getSummary() const
+{
+    static const double wanted[3] = {50.0, 99.0, 99.9};
+    uint64_t values[3];
+    this->percentiles(wanted, values, 3);
+
+    Summary summary;
+    summary.count = this->count.load(std::memory_order_relaxed);
+    summary.min = summary.count ? this->min.load(std::memory_order_relaxed) : 0;
+    summary.max = this->max.load(std::memory_order_relaxed);
+    summary.mean = summary.count ? (double)this->sum.load(std::memory_order_relaxed) / summary.count : 0.0;
+    summary.p50 = values[0];
+    summary.p99 = values[1];
+    summary.p999 = values[2];
+    summary.jitter = this->jitter16.load(std::memory_order_relaxed) / 16.0;
+    return summary;
+}
+
+
+std::string LatencyHistogram::toString(const Summary& summary, const std::string& unit)
+{
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+    out << "count=" << summary.count
+        << " min=" << summary.min << unit
+        << " p50=" << summary.p50 << unit
+        << " p99=" << summary.p99 << unit
+        << " p99.9=" << summary.p999 << unit
+        << " max=" << summary.max << unit
+        << " mean=" << summary.mean << unit
+        << " jitter=" << summary.jitter << unit;
+    return out.str();
+}
@@ -6,10 +6,16 @@
  *
  * Updates:
  * 01/31/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Added eventfd wakeups
+ * 10/18/2026 [msardonini] Added Unix domain socket helpers
+ * 10/18/2026 [msardonini] Added waitForOutput
+ * 10/19/2026 [msardonini] Added removeStaleUnixSocket
  */
 
 #include "Networking.h"
 
+#include <sys/stat.h>
+
 
 uint64_t Networking::strToUint(const std::string& str)
 {
@@ -141,6 +147,223 @@ bool Networking::hasInput(int fd, double timeout)
 }
 
 
+namespace {
+
+/** Polls a socket for the given events together with a wakeup event.
+ */
+bool waitForEvents(int fd, short events, int wakeFd, double timeout)
+{
+    struct pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = events;
+    fds[1].fd = wakeFd;
+    fds[1].events = POLLIN;
+    nfds_t nfds = wakeFd == -1 ? 1 : 2;
+
+    const double deadline = Networking::getWallTime() + timeout;
+    while (true)
+    {
+        int timeout_ms = -1;
+        if (timeout > 0)
+        {
+            double remaining = deadline - Networking::getWallTime();
+            timeout_ms = remaining > 0 ? (int)(remaining * 1000 + 0.999) : 0;
+        }
+
+        int status = ::poll(fds, nfds, timeout_ms);
+        if (status > 0)
+            return (fds[0].revents & events) && !(nfds == 2 && fds[1].revents);
+        else if (status == 0 || errno != EINTR)
+            return false;
+    }
+}
+
+}  // ANONYMOUS
+
+
+bool Networking::waitForInput(int fd, int wakeFd, double timeout)
+{
+    return waitForEvents(fd, POLLIN, wakeFd, timeout);
+}
+
+
+bool Networking::waitForOutput(int fd, int wakeFd, double timeout)
+{
+    return waitForEvents(fd, POLLOUT, wakeFd, timeout);
+}
+
+
+int Networking::createWakeup()
+{
+    int wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd == -1)
+        std::cerr << "Could not create wakeup event: " << strerror(errno) << std::endl;
+    return wakeFd;
+}
+
+
+bool Networking::signalWakeup(int wakeFd)
+{
+    uint64_t one = 1;
+    return ::write(wakeFd, &one, sizeof(one)) == sizeof(one);
+}
+
+
+void Networking::clearWakeup(int wakeFd)
+{
+    uint64_t count;
+    while (::read(wakeFd, &count, sizeof(count)) == sizeof(count)) {}
+}
+
+
+bool Networking::makeUnixAddress(const std::string& path, struct sockaddr_un& address, socklen_t& length)
+{
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    // Leave room for the terminator of a filesystem path
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Invalid Unix socket path '" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Abstract names start with a null byte and are not terminated
+    memcpy(address.sun_path, path.data(), path.size());
+    if (path[0] == '@')
+    {
+        address.sun_path[0] = '\0';
+        length = offsetof(struct sockaddr_un, sun_path) + path.size();
+    }
+    else
+        length = offsetof(struct sockaddr_un, sun_path) + path.size() + 1;
+    return true;
+}
+
+
+void Networking::removeStaleUnixSocket(const std::string& path, const struct sockaddr_un& address,
+    socklen_t length, int type)
+{
+    struct stat status;
+    if (path.empty() || path[0] == '@' || ::lstat(path.c_str(), &status) != 0 || !S_ISSOCK(status.st_mode))
+        return;
+
+    // Only a file nobody is bound to refuses the connection, a full backlog
+    // does not block the probe
+    int probe = ::socket(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe == -1)
+        return;
+    if (::connect(probe, (const struct sockaddr*)&address, length) == -1 && errno == ECONNREFUSED)
+        ::unlink(path.c_str());
+    ::close(probe);
+}
+
+
+ssize_t Networking::sendWithRights(int fd, const void* data, size_t length, const int* fds, size_t count,
+    const struct sockaddr_un* to, socklen_t toLength)
+{
+    if (count > maxPassedFds)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    struct iovec iov;
+    iov.iov_base = const_cast<void*>(data);
+    iov.iov_len = length;
+
+    char control[CMSG_SPACE(sizeof(int) * maxPassedFds)];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = const_cast<struct sockaddr_un*>(to);
+    msg.msg_namelen = to ? toLength : 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if (fds && count > 0)
+    {
+        msg.msg_control = control;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+    }
+
+    ssize_t sent;
+    do
+        sent = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    while (sent == -1 && errno == EINTR);
+    return sent;
+}
+
+
+ssize_t Networking::receiveWithRights(int fd, void* data, size_t length, std::vector<int>& fds,
+    struct ucred* credentials, struct sockaddr_un* from, socklen_t* fromLength)
+{
+    struct iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = length;
+
+    // Room for a full set of descriptors and the credentials
+    char control[CMSG_SPACE(sizeof(int) * maxPassedFds) + CMSG_SPACE(sizeof(struct ucred))];
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = from;
+    msg.msg_namelen = from ? sizeof(*from) : 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do
+        received = ::recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+    while (received == -1 && errno == EINTR);
+    if (received == -1)
+        return -1;
+
+    if (fromLength)
+        *fromLength = msg.msg_namelen;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET)
+            continue;
+
+        if (cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; i++)
+            {
+                int passed;
+                memcpy(&passed, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+                fds.push_back(passed);
+            }
+        }
+        else if (cmsg->cmsg_type == SCM_CREDENTIALS && credentials)
+            memcpy(credentials, CMSG_DATA(cmsg), sizeof(struct ucred));
+    }
+
+    // The kernel closes whatever did not fit
+    if (msg.msg_flags & MSG_CTRUNC)
+        std::cerr << "Warning: descriptors passed over a Unix socket were dropped" << std::endl;
+
+    return received;
+}
+
+
+bool Networking::getPeerCredentials(int fd, struct ucred& credentials)
+{
+    socklen_t length = sizeof(credentials);
+    return ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0;
+}
+
+
 bool Networking::flushSocket(int fd, double timeout)
 {
    const double start = Networking::getWallTime();
@@ -0,0 +1,324 @@
+/**
+ * @file PeerTable.cpp
+ * @brief Table of the peers a datagram socket hears from, keyed by address.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "PeerTable.h"
+
+#include <cstring>
+
+
+const uint32_t PeerTable::none;
+const uint32_t PeerTable::wheelSize;
+
+
+PeerTable::PeerTable(size_t capacity_, double idleTimeout)
+    : freeList(none),
+      wheel(wheelSize, none),
+      tick_ns(1),
+      timeout_ns(idleTimeout > 0 ? (uint64_t)(idleTimeout * 1e9) : 0),
+      currentTick(0),
+      count(0),
+      rejected(0),
+      expired(0)
+{
+    if (capacity_ == 0)
+        capacity_ = 1;
+
+    this->entries.resize(capacity_);
+    for (size_t i = capacity_; i-- > 0;)
+    {
+        memset(&this->entries[i].peer, 0, sizeof(Peer));
+        this->entries[i].generation = 1;
+        this->entries[i].used = false;
+        this->entries[i].next = this->freeList;
+        this->entries[i].prev = none;
+        this->entries[i].dueTick = 0;
+        this->freeList = i;
+    }
+
+    size_t indexSize = 1;
+    while (indexSize < 2 * capacity_)
+        indexSize <<= 1;
+    this->index.assign(indexSize, none);
+
+    // The wheel spans twice the timeout, so a deadline always lands within one
+    // lap of the current tick
+    if (this->timeout_ns > 0)
+        this->tick_ns = this->timeout_ns / (wheelSize / 2) > 0 ? this->timeout_ns / (wheelSize / 2) : 1;
+}
+
+
+PeerTable::Peer* PeerTable::onReceive(const struct sockaddr_in& address, size_t bytes, uint64_t now_ns)
+{
+    this->expire(now_ns);
+
+    const uint32_t addr = address.sin_addr.s_addr;
+    const uint16_t port = address.sin_port;
+    const uint32_t slot = this->findSlot(addr, port);
+
+    uint32_t e = this->index[slot];
+    if (e == none)
+    {
+        if (this->freeList == none)
+        {
+            this->rejected++;
+            return NULL;
+        }
+
+        e = this->freeList;
+        Entry& entry = this->entries[e];
+        this->freeList = entry.next;
+
+        memset(&entry.peer, 0, sizeof(Peer));
+        entry.peer.id = ((PeerId)entry.generation << 32) | e;
+        entry.peer.address = address;
+        entry.peer.firstSeen_ns = now_ns;
+        entry.peer.lastSeen_ns = now_ns;
+        entry.used = true;
+        this->index[slot] = e;
+        this->count++;
+        this->schedule(e);
+    }
+
+    // Only the time is updated, the wheel catches up when the slot comes due
+    Peer& peer = this->entries[e].peer;
+    peer.lastSeen_ns = now_ns;
+    peer.rxPackets++;
+    peer.rxBytes += bytes;
+    return &peer;
+}
+
+
+PeerTable::Peer* PeerTable::find(const struct sockaddr_in& address)
+{
+    uint32_t e = this->index[this->findSlot(address.sin_addr.s_addr, address.sin_port)];
+    return e == none ? NULL : &this->entries[e].peer;
+}
+
+
+PeerTable::Peer* PeerTable::get(PeerId id)
+{
+    uint32_t e = this->toIndex(id);
+    return e == none ? NULL : &this->entries[e].peer;
+}
+
+
+bool PeerTable::remove(PeerId id)
+{
+    uint32_t e = this->toIndex(id);
+    if (e == none)
+        return false;
+    this->release(e);
+    return true;
+}
+
+
+size_t PeerTable::expire(uint64_t now_ns)
+{
+    if (this->timeout_ns == 0)
+        return 0;
+
+    const uint64_t nowTick = now_ns / this->tick_ns;
+    if (this->currentTick == 0 || nowTick <= this->currentTick)
+    {
+        if (this->currentTick == 0)
+            this->currentTick = nowTick;
+        return 0;
+    }
+
+    // After a long gap one lap visits every slot
+    if (nowTick - this->currentTick > wheelSize)
+        this->currentTick = nowTick - wheelSize;
+
+    size_t removed = 0;
+    while (this->currentTick < nowTick)
+    {
+        this->currentTick++;
+        const uint32_t slot = this->currentTick & (wheelSize - 1);
+        uint32_t e = this->wheel[slot];
+        this->wheel[slot] = none;
+
+        while (e != none)
+        {
+            Entry& entry = this->entries[e];
+            const uint32_t next = entry.next;
+            const uint64_t dueTick = entry.dueTick;
+            entry.dueTick = 0;
+
+            if (dueTick > this->currentTick)
+            {
+                // Due on a later lap
+                entry.dueTick = dueTick;
+                entry.prev = none;
+                entry.next = this->wheel[slot];
+                if (entry.next != none)
+                    this->entries[entry.next].prev = e;
+                this->wheel[slot] = e;
+            }
+            else if (entry.peer.lastSeen_ns + this->timeout_ns <= now_ns)
+            {
+                this->release(e);
+                this->expired++;
+                removed++;
+            }
+            else
+                this->schedule(e);
+
+            e = next;
+        }
+    }
+    return removed;
+}
+
+
+std::vector<PeerTable::Peer> PeerTable::getPeers() const
+{
+    std::vector<Peer> peers;
+    peers.reserve(this->count);
+    for (size_t i = 0; i < this->entries.size(); i++)
+    {
+        if (this->entries[i].used)
+            peers.push_back(this->entries[i].peer);
+    }
+    return peers;
+}
+
+
+size_t PeerTable::size() const
+{
+    return this->count;
+}
+
+
+size_t PeerTable::capacity() const
+{
+    return this->entries.size();
+}
+
+
+uint64_t PeerTable::getRejected() const
+{
+    return this->rejected;
+}
+
+
+uint64_t PeerTable::getExpired() const
+{
+    return this->expired;
+}
+
+
+uint32_t PeerTable::hash(uint32_t addr, uint16_t port) const
+{
+    // 64 bit finalizer of MurmurHash3
+    uint64_t k = ((uint64_t)addr << 16) | port;
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return (uint32_t)k;
+}
+
+
+uint32_t PeerTable::findSlot(uint32_t addr, uint16_t port) const
+{
+    const uint32_t mask = this->index.size() - 1;
+    uint32_t slot = this->hash(addr, port) & mask;
+    while (true)
+    {
+        uint32_t e = this->index[slot];
+        if (e == none)
+            return slot;
+
+        const struct sockaddr_in& address = this->entries[e].peer.address;
+        if (address.sin_addr.s_addr == addr && address.sin_port == port)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+
+void PeerTable::release(uint32_t e)
+{
+    Entry& entry = this->entries[e];
+    const uint32_t mask = this->index.size() - 1;
+
+    // Backward shift deletion: pull later entries of the probe run into the
+    // hole unless that would move them before their home slot
+    uint32_t hole = this->findSlot(entry.peer.address.sin_addr.s_addr, entry.peer.address.sin_port);
+    this->index[hole] = none;
+    for (uint32_t slot = (hole + 1) & mask; this->index[slot] != none; slot = (slot + 1) & mask)
+    {
+        const struct sockaddr_in& address = this->entries[this->index[slot]].peer.address;
+        const uint32_t home = this->hash(address.sin_addr.s_addr, address.sin_port) & mask;
+        const bool stays = hole <= slot ? (hole < home && home <= slot) : (hole < home || home <= slot);
+        if (stays)
+            continue;
+
+        this->index[hole] = this->index[slot];
+        this->index[slot] = none;
+        hole = slot;
+    }
+
+    this->unschedule(e);
+    entry.used = false;
+    entry.generation++;
+    if (entry.generation == 0)
+        entry.generation = 1;
+    entry.next = this->freeList;
+    this->freeList = e;
+    this->count--;
+}
+
+
+void PeerTable::schedule(uint32_t e)
+{
+    if (this->timeout_ns == 0)
+        return;
+
+    Entry& entry = this->entries[e];
+    const uint64_t deadline = entry.peer.lastSeen_ns + this->timeout_ns;
+    uint64_t dueTick = (deadline + this->tick_ns - 1) / this->tick_ns;
+    if (dueTick <= this->currentTick)
+        dueTick = this->currentTick + 1;
+
+    const uint32_t slot = dueTick & (wheelSize - 1);
+    entry.dueTick = dueTick;
+    entry.prev = none;
+    entry.next = this->wheel[slot];
+    if (entry.next != none)
+        this->entries[entry.next].prev = e;
+    this->wheel[slot] = e;
+}
+
+
+void PeerTable::unschedule(uint32_t e)
+{
+    Entry& entry = this->entries[e];
+    if (entry.dueTick == 0)
+        return;
+
+    if (entry.prev != none)
+        this->entries[entry.prev].next = entry.next;
+    else
+        this->wheel[entry.dueTick & (wheelSize - 1)] = entry.next;
+    if (entry.next != none)
+        this->entries[entry.next].prev = entry.prev;
+    entry.dueTick = 0;
+}
+
+
+uint32_t PeerTable::toIndex(PeerId id) const
+{
+    const uint32_t e = (uint32_t)(id & 0xFFFFFFFF);
+    if (e >= this->entries.size() || !this->entries[e].used || this->entries[e].generation != (uint32_t)(id >> 32))
+        return none;
+    return e;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file PrerollRing.cpp
+ * @brief Lock-free ring keeping the most recent messages of a stream.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "PrerollRing.h"
+
+// STL
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// System
+#include <sys/mman.h>
+
+
+const size_t PrerollRing::cacheLine;
+
+
+PrerollRing::PrerollRing(size_t slotCount_, size_t slotSize_)
+    : slots(nullptr),
+      slotCount(0),
+      slotSize(0),
+      slotStride(0),
+      mappedSize(0),
+      head(0),
+      pushedBytes(0),
+      tooLong(0),
+      overruns(0),
+      reads(0)
+{
+    if (slotCount_ < 2 || slotSize_ == 0 || slotSize_ > UINT32_MAX)
+        return;
+
+    const size_t stride = (sizeof(Slot) + slotSize_ + cacheLine - 1) / cacheLine * cacheLine;
+    const size_t size = stride * slotCount_;
+
+    // Populated up front, so the producer never takes a page fault
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Could not map the preroll ring: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    // Anonymous memory starts zeroed, which reads as an empty slot
+    this->slots = static_cast<char*>(mapping);
+    this->slotCount = slotCount_;
+    this->slotSize = slotSize_;
+    this->slotStride = stride;
+    this->mappedSize = size;
+}
+
+
+PrerollRing::~PrerollRing()
+{
+    if (this->slots)
+        ::munmap(this->slots, this->mappedSize);
+}
+
+
+size_t PrerollRing::getSlotCount(double seconds, uint64_t rate_Bps, size_t messageSize)
+{
+    if (messageSize == 0)
+        return 2;
+    double count = std::ceil(2 * seconds * rate_Bps / messageSize);
+    return count > 2 ? static_cast<size_t>(count) : 2;
+}
+
+
+bool PrerollRing::push(const char* data, size_t length, uint64_t timestamp_ns)
+{
+    if (!this->slots || length > this->slotSize)
+    {
+        add(this->tooLong, 1);
+        return false;
+    }
+
+    // Only the producer moves the head. The odd sequence tells a reader the
+    // slot is being rewritten before any of it changes
+    const uint64_t position = this->head.load(std::memory_order_relaxed);
+    Slot* slot = this->getSlot(position);
+    slot->sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->timestamp_ns = timestamp_ns;
+    slot->length = length;
+    memcpy(reinterpret_cast<char*>(slot) + sizeof(Slot), data, length);
+
+    slot->sequence.store(2 * position + 2, std::memory_order_release);
+    this->head.store(position + 1, std::memory_order_release);
+    add(this->pushedBytes, length);
+    return true;
+}
+
+
+uint64_t PrerollRing::seek(uint64_t since_ns)
+{
+    // Timestamps only grow, the first match going forward is the oldest
+    const uint64_t head_ = this->getHead();
+    for (uint64_t position = this->getOldest(head_); position < head_; position++)
+    {
+        const Slot* slot = this->getSlot(position);
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const uint64_t timestamp_ns = slot->timestamp_ns;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Overwritten while looking, a later message will do
+        if (sequence != 2 * position + 2 || slot->sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+        if (timestamp_ns >= since_ns)
+            return position;
+    }
+    return head_;
+}
+
+
+ssize_t PrerollRing::read(uint64_t& position, char* buff, uint64_t& timestamp_ns)
+{
+    if (!this->slots)
+        return -1;
+
+    while (true)
+    {
+        const uint64_t head_ = this->getHead();
+        if (position >= head_)
+            return -1;
+
+        // Lapped, everything before the oldest message is lost
+        const uint64_t oldest = this->getOldest(head_);
+        if (position < oldest)
+        {
+            add(this->overruns, oldest - position);
+            position = oldest;
+        }
+
+        const Slot* slot = this->getSlot(position);
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence == 2 * position + 2)
+        {
+            const uint32_t length = std::min<uint32_t>(slot->length, this->slotSize);
+            timestamp_ns = slot->timestamp_ns;
+            memcpy(buff, reinterpret_cast<const char*>(slot) + sizeof(Slot), length);
+
+            // The copy counts only if the producer did not start on the slot meanwhile
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                position++;
+                add(this->reads, 1);
+                return length;
+            }
+        }
+
+        // Overwritten under us, try again from the oldest message
+        add(this->overruns, 1);
+        position++;
+    }
+}
+
+
+PrerollRing::Snapshot PrerollRing::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.pushed = this->getHead();
+    snapshot.pushedBytes = this->pushedBytes.load(std::memory_order_relaxed);
+    snapshot.tooLong = this->tooLong.load(std::memory_order_relaxed);
+    snapshot.overruns = this->overruns.load(std::memory_order_relaxed);
+    snapshot.read = this->reads.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+
+std::string PrerollRing::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "ringPushed=" << this->pushed
+        << " ringPushedBytes=" << this->pushedBytes
+        << " ringTooLong=" << this->tooLong
+        << " ringOverruns=" << this->overruns
+        << " ringRead=" << this->read;
+    return out.str();
+}
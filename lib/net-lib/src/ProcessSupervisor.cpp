@@ -0,0 +1,341 @@
+/**
+ * @file ProcessSupervisor.cpp
+ * @brief Starts, watches and stops a child process without a shell.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/18/2026 [msardonini] Optional pipe to the standard input of the child
+ */
+
+#include "ProcessSupervisor.h"
+
+// STL
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// System
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Older C libraries have no number for pidfd_open(2), it is the same on every
+// architecture
+#ifndef SYS_pidfd_open
+    #define SYS_pidfd_open 434
+#endif
+
+extern char** environ;
+
+
+namespace {
+
+uint64_t getTime_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+}
+
+
+// File name part of a path
+const char* getBaseName(const char* path)
+{
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+
+const char* toString(ProcessSupervisor::State state)
+{
+    switch (state)
+    {
+        case ProcessSupervisor::STOPPED:
+            return "stopped";
+        case ProcessSupervisor::RUNNING:
+            return "running";
+        case ProcessSupervisor::STOPPING:
+            return "stopping";
+        case ProcessSupervisor::EXITED:
+            return "exited";
+    }
+    return "unknown";
+}
+
+}  // ANONYMOUS
+
+
+ProcessSupervisor::ProcessSupervisor()
+    : state(STOPPED),
+      pid(-1),
+      pidFd(-1),
+      inputFd(-1),
+      killDeadline_ns(UINT64_MAX),
+      lastStatus(0),
+      starts(0),
+      unexpectedExits(0),
+      kills(0),
+      lastSpawn_ns(0),
+      maxSpawn_ns(0) {}
+
+
+ProcessSupervisor::~ProcessSupervisor()
+{
+    pid_t child = this->pid.load(std::memory_order_relaxed);
+    if (child > 0)
+    {
+        ::kill(-child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+    }
+    if (this->pidFd != -1)
+        ::close(this->pidFd);
+    if (this->inputFd != -1)
+        ::close(this->inputFd);
+}
+
+
+bool ProcessSupervisor::start(const std::vector<std::string>& argv, bool withInput)
+{
+    this->update();
+    State current = this->getState();
+    if (argv.empty() || current == RUNNING || current == STOPPING)
+        return false;
+
+    std::vector<char*> args;
+    for (size_t i = 0; i < argv.size(); i++)
+        args.push_back(const_cast<char*>(argv[i].c_str()));
+    args.push_back(nullptr);
+
+    // A group of its own, default handlers and no blocked signals, whatever
+    // the calling thread set up for itself
+    sigset_t signals;
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    posix_spawnattr_setpgroup(&attr, 0);
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attr, &signals);
+    sigfillset(&signals);
+    posix_spawnattr_setsigdefault(&attr, &signals);
+
+    // Both ends are close on exec, dup2() clears the flag on the copy the child
+    // reads as its standard input
+    int input[2] = {-1, -1};
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (withInput)
+    {
+        if (::pipe2(input, O_CLOEXEC) == -1)
+        {
+            std::cerr << "Could not create the input of " << argv[0] << ": " << strerror(errno) << std::endl;
+            posix_spawn_file_actions_destroy(&actions);
+            posix_spawnattr_destroy(&attr);
+            return false;
+        }
+        posix_spawn_file_actions_adddup2(&actions, input[0], STDIN_FILENO);
+    }
+
+    pid_t child;
+    uint64_t begin_ns = getTime_ns();
+    int ret = posix_spawn(&child, args[0], &actions, &attr, args.data(), environ);
+    uint64_t spawn_ns = getTime_ns() - begin_ns;
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (withInput)
+        ::close(input[0]);
+    if (ret != 0)
+    {
+        std::cerr << "Could not start " << argv[0] << ": " << strerror(ret) << std::endl;
+        if (withInput)
+            ::close(input[1]);
+        return false;
+    }
+
+    // A write never blocks the caller, a child that stopped reading fails it
+    if (withInput)
+        ::fcntl(input[1], F_SETFL, O_NONBLOCK);
+    this->inputFd = input[1];
+
+    this->pidFd = ::syscall(SYS_pidfd_open, child, 0);
+    this->killDeadline_ns = UINT64_MAX;
+    this->pid.store(child, std::memory_order_release);
+    this->state.store(RUNNING, std::memory_order_release);
+
+    add(this->starts, 1);
+    this->lastSpawn_ns.store(spawn_ns, std::memory_order_relaxed);
+    if (spawn_ns > this->maxSpawn_ns.load(std::memory_order_relaxed))
+        this->maxSpawn_ns.store(spawn_ns, std::memory_order_relaxed);
+    return true;
+}
+
+
+bool ProcessSupervisor::stop(int signal, double timeout)
+{
+    if (this->getState() != RUNNING)
+        return false;
+
+    ::kill(-this->getPid(), signal);
+    this->killDeadline_ns = getTime_ns() + static_cast<uint64_t>(timeout * 1e9);
+    this->state.store(STOPPING, std::memory_order_release);
+    return true;
+}
+
+
+bool ProcessSupervisor::writeInput(const void* data, size_t length)
+{
+    if (this->inputFd == -1)
+        return false;
+
+    // A reader that is gone raises SIGPIPE. It is blocked for this thread around
+    // the write, and taken back if the write raised it, so no handler is needed
+    sigset_t pipeSignal, previous;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous);
+
+    ssize_t ret;
+    do
+    {
+        ret = ::write(this->inputFd, data, length);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == -1 && errno == EPIPE)
+    {
+        struct timespec poll = {0, 0};
+        while (sigtimedwait(&pipeSignal, nullptr, &poll) == -1 && errno == EINTR) {}
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    return ret == static_cast<ssize_t>(length);
+}
+
+
+bool ProcessSupervisor::update()
+{
+    if (this->getPid() <= 0)
+        return false;
+    if (this->reap())
+        return true;
+
+    // It ignored the polite signal, the next update() reaps it
+    if (this->getState() == STOPPING && getTime_ns() >= this->killDeadline_ns)
+    {
+        ::kill(-this->getPid(), SIGKILL);
+        this->killDeadline_ns = UINT64_MAX;
+        add(this->kills, 1);
+    }
+    return false;
+}
+
+
+bool ProcessSupervisor::reap()
+{
+    int status;
+    pid_t child = this->getPid();
+    pid_t ret = ::waitpid(child, &status, WNOHANG);
+    if (ret == 0 || (ret == -1 && errno == EINTR))
+        return false;
+
+    // Someone else reaped it, e.g. SIGCHLD set to SIG_IGN, it is gone all the same
+    if (ret == -1)
+        status = 0;
+
+    if (this->pidFd != -1)
+        ::close(this->pidFd);
+    this->pidFd = -1;
+    if (this->inputFd != -1)
+        ::close(this->inputFd);
+    this->inputFd = -1;
+    this->lastStatus.store(status, std::memory_order_relaxed);
+    this->pid.store(-1, std::memory_order_release);
+    if (this->getState() == STOPPING)
+        this->state.store(STOPPED, std::memory_order_release);
+    else
+    {
+        add(this->unexpectedExits, 1);
+        this->state.store(EXITED, std::memory_order_release);
+    }
+    return true;
+}
+
+
+ProcessSupervisor::Snapshot ProcessSupervisor::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.state = this->getState();
+    snapshot.pid = this->getPid();
+    snapshot.lastStatus = this->lastStatus.load(std::memory_order_relaxed);
+    snapshot.starts = this->starts.load(std::memory_order_relaxed);
+    snapshot.unexpectedExits = this->unexpectedExits.load(std::memory_order_relaxed);
+    snapshot.kills = this->kills.load(std::memory_order_relaxed);
+    snapshot.lastSpawn_ns = this->lastSpawn_ns.load(std::memory_order_relaxed);
+    snapshot.maxSpawn_ns = this->maxSpawn_ns.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+
+pid_t ProcessSupervisor::findByName(const std::string& name)
+{
+    DIR* proc = ::opendir("/proc");
+    if (proc == nullptr)
+        return -1;
+
+    pid_t found = -1;
+    pid_t self = ::getpid();
+    struct dirent* entry;
+    while (found == -1 && (entry = ::readdir(proc)) != nullptr)
+    {
+        if (!isdigit(static_cast<unsigned char>(entry->d_name[0])))
+            continue;
+        pid_t candidate = strtol(entry->d_name, nullptr, 10);
+        if (candidate == self)
+            continue;
+
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%d/cmdline", static_cast<int>(candidate));
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            continue;
+        char cmdline[PATH_MAX * 2];
+        ssize_t ret = ::read(fd, cmdline, sizeof(cmdline) - 1);
+        ::close(fd);
+        if (ret <= 0)
+            continue;
+        cmdline[ret] = '\0';
+
+        // A script shows up as its interpreter with the script as the first argument
+        const char* program = cmdline;
+        size_t programLength = strlen(program);
+        const char* script = static_cast<size_t>(ret) > programLength + 1 ? program + programLength + 1 : "";
+        if (name == getBaseName(program) || name == getBaseName(script))
+            found = candidate;
+    }
+    ::closedir(proc);
+    return found;
+}
+
+
+std::string ProcessSupervisor::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "state=" << ::toString(this->state)
+        << " pid=" << this->pid
+        << " lastStatus=" << this->lastStatus
+        << " starts=" << this->starts
+        << " unexpectedExits=" << this->unexpectedExits
+        << " kills=" << this->kills
+        << " lastSpawn_ns=" << this->lastSpawn_ns
+        << " maxSpawn_ns=" << this->maxSpawn_ns;
+    return out.str();
+}
@@ -0,0 +1,480 @@
+/**
+ * @file SegmentWriter.cpp
+ * @brief Writes a long recording to disk in segments at a steady rate.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "SegmentWriter.h"
+#include "ThreadConfig.h"
+
+// STL
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// System
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+
+const size_t SegmentWriter::blockSize;
+
+
+namespace {
+
+uint64_t getTime_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+}
+
+
+uint64_t roundUp(uint64_t value, uint64_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+}  // ANONYMOUS
+
+
+SegmentWriter::Options::Options()
+    : directory("."),
+      prefix("segment"),
+      extension(""),
+      bufferSize(1024 * 1024),
+      segmentSize(1024ull * 1024 * 1024),
+      segmentDuration(0.0),
+      preallocateSize(64 * 1024 * 1024),
+      syncSize(8 * 1024 * 1024),
+      directIo(false),
+      threadRole("segment")
+{
+}
+
+
+SegmentWriter::SegmentWriter()
+    : bufferSize(0),
+      filling(0),
+      segmentBytes(0),
+      segmentStart_ns(0),
+      segmentStarted(false),
+      segmentNumber(0),
+      stopping(false),
+      fd(-1),
+      segmentDirect(false),
+      offset(0),
+      fileSize(0),
+      reserved(0),
+      syncedTo(0),
+      previousSync(0),
+      open_ns(0),
+      close_ns(0),
+      segments(0),
+      bytesWritten(0),
+      stalls(0),
+      stallTime_ns(0),
+      writeErrors(0),
+      preallocateErrors(0),
+      directIo(false)
+{
+    for (Buffer& buffer : this->buffers)
+    {
+        buffer.data = nullptr;
+        buffer.length = 0;
+        buffer.endsSegment = false;
+        buffer.full = false;
+    }
+}
+
+
+SegmentWriter::~SegmentWriter()
+{
+    this->close();
+}
+
+
+bool SegmentWriter::open(const Options& options_)
+{
+    if (this->isOpen() || options_.bufferSize == 0)
+        return false;
+    if (access(options_.directory.c_str(), W_OK) != 0)
+    {
+        std::cerr << "Cannot write segments to " << options_.directory << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Page aligned as O_DIRECT needs, and populated so the first appends
+    // do not fault
+    const size_t size = roundUp(options_.bufferSize, blockSize);
+    void* mapping = ::mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Could not map the segment buffers: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    this->options = options_;
+    this->bufferSize = size;
+    for (int i = 0; i < 2; i++)
+    {
+        Buffer& buffer = this->buffers[i];
+        buffer.data = static_cast<char*>(mapping) + i * size;
+        buffer.length = 0;
+        buffer.newSegment.clear();
+        buffer.endsSegment = false;
+        buffer.full = false;
+    }
+
+    this->filling = 0;
+    this->segmentStarted = false;
+    this->segmentNumber = 0;
+    this->stopping = false;
+    this->open_ns = getTime_ns();
+    this->close_ns = 0;
+    this->segments = 0;
+    this->bytesWritten = 0;
+    this->stalls = 0;
+    this->stallTime_ns = 0;
+    this->writeErrors = 0;
+    this->preallocateErrors = 0;
+    this->directIo = options_.directIo;
+    this->writeTime.reset();
+
+    this->thread = std::thread(&SegmentWriter::writeThread, this);
+    return true;
+}
+
+
+bool SegmentWriter::append(const char* data, size_t length)
+{
+    if (!this->isOpen())
+        return false;
+    if (length == 0)
+        return true;
+
+    // Ends the segment before the message that would not fit in it, a
+    // message longer than a whole segment gets one to itself
+    if (this->segmentStarted && this->segmentBytes > 0)
+    {
+        const bool full = this->options.segmentSize > 0 && this->segmentBytes + length > this->options.segmentSize;
+        const bool old = this->options.segmentDuration > 0.0 &&
+            getTime_ns() - this->segmentStart_ns >= this->options.segmentDuration * 1e9;
+        if (full || old)
+            this->rotate();
+    }
+    if (!this->segmentStarted)
+        this->startSegment();
+
+    // Messages do span buffers, so every buffer but the last of a segment is
+    // written whole
+    this->segmentBytes += length;
+    while (length > 0)
+    {
+        Buffer& buffer = this->buffers[this->filling];
+        const size_t chunk = std::min(length, this->bufferSize - buffer.length);
+        memcpy(buffer.data + buffer.length, data, chunk);
+        buffer.length += chunk;
+        data += chunk;
+        length -= chunk;
+        if (buffer.length == this->bufferSize)
+            this->handOff(false);
+    }
+    return true;
+}
+
+
+void SegmentWriter::rotate()
+{
+    if (!this->isOpen() || !this->segmentStarted)
+        return;
+    this->handOff(true);
+    this->segmentStarted = false;
+}
+
+
+void SegmentWriter::close()
+{
+    if (!this->isOpen())
+        return;
+
+    // The writing thread finishes every buffer handed off before it stops
+    this->rotate();
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->bufferFull.notify_one();
+    if (this->thread.joinable())
+        this->thread.join();
+
+    ::munmap(this->buffers[0].data, 2 * this->bufferSize);
+    for (Buffer& buffer : this->buffers)
+        buffer.data = nullptr;
+    this->close_ns = getTime_ns();
+}
+
+
+SegmentWriter::Snapshot SegmentWriter::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.segments = this->segments.load(std::memory_order_relaxed);
+    snapshot.bytesWritten = this->bytesWritten.load(std::memory_order_relaxed);
+    const uint64_t opened_ns = this->open_ns.load(std::memory_order_relaxed);
+    const uint64_t closed_ns = this->close_ns.load(std::memory_order_relaxed);
+    const uint64_t elapsed_ns = opened_ns ? (closed_ns ? closed_ns : getTime_ns()) - opened_ns : 0;
+    snapshot.rate_Bps = elapsed_ns ? static_cast<uint64_t>(snapshot.bytesWritten * 1e9 / elapsed_ns) : 0;
+    snapshot.stalls = this->stalls.load(std::memory_order_relaxed);
+    snapshot.stallTime_ns = this->stallTime_ns.load(std::memory_order_relaxed);
+    snapshot.writeErrors = this->writeErrors.load(std::memory_order_relaxed);
+    snapshot.preallocateErrors = this->preallocateErrors.load(std::memory_order_relaxed);
+    snapshot.directIo = this->directIo.load(std::memory_order_relaxed);
+    snapshot.writeTime = this->writeTime.getSummary();
+    return snapshot;
+}
+
+
+std::string SegmentWriter::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "segments=" << this->segments
+        << " segmentBytes=" << this->bytesWritten
+        << " segmentRate=" << this->rate_Bps << "B/s"
+        << " segmentStalls=" << this->stalls
+        << " segmentStallTime=" << this->stallTime_ns / 1000 << "us"
+        << " segmentWriteErrors=" << this->writeErrors
+        << " segmentPreallocateErrors=" << this->preallocateErrors
+        << " segmentDirectIo=" << (this->directIo ? 1 : 0)
+        << " segmentWrite " << LatencyHistogram::toString(this->writeTime);
+    return out.str();
+}
+
+
+void SegmentWriter::handOff(bool endsSegment)
+{
+    Buffer& buffer = this->buffers[this->filling];
+    buffer.endsSegment = endsSegment;
+    const int next = 1 - this->filling;
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        buffer.full = true;
+        this->bufferFull.notify_one();
+
+        // Both buffers waiting for the disk, the only place append() blocks
+        if (this->buffers[next].full)
+        {
+            const uint64_t start_ns = getTime_ns();
+            this->bufferFree.wait(lock, [this, next]() { return !this->buffers[next].full; });
+            this->stalls++;
+            this->stallTime_ns += getTime_ns() - start_ns;
+        }
+    }
+
+    this->filling = next;
+    Buffer& nextBuffer = this->buffers[next];
+    nextBuffer.length = 0;
+    nextBuffer.newSegment.clear();
+    nextBuffer.endsSegment = false;
+}
+
+
+void SegmentWriter::startSegment()
+{
+    // Named after the wall time of its first byte, numbered in case two start
+    // within a second
+    char name[64];
+    time_t now = time(nullptr);
+    struct tm local;
+    const size_t length = strftime(name, sizeof(name), "-%Y%m%d-%H%M%S-", localtime_r(&now, &local));
+    snprintf(name + length, sizeof(name) - length, "%03u", this->segmentNumber++);
+
+    this->buffers[this->filling].newSegment = this->options.directory + "/" + this->options.prefix + name +
+        this->options.extension;
+    this->segmentBytes = 0;
+    this->segmentStart_ns = getTime_ns();
+    this->segmentStarted = true;
+}
+
+
+void SegmentWriter::writeThread()
+{
+    // Apply the scheduling, pinning and name set up for this thread
+    Threading::configureThread(this->options.threadRole);
+
+    // Buffers are handed off in turn, and written in the same order
+    int next = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->bufferFull.wait(lock, [this, next]() { return this->buffers[next].full || this->stopping; });
+            if (!this->buffers[next].full)
+                break;
+        }
+
+        // The caller does not touch a full buffer, so it is written unlocked
+        this->writeBuffer(this->buffers[next]);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->buffers[next].full = false;
+        }
+        this->bufferFree.notify_one();
+        next = 1 - next;
+    }
+    this->closeSegment();
+}
+
+
+void SegmentWriter::writeBuffer(Buffer& buffer)
+{
+    if (!buffer.newSegment.empty())
+    {
+        this->closeSegment();
+        this->openSegment(buffer.newSegment);
+    }
+
+    if (this->fd >= 0 && buffer.length > 0)
+    {
+        // O_DIRECT writes whole blocks. Only the last buffer of a segment is
+        // short, the padding is trimmed when the segment is closed
+        size_t length = buffer.length;
+        if (this->segmentDirect && length % blockSize)
+        {
+            const size_t padded = roundUp(length, blockSize);
+            memset(buffer.data + length, 0, padded - length);
+            length = padded;
+        }
+
+        // Reserved a chunk at a time, at least a buffer ahead
+        if (this->offset + length + this->bufferSize > this->reserved)
+            this->preallocate(this->reserved + this->options.preallocateSize);
+
+        const uint64_t start_ns = getTime_ns();
+        size_t done = 0;
+        while (done < length)
+        {
+            const ssize_t ret = pwrite(this->fd, buffer.data + done, length - done, this->offset + done);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0)
+            {
+                // The buffer is lost either way, the next one is written after it
+                if (this->writeErrors++ == 0)
+                    std::cerr << "Could not write a segment: " << strerror(errno) << std::endl;
+                break;
+            }
+            done += ret;
+        }
+        this->writeTime.record((getTime_ns() - start_ns) / 1000);
+
+        this->offset += length;
+        this->fileSize += buffer.length;
+        if (done == length)
+            this->bytesWritten += buffer.length;
+        this->writeBack();
+    }
+
+    if (buffer.endsSegment)
+        this->closeSegment();
+}
+
+
+bool SegmentWriter::openSegment(const std::string& path)
+{
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    this->segmentDirect = this->directIo;
+    this->fd = ::open(path.c_str(), flags | (this->segmentDirect ? O_DIRECT : 0), 0644);
+
+    // tmpfs and some FUSE file systems refuse O_DIRECT, they are written
+    // through the page cache instead
+    if (this->fd < 0 && this->segmentDirect && errno == EINVAL)
+    {
+        std::cerr << "No O_DIRECT for " << path << ", writing buffered" << std::endl;
+        this->directIo = false;
+        this->segmentDirect = false;
+        this->fd = ::open(path.c_str(), flags, 0644);
+    }
+    if (this->fd < 0)
+    {
+        if (this->writeErrors++ == 0)
+            std::cerr << "Could not create " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    this->segments++;
+    this->offset = 0;
+    this->fileSize = 0;
+    this->reserved = 0;
+    this->syncedTo = 0;
+    this->previousSync = 0;
+    this->preallocate(this->options.preallocateSize);
+    return true;
+}
+
+
+void SegmentWriter::preallocate(uint64_t end)
+{
+    // Never past the end of the segment, unless a single message is longer
+    if (this->options.segmentSize > 0)
+        end = std::min(end, roundUp(this->options.segmentSize, blockSize));
+    end = std::max(end, this->offset + this->bufferSize);
+    if (end <= this->reserved)
+        return;
+
+    // The size stays as written, closeSegment() releases what is not used
+    if (fallocate(this->fd, FALLOC_FL_KEEP_SIZE, this->reserved, end - this->reserved) != 0)
+    {
+        if (this->preallocateErrors++ == 0)
+            std::cerr << "Could not reserve segment space: " << strerror(errno) << std::endl;
+
+        // Not supported or no space, the writes themselves will tell
+        end = UINT64_MAX;
+    }
+    this->reserved = end;
+}
+
+
+void SegmentWriter::writeBack()
+{
+    // O_DIRECT leaves nothing in the cache
+    if (this->segmentDirect || this->options.syncSize == 0 || this->offset - this->syncedTo < this->options.syncSize)
+        return;
+
+    sync_file_range(this->fd, this->syncedTo, this->offset - this->syncedTo, SYNC_FILE_RANGE_WRITE);
+    if (this->syncedTo > this->previousSync)
+    {
+        const uint64_t length = this->syncedTo - this->previousSync;
+        sync_file_range(this->fd, this->previousSync, length,
+            SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        posix_fadvise(this->fd, this->previousSync, length, POSIX_FADV_DONTNEED);
+    }
+    this->previousSync = this->syncedTo;
+    this->syncedTo = this->offset;
+}
+
+
+void SegmentWriter::closeSegment()
+{
+    if (this->fd < 0)
+        return;
+
+    // Writeback of the rest is only started, waiting for it would hold up
+    // the first buffers of the next segment
+    if (!this->segmentDirect && this->offset > this->syncedTo)
+        sync_file_range(this->fd, this->syncedTo, this->offset - this->syncedTo, SYNC_FILE_RANGE_WRITE);
+
+    // Drops the O_DIRECT padding and the space reserved but not written
+    if (ftruncate(this->fd, this->fileSize) != 0 && this->writeErrors++ == 0)
+        std::cerr << "Could not trim a segment: " << strerror(errno) << std::endl;
+    ::close(this->fd);
+    this->fd = -1;
+}
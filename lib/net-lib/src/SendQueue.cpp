@@ -0,0 +1,189 @@
+/**
+ * @file SendQueue.cpp
+ * @brief Prioritized queue of frames waiting to go out on a slow byte stream.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "SendQueue.h"
+
+// STL
+#include <sstream>
+
+// System
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+
+SendQueue::SendQueue(size_t maxFrames, size_t bulkWatermark)
+    : maxFrames(maxFrames > 0 ? maxFrames : 1),
+      bulkWatermark(bulkWatermark),
+      currentOffset(0),
+      currentPriority(URGENT),
+      hasCurrent(false)
+{
+    for (int i = 0; i < PRIORITY_COUNT; i++)
+        this->sent[i].store(0, std::memory_order_relaxed);
+    this->replaced.store(0, std::memory_order_relaxed);
+    this->dropped.store(0, std::memory_order_relaxed);
+    this->partialWrites.store(0, std::memory_order_relaxed);
+    this->blocked.store(0, std::memory_order_relaxed);
+}
+
+
+void SendQueue::push(Priority priority, const void* data, size_t length, bool replace)
+{
+    std::deque<std::vector<uint8_t> >& queue = this->queues[priority];
+
+    if (replace)
+    {
+        add(this->replaced, queue.size());
+        while (!queue.empty())
+        {
+            this->recycle(queue.front());
+            queue.pop_front();
+        }
+    }
+    else if (queue.size() >= this->maxFrames)
+    {
+        add(this->dropped, 1);
+        this->recycle(queue.front());
+        queue.pop_front();
+    }
+
+    queue.push_back(std::vector<uint8_t>());
+    if (!this->spares.empty())
+    {
+        queue.back().swap(this->spares.back());
+        this->spares.pop_back();
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    queue.back().assign(bytes, bytes + length);
+}
+
+
+SendQueue::Result SendQueue::flush(int fd)
+{
+    while (true)
+    {
+        if (!this->hasCurrent)
+        {
+            int priority = 0;
+            while (priority < PRIORITY_COUNT && this->queues[priority].empty())
+                priority++;
+            if (priority == PRIORITY_COUNT)
+                return FLUSHED;
+
+            // Bytes handed to the kernel go out in order, keep bulk out of the
+            // way of anything more urgent pushed while it drains
+            if (priority == BULK && this->bulkWatermark > 0)
+            {
+                int pending = 0;
+                if (ioctl(fd, TIOCOUTQ, &pending) == 0 && static_cast<size_t>(pending) >= this->bulkWatermark)
+                    return THROTTLED;
+            }
+
+            this->current.swap(this->queues[priority].front());
+            this->recycle(this->queues[priority].front());
+            this->queues[priority].pop_front();
+            this->currentOffset = 0;
+            this->currentPriority = static_cast<Priority>(priority);
+            this->hasCurrent = true;
+        }
+
+        ssize_t ret = ::write(fd, this->current.data() + this->currentOffset,
+            this->current.size() - this->currentOffset);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                add(this->blocked, 1);
+                return BLOCKED;
+            }
+            return FAILED;
+        }
+
+        this->currentOffset += static_cast<size_t>(ret);
+        if (this->currentOffset < this->current.size())
+        {
+            add(this->partialWrites, 1);
+            continue;
+        }
+
+        add(this->sent[this->currentPriority], 1);
+        this->recycle(this->current);
+        this->hasCurrent = false;
+    }
+}
+
+
+bool SendQueue::isEmpty() const
+{
+    if (this->hasCurrent)
+        return false;
+    for (int i = 0; i < PRIORITY_COUNT; i++)
+    {
+        if (!this->queues[i].empty())
+            return false;
+    }
+    return true;
+}
+
+
+void SendQueue::clear()
+{
+    for (int i = 0; i < PRIORITY_COUNT; i++)
+    {
+        while (!this->queues[i].empty())
+        {
+            this->recycle(this->queues[i].front());
+            this->queues[i].pop_front();
+        }
+    }
+    if (this->hasCurrent)
+        this->recycle(this->current);
+    this->hasCurrent = false;
+}
+
+
+SendQueue::Snapshot SendQueue::getSnapshot() const
+{
+    Snapshot snapshot;
+    for (int i = 0; i < PRIORITY_COUNT; i++)
+        snapshot.sent[i] = this->sent[i].load(std::memory_order_relaxed);
+    snapshot.replaced = this->replaced.load(std::memory_order_relaxed);
+    snapshot.dropped = this->dropped.load(std::memory_order_relaxed);
+    snapshot.partialWrites = this->partialWrites.load(std::memory_order_relaxed);
+    snapshot.blocked = this->blocked.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+
+void SendQueue::recycle(std::vector<uint8_t>& frame)
+{
+    if (frame.capacity() == 0 || this->spares.size() >= this->maxFrames)
+        return;
+    this->spares.push_back(std::vector<uint8_t>());
+    this->spares.back().swap(frame);
+}
+
+
+std::string SendQueue::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "sentUrgent=" << this->sent[URGENT]
+        << " sentStatus=" << this->sent[STATUS]
+        << " sentBulk=" << this->sent[BULK]
+        << " replaced=" << this->replaced
+        << " dropped=" << this->dropped
+        << " partialWrites=" << this->partialWrites
+        << " blocked=" << this->blocked;
+    return out.str();
+}
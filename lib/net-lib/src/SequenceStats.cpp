@@ -0,0 +1,106 @@
+/**
+ * @file SequenceStats.cpp
+ * @brief Loss, reordering and duplicate counters for a sequence numbered stream.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "SequenceStats.h"
+
+#include <sstream>
+
+
+const uint32_t SequenceStats::windowSize;
+
+
+SequenceStats::SequenceStats()
+{
+    this->reset();
+}
+
+
+SequenceStats::Result SequenceStats::record(uint32_t sequence)
+{
+    const uint32_t current = this->highest.load(std::memory_order_relaxed);
+
+    // Distance from the highest, signed so it survives the wrap around
+    const int32_t distance = static_cast<int32_t>(sequence - current);
+
+    // Too old to be a late message, the peer started counting again
+    const bool restarted = this->started && distance <= -static_cast<int32_t>(windowSize);
+    if (!this->started || restarted)
+    {
+        if (restarted)
+            add(this->restarts, 1);
+        this->started = true;
+        this->window = 1;
+        this->highest.store(sequence, std::memory_order_relaxed);
+        add(this->received, 1);
+        return restarted ? RESTARTED : NEW;
+    }
+
+    if (distance > 0)
+    {
+        // Everything skipped over is lost until it turns up
+        this->window = distance < static_cast<int32_t>(windowSize) ? (this->window << distance) | 1 : 1;
+        this->highest.store(sequence, std::memory_order_relaxed);
+        add(this->lost, distance - 1);
+        add(this->received, 1);
+        return NEW;
+    }
+
+    const uint64_t bit = 1ull << -distance;
+    if (this->window & bit)
+    {
+        add(this->duplicates, 1);
+        return DUPLICATE;
+    }
+
+    this->window |= bit;
+    add(this->lost, -1);
+    add(this->reordered, 1);
+    add(this->received, 1);
+    return REORDERED;
+}
+
+
+SequenceStats::Snapshot SequenceStats::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.received = this->received.load(std::memory_order_relaxed);
+    snapshot.lost = this->lost.load(std::memory_order_relaxed);
+    snapshot.reordered = this->reordered.load(std::memory_order_relaxed);
+    snapshot.duplicates = this->duplicates.load(std::memory_order_relaxed);
+    snapshot.restarts = this->restarts.load(std::memory_order_relaxed);
+    snapshot.highest = this->highest.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+
+void SequenceStats::reset()
+{
+    this->received.store(0, std::memory_order_relaxed);
+    this->lost.store(0, std::memory_order_relaxed);
+    this->reordered.store(0, std::memory_order_relaxed);
+    this->duplicates.store(0, std::memory_order_relaxed);
+    this->restarts.store(0, std::memory_order_relaxed);
+    this->highest.store(0, std::memory_order_relaxed);
+    this->window = 0;
+    this->started = false;
+}
+
+
+std::string SequenceStats::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "seqReceived=" << this->received
+        << " seqLost=" << this->lost
+        << " seqReordered=" << this->reordered
+        << " seqDuplicates=" << this->duplicates
+        << " seqRestarts=" << this->restarts
+        << " seqHighest=" << this->highest;
+    return out.str();
+}
@@ -0,0 +1,480 @@
+/**
+ * @file ShmRing.cpp
+ * @brief Shared memory ring of messages between processes on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "ShmRing.h"
+
+// STL
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+// System
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Older C libraries have no wrapper or flags for memfd_create(2)
+#ifndef MFD_CLOEXEC
+    #define MFD_CLOEXEC 0x0001U
+    #define MFD_ALLOW_SEALING 0x0002U
+#endif
+
+
+namespace {
+
+const uint32_t ringMagic = 0x474E4952;  // "RING"
+const uint32_t ringVersion = 1;
+
+const uint32_t cursorFree = 0;
+const uint32_t cursorJoining = 1;
+const uint32_t cursorSubscribed = 2;
+
+}  // ANONYMOUS
+
+
+const uint32_t ShmRing::maxConsumers;
+const size_t ShmRing::cacheLine;
+
+
+ShmRing::ShmRing()
+    : fd(-1),
+      header(nullptr),
+      mappedSize(0),
+      slots(nullptr),
+      slotStride(0),
+      producer(false),
+      consumer(-1),
+      claimed(false),
+      peeked(false),
+      interrupted(false) {}
+
+
+ShmRing::~ShmRing()
+{
+    this->close();
+}
+
+
+bool ShmRing::create(const std::string& name, size_t slotCount, size_t slotSize)
+{
+    if (this->fd != -1 || slotCount == 0 || slotSize == 0 || slotCount > UINT32_MAX || slotSize > UINT32_MAX)
+        return false;
+
+    int memfd = ::syscall(SYS_memfd_create, name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd == -1)
+    {
+        std::cerr << "Could not create shared memory '" << name << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    const size_t stride = (sizeof(Slot) + slotSize + cacheLine - 1) / cacheLine * cacheLine;
+    const size_t size = sizeof(Header) + stride * slotCount;
+    if (::ftruncate(memfd, size) == -1)
+    {
+        std::cerr << "Could not size shared memory: " << strerror(errno) << std::endl;
+        ::close(memfd);
+        return false;
+    }
+
+    // Consumers must not be able to shrink the ring under the producer
+    #ifdef F_ADD_SEALS
+        if (::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1)
+            std::cerr << "Could not seal shared memory: " << strerror(errno) << std::endl;
+    #endif
+
+    if (!this->map(memfd, size))
+    {
+        ::close(memfd);
+        return false;
+    }
+
+    // The memfd starts zeroed, which is a valid state for every atomic
+    this->header->slotCount = slotCount;
+    this->header->slotSize = slotSize;
+    this->header->mappedSize = size;
+    this->header->version = ringVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = ringMagic;
+
+    this->slotStride = stride;
+    this->producer = true;
+    return true;
+}
+
+
+bool ShmRing::attach(int fd_)
+{
+    if (this->fd != -1)
+        return false;
+
+    struct stat status;
+    if (::fstat(fd_, &status) == -1 || (size_t)status.st_size < sizeof(Header))
+    {
+        std::cerr << "Not a shared memory ring" << std::endl;
+        return false;
+    }
+
+    int dup = ::fcntl(fd_, F_DUPFD_CLOEXEC, 0);
+    if (dup == -1 || !this->map(dup, status.st_size))
+    {
+        if (dup != -1)
+            ::close(dup);
+        return false;
+    }
+
+    const Header* shared = this->header;
+    const size_t stride = (sizeof(Slot) + shared->slotSize + cacheLine - 1) / cacheLine * cacheLine;
+    if (shared->magic != ringMagic || shared->version != ringVersion || shared->slotCount == 0
+        || shared->mappedSize != (size_t)status.st_size
+        || sizeof(Header) + stride * shared->slotCount != (size_t)status.st_size)
+    {
+        std::cerr << "Not a shared memory ring" << std::endl;
+        this->close();
+        return false;
+    }
+
+    this->slotStride = stride;
+    this->producer = false;
+    return true;
+}
+
+
+void ShmRing::close()
+{
+    this->unsubscribe();
+
+    if (this->header)
+        ::munmap(this->header, this->mappedSize);
+    if (this->fd != -1)
+        ::close(this->fd);
+
+    this->fd = -1;
+    this->header = nullptr;
+    this->mappedSize = 0;
+    this->slots = nullptr;
+    this->producer = false;
+    this->claimed = false;
+}
+
+
+int ShmRing::getFd() const
+{
+    return this->fd;
+}
+
+
+size_t ShmRing::getSlotSize() const
+{
+    return this->header ? this->header->slotSize : 0;
+}
+
+
+size_t ShmRing::getSlotCount() const
+{
+    return this->header ? this->header->slotCount : 0;
+}
+
+
+char* ShmRing::claim(double timeout)
+{
+    if (!this->producer)
+        return NULL;
+
+    // Only the producer moves writeSeq
+    const uint64_t seq = this->header->writeSeq.load(std::memory_order_relaxed);
+    const uint64_t deadline_ns = getDeadline(timeout);
+    while (true)
+    {
+        uint32_t value = this->header->spaceFutex.load(std::memory_order_acquire);
+        if (seq - this->getOldestRead(false) < this->header->slotCount)
+            break;
+        if (this->interrupted)
+            return NULL;
+
+        // Full, so the slowest consumer may be one that died
+        this->header->spaceWaiters.fetch_add(1, std::memory_order_seq_cst);
+        bool waited = seq - this->getOldestRead(true) < this->header->slotCount
+            || this->wait(this->header->spaceFutex, value, deadline_ns);
+        this->header->spaceWaiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (!waited || this->interrupted)
+            return NULL;
+    }
+
+    this->claimed = true;
+    return (char*)this->getSlot(seq) + sizeof(Slot);
+}
+
+
+bool ShmRing::publish(size_t length)
+{
+    if (!this->claimed || length > this->header->slotSize)
+        return false;
+
+    const uint64_t seq = this->header->writeSeq.load(std::memory_order_relaxed);
+    this->getSlot(seq)->length = length;
+    this->header->writeSeq.store(seq + 1, std::memory_order_release);
+    this->claimed = false;
+
+    // Waiters count themselves before sleeping, so this only costs a system
+    // call when a consumer is actually asleep
+    this->header->dataFutex.fetch_add(1, std::memory_order_seq_cst);
+    if (this->header->dataWaiters.load(std::memory_order_seq_cst) > 0)
+        wake(this->header->dataFutex);
+    return true;
+}
+
+
+bool ShmRing::send(const char* buff, size_t length, double timeout)
+{
+    if (!this->header || length > this->header->slotSize)
+        return false;
+
+    char* slot = this->claim(timeout);
+    if (!slot)
+        return false;
+    memcpy(slot, buff, length);
+    return this->publish(length);
+}
+
+
+bool ShmRing::subscribe()
+{
+    if (!this->header || this->consumer != -1)
+        return false;
+
+    for (uint32_t i = 0; i < maxConsumers; i++)
+    {
+        Cursor& cursor = this->header->consumers[i];
+        uint32_t expected = cursorFree;
+        if (!cursor.state.compare_exchange_strong(expected, cursorJoining))
+            continue;
+
+        // The producer ignores the cursor until it points at a valid message
+        cursor.pid.store(getpid(), std::memory_order_relaxed);
+        cursor.readSeq.store(this->header->writeSeq.load(std::memory_order_acquire), std::memory_order_relaxed);
+        cursor.state.store(cursorSubscribed, std::memory_order_release);
+        this->consumer = i;
+        return true;
+    }
+
+    std::cerr << "No free consumer place in the shared memory ring" << std::endl;
+    return false;
+}
+
+
+void ShmRing::unsubscribe()
+{
+    if (!this->header || this->consumer == -1)
+        return;
+
+    this->header->consumers[this->consumer].state.store(cursorFree, std::memory_order_release);
+    this->consumer = -1;
+    this->peeked = false;
+
+    // The producer may be waiting on this consumer
+    this->header->spaceFutex.fetch_add(1, std::memory_order_seq_cst);
+    if (this->header->spaceWaiters.load(std::memory_order_seq_cst) > 0)
+        wake(this->header->spaceFutex);
+}
+
+
+const char* ShmRing::peek(size_t& length, double timeout)
+{
+    if (!this->header || this->consumer == -1)
+        return NULL;
+
+    Cursor& cursor = this->header->consumers[this->consumer];
+    if (cursor.state.load(std::memory_order_relaxed) != cursorSubscribed)
+    {
+        // The producer took us for dead
+        this->consumer = -1;
+        return NULL;
+    }
+
+    const uint64_t seq = cursor.readSeq.load(std::memory_order_relaxed);
+    const uint64_t deadline_ns = getDeadline(timeout);
+    while (true)
+    {
+        uint32_t value = this->header->dataFutex.load(std::memory_order_acquire);
+        if (this->header->writeSeq.load(std::memory_order_acquire) > seq)
+            break;
+        if (this->interrupted)
+            return NULL;
+
+        this->header->dataWaiters.fetch_add(1, std::memory_order_seq_cst);
+        bool waited = this->header->writeSeq.load(std::memory_order_seq_cst) > seq
+            || this->wait(this->header->dataFutex, value, deadline_ns);
+        this->header->dataWaiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (!waited)
+            return NULL;
+    }
+
+    const Slot* slot = this->getSlot(seq);
+    length = slot->length;
+    this->peeked = true;
+    return (const char*)slot + sizeof(Slot);
+}
+
+
+void ShmRing::release()
+{
+    if (!this->peeked || this->consumer == -1)
+        return;
+    this->peeked = false;
+
+    Cursor& cursor = this->header->consumers[this->consumer];
+    cursor.readSeq.fetch_add(1, std::memory_order_release);
+
+    this->header->spaceFutex.fetch_add(1, std::memory_order_seq_cst);
+    if (this->header->spaceWaiters.load(std::memory_order_seq_cst) > 0)
+        wake(this->header->spaceFutex);
+}
+
+
+ssize_t ShmRing::receive(char* buff, size_t size, double timeout)
+{
+    size_t length;
+    const char* message = this->peek(length, timeout);
+    if (!message)
+        return -1;
+
+    if (length > size)
+        length = size;
+    memcpy(buff, message, length);
+    this->release();
+    return length;
+}
+
+
+void ShmRing::interrupt()
+{
+    this->interrupted = true;
+    if (!this->header)
+        return;
+
+    // Changing the values fails any wait about to start
+    this->header->dataFutex.fetch_add(1, std::memory_order_seq_cst);
+    this->header->spaceFutex.fetch_add(1, std::memory_order_seq_cst);
+    wake(this->header->dataFutex);
+    wake(this->header->spaceFutex);
+}
+
+
+void ShmRing::clearInterrupt()
+{
+    this->interrupted = false;
+}
+
+
+uint64_t ShmRing::getPublished() const
+{
+    return this->header ? this->header->writeSeq.load(std::memory_order_acquire) : 0;
+}
+
+
+bool ShmRing::map(int fd_, size_t size)
+{
+    void* mapping = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Could not map shared memory: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    this->fd = fd_;
+    this->header = (Header*)mapping;
+    this->mappedSize = size;
+    this->slots = (char*)mapping + sizeof(Header);
+    return true;
+}
+
+
+ShmRing::Slot* ShmRing::getSlot(uint64_t seq) const
+{
+    return (Slot*)(this->slots + (seq % this->header->slotCount) * this->slotStride);
+}
+
+
+uint64_t ShmRing::getOldestRead(bool dropDead)
+{
+    const uint64_t writeSeq = this->header->writeSeq.load(std::memory_order_relaxed);
+    uint64_t oldest = writeSeq;
+    for (uint32_t i = 0; i < maxConsumers; i++)
+    {
+        Cursor& cursor = this->header->consumers[i];
+        if (cursor.state.load(std::memory_order_acquire) != cursorSubscribed)
+            continue;
+
+        const uint64_t readSeq = cursor.readSeq.load(std::memory_order_acquire);
+        if (readSeq >= oldest)
+            continue;
+
+        // A consumer that died holding its place would stall the ring forever
+        const pid_t pid = cursor.pid.load(std::memory_order_relaxed);
+        if (dropDead && ::kill(pid, 0) == -1 && errno == ESRCH)
+        {
+            std::cerr << "Dropping consumer " << pid << " of the shared memory ring, process is gone" << std::endl;
+            cursor.state.store(cursorFree, std::memory_order_release);
+            continue;
+        }
+        oldest = readSeq;
+    }
+    return oldest;
+}
+
+
+bool ShmRing::wait(std::atomic<uint32_t>& futex, uint32_t value, uint64_t deadline_ns)
+{
+    struct timespec timeout;
+    struct timespec* timeoutPtr = NULL;
+    if (deadline_ns > 0)
+    {
+        const uint64_t now_ns = getTime_ns();
+        if (now_ns >= deadline_ns)
+            return false;
+        timeout.tv_sec = (deadline_ns - now_ns) / 1000000000ull;
+        timeout.tv_nsec = (deadline_ns - now_ns) % 1000000000ull;
+        timeoutPtr = &timeout;
+    }
+
+    // Shared between processes, so not FUTEX_PRIVATE_FLAG
+    if (::syscall(SYS_futex, (uint32_t*)&futex, FUTEX_WAIT, value, timeoutPtr, NULL, 0) == -1
+        && errno == ETIMEDOUT)
+        return false;
+    return !this->interrupted;
+}
+
+
+void ShmRing::wake(std::atomic<uint32_t>& futex)
+{
+    ::syscall(SYS_futex, (uint32_t*)&futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+
+uint64_t ShmRing::getTime_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+
+uint64_t ShmRing::getDeadline(double timeout)
+{
+    return timeout > 0 ? getTime_ns() + (uint64_t)(timeout * 1e9) : 0;
+}
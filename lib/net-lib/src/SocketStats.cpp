@@ -0,0 +1,140 @@
+/**
+ * @file SocketStats.cpp
+ * @brief Traffic, error and drop counters for a socket.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/19/2026 [msardonini] Kernel drops accumulate across reset() and new sockets
+ */
+
+#include "SocketStats.h"
+
+#include <sstream>
+
+
+SocketStats::SocketStats()
+{
+    this->rx.kernelDropsSeen = 0;
+    this->reset();
+}
+
+
+void SocketStats::onReceive(size_t bytes)
+{
+    add(this->rx.packets, 1);
+    add(this->rx.bytes, bytes);
+}
+
+
+void SocketStats::onReceiveError(int error)
+{
+    add(this->rx.errors, 1);
+    this->countError(error);
+}
+
+
+void SocketStats::onKernelDrops(uint32_t dropped)
+{
+    // The kernel reports a running total for the socket, which survives
+    // reset() and wraps at 32 bits
+    add(this->rx.kernelDrops, static_cast<uint32_t>(dropped - this->rx.kernelDropsSeen));
+    this->rx.kernelDropsSeen = dropped;
+}
+
+
+void SocketStats::onSocketOpened()
+{
+    this->rx.kernelDropsSeen = 0;
+}
+
+
+void SocketStats::onHandler(uint64_t elapsed_ns)
+{
+    add(this->rx.handlerCalls, 1);
+    add(this->rx.handlerTime_ns, elapsed_ns);
+    if (elapsed_ns > this->rx.handlerMaxTime_ns.load(std::memory_order_relaxed))
+        this->rx.handlerMaxTime_ns.store(elapsed_ns, std::memory_order_relaxed);
+}
+
+
+void SocketStats::onSend(size_t bytes)
+{
+    this->tx.packets.fetch_add(1, std::memory_order_relaxed);
+    this->tx.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+
+void SocketStats::onSendError(int error)
+{
+    this->tx.errors.fetch_add(1, std::memory_order_relaxed);
+    this->countError(error);
+}
+
+
+void SocketStats::countError(int error)
+{
+    if (error < 0 || error > SOCKET_STATS_MAX_ERRNO)
+        error = SOCKET_STATS_MAX_ERRNO;
+    this->errnoCounts[error].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+SocketStats::Snapshot SocketStats::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.rxPackets = this->rx.packets.load(std::memory_order_relaxed);
+    snapshot.rxBytes = this->rx.bytes.load(std::memory_order_relaxed);
+    snapshot.rxErrors = this->rx.errors.load(std::memory_order_relaxed);
+    snapshot.kernelDrops = this->rx.kernelDrops.load(std::memory_order_relaxed);
+    snapshot.handlerCalls = this->rx.handlerCalls.load(std::memory_order_relaxed);
+    snapshot.handlerTime_ns = this->rx.handlerTime_ns.load(std::memory_order_relaxed);
+    snapshot.handlerMaxTime_ns = this->rx.handlerMaxTime_ns.load(std::memory_order_relaxed);
+    snapshot.txPackets = this->tx.packets.load(std::memory_order_relaxed);
+    snapshot.txBytes = this->tx.bytes.load(std::memory_order_relaxed);
+    snapshot.txErrors = this->tx.errors.load(std::memory_order_relaxed);
+
+    for (int i = 0; i <= SOCKET_STATS_MAX_ERRNO; i++)
+    {
+        uint64_t count = this->errnoCounts[i].load(std::memory_order_relaxed);
+        if (count)
+            snapshot.errors[i] = count;
+    }
+    return snapshot;
+}
+
+
+void SocketStats::reset()
+{
+    this->rx.packets.store(0, std::memory_order_relaxed);
+    this->rx.bytes.store(0, std::memory_order_relaxed);
+    this->rx.errors.store(0, std::memory_order_relaxed);
+    this->rx.kernelDrops.store(0, std::memory_order_relaxed);
+    this->rx.handlerCalls.store(0, std::memory_order_relaxed);
+    this->rx.handlerTime_ns.store(0, std::memory_order_relaxed);
+    this->rx.handlerMaxTime_ns.store(0, std::memory_order_relaxed);
+    this->tx.packets.store(0, std::memory_order_relaxed);
+    this->tx.bytes.store(0, std::memory_order_relaxed);
+    this->tx.errors.store(0, std::memory_order_relaxed);
+    for (int i = 0; i <= SOCKET_STATS_MAX_ERRNO; i++)
+        this->errnoCounts[i].store(0, std::memory_order_relaxed);
+}
+
+
+std::string SocketStats::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "rx=" << this->rxPackets
+        << " rxBytes=" << this->rxBytes
+        << " rxErrors=" << this->rxErrors
+        << " kernelDrops=" << this->kernelDrops
+        << " tx=" << this->txPackets
+        << " txBytes=" << this->txBytes
+        << " txErrors=" << this->txErrors
+        << " handlerAvg_ns=" << (this->handlerCalls ? this->handlerTime_ns / this->handlerCalls : 0)
+        << " handlerMax_ns=" << this->handlerMaxTime_ns;
+    for (std::map<int, uint64_t>::const_iterator it = this->errors.begin(); it != this->errors.end(); ++it)
+        out << " errno" << it->first << "=" << it->second;
+    return out.str();
+}
@@ -0,0 +1,199 @@
+/**
+ * @file StreamFramer.cpp
+ * @brief Finds frames in a byte stream, e.g. a serial port.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/18/2026 [msardonini] Added variable length frames
+ */
+
+#include "StreamFramer.h"
+
+// STL
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+// System
+#include <unistd.h>
+
+
+StreamFramer::StreamFramer(size_t frameSize, const uint8_t* header, size_t headerSize,
+    Validator validator, size_t capacity)
+    : StreamFramer(frameSize, headerSize, header, headerSize, nullptr, validator, capacity) {}
+
+
+StreamFramer::StreamFramer(size_t maxFrameSize, size_t sizeBytes, const uint8_t* header, size_t headerSize,
+    Sizer sizer, Validator validator, size_t capacity)
+    : frameSize(maxFrameSize),
+      sizeBytes(sizeBytes),
+      header(header, header + headerSize),
+      sizer(sizer),
+      validator(validator),
+      mask(0),
+      head(0),
+      tail(0),
+      discarding(false)
+{
+    size_t size = 1;
+    while (size < capacity || size < 2 * frameSize)
+        size <<= 1;
+    this->mask = size - 1;
+    this->ring.resize(size + frameSize - 1);
+
+    this->frames.store(0, std::memory_order_relaxed);
+    this->discardedBytes.store(0, std::memory_order_relaxed);
+    this->resyncs.store(0, std::memory_order_relaxed);
+    this->invalidFrames.store(0, std::memory_order_relaxed);
+}
+
+
+uint8_t* StreamFramer::getWriteBuffer(size_t* space)
+{
+    const size_t capacity = this->mask + 1;
+    const size_t position = this->tail & this->mask;
+    *space = std::min(capacity - this->getBuffered(), capacity - position);
+    return &this->ring[position];
+}
+
+
+void StreamFramer::commitWrite(size_t length)
+{
+    // Bytes landing at the start of the ring are mirrored past its end, so
+    // a frame that wraps can be read in one piece
+    const size_t position = this->tail & this->mask;
+    const size_t mirrored = this->frameSize - 1;
+    if (position < mirrored)
+    {
+        const size_t end = std::min(position + length, mirrored);
+        memcpy(&this->ring[this->mask + 1 + position], &this->ring[position], end - position);
+    }
+    this->tail += length;
+}
+
+
+ssize_t StreamFramer::readFrom(int fd)
+{
+    size_t space;
+    uint8_t* buf = this->getWriteBuffer(&space);
+    if (space == 0)
+        return 0;
+
+    ssize_t ret = read(fd, buf, space);
+    if (ret > 0)
+        this->commitWrite(static_cast<size_t>(ret));
+    return ret;
+}
+
+
+const uint8_t* StreamFramer::next()
+{
+    size_t length;
+    return this->next(&length);
+}
+
+
+const uint8_t* StreamFramer::next(size_t* length)
+{
+    const size_t capacity = this->mask + 1;
+    while (this->getBuffered() > 0)
+    {
+        const size_t position = this->head & this->mask;
+        const uint8_t* p = &this->ring[position];
+
+        // Skip straight to the next byte that could start a header
+        const size_t contiguous = std::min(this->getBuffered(), capacity - position);
+        const uint8_t* found = static_cast<const uint8_t*>(memchr(p, this->header[0], contiguous));
+        if (found != p)
+        {
+            this->discard(found ? static_cast<size_t>(found - p) : contiguous);
+            continue;
+        }
+
+        if (this->getBuffered() < this->header.size())
+            return nullptr;
+        if (memcmp(p, this->header.data(), this->header.size()) != 0)
+        {
+            this->discard(1);
+            continue;
+        }
+
+        size_t size = this->frameSize;
+        if (this->sizer)
+        {
+            if (this->getBuffered() < this->sizeBytes)
+                return nullptr;
+            size = this->sizer(p);
+            if (size == 0)
+            {
+                this->discard(1);
+                continue;
+            }
+            if (size < this->sizeBytes || size > this->frameSize)
+            {
+                add(this->invalidFrames, 1);
+                this->discard(1);
+                continue;
+            }
+        }
+
+        if (this->getBuffered() < size)
+            return nullptr;
+        if (this->validator && !this->validator(p, size))
+        {
+            add(this->invalidFrames, 1);
+            this->discard(1);
+            continue;
+        }
+
+        *length = size;
+        this->head += size;
+        this->discarding = false;
+        add(this->frames, 1);
+        return p;
+    }
+    return nullptr;
+}
+
+
+StreamFramer::Snapshot StreamFramer::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.frames = this->frames.load(std::memory_order_relaxed);
+    snapshot.discardedBytes = this->discardedBytes.load(std::memory_order_relaxed);
+    snapshot.resyncs = this->resyncs.load(std::memory_order_relaxed);
+    snapshot.invalidFrames = this->invalidFrames.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+
+void StreamFramer::clear()
+{
+    this->head = this->tail;
+    this->discarding = false;
+}
+
+
+void StreamFramer::discard(size_t length)
+{
+    this->head += length;
+    add(this->discardedBytes, length);
+    if (!this->discarding)
+    {
+        this->discarding = true;
+        add(this->resyncs, 1);
+    }
+}
+
+
+std::string StreamFramer::Snapshot::toString() const
+{
+    std::ostringstream out;
+    out << "frames=" << this->frames
+        << " discardedBytes=" << this->discardedBytes
+        << " resyncs=" << this->resyncs
+        << " invalidFrames=" << this->invalidFrames;
+    return out.str();
+}
@@ -6,6 +6,7 @@
  *
  * Updates:
  * 01/30/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Sockets are closed on exec, spawned processes do not inherit them
  */
 
 #include "TcpClient.h"
@@ -40,7 +41,7 @@ bool TcpClient::connect(const std::string& address_, int port_)
         else
             this->address = address_;
 
-        this->sock = ::socket(AF_INET, SOCK_STREAM, 0);
+        this->sock = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
         if (this->sock == -1)
         {
             std::cerr << "Could not connect socket: " << strerror(errno) << std::endl;
@@ -116,3 +117,8 @@ bool TcpClient::isAlive() const
     return this->alive;
 }
 
+
+int TcpClient::getSocket() const
+{
+    return this->sock;
+}
@@ -6,20 +6,15 @@
  *
  * Updates:
  * 01/30/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Split into TcpServerBase and BasicTcpServer<Handler>
+ * 10/18/2026 [msardonini] Added traffic capture
+ * 10/18/2026 [msardonini] Sockets are closed on exec, spawned processes do not inherit them
  */
 
 #include "TcpServer.h"
 
 
-void* tcpServerRunTrampoline(void* args)
-{
-    TcpServer::ThreadArgs* threadArgs = (TcpServer::ThreadArgs*)args;
-	threadArgs->thisPtr->run(threadArgs->task, threadArgs->timeoutClientAccept, threadArgs->timeoutClientBoot);
-    return NULL;
-}
-
-
-TcpServer::TcpServer()
+TcpServerBase::TcpServerBase()
     : timeoutClientAccept(0),
       timeoutClientBoot(0),
       sockServer(-1),
@@ -31,33 +26,21 @@ TcpServer::TcpServer()
       clientAlive(false),
       running(false),
       time2Exit(false),
-      tid(-1) {}
+      wakeFd(Networking::createWakeup()),
+      tid(-1),
+      threadRole("server") {}
 
 
-TcpServer::TcpServer(std::function<bool(int)> task_, const std::string& address_,
-    int port_, double timeoutClientAccept_, double timeoutClientBoot_,
-    bool multicast_)
-    : timeoutClientAccept(0),
-      timeoutClientBoot(0),
-      sockServer(-1),
-      sockClient(-1),
-      addressServer(""),
-      addressClient(""),
-      port(0),
-      serverAlive(false),
-      clientAlive(false),
-      running(false),
-      time2Exit(false),
-      tid(-1)
+TcpServerBase::~TcpServerBase()
 {
-    if (this->connect(address_, port_, multicast_))
-        this->runInThread(task_, timeoutClientAccept_, timeoutClientBoot_);
-    else
-        std::cerr << "Could not establish a connection on '" << address_ << "' port '" << port_ << "'" << std::endl;
+    this->disconnect();
+
+    if (this->wakeFd != -1)
+        ::close(this->wakeFd);
 }
 
 
-bool TcpServer::connect(const std::string& address_, int port_, bool multicast_)
+bool TcpServerBase::connect(const std::string& address_, int port_, bool multicast_)
 {
     this->addressServer = address_;
     this->port = port_;
@@ -67,7 +50,7 @@ bool TcpServer::connect(const std::string& address_, int port_, bool multicast_)
         this->addressServer = "127.0.0.1";
 
     // Create the socket
-    this->sockServer = ::socket(AF_INET, SOCK_STREAM, 0);
+    this->sockServer = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (this->sockServer == -1)
     {
         std::cerr << "Could not connect socket: " << strerror(errno) << std::endl;
@@ -128,12 +111,13 @@ bool TcpServer::connect(const std::string& address_, int port_, bool multicast_)
 }
 
 
-bool TcpServer::disconnect()
+bool TcpServerBase::disconnect()
 {
     if (this->running)
     {
-        // Give the go-ahead to exit
+        // Give the go-ahead to exit and wake the loop if it is waiting
 	    this->time2Exit = true;
+        Networking::signalWakeup(this->wakeFd);
    
 	    // Wait for exit
         void *returnValue;
@@ -151,7 +135,10 @@ bool TcpServer::disconnect()
             return false;
         }
         else
+        {
+            Networking::clearWakeup(this->wakeFd);
             time2Exit = false;
+        }
     }
 
     if (this->sockServer != -1)
@@ -175,121 +162,158 @@ bool TcpServer::disconnect()
 }
 
 
-void TcpServer::run(std::function<bool(int)> task_, double timeoutClientAccept_, double timeoutClientBoot_)
+void TcpServerBase::beginRun(double timeoutClientAccept_, double timeoutClientBoot_)
 {
-    this->task = task_;
     this->timeoutClientAccept = timeoutClientAccept_;
     this->timeoutClientBoot = timeoutClientBoot_;
 
-    while (!time2Exit)
-    {
-        socklen_t csSize = sizeof(this->client);
-        //std::cout << "Server waiting for connections" << std::endl;
+    Threading::configureThread(this->threadRole);
+}
 
-        fd_set set;
-        struct timeval tv;
-        int rv;
-        FD_ZERO(&set); /* clear the set */
-        FD_SET(this->sockServer, &set); /* add our file descriptor to the set */
 
-        tv.tv_sec  = (long)timeoutClientAccept;
-        tv.tv_usec = (long)((timeoutClientAccept - tv.tv_sec) * 1000000);
+bool TcpServerBase::acceptClient()
+{
+    socklen_t csSize = sizeof(this->client);
+    //std::cout << "Server waiting for connections" << std::endl;
 
-        rv = select(this->sockServer + 1, &set, NULL, NULL, &tv);
-        if (rv == -1)
-        {
-            std::cerr << "Error on select" << std::endl;
-            continue;
-        }
-        else if (rv == 0)
+    // Wait for a client, disconnect() wakes us up to exit
+    if (!Networking::waitForInput(this->sockServer, this->wakeFd, this->timeoutClientAccept))
+        return false;
+
+    this->sockClient = ::accept4(this->sockServer, (struct sockaddr *)&this->client, &csSize, SOCK_CLOEXEC);
+    if (this->sockClient < 0)
+    {
+        std::cerr << "Failed to accept client" << std::endl;
+        return false;
+    }
+
+    // Figure out who we are connected to    
+    struct hostent* hostp;
+    hostp = ::gethostbyaddr((const char *)&this->client.sin_addr.s_addr, sizeof(this->client.sin_addr.s_addr), AF_INET);
+    if (hostp == NULL) 
+    {
+        char* hostaddrp = inet_ntoa(this->client.sin_addr);
+        if (hostaddrp == NULL)
         {
-            //std::cerr << "Timeout occured" << std::endl;
-            continue;
+            std::cerr << "Could not convert host address to a string" << std::endl;
+            ::close(this->sockClient);
+            return false;
         }
         else
-        {
-            this->sockClient = ::accept(this->sockServer, (struct sockaddr *)&this->client, &csSize);
-            if (this->sockClient < 0)
-            {
-                std::cerr << "Failed to accept client" << std::endl;
-                continue;
-            }
-
-            // Figure out who we are connected to    
-            struct hostent* hostp;
-            hostp = ::gethostbyaddr((const char *)&this->client.sin_addr.s_addr, sizeof(this->client.sin_addr.s_addr), AF_INET);
-            if (hostp == NULL) 
-            {
-                char* hostaddrp = inet_ntoa(this->client.sin_addr);
-                if (hostaddrp == NULL)
-                {
-                    std::cerr << "Could not convert host address to a string" << std::endl;
-                    continue;
-                }
-                else
-                    this->addressClient = hostaddrp;
-            }
-            else
-                this->addressClient = hostp->h_name;
-
-            //std::cout << "Server established connection with '" << this->addressClient << "'" << std::endl;
-            this->clientAlive = true;
-
-            // Process this client
-            if (!task(this->sockClient))
-            {
-                std::cerr << "Error in client task" << std::endl;
-            }
-
-            // Once the task is done, close the socket to the client.
-            if (!Networking::flushSocket(this->sockClient, 2.0))
-                std::cerr << "Warning: cannot flush socket" << std::endl;   
-            if (::close(this->sockClient) == -1)
-                std::cerr << "Could not close client socket: " << strerror(errno) << std::endl;
-
-            this->addressClient = "";
-            this->clientAlive = false;
+            this->addressClient = hostaddrp;
+    }
+    else
+        this->addressClient = hostp->h_name;
 
-        }
+    // Mark the connection so replay opens a new one here as well
+    if (this->capture.isOpen())
+    {
+        int on = 1;
+        if (::setsockopt(this->sockClient, SOL_SOCKET, SO_TIMESTAMPNS, (const char*)&on, sizeof(on)) == -1)
+            std::cerr << "Could not enable receive timestamps: " << strerror(errno) << std::endl;
+        this->capture.append(Capture::protocolTcp, this->client, NULL, 0, CaptureLog::getWallTime_ns(),
+            Capture::flagConnect);
     }
-    this->running = false;
+
+    //std::cout << "Server established connection with '" << this->addressClient << "'" << std::endl;
+    this->clientAlive = true;
+    return true;
 }
 
 
-bool TcpServer::runInThread(std::function<bool(int)> task_, double timeoutClientAccept_, double timeoutClientBoot_)
+void TcpServerBase::closeClient()
 {
-    this->threadArgs.thisPtr = this;
-    this->threadArgs.task = task_;
-    this->threadArgs.timeoutClientAccept = timeoutClientAccept_;
-    this->threadArgs.timeoutClientBoot = timeoutClientBoot_;
-    int result = pthread_create(&this->tid, NULL, &tcpServerRunTrampoline, &threadArgs);
-    if (result)
-        return false;
+    // Once the task is done, close the socket to the client.
+    if (!Networking::flushSocket(this->sockClient, 2.0))
+        std::cerr << "Warning: cannot flush socket" << std::endl;   
+    if (::close(this->sockClient) == -1)
+        std::cerr << "Could not close client socket: " << strerror(errno) << std::endl;
 
-    this->running = true;
-    return true;
+    this->addressClient = "";
+    this->clientAlive = false;
+}
+
+
+ssize_t TcpServerBase::receive(char* buff, size_t size)
+{
+    if (!this->capture.isOpen())
+        return ::recv(this->sockClient, buff, size, 0);
+
+    struct iovec iov;
+    iov.iov_base = buff;
+    iov.iov_len = size;
+
+    char control[CMSG_SPACE(sizeof(struct timespec))];
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t recvlen = ::recvmsg(this->sockClient, &msg, 0);
+    if (recvlen <= 0)
+        return recvlen;
+
+    // Stream data has no message boundaries, each read becomes a record
+    uint64_t timestamp_ns = 0;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+    {
+        struct timespec received;
+        memcpy(&received, CMSG_DATA(cmsg), sizeof(received));
+        timestamp_ns = received.tv_sec * 1000000000ull + received.tv_nsec;
+    }
+    this->capture.append(Capture::protocolTcp, this->client, buff, recvlen,
+        timestamp_ns ? timestamp_ns : CaptureLog::getWallTime_ns());
+    return recvlen;
+}
+
+
+bool TcpServerBase::startCapture(const std::string& path)
+{
+    return this->capture.open(path);
+}
+
+
+void TcpServerBase::stopCapture()
+{
+    this->capture.close();
+}
+
+
+uint64_t TcpServerBase::getCaptured() const
+{
+    return this->capture.getRecords();
+}
+
+
+void TcpServerBase::setThreadRole(const std::string& role)
+{
+    this->threadRole = role;
 }
 
 
-bool TcpServer::isServerAlive() const
+bool TcpServerBase::isServerAlive() const
 {
     return this->serverAlive;
 }
 
 
-bool TcpServer::isClientAlive() const
+bool TcpServerBase::isClientAlive() const
 {
     return this->clientAlive;
 }
 
 
-int TcpServer::getServer() const
+int TcpServerBase::getServer() const
 {
     return this->sockServer;
 }
 
 
-int TcpServer::getClient() const
+int TcpServerBase::getClient() const
 {
     return this->sockClient;
 }
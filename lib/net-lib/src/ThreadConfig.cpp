@@ -0,0 +1,240 @@
+/**
+ * @file ThreadConfig.cpp
+ * @brief Scheduling, CPU affinity, memory locking and naming of threads.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/19/2026 [msardonini] Entries without a CPU keep the existing pin
+ */
+
+#include "ThreadConfig.h"
+
+// STL
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+// System
+#include <alloca.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+namespace {
+
+// Settings by thread role, filled at start up and read as threads start.
+std::map<std::string, ThreadConfig> configs;
+std::mutex configsMutex;
+
+
+/** Touches every page of the next size bytes of stack below the caller. Kept
+ *  out of line so the pages are released back to the caller's frame, mapped
+ *  and, after lockMemory(), locked.
+ */
+__attribute__((noinline)) void prefaultStack(size_t size)
+{
+    volatile char* stack = static_cast<volatile char*>(alloca(size));
+    const size_t page = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < size; i += page)
+        stack[i] = 0;
+}
+
+}  // ANONYMOUS
+
+
+namespace Threading {
+
+
+void setConfig(const std::string& role, const ThreadConfig& config)
+{
+    std::lock_guard<std::mutex> lock(configsMutex);
+    ThreadConfig& stored = configs[role];
+    stored = config;
+    if (stored.name.empty())
+        stored.name = role;
+}
+
+
+bool getConfig(const std::string& role, ThreadConfig& config)
+{
+    std::lock_guard<std::mutex> lock(configsMutex);
+    std::map<std::string, ThreadConfig>::const_iterator it = configs.find(role);
+    if (it == configs.end())
+        return false;
+    config = it->second;
+    return true;
+}
+
+
+void clearConfig()
+{
+    std::lock_guard<std::mutex> lock(configsMutex);
+    configs.clear();
+}
+
+
+bool parseConfig(const std::string& spec)
+{
+    std::istringstream entries(spec);
+    std::string entry;
+    bool success = true;
+    while (std::getline(entries, entry, ','))
+    {
+        if (entry.empty())
+            continue;
+
+        std::istringstream fields(entry);
+        std::string role, priority, cpu;
+        std::getline(fields, role, ':');
+        std::getline(fields, priority, ':');
+        std::getline(fields, cpu, ':');
+
+        // An entry only replaces what it gives, the rest of an existing
+        // entry (a CPU pin or the stack prefault from a profile) is kept
+        ThreadConfig existing;
+        const bool exists = getConfig(role, existing);
+
+        char* end = NULL;
+        ThreadConfig config;
+        config.priority = std::strtol(priority.c_str(), &end, 10);
+        if (role.empty() || priority.empty() || *end != '\0' || config.priority < 0 || config.priority > 99)
+        {
+            std::cerr << "Invalid thread setting '" << entry << "', expected role:priority[:cpu]" << std::endl;
+            success = false;
+            continue;
+        }
+        if (cpu.empty())
+            config.cpu = exists ? existing.cpu : ThreadConfig().cpu;
+        else
+        {
+            config.cpu = std::strtol(cpu.c_str(), &end, 10);
+            if (*end != '\0' || config.cpu < -1)
+            {
+                std::cerr << "Invalid CPU in thread setting '" << entry << "'" << std::endl;
+                success = false;
+                continue;
+            }
+        }
+
+        config.prefaultStack = exists ? existing.prefaultStack : ThreadConfig().prefaultStack;
+        setConfig(role, config);
+    }
+    return success;
+}
+
+
+bool configureThread(const std::string& role)
+{
+    ThreadConfig config;
+    if (!getConfig(role, config))
+        config.name = role;
+    return applyConfig(config);
+}
+
+
+bool applyConfig(const ThreadConfig& config)
+{
+    bool success = true;
+
+    if (!config.name.empty())
+    {
+        // The kernel limits names to 15 characters plus the terminator
+        std::string name = config.name.substr(0, 15);
+        if (pthread_setname_np(pthread_self(), name.c_str()) != 0)
+            success = false;
+    }
+
+    if (config.cpu >= 0 && !setAffinity(config.cpu))
+        success = false;
+
+    if (config.priority > 0)
+    {
+        struct sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = config.priority;
+
+        // Children forked from this thread, e.g. by system(), start back on the
+        // default scheduler
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO | SCHED_RESET_ON_FORK, &param);
+        if (error != 0)
+        {
+            std::cerr << "Could not set SCHED_FIFO priority " << config.priority << " on thread '" << config.name
+                      << "': " << std::strerror(error) << std::endl;
+            success = false;
+        }
+    }
+
+    if (config.prefaultStack > 0)
+        prefaultStack(config.prefaultStack);
+
+    return success;
+}
+
+
+bool setAffinity(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (error != 0)
+    {
+        std::cerr << "Could not pin thread to CPU " << cpu << ": " << std::strerror(error) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool lockMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        std::cerr << "Could not lock memory: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool setDefaultStackSize(size_t size)
+{
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0)
+        return false;
+
+    int error = pthread_attr_setstacksize(&attr, size);
+    if (error == 0)
+        error = pthread_setattr_default_np(&attr);
+    pthread_attr_destroy(&attr);
+
+    if (error != 0)
+    {
+        std::cerr << "Could not set default thread stack size: " << std::strerror(error) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+int getCpuCount()
+{
+    cpu_set_t cpus;
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0)
+        return CPU_COUNT(&cpus);
+
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+
+}  // THREADING
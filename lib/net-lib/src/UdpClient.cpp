@@ -6,6 +6,7 @@
  *
  * Updates:
  * 01/30/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Sockets are closed on exec, spawned processes do not inherit them
  */
 
 #include "UdpClient.h"
@@ -46,7 +47,7 @@ bool UdpClient::connect(const std::string& address_, int port_)
         else
             this->address = address_;
 
-        this->sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+        this->sock = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
         if (this->sock == -1)
         {
             std::cerr << "Could not connect socket: " << strerror(errno) << std::endl;
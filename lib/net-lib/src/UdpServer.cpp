@@ -6,65 +6,66 @@
  *
  * Updates:
  * 02/17/2018 [janjic.igor] Created file
+ * 10/18/2026 [msardonini] Split into UdpServerBase and BasicUdpServer<Handler>
+ * 10/18/2026 [msardonini] Added the peer table
+ * 10/18/2026 [msardonini] Added traffic capture
+ * 10/18/2026 [msardonini] Sockets are closed on exec, spawned processes do not inherit them
+ * 10/19/2026 [msardonini] Spin only after traffic, clearLowLatency() undoes the options
+ * 10/19/2026 [msardonini] The receive thread only uses the peer table under its lock
+ * 10/19/2026 [msardonini] The receive thread reads the low-latency settings through atomics
  */
 
 #include "UdpServer.h"
 
 
-void* udpServerRunTrampoline(void* args)
-{
-    UdpServer::ThreadArgs* threadArgs = (UdpServer::ThreadArgs*)args;
-	threadArgs->thisPtr->run(threadArgs->task, threadArgs->readSize, threadArgs->timeoutRead);
-    return NULL;
-}
-
-
-UdpServer::UdpServer()
-    : buff(nullptr),
-      readSize(0),
-      timeoutRead(0),
-      sockServer(-1),
-      addressServer(""),
-      addressClient(""),
-      port(0),
-      serverAlive(false),
-      running(false),
-      time2Exit(false),
-	  tid(-1) {}
-
-
-UdpServer::UdpServer(std::function<bool(int, char*, size_t)> task_,
-    const std::string& address_, int port_, int readSize_, int recvBuffSize_,
-    double timeoutRead_, bool multicast_)
+UdpServerBase::UdpServerBase()
     : buff(nullptr),
       readSize(0),
       timeoutRead(0),
       sockServer(-1),
       addressServer(""),
       addressClient(""),
+      peerConnected(false),
+      peerUnreachable(false),
+      peers(nullptr),
+      hasPeers(false),
+      lastPeer(0),
       port(0),
       serverAlive(false),
       running(false),
       time2Exit(false),
-	  tid(-1)
+      wakeFd(Networking::createWakeup()),
+	  tid(-1),
+      lowLatency(false),
+      spinCpu(-1),
+      spinTime_ns(0),
+      socketBusyPoll(-1),
+      pinned(false),
+      unpinDue(false),
+      recentInput(false),
+      threadRole("server")
 {
-    if (this->connect(address_, port_, recvBuffSize_, multicast_))
-        this->runInThread(task_, readSize_, timeoutRead_);
-    else
-        std::cerr << "Could not establish a connection on '" << address_ << "' port '" << port_ << "'" << std::endl;
+    CPU_ZERO(&this->unpinnedCpus);
 }
 
 
-UdpServer::~UdpServer()
+UdpServerBase::~UdpServerBase()
 {
+    // Stop the receive loop before freeing the buffer it reads into
+    this->disconnect();
+
     if (this->buff)
         delete[] this->buff;
 
-    this->disconnect();
+    if (this->peers)
+        delete this->peers;
+
+    if (this->wakeFd != -1)
+        ::close(this->wakeFd);
 }
 
 
-bool UdpServer::connect(const std::string& address_, int port_, int recvBuffSize_, bool multicast_)
+bool UdpServerBase::connect(const std::string& address_, int port_, int recvBuffSize_, bool multicast_)
 {
     this->addressServer = address_;
     this->port = port_;
@@ -75,9 +76,12 @@ bool UdpServer::connect(const std::string& address_, int port_, int recvBuffSize
 
     memset(&this->server, 0, sizeof(this->server));
     memset(&this->client, 0, sizeof(this->client));
+    this->peerConnected = false;
+    this->peerUnreachable = false;
+    this->stats.onSocketOpened();
 
     // Create a udp socket
-    if ((this->sockServer = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0)) < 0)
+    if ((this->sockServer = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
     {
         std::cerr << "error: cannot create socket: " << strerror(errno) <<  std::endl;
         return false;
@@ -138,23 +142,50 @@ bool UdpServer::connect(const std::string& address_, int port_, int recvBuffSize
             std::cerr << "error: could not set receive buffer size for socket: " << strerror(errno) << std::endl;
     }
 
+    // Have the kernel report how many datagrams it dropped on a full buffer
+    int overflow = 1;
+    if (::setsockopt(this->sockServer, SOL_SOCKET, SO_RXQ_OVFL, (const char*)&overflow, sizeof(overflow)) == -1)
+        std::cerr << "Could not enable kernel drop counter: " << strerror(errno) << std::endl;
+
+    // A new socket starts with the system's busy poll setting
+    this->socketBusyPoll = -1;
+    if (this->lowLatency.load(std::memory_order_acquire))
+        this->applyLowLatencyOptions();
+
+    // Keep capturing across reconnects
+    if (this->capture.isOpen())
+        this->enableTimestamps();
+
     this->serverAlive = true;
     return true;
 }
 
-void UdpServer::setClientInfo(std::string address_, int port_)
+bool UdpServerBase::setClientInfo(std::string address_, int port_, bool connectPeer_)
 {   
     this->client.sin_addr.s_addr = inet_addr(address_.c_str());
     this->client.sin_family = AF_INET;
     this->client.sin_port = htons(port_);
+
+    if (!connectPeer_)
+        return true;
+
+    if (::connect(this->sockServer, (struct sockaddr*)&this->client, sizeof(this->client)) == -1)
+    {
+        std::cerr << "Could not connect to peer '" << address_ << "' port '" << port_ << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+    this->peerConnected = true;
+    this->peerUnreachable = false;
+    return true;
 }
 
-bool UdpServer::disconnect()
+bool UdpServerBase::disconnect()
 {
     if (this->running)
     {
-        // Give the go-ahead to exit
+        // Give the go-ahead to exit and wake the loop if it is waiting
 	    this->time2Exit = true;
+        Networking::signalWakeup(this->wakeFd);
    
 	    // Wait for exit
         void *returnValue;
@@ -172,7 +203,10 @@ bool UdpServer::disconnect()
             return false;
         }
         else
+        {
+            Networking::clearWakeup(this->wakeFd);
             time2Exit = false;
+        }
     }
 
     if (this->sockServer != -1)
@@ -190,15 +224,88 @@ bool UdpServer::disconnect()
     return true;
 }
 
-ssize_t UdpServer::receiveUdp(void* buf, int readSize_)
+ssize_t UdpServerBase::receiveUdp(void* buf, int readSize_)
 {
-    socklen_t addrlen = sizeof(this->client);
-    return recvfrom(this->sockServer, buf, readSize_, 0, (struct sockaddr *)&this->client, &addrlen);
+    return this->receiveMessage(buf, readSize_);
 }
 
-void UdpServer::run(std::function<bool(int, char*, size_t)> task_, int readSize_, double timeoutRead_)
+
+ssize_t UdpServerBase::receiveMessage(void* buf, size_t size)
+{
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = size;
+
+    // Room for the SO_RXQ_OVFL drop counter and the capture timestamp
+    char control[CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(struct timespec))];
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &this->client;
+    msg.msg_namelen = sizeof(this->client);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t recvlen = ::recvmsg(this->sockServer, &msg, 0);
+    if (recvlen == -1)
+    {
+        // Nothing waiting on a non-blocking socket is not an error
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            this->stats.onReceiveError(errno);
+            this->onPeerError(errno);
+        }
+        return -1;
+    }
+
+    // The kernel stamps its running drop count on each datagram as it is
+    // queued, so drops show up with the first datagram that arrives after them
+    uint64_t timestamp_ns = 0;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+        {
+            uint32_t dropped;
+            memcpy(&dropped, CMSG_DATA(cmsg), sizeof(dropped));
+            this->stats.onKernelDrops(dropped);
+        }
+        else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            struct timespec received;
+            memcpy(&received, CMSG_DATA(cmsg), sizeof(received));
+            timestamp_ns = received.tv_sec * 1000000000ull + received.tv_nsec;
+        }
+    }
+
+    if (this->capture.isOpen())
+    {
+        this->capture.append(Capture::protocolUdp, this->client, (const char*)buf, recvlen,
+            timestamp_ns ? timestamp_ns : CaptureLog::getWallTime_ns());
+    }
+
+    // Datagram was larger than the buffer and got cut short
+    if (msg.msg_flags & MSG_TRUNC)
+        this->stats.onReceiveError(EMSGSIZE);
+
+    // Hearing from the peer means it is back
+    if (this->peerUnreachable.load(std::memory_order_relaxed))
+        this->peerUnreachable = false;
+
+    if (this->hasPeers.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(this->peersMutex);
+        PeerTable::Peer* peer = this->peers->onReceive(this->client, recvlen, getTime_ns());
+        this->lastPeer = peer ? peer->id : 0;
+    }
+
+    this->stats.onReceive(recvlen);
+    return recvlen;
+}
+
+void UdpServerBase::beginRun(int readSize_, double timeoutRead_)
 {
-    this->task = task_;
     this->readSize = readSize_;
     this->timeoutRead = timeoutRead_;
 
@@ -214,61 +321,191 @@ void UdpServer::run(std::function<bool(int, char*, size_t)> task_, int readSize_
             std::cerr << "Could not set timeout on receive" << std::endl;
     }
 
-    while (!time2Exit)
+    Threading::configureThread(this->threadRole);
+
+    // Keep the spinning receive loop on its own core, remembering where it
+    // ran so clearLowLatency() can put it back
+    this->unpinDue = false;
+    const int cpu = this->lowLatency.load(std::memory_order_acquire) ? this->spinCpu.load(std::memory_order_relaxed) : -1;
+    if (cpu >= 0)
     {
-        socklen_t addrlen = sizeof(this->client);
-        size_t recvlen = recvfrom(this->sockServer, this->buff, this->readSize, 0, (struct sockaddr *)&this->client, &addrlen);
+        this->pinned = pthread_getaffinity_np(pthread_self(), sizeof(this->unpinnedCpus), &this->unpinnedCpus) == 0 &&
+            Threading::setAffinity(cpu);
+    }
+}
 
-        if (recvlen != -1)
+
+ssize_t UdpServerBase::nextDatagram()
+{
+    if (this->unpinDue.exchange(false) && this->pinned)
+    {
+        pthread_setaffinity_np(pthread_self(), sizeof(this->unpinnedCpus), &this->unpinnedCpus);
+        this->pinned = false;
+    }
+
+    ssize_t recvlen = this->receiveMessage(this->buff, this->readSize);
+
+    // Socket is empty, spin in low-latency mode right after traffic, then
+    // block until input. An idle socket that timed out blocks again at once
+    if (recvlen == -1)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
         {
-            // Figure out who we are connected to    
-            std::string hostaddr;
-            char* hostaddrp = inet_ntoa(this->client.sin_addr);
-            if (hostaddrp == NULL)
-            {
-                std::cerr << "Could not convert host address to a string" << std::endl;
-                continue;
-            }
-            else
-                hostaddr = hostaddrp;
+            const bool arrived = this->recentInput && this->spinForInput();
+            this->recentInput = false;
+            if (!arrived)
+                Networking::waitForInput(this->sockServer, this->wakeFd, this->timeoutRead);
+        }
+        return -1;
+    }
+    this->recentInput = true;
+
+    // Figure out who we are connected to
+    char* hostaddrp = inet_ntoa(this->client.sin_addr);
+    if (hostaddrp == NULL)
+    {
+        std::cerr << "Could not convert host address to a string" << std::endl;
+        return -1;
+    }
+    this->addressClient = hostaddrp;
+    return recvlen;
+}
+
+
+bool UdpServerBase::setLowLatency(const LowLatencyOptions& options)
+{
+    this->lowLatencyOptions = options;
+    this->spinCpu.store(options.cpu, std::memory_order_relaxed);
+    this->spinTime_ns.store(options.spinTime > 0 ? (uint64_t)(options.spinTime * 1e9) : 0, std::memory_order_relaxed);
+    this->lowLatency.store(true, std::memory_order_release);
+
+    if (this->sockServer == -1)
+        return true;
+    return this->applyLowLatencyOptions();
+}
+
+
+void UdpServerBase::clearLowLatency()
+{
+    if (this->sockServer != -1 && this->socketBusyPoll >= 0)
+    {
+        if (::setsockopt(this->sockServer, SOL_SOCKET, SO_BUSY_POLL, (const char*)&this->socketBusyPoll,
+                sizeof(this->socketBusyPoll)) == -1)
+            std::cerr << "Could not restore busy polling: " << strerror(errno) << std::endl;
+
+        int prefer = 0;
+        if (this->lowLatencyOptions.preferBusyPoll)
+            ::setsockopt(this->sockServer, SOL_SOCKET, SO_PREFER_BUSY_POLL, (const char*)&prefer, sizeof(prefer));
+    }
+    this->socketBusyPoll = -1;
+    this->lowLatency.store(false, std::memory_order_release);
+
+    // Only the receive thread may change its own affinity
+    this->unpinDue = true;
+}
+
+
+void UdpServerBase::setThreadRole(const std::string& role)
+{
+    this->threadRole = role;
+}
 
-            if (this->addressClient != hostaddr)
-            {
-                //std::cout << "Server established connection with '" << hostaddr << "'" << std::endl;
-            }
-            this->addressClient = hostaddr;
 
-            if (!task(this->sockServer, this->buff, recvlen))
-                std::cerr << "Error in client task" << std::endl;
+void UdpServerBase::onPeerError(int error)
+{
+    // ICMP errors are only reported on connected sockets
+    if (this->peerConnected && (error == ECONNREFUSED || error == EHOSTUNREACH || error == ENETUNREACH))
+        this->peerUnreachable = true;
+}
+
+
+bool UdpServerBase::applyLowLatencyOptions()
+{
+    bool okay = true;
+
+    // Remembered once per socket, as the setting to go back to
+    if (this->socketBusyPoll < 0)
+    {
+        int current = 0;
+        socklen_t length = sizeof(current);
+        if (::getsockopt(this->sockServer, SOL_SOCKET, SO_BUSY_POLL, (char*)&current, &length) == 0)
+            this->socketBusyPoll = current;
+    }
+
+    if (this->lowLatencyOptions.busyPoll_us > 0)
+    {
+        int busyPoll = this->lowLatencyOptions.busyPoll_us;
+        if (::setsockopt(this->sockServer, SOL_SOCKET, SO_BUSY_POLL, (const char*)&busyPoll, sizeof(busyPoll)) == -1)
+        {
+            std::cerr << "Could not enable busy polling: " << strerror(errno) << std::endl;
+            okay = false;
         }
     }
-    this->running = false;
+
+    if (this->lowLatencyOptions.preferBusyPoll)
+    {
+        int prefer = 1;
+        if (::setsockopt(this->sockServer, SOL_SOCKET, SO_PREFER_BUSY_POLL, (const char*)&prefer, sizeof(prefer)) == -1)
+        {
+            std::cerr << "Could not prefer busy polling: " << strerror(errno) << std::endl;
+            okay = false;
+        }
+    }
+    return okay;
 }
 
 
-bool UdpServer::runInThread(std::function<bool(int, char*, size_t)> task_, int readSize_, double timeoutRead_)
+bool UdpServerBase::spinForInput()
 {
-    this->threadArgs.thisPtr = this;
-    this->threadArgs.task = task_;
-    this->threadArgs.readSize = readSize_;
-    this->threadArgs.timeoutRead = timeoutRead_;
-    int result = pthread_create(&this->tid, NULL, &udpServerRunTrampoline, &threadArgs);
-    if (result)
+    const uint64_t spin_ns = this->lowLatency.load(std::memory_order_acquire)
+        ? this->spinTime_ns.load(std::memory_order_relaxed) : 0;
+    if (spin_ns == 0)
         return false;
-    this->running = true;
-    return true;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t deadline_ns = now.tv_sec * 1000000000ull + now.tv_nsec + spin_ns;
+
+    while (!this->time2Exit)
+    {
+        // Zero length peek only asks whether a datagram is queued, with
+        // SO_BUSY_POLL set each call also polls the device queue
+        char discard;
+        if (::recv(this->sockServer, &discard, 0, MSG_PEEK | MSG_DONTWAIT) >= 0)
+            return true;
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            return false;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec * 1000000000ull + now.tv_nsec >= deadline_ns)
+            return false;
+    }
+    return false;
 }
 
 
-ssize_t UdpServer::send(const char* buff, size_t length)
+ssize_t UdpServerBase::send(const char* buff, size_t length)
 {
-    ssize_t lenSent;
+    ssize_t lenSent = -1;
     bool okay = true;
     if (this->serverAlive)
     {
-        lenSent = sendto(this->sockServer, buff, length, 0, (struct sockaddr*)&this->client, sizeof(this->client));
+        // A connected socket already knows its peer and route
+        if (this->peerConnected)
+            lenSent = ::send(this->sockServer, buff, length, 0);
+        else
+            lenSent = sendto(this->sockServer, buff, length, 0, (struct sockaddr*)&this->client, sizeof(this->client));
+
+        if (lenSent == -1)
+        {
+            this->stats.onSendError(errno);
+            this->onPeerError(errno);
+        }
+        else
+            this->stats.onSend(lenSent);
 
-        if ((lenSent == -1) || (lenSent != length))
+        // An unreachable peer is expected while it is down, see isPeerUnreachable()
+        if (((lenSent == -1) && !this->peerUnreachable) || (lenSent != -1 && lenSent != static_cast<ssize_t>(length)))
         {
             std::cerr << "Failed to send: " << strerror(errno) << std::endl;
             // return okay = false;
@@ -280,26 +517,147 @@ ssize_t UdpServer::send(const char* buff, size_t length)
 }
 
 
-bool UdpServer::isServerAlive() const
+bool UdpServerBase::startCapture(const std::string& path)
+{
+    if (!this->capture.open(path))
+        return false;
+
+    if (this->sockServer != -1)
+        this->enableTimestamps();
+    return true;
+}
+
+
+void UdpServerBase::stopCapture()
+{
+    this->capture.close();
+
+    int off = 0;
+    if (this->sockServer != -1)
+        ::setsockopt(this->sockServer, SOL_SOCKET, SO_TIMESTAMPNS, (const char*)&off, sizeof(off));
+}
+
+
+uint64_t UdpServerBase::getCaptured() const
+{
+    return this->capture.getRecords();
+}
+
+
+void UdpServerBase::enableTimestamps()
+{
+    // The kernel stamps each datagram as it arrives, before any queueing
+    int on = 1;
+    if (::setsockopt(this->sockServer, SOL_SOCKET, SO_TIMESTAMPNS, (const char*)&on, sizeof(on)) == -1)
+        std::cerr << "Could not enable receive timestamps: " << strerror(errno) << std::endl;
+}
+
+
+void UdpServerBase::setPeerTable(size_t capacity, double idleTimeout)
+{
+    std::lock_guard<std::mutex> lock(this->peersMutex);
+    if (this->peers)
+        delete this->peers;
+    this->peers = new PeerTable(capacity, idleTimeout);
+    this->lastPeer = 0;
+    this->hasPeers.store(true, std::memory_order_release);
+}
+
+
+PeerTable::PeerId UdpServerBase::getLastPeer() const
+{
+    return this->lastPeer;
+}
+
+
+ssize_t UdpServerBase::sendToPeer(PeerTable::PeerId peer_, const char* buff, size_t length)
+{
+    struct sockaddr_in address;
+    {
+        std::lock_guard<std::mutex> lock(this->peersMutex);
+        PeerTable::Peer* peer = this->peers ? this->peers->get(peer_) : NULL;
+        if (!peer || this->sockServer == -1)
+            return -1;
+        address = peer->address;
+        peer->txPackets++;
+        peer->txBytes += length;
+    }
+
+    ssize_t lenSent = ::sendto(this->sockServer, buff, length, 0, (struct sockaddr*)&address, sizeof(address));
+    if (lenSent == -1)
+        this->stats.onSendError(errno);
+    else
+        this->stats.onSend(lenSent);
+    return lenSent;
+}
+
+
+std::vector<PeerTable::Peer> UdpServerBase::getPeers()
+{
+    std::lock_guard<std::mutex> lock(this->peersMutex);
+    if (!this->peers)
+        return std::vector<PeerTable::Peer>();
+
+    // Nothing else expires peers while the socket is quiet
+    this->peers->expire(getTime_ns());
+    return this->peers->getPeers();
+}
+
+
+bool UdpServerBase::removePeer(PeerTable::PeerId peer)
+{
+    std::lock_guard<std::mutex> lock(this->peersMutex);
+    return this->peers && this->peers->remove(peer);
+}
+
+
+bool UdpServerBase::isPeerUnreachable() const
+{
+    return this->peerUnreachable;
+}
+
+
+bool UdpServerBase::isServerAlive() const
 {
     return this->serverAlive;
 }
 
 
-bool UdpServer::isRunning() const
+bool UdpServerBase::isRunning() const
 {
     return this->running;
 }
 
 
-int UdpServer::getServer() const
+int UdpServerBase::getServer() const
 {
     return this->sockServer;
 }
 
 
-std::string UdpServer::getClientAddress() const
+std::string UdpServerBase::getClientAddress() const
 {
     return this->addressClient;
 }
 
+
+SocketStats::Snapshot UdpServerBase::getStats() const
+{
+    return this->stats.getSnapshot();
+}
+
+
+void UdpServerBase::resetStats()
+{
+    this->stats.reset();
+}
+
+
+int UdpServerBase::getReceiveBufferSize() const
+{
+    int size = -1;
+    socklen_t len = sizeof(size);
+    if (this->sockServer == -1 || ::getsockopt(this->sockServer, SOL_SOCKET, SO_RCVBUF, &size, &len) == -1)
+        return -1;
+    return size;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file UnixClient.cpp
+ * @brief Client of a Unix domain datagram or stream server on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ */
+
+#include "UnixClient.h"
+
+
+UnixClient::UnixClient()
+    : sock(-1),
+      path(""),
+      alive(false) {}
+
+
+UnixClient::UnixClient(const std::string& path_, int type_)
+    : sock(-1),
+      path(""),
+      alive(false)
+{
+    this->connect(path_, type_);
+}
+
+
+UnixClient::~UnixClient()
+{
+    this->disconnect();
+}
+
+
+bool UnixClient::connect(const std::string& path_, int type_)
+{
+    // Do not try to connect if a connection is already present
+    if (this->sock != -1)
+        return false;
+
+    struct sockaddr_un server;
+    socklen_t serverLength;
+    if (!Networking::makeUnixAddress(path_, server, serverLength))
+        return false;
+
+    this->sock = ::socket(AF_UNIX, type_ | SOCK_CLOEXEC, 0);
+    if (this->sock == -1)
+    {
+        std::cerr << "Could not connect socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Binding just the family picks a free abstract name the server can reply to
+    if (type_ == SOCK_DGRAM)
+    {
+        struct sockaddr_un local;
+        memset(&local, 0, sizeof(local));
+        local.sun_family = AF_UNIX;
+        if (::bind(this->sock, (struct sockaddr*)&local, sizeof(sa_family_t)) == -1)
+            std::cerr << "Could not bind reply address: " << strerror(errno) << std::endl;
+    }
+
+    if (::connect(this->sock, (struct sockaddr*)&server, serverLength) == -1)
+    {
+        std::cerr << "Could not connect to '" << path_ << "': " << strerror(errno) << std::endl;
+        ::close(this->sock);
+        this->sock = -1;
+        return false;
+    }
+
+    this->path = path_;
+    this->setAlive(true);
+    return true;
+}
+
+
+bool UnixClient::disconnect()
+{
+    this->setAlive(false);
+
+    if (this->sock != -1)
+    {
+        if (::close(this->sock) == -1)
+        {
+            std::cerr << "Could not close socket: " << strerror(errno) << std::endl;
+            this->sock = -1;
+            return false;
+        }
+        this->sock = -1;
+    }
+    this->path = "";
+    return true;
+}
+
+
+bool UnixClient::send(const char* buff, size_t length, const int* fds, size_t count)
+{
+    if (!this->isAlive())
+        return false;
+
+    ssize_t lenSent = Networking::sendWithRights(this->sock, buff, length, fds, count);
+    if (lenSent == -1)
+    {
+        std::cerr << "Failed to send to '" << this->path << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+    else if ((size_t)lenSent != length)
+    {
+        std::cerr << "Could not send the entire message" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+ssize_t UnixClient::receive(char* buff, size_t length, std::vector<int>* fds, double timeout)
+{
+    if (!this->isAlive() || !Networking::waitForInput(this->sock, -1, timeout))
+        return -1;
+
+    std::vector<int> received;
+    ssize_t recvlen = Networking::receiveWithRights(this->sock, buff, length, received);
+
+    if (fds)
+        fds->insert(fds->end(), received.begin(), received.end());
+    else
+    {
+        for (size_t i = 0; i < received.size(); i++)
+            ::close(received[i]);
+    }
+    return recvlen;
+}
+
+
+int UnixClient::getSocket() const
+{
+    return this->sock;
+}
+
+
+bool UnixClient::isAlive()
+{
+    std::lock_guard<std::mutex> lock(this->mutexUnix);
+    return this->alive;
+}
+
+
+void UnixClient::setAlive(bool alive_)
+{
+    std::lock_guard<std::mutex> lock(this->mutexUnix);
+    this->alive = alive_;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file UnixDatagramServer.cpp
+ * @brief Datagram server on a Unix domain socket for processes on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/19/2026 [msardonini] Leave the socket file of a running server alone
+ */
+
+#include "UnixDatagramServer.h"
+
+
+UnixDatagramServerBase::UnixDatagramServerBase()
+    : buff(nullptr),
+      readSize(0),
+      timeoutRead(0),
+      sockServer(-1),
+      path(""),
+      clientLength(0),
+      serverAlive(false),
+      running(false),
+      time2Exit(false),
+      wakeFd(Networking::createWakeup()),
+      tid(-1),
+      threadRole("server")
+{
+    memset(&this->client, 0, sizeof(this->client));
+    memset(&this->credentials, 0, sizeof(this->credentials));
+}
+
+
+UnixDatagramServerBase::~UnixDatagramServerBase()
+{
+    // Stop the receive loop before freeing the buffer it reads into
+    this->disconnect();
+
+    if (this->buff)
+        delete[] this->buff;
+
+    if (this->wakeFd != -1)
+        ::close(this->wakeFd);
+}
+
+
+bool UnixDatagramServerBase::connect(const std::string& path_, int recvBuffSize_)
+{
+    struct sockaddr_un server;
+    socklen_t serverLength;
+    if (!Networking::makeUnixAddress(path_, server, serverLength))
+        return false;
+
+    if ((this->sockServer = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+    {
+        std::cerr << "error: cannot create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // A socket file outlives the server that crashed without removing it
+    Networking::removeStaleUnixSocket(path_, server, serverLength, SOCK_DGRAM);
+
+    if (::bind(this->sockServer, (struct sockaddr*)&server, serverLength) < 0)
+    {
+        std::cerr << "Bind to '" << path_ << "' failed: " << strerror(errno) << std::endl;
+        ::close(this->sockServer);
+        this->sockServer = -1;
+        return false;
+    }
+    this->path = path_;
+
+    if (recvBuffSize_ > 0)
+    {
+        if (::setsockopt(this->sockServer, SOL_SOCKET, SO_RCVBUF, (char*)&recvBuffSize_, sizeof(recvBuffSize_)) == -1)
+            std::cerr << "error: could not set receive buffer size for socket: " << strerror(errno) << std::endl;
+    }
+
+    // Have the kernel attach the credentials of the sender to every datagram
+    int passCredentials = 1;
+    if (::setsockopt(this->sockServer, SOL_SOCKET, SO_PASSCRED, (const char*)&passCredentials, sizeof(passCredentials)) == -1)
+        std::cerr << "Could not enable sender credentials: " << strerror(errno) << std::endl;
+
+    this->serverAlive = true;
+    return true;
+}
+
+
+bool UnixDatagramServerBase::disconnect()
+{
+    if (this->running)
+    {
+        // Give the go-ahead to exit and wake the loop if it is waiting
+        this->time2Exit = true;
+        Networking::signalWakeup(this->wakeFd);
+
+        // Wait for exit
+        pthread_join(this->tid, NULL);
+        Networking::clearWakeup(this->wakeFd);
+        this->time2Exit = false;
+    }
+
+    this->closeFds();
+
+    bool okay = true;
+    if (this->sockServer != -1)
+    {
+        if (::close(this->sockServer) == -1)
+        {
+            std::cerr << "Could not close server socket: " << strerror(errno) << std::endl;
+            okay = false;
+        }
+        this->sockServer = -1;
+
+        if (!this->path.empty() && this->path[0] != '@')
+            ::unlink(this->path.c_str());
+    }
+
+    this->path = "";
+    this->serverAlive = false;
+    return okay;
+}
+
+
+void UnixDatagramServerBase::setThreadRole(const std::string& role)
+{
+    this->threadRole = role;
+}
+
+
+ssize_t UnixDatagramServerBase::receive(void* buf, size_t size)
+{
+    this->closeFds();
+
+    this->clientLength = sizeof(this->client);
+    ssize_t recvlen = Networking::receiveWithRights(this->sockServer, buf, size, this->fds,
+        &this->credentials, &this->client, &this->clientLength);
+    if (recvlen == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+        std::cerr << "Could not receive from '" << this->path << "': " << strerror(errno) << std::endl;
+    return recvlen;
+}
+
+
+ssize_t UnixDatagramServerBase::send(const char* buff_, size_t length, const int* fds_, size_t count)
+{
+    // Unbound senders have no address to reply to
+    if (this->clientLength <= offsetof(struct sockaddr_un, sun_path))
+    {
+        errno = ENOTCONN;
+        return -1;
+    }
+    return Networking::sendWithRights(this->sockServer, buff_, length, fds_, count, &this->client, this->clientLength);
+}
+
+
+struct ucred UnixDatagramServerBase::getLastCredentials() const
+{
+    return this->credentials;
+}
+
+
+size_t UnixDatagramServerBase::takeFds(std::vector<int>& fds_)
+{
+    size_t count = this->fds.size();
+    fds_.insert(fds_.end(), this->fds.begin(), this->fds.end());
+    this->fds.clear();
+    return count;
+}
+
+
+bool UnixDatagramServerBase::isServerAlive() const
+{
+    return this->serverAlive;
+}
+
+
+int UnixDatagramServerBase::getServer() const
+{
+    return this->sockServer;
+}
+
+
+const std::string& UnixDatagramServerBase::getPath() const
+{
+    return this->path;
+}
+
+
+void UnixDatagramServerBase::beginRun(int readSize_, double timeoutRead_)
+{
+    this->readSize = readSize_;
+    this->timeoutRead = timeoutRead_;
+
+    if (this->buff)
+        delete[] this->buff;
+    this->buff = new char[readSize_];
+
+    Threading::configureThread(this->threadRole);
+}
+
+
+ssize_t UnixDatagramServerBase::nextDatagram()
+{
+    ssize_t recvlen = this->receive(this->buff, this->readSize);
+
+    // Socket is empty, block until input or a wakeup
+    if (recvlen == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        Networking::waitForInput(this->sockServer, this->wakeFd, this->timeoutRead);
+    return recvlen;
+}
+
+
+void UnixDatagramServerBase::closeFds()
+{
+    for (size_t i = 0; i < this->fds.size(); i++)
+        ::close(this->fds[i]);
+    this->fds.clear();
+}
@@ -0,0 +1,200 @@
+/**
+ * @file UnixStreamServer.cpp
+ * @brief Stream server on a Unix domain socket for processes on the same host.
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ *
+ * Updates:
+ * 10/18/2026 [msardonini] Created file
+ * 10/19/2026 [msardonini] Leave the socket file of a running server alone
+ */
+
+#include "UnixStreamServer.h"
+
+
+UnixStreamServerBase::UnixStreamServerBase()
+    : timeoutClientAccept(0),
+      sockServer(-1),
+      sockClient(-1),
+      path(""),
+      serverAlive(false),
+      clientAlive(false),
+      running(false),
+      time2Exit(false),
+      wakeFd(Networking::createWakeup()),
+      tid(-1),
+      threadRole("server")
+{
+    memset(&this->credentials, 0, sizeof(this->credentials));
+}
+
+
+UnixStreamServerBase::~UnixStreamServerBase()
+{
+    this->disconnect();
+
+    if (this->wakeFd != -1)
+        ::close(this->wakeFd);
+}
+
+
+bool UnixStreamServerBase::connect(const std::string& path_)
+{
+    struct sockaddr_un server;
+    socklen_t serverLength;
+    if (!Networking::makeUnixAddress(path_, server, serverLength))
+        return false;
+
+    this->sockServer = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->sockServer == -1)
+    {
+        std::cerr << "Could not connect socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // A socket file outlives the server that crashed without removing it
+    Networking::removeStaleUnixSocket(path_, server, serverLength, SOCK_STREAM);
+
+    if (::bind(this->sockServer, (struct sockaddr*)&server, serverLength) == -1)
+    {
+        std::cerr << "Could not bind to '" << path_ << "': " << strerror(errno) << std::endl;
+        ::close(this->sockServer);
+        this->sockServer = -1;
+        return false;
+    }
+    this->path = path_;
+
+    if (::listen(this->sockServer, 1) == -1)
+    {
+        std::cerr << "Could not listen: " << strerror(errno) << std::endl;
+        ::close(this->sockServer);
+        this->sockServer = -1;
+        if (path_[0] != '@')
+            ::unlink(path_.c_str());
+        this->path = "";
+        return false;
+    }
+
+    this->serverAlive = true;
+    return true;
+}
+
+
+bool UnixStreamServerBase::disconnect()
+{
+    if (this->running)
+    {
+        // Give the go-ahead to exit and wake the loop if it is waiting
+        this->time2Exit = true;
+        Networking::signalWakeup(this->wakeFd);
+
+        // Wait for exit
+        pthread_join(this->tid, NULL);
+        Networking::clearWakeup(this->wakeFd);
+        this->time2Exit = false;
+    }
+
+    bool okay = true;
+    if (this->sockServer != -1)
+    {
+        if (::close(this->sockServer) == -1)
+        {
+            std::cerr << "Could not close server socket: " << strerror(errno) << std::endl;
+            okay = false;
+        }
+        this->sockServer = -1;
+
+        if (!this->path.empty() && this->path[0] != '@')
+            ::unlink(this->path.c_str());
+    }
+
+    this->path = "";
+    this->serverAlive = false;
+    this->clientAlive = false;
+    return okay;
+}
+
+
+void UnixStreamServerBase::setThreadRole(const std::string& role)
+{
+    this->threadRole = role;
+}
+
+
+struct ucred UnixStreamServerBase::getClientCredentials() const
+{
+    return this->credentials;
+}
+
+
+bool UnixStreamServerBase::isServerAlive() const
+{
+    return this->serverAlive;
+}
+
+
+bool UnixStreamServerBase::isClientAlive() const
+{
+    return this->clientAlive;
+}
+
+
+int UnixStreamServerBase::getServer() const
+{
+    return this->sockServer;
+}
+
+
+int UnixStreamServerBase::getClient() const
+{
+    return this->sockClient;
+}
+
+
+const std::string& UnixStreamServerBase::getPath() const
+{
+    return this->path;
+}
+
+
+void UnixStreamServerBase::beginRun(double timeoutClientAccept_)
+{
+    this->timeoutClientAccept = timeoutClientAccept_;
+
+    Threading::configureThread(this->threadRole);
+}
+
+
+bool UnixStreamServerBase::acceptClient()
+{
+    // Wait for a client, disconnect() wakes us up to exit
+    if (!Networking::waitForInput(this->sockServer, this->wakeFd, this->timeoutClientAccept))
+        return false;
+
+    this->sockClient = ::accept4(this->sockServer, NULL, NULL, SOCK_CLOEXEC);
+    if (this->sockClient < 0)
+    {
+        std::cerr << "Failed to accept client: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!Networking::getPeerCredentials(this->sockClient, this->credentials))
+    {
+        std::cerr << "Could not get client credentials: " << strerror(errno) << std::endl;
+        memset(&this->credentials, 0, sizeof(this->credentials));
+    }
+
+    this->clientAlive = true;
+    return true;
+}
+
+
+void UnixStreamServerBase::closeClient()
+{
+    if (::close(this->sockClient) == -1)
+        std::cerr << "Could not close client socket: " << strerror(errno) << std::endl;
+
+    this->sockClient = -1;
+    memset(&this->credentials, 0, sizeof(this->credentials));
+    this->clientAlive = false;
+}
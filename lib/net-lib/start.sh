@@ -39,6 +39,7 @@ usage() {
     echo "run               Runs the module."
     echo "build             Build the module."
     echo "test              Runs the tests."
+    echo "bench             Runs the benchmarks."
     echo ""
     copyright
 }
@@ -71,6 +72,7 @@ usage_build() {
     echo "--debug           Build a debug version."
     echo "--testing         Build with tests."
     echo "--examples        Build with examples."
+    echo "--benchmarks      Build with benchmarks."
     echo ""
     copyright
 }
@@ -86,6 +88,17 @@ usage_test() {
 }
 
 
+usage_bench() {
+    echo "[$MODULE_NAME] Usage: start.sh bench [--help | <args>]"
+    echo "-h --help         Show help information about the bench command."
+    echo ""
+    echo "Runs netlib_bench and prints the results as JSON. Build with"
+    echo "--benchmarks first."
+    echo ""
+    copyright
+}
+
+
 # Build the command line arguments to make start.sh based on the passed input.
 # NOTE: deprecated
 construct_start_args() {
@@ -111,6 +124,9 @@ construct_start_args() {
     if [ "$arg_examples" = true ]; then
         start_args="$start_args --examples"
     fi
+    if [ "$arg_benchmarks" = true ]; then
+        start_args="$start_args --benchmarks"
+    fi
     echo "$start_args"
 }
 
@@ -135,6 +151,9 @@ construct_cmake_args() {
     if [ "$arg_examples" = true ]; then
         cmake_args="$cmake_args -DGLOBAL_WITH_EXAMPLES=ON"
     fi
+    if [ "$arg_benchmarks" = true ]; then
+        cmake_args="$cmake_args -DGLOBAL_WITH_BENCHMARKS=ON"
+    fi
 
     # Create the MIDAS_ROOT argument from the environmental variable
     if [ -z "${MIDAS_ROOT-}" ]; then 
@@ -182,6 +201,13 @@ run_test() {
 }
 
 
+run_bench() {
+    echo "Starting $MODULE_NAME benchmarks" >&2
+    [ -x $dir_build/bench/netlib_bench ] || error "Error: netlib_bench not built, rebuild with --benchmarks"
+    $dir_build/bench/netlib_bench
+}
+
+
 build() {
     echo "Building $MODULE_NAME"
 
@@ -250,6 +276,7 @@ arg_rpi=false
 arg_debug=false
 arg_testing=false
 arg_examples=false
+arg_benchmarks=false
 
 # Array containing the positional arguments
 positional=()
@@ -288,6 +315,10 @@ do
         arg_examples=true
         shift
         ;;
+        --benchmarks)
+        arg_benchmarks=true
+        shift
+        ;;
         -h|--help)
         arg_help=true
         shift
@@ -348,4 +379,12 @@ if [ "${positional[0]}" = "test" ]; then
     fi
 fi
 
+if [ "${positional[0]}" = "bench" ]; then
+    if [ "$arg_help" = true ]; then
+        usage_bench
+    else
+        run_bench
+    fi
+fi
+
 exit 0
@@ -0,0 +1,47 @@
+/**
+ * @file TestCaptureLog.h
+ * @brief Tests capturing received traffic.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_CAPTURE_LOG_H
+#define TEST_CAPTURE_LOG_H
+
+// STL
+#include <string>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "CaptureLog.h"
+
+
+/** Fixture for capture tests */
+class TestCaptureLog : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestCaptureLog();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestCaptureLog();
+
+
+    /** Removes the capture file of the test.
+     */
+    virtual void TearDown();
+
+    // Capture file of every test.
+    std::string path;
+
+};  // TEST_CAPTURE_LOG
+
+
+#endif  // TEST_CAPTURE_LOG_H
@@ -0,0 +1,42 @@
+/**
+ * @file TestCrc32c.h
+ * @brief Tests the CRC32C checksums.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_CRC32C_H
+#define TEST_CRC32C_H
+
+// STL
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "Crc32c.h"
+
+
+/** Fixture for CRC32C tests */
+class TestCrc32c : public ::testing::Test
+{
+protected:
+
+    /** Default constructor, fills the pseudo random buffer.
+     */
+    TestCrc32c();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestCrc32c();
+
+    // Pseudo random bytes checksummed at every length and alignment.
+    std::vector<uint8_t> buffer;
+
+};  // TEST_CRC32C
+
+
+#endif  // TEST_CRC32C_H
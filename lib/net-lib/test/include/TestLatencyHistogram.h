@@ -0,0 +1,39 @@
+/**
+ * @file TestLatencyHistogram.h
+ * @brief Tests the latency histogram.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_LATENCY_HISTOGRAM_H
+#define TEST_LATENCY_HISTOGRAM_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "LatencyHistogram.h"
+
+
+/** Fixture for latency histogram tests */
+class TestLatencyHistogram : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestLatencyHistogram();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestLatencyHistogram();
+
+    // Histogram that will be tested, 1 us to 60 s.
+    LatencyHistogram histogram;
+
+};  // TEST_LATENCY_HISTOGRAM
+
+
+#endif  // TEST_LATENCY_HISTOGRAM_H
@@ -0,0 +1,45 @@
+/**
+ * @file TestPeerTable.h
+ * @brief Tests the peer table.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_PEER_TABLE_H
+#define TEST_PEER_TABLE_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "PeerTable.h"
+
+
+/** Fixture for peer table tests */
+class TestPeerTable : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestPeerTable();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestPeerTable();
+
+
+    /** Builds the address of a test peer.
+     */
+    static struct sockaddr_in makeAddress(uint32_t ip, uint16_t port);
+
+
+    // Start of time in the tests, far from 0.
+    static const uint64_t start_ns;
+
+};  // TEST_PEER_TABLE
+
+
+#endif  // TEST_PEER_TABLE_H
@@ -0,0 +1,44 @@
+/**
+ * @file TestPrerollRing.h
+ * @brief Tests the preroll ring.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_PREROLL_RING_H
+#define TEST_PREROLL_RING_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "PrerollRing.h"
+
+
+/** Fixture for preroll ring tests */
+class TestPrerollRing : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestPrerollRing();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestPrerollRing();
+
+
+    /** Pushes a message holding its number, stamped with that number.
+     */
+    bool pushNumber(uint64_t number);
+
+    // Ring of 8 slots the tests push into.
+    PrerollRing ring;
+
+};  // TEST_PREROLL_RING
+
+
+#endif  // TEST_PREROLL_RING_H
@@ -0,0 +1,47 @@
+/**
+ * @file TestProcessSupervisor.h
+ * @brief Tests supervising a child process.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_PROCESS_SUPERVISOR_H
+#define TEST_PROCESS_SUPERVISOR_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "ProcessSupervisor.h"
+
+
+/** Fixture for process supervisor tests */
+class TestProcessSupervisor : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestProcessSupervisor();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestProcessSupervisor();
+
+
+    /** Calls update() whenever the pidfd is readable until the state changes.
+     *
+     *  @param[in] timeout  Seconds to wait at most.
+     *  @return             True if the state changed in time.
+     */
+    bool waitForChange(double timeout);
+
+    // Supervisor that will be tested.
+    ProcessSupervisor supervisor;
+
+};  // TEST_PROCESS_SUPERVISOR
+
+
+#endif  // TEST_PROCESS_SUPERVISOR_H
@@ -0,0 +1,60 @@
+/**
+ * @file TestSegmentWriter.h
+ * @brief Tests the segment writer.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_SEGMENT_WRITER_H
+#define TEST_SEGMENT_WRITER_H
+
+// STL
+#include <string>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "SegmentWriter.h"
+
+
+/** Fixture for segment writer tests */
+class TestSegmentWriter : public ::testing::Test
+{
+protected:
+
+    /** Default constructor, creates an empty directory to write to.
+     */
+    TestSegmentWriter();
+
+
+    /** Default destructor, removes the directory.
+     */
+    virtual ~TestSegmentWriter();
+
+
+    /** Gets the paths of the segments written, in order.
+     */
+    std::vector<std::string> getSegments() const;
+
+
+    /** Reads a whole file.
+     */
+    static std::string readFile(const std::string& path);
+
+
+    /** Makes a message of some length holding its number.
+     */
+    static std::string makeMessage(uint32_t number, size_t length);
+
+    // Directory the tests write to, and options with small sizes.
+    std::string directory;
+    SegmentWriter::Options options;
+    SegmentWriter writer;
+
+};  // TEST_SEGMENT_WRITER
+
+
+#endif  // TEST_SEGMENT_WRITER_H
@@ -0,0 +1,55 @@
+/**
+ * @file TestSendQueue.h
+ * @brief Tests the prioritized send queue.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_SEND_QUEUE_H
+#define TEST_SEND_QUEUE_H
+
+// STL
+#include <string>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "SendQueue.h"
+
+
+/** Fixture for send queue tests */
+class TestSendQueue : public ::testing::Test
+{
+protected:
+
+    /** Default constructor, opens a non-blocking socket pair.
+     */
+    TestSendQueue();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestSendQueue();
+
+
+    /** Queues a string as a frame.
+     */
+    void push(SendQueue::Priority priority, const std::string& frame, bool replace = false);
+
+
+    /** Reads everything that arrived on the other end.
+     */
+    std::string readAll();
+
+    // Queue that will be tested, bulk never held back.
+    SendQueue queue;
+
+    // Sending and receiving ends of the stream.
+    int fds[2];
+
+};  // TEST_SEND_QUEUE
+
+
+#endif  // TEST_SEND_QUEUE_H
@@ -0,0 +1,39 @@
+/**
+ * @file TestSequenceStats.h
+ * @brief Tests the sequence number statistics.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_SEQUENCE_STATS_H
+#define TEST_SEQUENCE_STATS_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "SequenceStats.h"
+
+
+/** Fixture for sequence statistics tests */
+class TestSequenceStats : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestSequenceStats();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestSequenceStats();
+
+    // Statistics that will be tested.
+    SequenceStats stats;
+
+};  // TEST_SEQUENCE_STATS
+
+
+#endif  // TEST_SEQUENCE_STATS_H
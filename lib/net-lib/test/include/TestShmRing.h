@@ -0,0 +1,44 @@
+/**
+ * @file TestShmRing.h
+ * @brief Tests the shared memory ring.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_SHM_RING_H
+#define TEST_SHM_RING_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "ShmRing.h"
+
+
+/** Fixture for shared memory ring tests */
+class TestShmRing : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestShmRing();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestShmRing();
+
+
+    /** Creates the producer ring of every test.
+     */
+    virtual void SetUp();
+
+    // Ring the tests produce into.
+    ShmRing producer;
+
+};  // TEST_SHM_RING
+
+
+#endif  // TEST_SHM_RING_H
@@ -0,0 +1,68 @@
+/**
+ * @file TestStreamFramer.h
+ * @brief Tests finding frames in a byte stream.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_STREAM_FRAMER_H
+#define TEST_STREAM_FRAMER_H
+
+// STL
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "StreamFramer.h"
+
+
+/** Fixture for stream framer tests */
+class TestStreamFramer : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestStreamFramer();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestStreamFramer();
+
+
+    /** Builds a valid frame carrying the given payload byte.
+     */
+    static std::vector<uint8_t> makeFrame(uint8_t payload);
+
+
+    /** Accepts frames ending in the footer whose payload bytes all match.
+     */
+    static bool validate(const uint8_t* frame, size_t length);
+
+
+    /** Writes bytes into the framer, as many reads as it takes, draining
+     *  it after each one.
+     *
+     *  @return     Payload byte of every frame the framer returned.
+     */
+    std::vector<uint8_t> feed(const std::vector<uint8_t>& bytes);
+
+
+    /** Collects the payload byte of every frame the framer returns.
+     */
+    std::vector<uint8_t> drain();
+
+    // Bytes of the frames under test.
+    static const size_t frameSize = 8;
+
+    // Framer that will be tested, with the smallest ring it allows.
+    StreamFramer framer;
+
+};  // TEST_STREAM_FRAMER
+
+
+#endif  // TEST_STREAM_FRAMER_H
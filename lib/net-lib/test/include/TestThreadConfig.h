@@ -0,0 +1,36 @@
+/**
+ * @file TestThreadConfig.h
+ * @brief Tests the thread configuration table.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_THREAD_CONFIG_H
+#define TEST_THREAD_CONFIG_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "ThreadConfig.h"
+
+
+/** Fixture for thread configuration tests */
+class TestThreadConfig : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestThreadConfig();
+
+
+    /** Default destructor, empties the configuration table.
+     */
+    virtual ~TestThreadConfig();
+
+};  // TEST_THREAD_CONFIG
+
+
+#endif  // TEST_THREAD_CONFIG_H
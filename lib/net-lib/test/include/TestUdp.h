@@ -0,0 +1,90 @@
+/**
+ * @file TestUdp.h
+ * @brief Tests the UDP client and server classes.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+
+#ifndef TEST_UDP_H
+#define TEST_UDP_H
+
+#include <atomic>
+#include <functional>
+#include <unistd.h>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "UdpClient.h"
+#include "UdpServer.h"
+
+
+/** Fixture for UDP tests */
+class TestUdp : public ::testing::Test
+{
+
+public:
+
+    /** Task that will be executed by the UdpServer for every datagram.
+     */
+    bool serverTask1(int fd, char* buff, size_t length);
+
+protected:
+
+    /** Default constructor.
+     */
+    TestUdp();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestUdp();
+
+
+    /** Code here will be called immediately after the constructor (right
+     *  before each test).
+     */
+    virtual void SetUp();
+
+
+    /** Code here will be called immediately after each test (right
+     *  before the destructor).
+     */
+    virtual void TearDown();
+
+    /** Gets the busy poll setting of the server's socket, -1 on error.
+     */
+    int getBusyPoll() const;
+
+    /** Overflows the receive buffer of the server, connected with the smallest
+     *  one, then drains it and receives one more datagram to learn the drops.
+     *
+     *  @return Datagrams the kernel dropped.
+     */
+    uint64_t overflowServer();
+
+    // Function pointer to task 1.
+    std::function<bool(int, char*, size_t)> task1;
+
+    // Number of datagrams task1 has seen.
+    std::atomic<int> task1Count;
+
+    // UdpServer that will be tested.
+    UdpServer* udpServer;
+
+    // UdpClient that will be tested.
+    UdpClient* udpClient;
+
+    // Address of the server is localhost.
+    static const std::string udpAddress;
+
+    // Port is 4004.
+    static const int udpPort;
+
+};  // TEST_UDP
+
+
+#endif  // TEST_UDP_H
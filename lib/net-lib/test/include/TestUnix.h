@@ -0,0 +1,53 @@
+/**
+ * @file TestUnix.h
+ * @brief Tests the Unix domain socket client and server classes.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_UNIX_H
+#define TEST_UNIX_H
+
+#include <atomic>
+#include <string>
+#include <unistd.h>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "UnixClient.h"
+#include "UnixDatagramServer.h"
+#include "UnixStreamServer.h"
+
+
+/** Fixture for Unix domain socket tests */
+class TestUnix : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestUnix();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestUnix();
+
+
+    /** Waits up to a second for a counter to reach a value.
+     */
+    static bool waitFor(const std::atomic<int>& counter, int value);
+
+    // Abstract name of the test sockets, unique to the process.
+    std::string abstractPath;
+
+    // Filesystem path of the test sockets.
+    std::string filePath;
+
+};  // TEST_UNIX
+
+
+#endif  // TEST_UNIX_H
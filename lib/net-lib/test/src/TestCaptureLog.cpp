@@ -0,0 +1,195 @@
+/**
+ * @file TestCaptureLog.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "TcpClient.h"
+#include "TcpServer.h"
+#include "TestCaptureLog.h"
+#include "UdpServer.h"
+
+
+TestCaptureLog::TestCaptureLog()
+    : path("/tmp/netlib-test-" + std::to_string(getpid()) + ".cap") {}
+
+TestCaptureLog::~TestCaptureLog() {}
+
+void TestCaptureLog::TearDown()
+{
+    ::unlink(this->path.c_str());
+}
+
+
+TEST_F(TestCaptureLog, TestWriteRead)
+{
+    struct sockaddr_in source;
+    memset(&source, 0, sizeof(source));
+    source.sin_addr.s_addr = htonl(0x0A000001);
+    source.sin_port = htons(4000);
+
+    CaptureLog log;
+    ASSERT_TRUE(log.open(this->path));
+    ASSERT_FALSE(log.open(this->path));
+    ASSERT_TRUE(log.isOpen());
+    for (int i = 0; i < 100; i++)
+    {
+        std::string message(i, 'a' + i % 26);
+        ASSERT_TRUE(log.append(Capture::protocolUdp, source, message.data(), message.size(), 1000 + i));
+    }
+    ASSERT_EQ(log.getRecords(), 100u);
+    log.close();
+    ASSERT_FALSE(log.isOpen());
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(this->path));
+    Capture::Record record;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            ASSERT_TRUE(reader.next(record));
+            ASSERT_EQ(record.header.timestamp_ns, 1000u + i);
+            ASSERT_EQ(record.header.address, source.sin_addr.s_addr);
+            ASSERT_EQ(record.header.port, source.sin_port);
+            ASSERT_EQ(record.header.protocol, Capture::protocolUdp);
+            ASSERT_EQ(std::string(record.data, record.header.length), std::string(i, 'a' + i % 26));
+        }
+        ASSERT_FALSE(reader.next(record));
+        reader.rewind();
+    }
+}
+
+
+TEST_F(TestCaptureLog, TestTornRecord)
+{
+    struct sockaddr_in source;
+    memset(&source, 0, sizeof(source));
+
+    CaptureLog log;
+    ASSERT_TRUE(log.open(this->path));
+    ASSERT_TRUE(log.append(Capture::protocolUdp, source, "first", 5, 1));
+    ASSERT_TRUE(log.append(Capture::protocolUdp, source, "second", 6, 2));
+    log.close();
+
+    // Clear the valid flag of the last record as a crash mid append would
+    int fd = ::open(this->path.c_str(), O_RDWR);
+    ASSERT_NE(fd, -1);
+    off_t last = sizeof(Capture::FileHeader) + sizeof(Capture::RecordHeader) + 8;
+    uint8_t flags = 0;
+    ASSERT_EQ(::pwrite(fd, &flags, 1, last + offsetof(Capture::RecordHeader, flags)), 1);
+    ::close(fd);
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(this->path));
+    Capture::Record record;
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(std::string(record.data, record.header.length), "first");
+    ASSERT_FALSE(reader.next(record));
+
+    // Anything else is rejected
+    fd = ::open(this->path.c_str(), O_WRONLY | O_TRUNC);
+    ASSERT_EQ(::write(fd, "not a capture, not a capture", 28), 28);
+    ::close(fd);
+    ASSERT_FALSE(reader.open(this->path));
+}
+
+
+TEST_F(TestCaptureLog, TestUdpServerCapture)
+{
+    UdpServer server, sender;
+    ASSERT_TRUE(server.connect("", 4020, 0));
+    ASSERT_TRUE(sender.connect("", 4021, 0));
+    ASSERT_TRUE(sender.setClientInfo("127.0.0.1", 4020));
+    ASSERT_TRUE(server.startCapture(this->path));
+
+    uint64_t before_ns = CaptureLog::getWallTime_ns();
+    char buff[64] = "datagram";
+    for (int i = 0; i < 3; i++)
+        ASSERT_EQ(sender.send(buff, 8 + i), 8 + i);
+    usleep(10000);
+    for (int i = 0; i < 3; i++)
+        ASSERT_EQ(server.receiveUdp(buff, sizeof(buff)), 8 + i);
+    ASSERT_EQ(server.getCaptured(), 3u);
+    server.stopCapture();
+
+    // Nothing is recorded once stopped
+    ASSERT_EQ(sender.send(buff, 8), 8);
+    usleep(10000);
+    ASSERT_EQ(server.receiveUdp(buff, sizeof(buff)), 8);
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(this->path));
+    Capture::Record record;
+    uint64_t previous_ns = before_ns;
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(reader.next(record));
+        ASSERT_EQ(record.header.protocol, Capture::protocolUdp);
+        ASSERT_EQ(record.header.length, 8u + i);
+        ASSERT_EQ(ntohs(record.header.port), 4021);
+        ASSERT_EQ(ntohl(record.header.address), 0x7F000001u);
+        ASSERT_GE(record.header.timestamp_ns, previous_ns);
+        previous_ns = record.header.timestamp_ns;
+    }
+    ASSERT_FALSE(reader.next(record));
+}
+
+
+TEST_F(TestCaptureLog, TestTcpServerCapture)
+{
+    TcpServer server;
+    ASSERT_TRUE(server.connect("", 4022));
+    ASSERT_TRUE(server.startCapture(this->path));
+
+    std::atomic<ssize_t> received(0);
+    ASSERT_TRUE(server.runInThread([&](int) {
+        char buff[64];
+        ssize_t length;
+        while ((length = server.receive(buff, sizeof(buff))) > 0)
+            received += length;
+        return true;
+    }, 1.0, 5.0));
+
+    TcpClient client("", 4022);
+    ASSERT_TRUE(client.isAlive());
+    ASSERT_EQ(::send(client.getSocket(), "stream data", 11, 0), 11);
+    ASSERT_TRUE(client.disconnect());
+    for (int i = 0; i < 100 && received < 11; i++)
+        usleep(10000);
+    ASSERT_EQ(received, 11);
+    ASSERT_TRUE(server.disconnect());
+    server.stopCapture();
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(this->path));
+    Capture::Record record;
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(record.header.protocol, Capture::protocolTcp);
+    ASSERT_TRUE(record.header.flags & Capture::flagConnect);
+    ASSERT_EQ(record.header.length, 0u);
+
+    std::string stream;
+    while (reader.next(record))
+    {
+        ASSERT_FALSE(record.header.flags & Capture::flagConnect);
+        stream.append(record.data, record.header.length);
+    }
+    ASSERT_EQ(stream, "stream data");
+}
+
+
+int main(int argc, char** argv)
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
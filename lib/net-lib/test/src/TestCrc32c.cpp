@@ -0,0 +1,100 @@
+/**
+ * @file TestCrc32c.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+#include <iostream>
+
+#include "TestCrc32c.h"
+
+
+TestCrc32c::TestCrc32c()
+    : buffer(1024)
+{
+    uint32_t state = 12345;
+    for (size_t i = 0; i < this->buffer.size(); i++)
+    {
+        state = state * 1103515245 + 12345;
+        this->buffer[i] = state >> 24;
+    }
+}
+
+TestCrc32c::~TestCrc32c() {}
+
+
+TEST_F(TestCrc32c, TestKnownValues)
+{
+    std::cout << "Using " << Crc32c::getImplementation() << std::endl;
+
+    // Check value of the catalogue of CRC algorithms
+    ASSERT_EQ(Crc32c::compute("123456789", 9), 0xE3069283u);
+    ASSERT_EQ(Crc32c::computeSoftware("123456789", 9), 0xE3069283u);
+
+    // Vectors of RFC 3720 B.4
+    uint8_t data[32];
+    memset(data, 0, sizeof(data));
+    ASSERT_EQ(Crc32c::compute(data, sizeof(data)), 0x8A9136AAu);
+    ASSERT_EQ(Crc32c::computeSoftware(data, sizeof(data)), 0x8A9136AAu);
+
+    memset(data, 0xFF, sizeof(data));
+    ASSERT_EQ(Crc32c::compute(data, sizeof(data)), 0x62A8AB43u);
+    ASSERT_EQ(Crc32c::computeSoftware(data, sizeof(data)), 0x62A8AB43u);
+
+    for (int i = 0; i < 32; i++)
+        data[i] = i;
+    ASSERT_EQ(Crc32c::compute(data, sizeof(data)), 0x46DD794Eu);
+    ASSERT_EQ(Crc32c::computeSoftware(data, sizeof(data)), 0x46DD794Eu);
+
+    ASSERT_EQ(Crc32c::compute(data, 0), 0u);
+}
+
+
+TEST_F(TestCrc32c, TestImplementationsAgree)
+{
+    for (size_t offset = 0; offset < 8; offset++)
+    {
+        for (size_t length = 0; length + offset <= 300; length++)
+        {
+            ASSERT_EQ(Crc32c::compute(&this->buffer[offset], length),
+                Crc32c::computeSoftware(&this->buffer[offset], length)) << offset << " " << length;
+        }
+    }
+}
+
+
+TEST_F(TestCrc32c, TestPieces)
+{
+    const uint32_t whole = Crc32c::compute(this->buffer.data(), this->buffer.size());
+    for (size_t split = 0; split <= this->buffer.size(); split += 37)
+    {
+        uint32_t crc = Crc32c::compute(this->buffer.data(), split);
+        ASSERT_EQ(Crc32c::compute(&this->buffer[split], this->buffer.size() - split, crc), whole);
+
+        crc = Crc32c::computeSoftware(this->buffer.data(), split);
+        ASSERT_EQ(Crc32c::computeSoftware(&this->buffer[split], this->buffer.size() - split, crc), whole);
+    }
+}
+
+
+TEST_F(TestCrc32c, TestDetectsBitFlips)
+{
+    const uint32_t original = Crc32c::compute(this->buffer.data(), 19);
+    for (size_t bit = 0; bit < 19 * 8; bit++)
+    {
+        this->buffer[bit / 8] ^= 1 << (bit % 8);
+        ASSERT_NE(Crc32c::compute(this->buffer.data(), 19), original);
+        this->buffer[bit / 8] ^= 1 << (bit % 8);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
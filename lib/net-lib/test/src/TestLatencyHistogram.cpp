@@ -0,0 +1,95 @@
+/**
+ * @file TestLatencyHistogram.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <thread>
+#include <vector>
+
+#include "TestLatencyHistogram.h"
+
+
+TestLatencyHistogram::TestLatencyHistogram() {}
+
+TestLatencyHistogram::~TestLatencyHistogram() {}
+
+
+TEST_F(TestLatencyHistogram, TestEmpty)
+{
+    LatencyHistogram::Summary summary = this->histogram.getSummary();
+    ASSERT_EQ(summary.count, 0u);
+    ASSERT_EQ(summary.min, 0u);
+    ASSERT_EQ(summary.p50, 0u);
+    ASSERT_EQ(summary.p999, 0u);
+}
+
+
+TEST_F(TestLatencyHistogram, TestSmallValuesAreExact)
+{
+    for (uint64_t i = 1; i <= 100; i++)
+        this->histogram.record(i);
+
+    ASSERT_EQ(this->histogram.getValueAtPercentile(50.0), 50u);
+    ASSERT_EQ(this->histogram.getValueAtPercentile(99.0), 99u);
+    ASSERT_EQ(this->histogram.getValueAtPercentile(100.0), 100u);
+}
+
+
+TEST_F(TestLatencyHistogram, TestRelativeError)
+{
+    // 1 ms to 1 s in 1 ms steps
+    for (uint64_t i = 1; i <= 1000; i++)
+        this->histogram.record(i * 1000);
+
+    LatencyHistogram::Summary summary = this->histogram.getSummary();
+    ASSERT_EQ(summary.count, 1000u);
+    ASSERT_EQ(summary.min, 1000u);
+    ASSERT_EQ(summary.max, 1000000u);
+    ASSERT_NEAR(summary.p50, 500000.0, 500000.0 / 64);
+    ASSERT_NEAR(summary.p99, 990000.0, 990000.0 / 64);
+    ASSERT_NEAR(summary.p999, 999000.0, 999000.0 / 64);
+    ASSERT_NEAR(summary.mean, 500500.0, 1e-6);
+}
+
+
+TEST_F(TestLatencyHistogram, TestJitter)
+{
+    // Constant samples have no jitter
+    for (int i = 0; i < 100; i++)
+        this->histogram.record(1000);
+    ASSERT_EQ(this->histogram.getSummary().jitter, 0.0);
+
+    // Alternating samples converge on the step size
+    for (int i = 0; i < 1000; i++)
+        this->histogram.record(i % 2 ? 1100 : 1000);
+    ASSERT_NEAR(this->histogram.getSummary().jitter, 100.0, 1.0);
+}
+
+
+TEST_F(TestLatencyHistogram, TestConcurrentRecord)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.push_back(std::thread([this]() {
+            for (int i = 0; i < 10000; i++)
+                this->histogram.record(i);
+        }));
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    ASSERT_EQ(this->histogram.getCount(), 40000u);
+    ASSERT_EQ(this->histogram.getSummary().max, 9999u);
+}
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+/**
+ * @file TestPeerTable.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+
+#include <arpa/inet.h>
+
+#include "TestPeerTable.h"
+
+
+const uint64_t TestPeerTable::start_ns = 1000000000000ull;
+
+TestPeerTable::TestPeerTable() {}
+
+TestPeerTable::~TestPeerTable() {}
+
+
+struct sockaddr_in TestPeerTable::makeAddress(uint32_t ip, uint16_t port)
+{
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(ip);
+    address.sin_port = htons(port);
+    return address;
+}
+
+
+TEST_F(TestPeerTable, TestLookupManyPeers)
+{
+    const int peers = 4000;
+    PeerTable table(peers, 0);
+
+    // Same ip on many ports and many ips on the same port
+    for (int i = 0; i < peers; i++)
+    {
+        struct sockaddr_in address = makeAddress(i % 2 ? 0x0A000000 + i : 0x0B000001, 5000 + (i % 2 ? 0 : i));
+        ASSERT_NE(table.onReceive(address, 10, start_ns), nullptr);
+    }
+    ASSERT_EQ(table.size(), (size_t)peers);
+
+    for (int i = 0; i < peers; i++)
+    {
+        struct sockaddr_in address = makeAddress(i % 2 ? 0x0A000000 + i : 0x0B000001, 5000 + (i % 2 ? 0 : i));
+        PeerTable::Peer* peer = table.onReceive(address, 20, start_ns + 1);
+        ASSERT_NE(peer, nullptr);
+        ASSERT_EQ(peer->rxPackets, 2u);
+        ASSERT_EQ(peer->rxBytes, 30u);
+        ASSERT_EQ(peer->firstSeen_ns, start_ns);
+        ASSERT_EQ(peer->lastSeen_ns, start_ns + 1);
+        ASSERT_EQ(table.get(peer->id), peer);
+    }
+    ASSERT_EQ(table.size(), (size_t)peers);
+    ASSERT_EQ(table.getPeers().size(), (size_t)peers);
+}
+
+
+TEST_F(TestPeerTable, TestFullTableRejects)
+{
+    PeerTable table(2, 0);
+    ASSERT_NE(table.onReceive(makeAddress(1, 1), 1, start_ns), nullptr);
+    ASSERT_NE(table.onReceive(makeAddress(2, 1), 1, start_ns), nullptr);
+    ASSERT_EQ(table.onReceive(makeAddress(3, 1), 1, start_ns), nullptr);
+    ASSERT_EQ(table.getRejected(), 1u);
+
+    // Known peers still get through
+    ASSERT_NE(table.onReceive(makeAddress(1, 1), 1, start_ns), nullptr);
+    ASSERT_EQ(table.getRejected(), 1u);
+}
+
+
+TEST_F(TestPeerTable, TestRemoveKeepsOtherPeers)
+{
+    const int peers = 256;
+    PeerTable table(peers, 0);
+    std::vector<PeerTable::PeerId> ids;
+    for (int i = 0; i < peers; i++)
+        ids.push_back(table.onReceive(makeAddress(0x7F000001, i), 1, start_ns)->id);
+
+    // Removing every other entry must not break the probe runs of the rest
+    for (int i = 0; i < peers; i += 2)
+        ASSERT_TRUE(table.remove(ids[i]));
+    ASSERT_FALSE(table.remove(ids[0]));
+    ASSERT_EQ(table.size(), (size_t)peers / 2);
+
+    for (int i = 0; i < peers; i++)
+    {
+        PeerTable::Peer* peer = table.find(makeAddress(0x7F000001, i));
+        if (i % 2)
+        {
+            ASSERT_NE(peer, nullptr);
+            ASSERT_EQ(peer->id, ids[i]);
+        }
+        else
+            ASSERT_EQ(peer, nullptr);
+    }
+}
+
+
+TEST_F(TestPeerTable, TestStaleIdAfterReuse)
+{
+    PeerTable table(1, 0);
+    PeerTable::PeerId first = table.onReceive(makeAddress(1, 1), 1, start_ns)->id;
+    ASSERT_NE(first, 0u);
+    ASSERT_TRUE(table.remove(first));
+
+    // The same pool entry comes back under a new id
+    PeerTable::PeerId second = table.onReceive(makeAddress(2, 2), 1, start_ns)->id;
+    ASSERT_NE(second, first);
+    ASSERT_EQ(table.get(first), nullptr);
+    ASSERT_NE(table.get(second), nullptr);
+}
+
+
+TEST_F(TestPeerTable, TestIdlePeersExpire)
+{
+    // One second timeout
+    PeerTable table(16, 1.0);
+    PeerTable::PeerId quiet = table.onReceive(makeAddress(1, 1), 1, start_ns)->id;
+    PeerTable::PeerId busy = table.onReceive(makeAddress(2, 2), 1, start_ns)->id;
+
+    // Only the busy peer keeps talking
+    for (int i = 1; i <= 20; i++)
+        table.onReceive(makeAddress(2, 2), 1, start_ns + i * 100000000ull);
+
+    ASSERT_EQ(table.get(quiet), nullptr);
+    ASSERT_NE(table.get(busy), nullptr);
+    ASSERT_EQ(table.getExpired(), 1u);
+
+    // Expiry is late by at most one tick of the wheel
+    table.expire(start_ns + 3000000000ull - 1);
+    ASSERT_NE(table.get(busy), nullptr);
+    ASSERT_EQ(table.expire(start_ns + 3100000000ull), 1u);
+    ASSERT_EQ(table.get(busy), nullptr);
+    ASSERT_EQ(table.size(), 0u);
+
+    // A long silence clears everything in one call
+    table.onReceive(makeAddress(3, 3), 1, start_ns + 4000000000ull);
+    ASSERT_EQ(table.expire(start_ns + 3600000000000ull), 1u);
+    ASSERT_EQ(table.size(), 0u);
+}
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
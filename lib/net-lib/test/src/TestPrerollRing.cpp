@@ -0,0 +1,146 @@
+/**
+ * @file TestPrerollRing.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "TestPrerollRing.h"
+
+
+TestPrerollRing::TestPrerollRing()
+    : ring(8, 64) {}
+
+TestPrerollRing::~TestPrerollRing() {}
+
+
+bool TestPrerollRing::pushNumber(uint64_t number)
+{
+    return this->ring.push(reinterpret_cast<const char*>(&number), sizeof(number), number);
+}
+
+
+TEST_F(TestPrerollRing, TestPushRead)
+{
+    ASSERT_TRUE(this->ring.isValid());
+    ASSERT_EQ(this->ring.getSlotCount(), 8u);
+    ASSERT_EQ(this->ring.getSlotSize(), 64u);
+    ASSERT_FALSE(this->ring.push(std::string(65, 'x').c_str(), 65, 0));
+
+    char buff[64];
+    uint64_t position = 0;
+    uint64_t timestamp_ns;
+    ASSERT_EQ(this->ring.read(position, buff, timestamp_ns), -1);
+
+    ASSERT_TRUE(this->ring.push("hello", 5, 100));
+    ASSERT_TRUE(this->ring.push("", 0, 200));
+    ASSERT_EQ(this->ring.getHead(), 2u);
+
+    ASSERT_EQ(this->ring.read(position, buff, timestamp_ns), 5);
+    ASSERT_EQ(std::string(buff, 5), "hello");
+    ASSERT_EQ(timestamp_ns, 100u);
+    ASSERT_EQ(position, 1u);
+    ASSERT_EQ(this->ring.read(position, buff, timestamp_ns), 0);
+    ASSERT_EQ(timestamp_ns, 200u);
+    ASSERT_EQ(this->ring.read(position, buff, timestamp_ns), -1);
+    ASSERT_EQ(position, 2u);
+
+    PrerollRing::Snapshot snapshot = this->ring.getSnapshot();
+    ASSERT_EQ(snapshot.pushed, 2u);
+    ASSERT_EQ(snapshot.pushedBytes, 5u);
+    ASSERT_EQ(snapshot.tooLong, 1u);
+    ASSERT_EQ(snapshot.overruns, 0u);
+    ASSERT_EQ(snapshot.read, 2u);
+}
+
+
+TEST_F(TestPrerollRing, TestSeek)
+{
+    ASSERT_EQ(this->ring.seek(0), 0u);
+    for (uint64_t i = 0; i < 20; i++)
+        ASSERT_TRUE(this->pushNumber(i * 10));
+
+    // Only the newest 7 messages are whole, the slot of the next one goes first
+    ASSERT_EQ(this->ring.seek(0), 13u);
+    ASSERT_EQ(this->ring.seek(150), 15u);
+    ASSERT_EQ(this->ring.seek(151), 16u);
+    ASSERT_EQ(this->ring.seek(190), 19u);
+    ASSERT_EQ(this->ring.seek(191), 20u);
+}
+
+
+TEST_F(TestPrerollRing, TestOverrun)
+{
+    uint64_t position = 0;
+    for (uint64_t i = 0; i < 20; i++)
+        ASSERT_TRUE(this->pushNumber(i));
+
+    // A consumer that fell behind continues with the oldest message left
+    char buff[64];
+    uint64_t timestamp_ns;
+    ASSERT_EQ(this->ring.read(position, buff, timestamp_ns), 8);
+    ASSERT_EQ(timestamp_ns, 13u);
+    ASSERT_EQ(position, 14u);
+    ASSERT_EQ(this->ring.getSnapshot().overruns, 13u);
+}
+
+
+TEST_F(TestPrerollRing, TestSlotCount)
+{
+    // 2 s of 1 MB/s in 1000 byte messages, with as much again as headroom
+    ASSERT_EQ(PrerollRing::getSlotCount(2.0, 1000000, 1000), 4000u);
+    ASSERT_EQ(PrerollRing::getSlotCount(0.0, 1000000, 1000), 2u);
+    ASSERT_EQ(PrerollRing::getSlotCount(1.0, 1000000, 0), 2u);
+    ASSERT_FALSE(PrerollRing(1, 64).isValid());
+}
+
+
+TEST_F(TestPrerollRing, TestConcurrent)
+{
+    // Every message is filled with its own number, a torn copy would mix two
+    const uint64_t count = 200000;
+    std::atomic<bool> done(false);
+    std::thread producer([&]() {
+        uint64_t message[8];
+        for (uint64_t i = 0; i < count; i++)
+        {
+            for (size_t j = 0; j < 8; j++)
+                message[j] = i;
+            this->ring.push(reinterpret_cast<const char*>(message), sizeof(message), i);
+        }
+        done = true;
+    });
+
+    uint64_t position = 0;
+    uint64_t received = 0;
+    uint64_t previous = 0;
+    uint64_t message[8];
+    uint64_t timestamp_ns;
+    while (!done || position < this->ring.getHead())
+    {
+        if (this->ring.read(position, reinterpret_cast<char*>(message), timestamp_ns) == -1)
+            continue;
+        for (size_t j = 0; j < 8; j++)
+            ASSERT_EQ(message[j], timestamp_ns);
+        ASSERT_EQ(timestamp_ns, position - 1);
+        if (received > 0)
+        {
+            ASSERT_GT(timestamp_ns, previous);
+        }
+        previous = timestamp_ns;
+        received++;
+    }
+    producer.join();
+
+    // Whatever was not read was counted as lost
+    PrerollRing::Snapshot snapshot = this->ring.getSnapshot();
+    ASSERT_EQ(snapshot.pushed, count);
+    ASSERT_EQ(snapshot.read, received);
+    ASSERT_EQ(snapshot.read + snapshot.overruns, count);
+}
@@ -0,0 +1,181 @@
+/**
+ * @file TestProcessSupervisor.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "TestProcessSupervisor.h"
+
+// System
+#include <signal.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Ours
+#include "Networking.h"
+
+
+TestProcessSupervisor::TestProcessSupervisor() {}
+
+TestProcessSupervisor::~TestProcessSupervisor() {}
+
+
+bool TestProcessSupervisor::waitForChange(double timeout)
+{
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        if (this->supervisor.getFd() != -1)
+            Networking::waitForInput(this->supervisor.getFd(), -1, 0.05);
+        else
+            usleep(10000);
+        if (this->supervisor.update())
+            return true;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while (now.tv_sec - start.tv_sec + (now.tv_nsec - start.tv_nsec) / 1e9 < timeout);
+    return false;
+}
+
+
+TEST_F(TestProcessSupervisor, TestUnexpectedExit)
+{
+    ASSERT_TRUE(this->supervisor.start({"/bin/sh", "-c", "exit 3"}));
+    ASSERT_GT(this->supervisor.getPid(), 0);
+    ASSERT_NE(this->supervisor.getFd(), -1);
+
+    ASSERT_TRUE(this->waitForChange(5.0));
+    ASSERT_EQ(this->supervisor.getState(), ProcessSupervisor::EXITED);
+    ASSERT_EQ(this->supervisor.getPid(), -1);
+    ASSERT_EQ(this->supervisor.getFd(), -1);
+
+    ProcessSupervisor::Snapshot snapshot = this->supervisor.getSnapshot();
+    ASSERT_TRUE(WIFEXITED(snapshot.lastStatus));
+    ASSERT_EQ(WEXITSTATUS(snapshot.lastStatus), 3);
+    ASSERT_EQ(snapshot.starts, 1u);
+    ASSERT_EQ(snapshot.unexpectedExits, 1u);
+    ASSERT_GT(snapshot.lastSpawn_ns, 0u);
+}
+
+
+TEST_F(TestProcessSupervisor, TestStop)
+{
+    ASSERT_TRUE(this->supervisor.start({"/bin/sleep", "10"}));
+    ASSERT_FALSE(this->supervisor.start({"/bin/sleep", "10"}));
+    ASSERT_FALSE(this->waitForChange(0.1));
+    ASSERT_EQ(this->supervisor.getState(), ProcessSupervisor::RUNNING);
+
+    ASSERT_TRUE(this->supervisor.stop(SIGTERM, 5.0));
+    ASSERT_EQ(this->supervisor.getState(), ProcessSupervisor::STOPPING);
+    ASSERT_FALSE(this->supervisor.stop(SIGTERM, 5.0));
+
+    ASSERT_TRUE(this->waitForChange(5.0));
+    ASSERT_EQ(this->supervisor.getState(), ProcessSupervisor::STOPPED);
+
+    ProcessSupervisor::Snapshot snapshot = this->supervisor.getSnapshot();
+    ASSERT_TRUE(WIFSIGNALED(snapshot.lastStatus));
+    ASSERT_EQ(WTERMSIG(snapshot.lastStatus), SIGTERM);
+    ASSERT_EQ(snapshot.unexpectedExits, 0u);
+    ASSERT_EQ(snapshot.kills, 0u);
+
+    // A stopped supervisor starts again
+    ASSERT_TRUE(this->supervisor.start({"/bin/sleep", "10"}));
+    ASSERT_EQ(this->supervisor.getSnapshot().starts, 2u);
+}
+
+
+TEST_F(TestProcessSupervisor, TestKillAfterTimeout)
+{
+    // Ignored signals stay ignored across exec, so the whole group ignores SIGTERM
+    ASSERT_TRUE(this->supervisor.start({"/bin/sh", "-c", "trap '' TERM; while true; do sleep 0.05; done"}));
+    usleep(100000);
+    ASSERT_TRUE(this->supervisor.stop(SIGTERM, 0.2));
+
+    ASSERT_TRUE(this->waitForChange(5.0));
+    ASSERT_EQ(this->supervisor.getState(), ProcessSupervisor::STOPPED);
+
+    ProcessSupervisor::Snapshot snapshot = this->supervisor.getSnapshot();
+    ASSERT_TRUE(WIFSIGNALED(snapshot.lastStatus));
+    ASSERT_EQ(WTERMSIG(snapshot.lastStatus), SIGKILL);
+    ASSERT_EQ(snapshot.kills, 1u);
+}
+
+
+TEST_F(TestProcessSupervisor, TestStartFailure)
+{
+    ASSERT_FALSE(this->supervisor.start({"/nonexistent/recorder"}));
+    ASSERT_FALSE(this->supervisor.start({}));
+    ASSERT_EQ(this->supervisor.getState(), ProcessSupervisor::STOPPED);
+    ASSERT_EQ(this->supervisor.getPid(), -1);
+    ASSERT_EQ(this->supervisor.getSnapshot().starts, 0u);
+}
+
+
+TEST_F(TestProcessSupervisor, TestSignalsReset)
+{
+    // A child must not inherit a blocked SIGTERM from the thread that starts it
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    bool started = this->supervisor.start({"/bin/sleep", "10"});
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    ASSERT_TRUE(started);
+
+    ASSERT_TRUE(this->supervisor.stop(SIGTERM, 5.0));
+    ASSERT_TRUE(this->waitForChange(5.0));
+    ASSERT_EQ(this->supervisor.getSnapshot().kills, 0u);
+}
+
+
+TEST_F(TestProcessSupervisor, TestInput)
+{
+    // The child waits on its input before it goes on, like an armed recorder
+    ASSERT_TRUE(this->supervisor.start({"/bin/sh", "-c", "read line; [ \"$line\" = go ] && exit 4"}, true));
+    ASSERT_FALSE(this->waitForChange(0.1));
+
+    ASSERT_TRUE(this->supervisor.writeInput("go\n", 3));
+    ASSERT_TRUE(this->waitForChange(5.0));
+    ASSERT_EQ(WEXITSTATUS(this->supervisor.getSnapshot().lastStatus), 4);
+
+    // No pipe once it is reaped, nor for a child started without one
+    ASSERT_FALSE(this->supervisor.writeInput("go\n", 3));
+    ASSERT_TRUE(this->supervisor.start({"/bin/sh", "-c", "exit 0"}));
+    ASSERT_FALSE(this->supervisor.writeInput("go\n", 3));
+    ASSERT_TRUE(this->waitForChange(5.0));
+}
+
+
+TEST_F(TestProcessSupervisor, TestInputAfterExit)
+{
+    // Writing to a child that exited without reading fails instead of raising SIGPIPE
+    ASSERT_TRUE(this->supervisor.start({"/bin/sh", "-c", "exit 0"}, true));
+    usleep(200000);
+    ASSERT_FALSE(this->supervisor.writeInput("go\n", 3));
+    ASSERT_TRUE(this->waitForChange(5.0));
+}
+
+
+TEST_F(TestProcessSupervisor, TestFindByName)
+{
+    // A name no other process on the machine has
+    std::string name = "netlib-test-sleep-" + std::to_string(getpid());
+    std::string path = "/tmp/" + name;
+    ::unlink(path.c_str());
+    ASSERT_EQ(::symlink("/bin/sleep", path.c_str()), 0);
+
+    // The arguments of a new process only show once its exec is complete
+    ASSERT_TRUE(this->supervisor.start({path, "10"}));
+    pid_t found = -1;
+    for (int i = 0; i < 100 && found != this->supervisor.getPid(); i++)
+    {
+        usleep(10000);
+        found = ProcessSupervisor::findByName(name);
+    }
+    ::unlink(path.c_str());
+    ASSERT_EQ(found, this->supervisor.getPid());
+    ASSERT_EQ(ProcessSupervisor::findByName("no-such-program"), -1);
+}
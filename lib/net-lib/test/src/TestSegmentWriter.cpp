@@ -0,0 +1,192 @@
+/**
+ * @file TestSegmentWriter.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "TestSegmentWriter.h"
+
+// STL
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// System
+#include <dirent.h>
+#include <unistd.h>
+
+
+TestSegmentWriter::TestSegmentWriter()
+{
+    char path[] = "/tmp/TestSegmentWriterXXXXXX";
+    if (mkdtemp(path))
+        this->directory = path;
+
+    this->options.directory = this->directory;
+    this->options.prefix = "test";
+    this->options.extension = ".bin";
+    this->options.bufferSize = 4096;
+    this->options.segmentSize = 0;
+    this->options.preallocateSize = 64 * 1024;
+    this->options.syncSize = 16 * 1024;
+}
+
+TestSegmentWriter::~TestSegmentWriter()
+{
+    this->writer.close();
+    for (const std::string& path : this->getSegments())
+        unlink(path.c_str());
+    rmdir(this->directory.c_str());
+}
+
+
+std::vector<std::string> TestSegmentWriter::getSegments() const
+{
+    // Names sort by time and then number
+    std::vector<std::string> paths;
+    DIR* dir = opendir(this->directory.c_str());
+    if (!dir)
+        return paths;
+    while (struct dirent* entry = readdir(dir))
+    {
+        if (entry->d_name[0] != '.')
+            paths.push_back(this->directory + "/" + entry->d_name);
+    }
+    closedir(dir);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+
+std::string TestSegmentWriter::readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+
+std::string TestSegmentWriter::makeMessage(uint32_t number, size_t length)
+{
+    std::string message(length, static_cast<char>('a' + number % 26));
+    memcpy(&message[0], &number, std::min(sizeof(number), length));
+    return message;
+}
+
+
+TEST_F(TestSegmentWriter, TestRoundTrip)
+{
+    ASSERT_FALSE(this->directory.empty());
+    ASSERT_TRUE(this->writer.open(this->options));
+    ASSERT_FALSE(this->writer.open(this->options));
+
+    // Messages spanning buffers, and a last buffer written short
+    std::string expected;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        std::string message = makeMessage(i, 1316);
+        ASSERT_TRUE(this->writer.append(message.data(), message.size()));
+        expected += message;
+    }
+    this->writer.close();
+    ASSERT_FALSE(this->writer.isOpen());
+    ASSERT_FALSE(this->writer.append("x", 1));
+
+    std::vector<std::string> segments = this->getSegments();
+    ASSERT_EQ(segments.size(), 1u);
+    ASSERT_NE(segments[0].find("/test-"), std::string::npos);
+    ASSERT_EQ(segments[0].substr(segments[0].size() - 8), "-000.bin");
+    ASSERT_TRUE(readFile(segments[0]) == expected);
+
+    SegmentWriter::Snapshot snapshot = this->writer.getSnapshot();
+    ASSERT_EQ(snapshot.segments, 1u);
+    ASSERT_EQ(snapshot.bytesWritten, expected.size());
+    ASSERT_EQ(snapshot.writeErrors, 0u);
+    ASSERT_EQ(snapshot.writeTime.count, (expected.size() + 4095) / 4096);
+}
+
+
+TEST_F(TestSegmentWriter, TestSizeRotation)
+{
+    // Four messages fill a segment, the fifth starts the next one
+    this->options.segmentSize = 4000;
+    ASSERT_TRUE(this->writer.open(this->options));
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        std::string message = makeMessage(i, 1000);
+        ASSERT_TRUE(this->writer.append(message.data(), message.size()));
+    }
+    this->writer.close();
+
+    std::vector<std::string> segments = this->getSegments();
+    ASSERT_EQ(segments.size(), 3u);
+    uint32_t number = 0;
+    for (const std::string& path : segments)
+    {
+        std::string contents = readFile(path);
+        ASSERT_LE(contents.size(), 4000u);
+        for (size_t at = 0; at < contents.size(); at += 1000)
+            ASSERT_TRUE(contents.compare(at, 1000, makeMessage(number++, 1000)) == 0);
+    }
+    ASSERT_EQ(number, 10u);
+    ASSERT_EQ(this->writer.getSnapshot().segments, 3u);
+}
+
+
+TEST_F(TestSegmentWriter, TestTimeRotation)
+{
+    this->options.segmentDuration = 0.05;
+    ASSERT_TRUE(this->writer.open(this->options));
+    ASSERT_TRUE(this->writer.append("first", 5));
+    ASSERT_TRUE(this->writer.append("second", 6));
+    usleep(100000);
+    ASSERT_TRUE(this->writer.append("third", 5));
+
+    // rotate() ends a segment at once, an empty one is never created
+    this->writer.rotate();
+    this->writer.rotate();
+    ASSERT_TRUE(this->writer.append("fourth", 6));
+    this->writer.close();
+
+    std::vector<std::string> segments = this->getSegments();
+    ASSERT_EQ(segments.size(), 3u);
+    ASSERT_EQ(readFile(segments[0]), "firstsecond");
+    ASSERT_EQ(readFile(segments[1]), "third");
+    ASSERT_EQ(readFile(segments[2]), "fourth");
+}
+
+
+TEST_F(TestSegmentWriter, TestDirectIo)
+{
+    // Written whole blocks at a time, trimmed back to the bytes appended
+    this->options.directIo = true;
+    this->options.bufferSize = 3 * 4096;
+    ASSERT_TRUE(this->writer.open(this->options));
+    std::string expected;
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        std::string message = makeMessage(i, 1000 + i);
+        ASSERT_TRUE(this->writer.append(message.data(), message.size()));
+        expected += message;
+    }
+    this->writer.close();
+
+    std::vector<std::string> segments = this->getSegments();
+    ASSERT_EQ(segments.size(), 1u);
+    ASSERT_TRUE(readFile(segments[0]) == expected);
+    ASSERT_EQ(this->writer.getSnapshot().bytesWritten, expected.size());
+    ASSERT_EQ(this->writer.getSnapshot().writeErrors, 0u);
+}
+
+
+TEST_F(TestSegmentWriter, TestBadDirectory)
+{
+    this->options.directory = this->directory + "/missing";
+    ASSERT_FALSE(this->writer.open(this->options));
+    ASSERT_FALSE(this->writer.isOpen());
+}
@@ -0,0 +1,156 @@
+/**
+ * @file TestSendQueue.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "TestSendQueue.h"
+
+// System
+#include <sys/socket.h>
+#include <signal.h>
+#include <unistd.h>
+
+
+TestSendQueue::TestSendQueue()
+    : queue(4, 0)
+{
+    socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, this->fds);
+}
+
+TestSendQueue::~TestSendQueue()
+{
+    close(this->fds[0]);
+    close(this->fds[1]);
+}
+
+
+void TestSendQueue::push(SendQueue::Priority priority, const std::string& frame, bool replace)
+{
+    this->queue.push(priority, frame.data(), frame.size(), replace);
+}
+
+
+std::string TestSendQueue::readAll()
+{
+    std::string received;
+    char buf[4096];
+    ssize_t ret;
+    while ((ret = read(this->fds[1], buf, sizeof(buf))) > 0)
+        received.append(buf, ret);
+    return received;
+}
+
+
+TEST_F(TestSendQueue, TestPriorityOrder)
+{
+    this->push(SendQueue::BULK, "bulk;");
+    this->push(SendQueue::STATUS, "status;");
+    this->push(SendQueue::URGENT, "urgent1;");
+    this->push(SendQueue::URGENT, "urgent2;");
+    ASSERT_FALSE(this->queue.isEmpty());
+
+    ASSERT_EQ(this->queue.flush(this->fds[0]), SendQueue::FLUSHED);
+    ASSERT_TRUE(this->queue.isEmpty());
+    ASSERT_EQ(this->readAll(), "urgent1;urgent2;status;bulk;");
+
+    SendQueue::Snapshot snapshot = this->queue.getSnapshot();
+    ASSERT_EQ(snapshot.sent[SendQueue::URGENT], 2u);
+    ASSERT_EQ(snapshot.sent[SendQueue::STATUS], 1u);
+    ASSERT_EQ(snapshot.sent[SendQueue::BULK], 1u);
+}
+
+
+TEST_F(TestSendQueue, TestReplaceAndDrop)
+{
+    this->push(SendQueue::STATUS, "old;");
+    this->push(SendQueue::STATUS, "older;");
+    this->push(SendQueue::STATUS, "new;", true);
+
+    // The oldest frame goes once a class is full
+    for (int i = 0; i < 5; i++)
+        this->push(SendQueue::URGENT, std::string(1, 'a' + i));
+
+    ASSERT_EQ(this->queue.flush(this->fds[0]), SendQueue::FLUSHED);
+    ASSERT_EQ(this->readAll(), "bcdenew;");
+
+    SendQueue::Snapshot snapshot = this->queue.getSnapshot();
+    ASSERT_EQ(snapshot.replaced, 2u);
+    ASSERT_EQ(snapshot.dropped, 1u);
+}
+
+
+TEST_F(TestSendQueue, TestPartialWriteResumes)
+{
+    // Fill the stream until the kernel takes no more
+    std::string big(1 << 16, 'x');
+    std::string sent;
+    for (int i = 0; i < 64 && this->queue.flush(this->fds[0]) != SendQueue::BLOCKED; i++)
+        this->push(SendQueue::STATUS, big);
+    ASSERT_FALSE(this->queue.isEmpty());
+    ASSERT_GT(this->queue.getSnapshot().blocked, 0u);
+
+    // An urgent frame waits only for the rest of the frame already started
+    this->push(SendQueue::URGENT, "urgent;");
+
+    std::string received;
+    SendQueue::Result result;
+    do
+    {
+        result = this->queue.flush(this->fds[0]);
+        received += this->readAll();
+    } while (result != SendQueue::FLUSHED);
+    received += this->readAll();
+
+    size_t urgent = received.find("urgent;");
+    ASSERT_NE(urgent, std::string::npos);
+    ASSERT_EQ(urgent % big.size(), 0u);
+    ASSERT_EQ(received.size() % big.size(), 7u);
+    ASSERT_EQ(received.find_first_not_of('x'), urgent);
+    ASSERT_GT(this->queue.getSnapshot().partialWrites, 0u);
+}
+
+
+TEST_F(TestSendQueue, TestBulkThrottled)
+{
+    // A Unix socket counts the buffers around its bytes too, so hold bulk
+    // back as soon as anything is left unread
+    SendQueue throttled(4, 1);
+    std::string bulk(300, 'b');
+    throttled.push(SendQueue::BULK, bulk.data(), bulk.size());
+    throttled.push(SendQueue::BULK, bulk.data(), bulk.size());
+
+    // The second bulk frame waits until the first one left the kernel
+    ASSERT_EQ(throttled.flush(this->fds[0]), SendQueue::THROTTLED);
+    throttled.push(SendQueue::URGENT, "urgent;", 7);
+    ASSERT_EQ(throttled.flush(this->fds[0]), SendQueue::THROTTLED);
+    ASSERT_EQ(this->readAll(), bulk + "urgent;");
+
+    ASSERT_EQ(throttled.flush(this->fds[0]), SendQueue::FLUSHED);
+    ASSERT_EQ(this->readAll(), bulk);
+}
+
+
+TEST_F(TestSendQueue, TestClear)
+{
+    this->push(SendQueue::URGENT, "a");
+    this->push(SendQueue::BULK, "b");
+    this->queue.clear();
+    ASSERT_TRUE(this->queue.isEmpty());
+    ASSERT_EQ(this->queue.flush(this->fds[0]), SendQueue::FLUSHED);
+    ASSERT_EQ(this->readAll(), "");
+}
+
+
+TEST_F(TestSendQueue, TestFailed)
+{
+    close(this->fds[1]);
+    this->fds[1] = -1;
+    signal(SIGPIPE, SIG_IGN);
+
+    this->push(SendQueue::URGENT, "a");
+    ASSERT_EQ(this->queue.flush(this->fds[0]), SendQueue::FAILED);
+    ASSERT_FALSE(this->queue.isEmpty());
+}
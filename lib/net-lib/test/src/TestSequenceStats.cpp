@@ -0,0 +1,106 @@
+/**
+ * @file TestSequenceStats.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "TestSequenceStats.h"
+
+
+TestSequenceStats::TestSequenceStats() {}
+
+TestSequenceStats::~TestSequenceStats() {}
+
+
+TEST_F(TestSequenceStats, TestInOrder)
+{
+    for (uint32_t i = 100; i < 200; i++)
+        ASSERT_EQ(this->stats.record(i), SequenceStats::NEW);
+
+    SequenceStats::Snapshot snapshot = this->stats.getSnapshot();
+    ASSERT_EQ(snapshot.received, 100u);
+    ASSERT_EQ(snapshot.lost, 0u);
+    ASSERT_EQ(snapshot.reordered, 0u);
+    ASSERT_EQ(snapshot.duplicates, 0u);
+    ASSERT_EQ(snapshot.highest, 199u);
+}
+
+
+TEST_F(TestSequenceStats, TestLossAndReorder)
+{
+    ASSERT_EQ(this->stats.record(1), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.record(2), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.record(6), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.getSnapshot().lost, 3u);
+
+    // A missing message turning up late is no longer lost
+    ASSERT_EQ(this->stats.record(4), SequenceStats::REORDERED);
+    ASSERT_EQ(this->stats.record(4), SequenceStats::DUPLICATE);
+    ASSERT_EQ(this->stats.record(6), SequenceStats::DUPLICATE);
+    ASSERT_EQ(this->stats.record(7), SequenceStats::NEW);
+
+    SequenceStats::Snapshot snapshot = this->stats.getSnapshot();
+    ASSERT_EQ(snapshot.received, 5u);
+    ASSERT_EQ(snapshot.lost, 2u);
+    ASSERT_EQ(snapshot.reordered, 1u);
+    ASSERT_EQ(snapshot.duplicates, 2u);
+    ASSERT_EQ(snapshot.highest, 7u);
+}
+
+
+TEST_F(TestSequenceStats, TestWrapAround)
+{
+    ASSERT_EQ(this->stats.record(0xFFFFFFFE), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.record(0xFFFFFFFF), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.record(1), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.record(0), SequenceStats::REORDERED);
+
+    SequenceStats::Snapshot snapshot = this->stats.getSnapshot();
+    ASSERT_EQ(snapshot.lost, 0u);
+    ASSERT_EQ(snapshot.highest, 1u);
+}
+
+
+TEST_F(TestSequenceStats, TestLargeGap)
+{
+    ASSERT_EQ(this->stats.record(10), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.record(1010), SequenceStats::NEW);
+    ASSERT_EQ(this->stats.getSnapshot().lost, 999u);
+
+    // The window moved entirely past the old numbers
+    ASSERT_EQ(this->stats.record(1009), SequenceStats::REORDERED);
+    ASSERT_EQ(this->stats.record(1010), SequenceStats::DUPLICATE);
+}
+
+
+TEST_F(TestSequenceStats, TestRestart)
+{
+    for (uint32_t i = 0; i < 500; i++)
+        this->stats.record(i);
+
+    // The peer came back counting from 0
+    ASSERT_EQ(this->stats.record(0), SequenceStats::RESTARTED);
+    ASSERT_EQ(this->stats.record(1), SequenceStats::NEW);
+
+    SequenceStats::Snapshot snapshot = this->stats.getSnapshot();
+    ASSERT_EQ(snapshot.restarts, 1u);
+    ASSERT_EQ(snapshot.received, 502u);
+    ASSERT_EQ(snapshot.lost, 0u);
+    ASSERT_EQ(snapshot.highest, 1u);
+
+    this->stats.reset();
+    snapshot = this->stats.getSnapshot();
+    ASSERT_EQ(snapshot.received, 0u);
+    ASSERT_EQ(snapshot.restarts, 0u);
+    ASSERT_EQ(this->stats.record(0), SequenceStats::NEW);
+}
+
+
+int main(int argc, char** argv)
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,225 @@
+/**
+ * @file TestShmRing.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <cstring>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "TestShmRing.h"
+
+
+TestShmRing::TestShmRing() {}
+
+TestShmRing::~TestShmRing() {}
+
+void TestShmRing::SetUp()
+{
+    ASSERT_TRUE(this->producer.create("netlib-test", 4, 256));
+}
+
+
+TEST_F(TestShmRing, TestSendReceive)
+{
+    ShmRing consumer;
+    ASSERT_TRUE(consumer.attach(this->producer.getFd()));
+    ASSERT_EQ(consumer.getSlotCount(), 4u);
+    ASSERT_EQ(consumer.getSlotSize(), 256u);
+    ASSERT_TRUE(consumer.subscribe());
+
+    // Only the creator produces
+    ASSERT_FALSE(consumer.send("x", 1));
+    ASSERT_FALSE(this->producer.send(std::string(257, 'x').c_str(), 257));
+
+    char buff[256];
+    for (int i = 0; i < 10; i++)
+    {
+        std::string message = "message " + std::to_string(i);
+        ASSERT_TRUE(this->producer.send(message.c_str(), message.size()));
+        ASSERT_EQ(consumer.receive(buff, sizeof(buff), 0.1), (ssize_t)message.size());
+        ASSERT_EQ(std::string(buff, message.size()), message);
+    }
+    ASSERT_EQ(consumer.receive(buff, sizeof(buff), 0.01), -1);
+    ASSERT_EQ(this->producer.getPublished(), 10u);
+}
+
+
+TEST_F(TestShmRing, TestZeroCopy)
+{
+    ShmRing consumer;
+    ASSERT_TRUE(consumer.attach(this->producer.getFd()));
+    ASSERT_TRUE(consumer.subscribe());
+
+    char* slot = this->producer.claim(0.1);
+    ASSERT_NE(slot, nullptr);
+    ASSERT_EQ((uintptr_t)slot % 16, 0u);
+    memcpy(slot, "in place", 8);
+
+    // Nothing is visible before publish
+    size_t length = 0;
+    ASSERT_EQ(consumer.peek(length, 0.01), nullptr);
+    ASSERT_TRUE(this->producer.publish(8));
+
+    const char* message = consumer.peek(length, 0.1);
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(length, 8u);
+    ASSERT_EQ(std::string(message, length), "in place");
+
+    // The consumer reads the producer's pages, not a copy
+    slot[0] = 'I';
+    ASSERT_EQ(message[0], 'I');
+    consumer.release();
+}
+
+
+TEST_F(TestShmRing, TestConsumersSeeEveryMessageAndHoldProducer)
+{
+    ShmRing fast, slow;
+    ASSERT_TRUE(fast.attach(this->producer.getFd()));
+    ASSERT_TRUE(slow.attach(this->producer.getFd()));
+    ASSERT_TRUE(fast.subscribe());
+    ASSERT_TRUE(slow.subscribe());
+
+    char buff[16];
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(this->producer.send((char*)&i, sizeof(i), 0.1));
+        ASSERT_EQ(fast.receive(buff, sizeof(buff), 0.1), (ssize_t)sizeof(i));
+    }
+
+    // The slow consumer has not read anything, so the ring is full
+    int next = 4;
+    ASSERT_FALSE(this->producer.send((char*)&next, sizeof(next), 0.05));
+
+    ASSERT_EQ(slow.receive(buff, sizeof(buff), 0.1), (ssize_t)sizeof(int));
+    ASSERT_EQ(*(int*)buff, 0);
+    ASSERT_TRUE(this->producer.send((char*)&next, sizeof(next), 0.1));
+
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_EQ(slow.receive(buff, sizeof(buff), 0.1), (ssize_t)sizeof(int));
+        ASSERT_EQ(*(int*)buff, i);
+    }
+    ASSERT_EQ(fast.receive(buff, sizeof(buff), 0.1), (ssize_t)sizeof(int));
+    ASSERT_EQ(*(int*)buff, 4);
+
+    // A consumer that leaves no longer holds the producer
+    slow.unsubscribe();
+    for (int i = 0; i < 4; i++)
+        ASSERT_TRUE(this->producer.send((char*)&i, sizeof(i), 0.1));
+}
+
+
+TEST_F(TestShmRing, TestAcrossProcesses)
+{
+    const int count = 1000;
+    int ready[2];
+    ASSERT_EQ(::pipe(ready), 0);
+
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0)
+    {
+        // Consumer process, sums what it receives and reports through the exit
+        // status
+        ShmRing consumer;
+        if (!consumer.attach(this->producer.getFd()) || !consumer.subscribe())
+            _exit(2);
+        char c = 1;
+        if (::write(ready[1], &c, 1) != 1)
+            _exit(2);
+
+        long sum = 0;
+        for (int i = 0; i < count; i++)
+        {
+            int value;
+            if (consumer.receive((char*)&value, sizeof(value), 5.0) != sizeof(value))
+                _exit(3);
+            sum += value;
+        }
+        _exit(sum == (long)count * (count - 1) / 2 ? 0 : 4);
+    }
+
+    char c;
+    ASSERT_EQ(::read(ready[0], &c, 1), 1);
+    for (int i = 0; i < count; i++)
+        ASSERT_TRUE(this->producer.send((char*)&i, sizeof(i), 5.0));
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ::close(ready[0]);
+    ::close(ready[1]);
+}
+
+
+TEST_F(TestShmRing, TestDeadConsumerIsDropped)
+{
+    pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0)
+    {
+        // Subscribe and die without reading
+        ShmRing consumer;
+        _exit(consumer.attach(this->producer.getFd()) && consumer.subscribe() ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    for (int i = 0; i < 4; i++)
+        ASSERT_TRUE(this->producer.send((char*)&i, sizeof(i), 0.1));
+    ASSERT_TRUE(this->producer.send("x", 1, 0.1));
+}
+
+
+TEST_F(TestShmRing, TestInterruptWakesPeek)
+{
+    ShmRing consumer;
+    ASSERT_TRUE(consumer.attach(this->producer.getFd()));
+    ASSERT_TRUE(consumer.subscribe());
+
+    bool woken = false;
+    std::thread waiter([&]() {
+        size_t length;
+        woken = consumer.peek(length) == nullptr;
+    });
+    usleep(10000);
+    consumer.interrupt();
+    waiter.join();
+    ASSERT_TRUE(woken);
+
+    // Messages still get through once cleared
+    consumer.clearInterrupt();
+    ASSERT_TRUE(this->producer.send("y", 1));
+    char buff[4];
+    ASSERT_EQ(consumer.receive(buff, sizeof(buff), 0.1), 1);
+}
+
+
+TEST_F(TestShmRing, TestAttachRejectsOtherFiles)
+{
+    int pipes[2];
+    ASSERT_EQ(::pipe(pipes), 0);
+    ShmRing consumer;
+    ASSERT_FALSE(consumer.attach(pipes[0]));
+    ::close(pipes[0]);
+    ::close(pipes[1]);
+}
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
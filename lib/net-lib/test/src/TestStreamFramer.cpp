@@ -0,0 +1,264 @@
+/**
+ * @file TestStreamFramer.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "TestStreamFramer.h"
+
+// STL
+#include <algorithm>
+#include <cstring>
+
+// System
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace {
+
+const uint8_t header[] = {0xAA, 0x55};
+const uint8_t footer = 0xEE;
+
+}  // ANONYMOUS
+
+
+const size_t TestStreamFramer::frameSize;
+
+
+TestStreamFramer::TestStreamFramer()
+    : framer(frameSize, header, sizeof(header), &TestStreamFramer::validate, 0) {}
+
+TestStreamFramer::~TestStreamFramer() {}
+
+
+std::vector<uint8_t> TestStreamFramer::makeFrame(uint8_t payload)
+{
+    std::vector<uint8_t> frame(frameSize, payload);
+    frame[0] = header[0];
+    frame[1] = header[1];
+    frame[frameSize - 1] = footer;
+    return frame;
+}
+
+
+bool TestStreamFramer::validate(const uint8_t* frame, size_t length)
+{
+    if (frame[length - 1] != footer)
+        return false;
+    for (size_t i = 3; i < length - 1; i++)
+    {
+        if (frame[i] != frame[2])
+            return false;
+    }
+    return true;
+}
+
+
+std::vector<uint8_t> TestStreamFramer::feed(const std::vector<uint8_t>& bytes)
+{
+    std::vector<uint8_t> payloads;
+    size_t written = 0;
+    while (written < bytes.size())
+    {
+        size_t space;
+        uint8_t* buf = this->framer.getWriteBuffer(&space);
+        EXPECT_GT(space, 0u);
+        space = std::min(space, bytes.size() - written);
+        memcpy(buf, &bytes[written], space);
+        this->framer.commitWrite(space);
+        written += space;
+
+        std::vector<uint8_t> drained = this->drain();
+        payloads.insert(payloads.end(), drained.begin(), drained.end());
+    }
+    return payloads;
+}
+
+
+std::vector<uint8_t> TestStreamFramer::drain()
+{
+    std::vector<uint8_t> payloads;
+    const uint8_t* frame;
+    while ((frame = this->framer.next()) != nullptr)
+        payloads.push_back(frame[2]);
+    return payloads;
+}
+
+
+TEST_F(TestStreamFramer, TestConcatenatedFrames)
+{
+    std::vector<uint8_t> stream;
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        std::vector<uint8_t> frame = makeFrame(i);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    ASSERT_EQ(this->feed(stream), std::vector<uint8_t>({1, 2, 3}));
+    ASSERT_EQ(this->framer.getBuffered(), 0u);
+
+    StreamFramer::Snapshot snapshot = this->framer.getSnapshot();
+    ASSERT_EQ(snapshot.frames, 3u);
+    ASSERT_EQ(snapshot.discardedBytes, 0u);
+    ASSERT_EQ(snapshot.resyncs, 0u);
+}
+
+
+TEST_F(TestStreamFramer, TestSplitReads)
+{
+    // One byte per read, across many laps of the ring
+    std::vector<uint8_t> expected;
+    for (int i = 0; i < 100; i++)
+    {
+        std::vector<uint8_t> frame = makeFrame(static_cast<uint8_t>(i));
+        for (size_t j = 0; j < frame.size(); j++)
+        {
+            std::vector<uint8_t> payloads = this->feed(std::vector<uint8_t>(1, frame[j]));
+            if (j + 1 < frame.size())
+                ASSERT_TRUE(payloads.empty());
+            else
+                ASSERT_EQ(payloads, std::vector<uint8_t>(1, static_cast<uint8_t>(i)));
+        }
+    }
+    ASSERT_EQ(this->framer.getSnapshot().frames, 100u);
+    ASSERT_EQ(this->framer.getSnapshot().resyncs, 0u);
+}
+
+
+TEST_F(TestStreamFramer, TestWrappingFrame)
+{
+    // Offsets the stream so frames straddle the end of the 16 byte ring
+    ASSERT_TRUE(this->feed(std::vector<uint8_t>(3, 0x00)).empty());
+
+    for (uint8_t i = 1; i <= 20; i++)
+    {
+        ASSERT_EQ(this->feed(makeFrame(i)), std::vector<uint8_t>(1, i));
+    }
+    ASSERT_EQ(this->framer.getSnapshot().discardedBytes, 3u);
+    ASSERT_EQ(this->framer.getSnapshot().resyncs, 1u);
+}
+
+
+TEST_F(TestStreamFramer, TestResync)
+{
+    std::vector<uint8_t> stream = {0x01, 0xAA, 0x02, 0xAA};
+    std::vector<uint8_t> frame = makeFrame(7);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    stream.push_back(0x55);
+    frame = makeFrame(8);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    ASSERT_EQ(this->feed(stream), std::vector<uint8_t>({7, 8}));
+
+    StreamFramer::Snapshot snapshot = this->framer.getSnapshot();
+    ASSERT_EQ(snapshot.frames, 2u);
+    ASSERT_EQ(snapshot.discardedBytes, 5u);
+    ASSERT_EQ(snapshot.resyncs, 2u);
+    ASSERT_EQ(snapshot.invalidFrames, 0u);
+}
+
+
+TEST_F(TestStreamFramer, TestFrameInsideInvalidFrame)
+{
+    // A header whose frame is cut short by a real one
+    std::vector<uint8_t> stream = {0xAA, 0x55, 0x09};
+    std::vector<uint8_t> frame = makeFrame(4);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    ASSERT_EQ(this->feed(stream), std::vector<uint8_t>(1, 4));
+
+    StreamFramer::Snapshot snapshot = this->framer.getSnapshot();
+    ASSERT_EQ(snapshot.invalidFrames, 1u);
+    ASSERT_EQ(snapshot.discardedBytes, 3u);
+    ASSERT_EQ(snapshot.resyncs, 1u);
+}
+
+
+TEST_F(TestStreamFramer, TestClear)
+{
+    std::vector<uint8_t> frame = makeFrame(5);
+    ASSERT_TRUE(this->feed(std::vector<uint8_t>(frame.begin(), frame.begin() + 4)).empty());
+    ASSERT_EQ(this->framer.getBuffered(), 4u);
+
+    this->framer.clear();
+    ASSERT_EQ(this->framer.getBuffered(), 0u);
+
+    ASSERT_EQ(this->feed(makeFrame(6)), std::vector<uint8_t>(1, 6));
+}
+
+
+TEST_F(TestStreamFramer, TestReadFrom)
+{
+    int fds[2];
+    ASSERT_EQ(pipe2(fds, O_NONBLOCK), 0);
+
+    std::vector<uint8_t> stream(5, 0x00);
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        std::vector<uint8_t> frame = makeFrame(i);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    ASSERT_EQ(::write(fds[1], stream.data(), stream.size()), static_cast<ssize_t>(stream.size()));
+
+    // The ring only takes up to its end per read
+    std::vector<uint8_t> payloads;
+    ssize_t ret;
+    while ((ret = this->framer.readFrom(fds[0])) > 0)
+    {
+        std::vector<uint8_t> drained = this->drain();
+        payloads.insert(payloads.end(), drained.begin(), drained.end());
+    }
+    ASSERT_EQ(ret, -1);
+    ASSERT_EQ(payloads, std::vector<uint8_t>({1, 2, 3}));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+
+namespace {
+
+// Frames of the variable length test, the third byte is the frame size
+size_t sizeFrame(const uint8_t* frame)
+{
+    return frame[2];
+}
+
+}  // ANONYMOUS
+
+
+TEST_F(TestStreamFramer, TestVariableLength)
+{
+    StreamFramer variable(16, 3, header, sizeof(header), &sizeFrame, nullptr, 0);
+
+    // Frames of 4, 16 and 3 bytes, one with a size beyond the largest frame
+    // and a header that starts no frame in front, fed a byte at a time
+    const uint8_t stream[] = {0xAA, 0x55, 40, 0x01,
+        0xAA, 0x55, 0,
+        0xAA, 0x55, 4, 0x07,
+        0xAA, 0x55, 16, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+        0xAA, 0x55, 3};
+
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < sizeof(stream); i++)
+    {
+        size_t space;
+        uint8_t* buf = variable.getWriteBuffer(&space);
+        ASSERT_GT(space, 0u);
+        *buf = stream[i];
+        variable.commitWrite(1);
+
+        size_t length;
+        const uint8_t* frame;
+        while ((frame = variable.next(&length)) != nullptr)
+        {
+            ASSERT_EQ(frame[2], length);
+            sizes.push_back(length);
+        }
+    }
+
+    ASSERT_EQ(sizes, std::vector<size_t>({4, 16, 3}));
+    StreamFramer::Snapshot snapshot = variable.getSnapshot();
+    ASSERT_EQ(snapshot.invalidFrames, 1u);
+    ASSERT_EQ(snapshot.discardedBytes, 7u);
+}
@@ -114,6 +114,22 @@ TEST_F(TestTcp, TestTcpServerReconnect)
 }
 
 
+TEST_F(TestTcp, TestTcpServerDisconnectWakesAccept)
+{
+    // Accept timeout of 0 waits for a client without spinning until woken
+    ASSERT_TRUE(this->tcpServer->disconnect());
+    ASSERT_TRUE(this->tcpServer->connect(this->tcpServerAddress, this->tcpPort));
+    ASSERT_TRUE(this->tcpServer->runInThread(this->task1, 0, 5.0));
+    usleep(100000);
+
+    const double start = Networking::getWallTime();
+    ASSERT_TRUE(this->tcpServer->disconnect());
+    ASSERT_LT(Networking::getWallTime() - start, 0.05);
+    ASSERT_FALSE(this->tcpServer->running);
+    ASSERT_FALSE(this->tcpServer->time2Exit);
+}
+
+
 /** Application main entry point.
  */
 int main(int argc, char* argv[])
@@ -0,0 +1,119 @@
+/**
+ * @file TestThreadConfig.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <thread>
+
+#include "TestThreadConfig.h"
+
+
+TestThreadConfig::TestThreadConfig() {}
+
+TestThreadConfig::~TestThreadConfig()
+{
+    Threading::clearConfig();
+}
+
+
+TEST_F(TestThreadConfig, TestParseConfig)
+{
+    ASSERT_TRUE(Threading::parseConfig("button:90:3,led:0"));
+
+    ThreadConfig config;
+    ASSERT_TRUE(Threading::getConfig("button", config));
+    ASSERT_EQ(config.name, "button");
+    ASSERT_EQ(config.priority, 90);
+    ASSERT_EQ(config.cpu, 3);
+
+    ASSERT_TRUE(Threading::getConfig("led", config));
+    ASSERT_EQ(config.priority, 0);
+    ASSERT_EQ(config.cpu, -1);
+
+    ASSERT_FALSE(Threading::getConfig("read", config));
+}
+
+
+TEST_F(TestThreadConfig, TestParseConfigKeepsPin)
+{
+    // A profile pins the role, an override without a cpu only changes the priority
+    Threading::setConfig("read", ThreadConfig("read", 80, 2));
+    ASSERT_TRUE(Threading::parseConfig("read:85"));
+
+    ThreadConfig config;
+    ASSERT_TRUE(Threading::getConfig("read", config));
+    ASSERT_EQ(config.priority, 85);
+    ASSERT_EQ(config.cpu, 2);
+
+    ASSERT_TRUE(Threading::parseConfig("read:85:-1"));
+    ASSERT_TRUE(Threading::getConfig("read", config));
+    ASSERT_EQ(config.cpu, -1);
+}
+
+
+TEST_F(TestThreadConfig, TestParseConfigRejectsBadEntries)
+{
+    ASSERT_FALSE(Threading::parseConfig("button:fast"));
+    ASSERT_FALSE(Threading::parseConfig("button:100"));
+    ASSERT_FALSE(Threading::parseConfig(":10"));
+    ASSERT_FALSE(Threading::parseConfig("read:80:x"));
+
+    ThreadConfig config;
+    ASSERT_FALSE(Threading::getConfig("button", config));
+    ASSERT_FALSE(Threading::getConfig("read", config));
+}
+
+
+TEST_F(TestThreadConfig, TestConfigureThreadSetsNameAndAffinity)
+{
+    Threading::setConfig("worker", ThreadConfig("netlib-worker", 0, 0));
+
+    std::string name;
+    cpu_set_t cpus;
+    bool success = false;
+    std::thread worker([&]() {
+        success = Threading::configureThread("worker");
+
+        char buff[16];
+        pthread_getname_np(pthread_self(), buff, sizeof(buff));
+        name = buff;
+        pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    });
+    worker.join();
+
+    ASSERT_TRUE(success);
+    ASSERT_EQ(name, "netlib-worker");
+    ASSERT_EQ(CPU_COUNT(&cpus), 1);
+    ASSERT_TRUE(CPU_ISSET(0, &cpus));
+}
+
+
+TEST_F(TestThreadConfig, TestUnconfiguredRoleOnlySetsName)
+{
+    std::string name;
+    bool success = false;
+    std::thread worker([&]() {
+        success = Threading::configureThread("unlisted");
+
+        char buff[16];
+        pthread_getname_np(pthread_self(), buff, sizeof(buff));
+        name = buff;
+    });
+    worker.join();
+
+    ASSERT_TRUE(success);
+    ASSERT_EQ(name, "unlisted");
+}
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,341 @@
+/**
+ * @file TestUdp.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "TestUdp.h"
+
+
+const std::string TestUdp::udpAddress = "127.0.0.1";
+const int TestUdp::udpPort = 4004;
+
+TestUdp::TestUdp()
+    : task1Count(0),
+      udpServer(nullptr),
+      udpClient(nullptr)
+{}
+
+TestUdp::~TestUdp() {}
+
+void TestUdp::SetUp()
+{
+    this->task1 = std::bind(&TestUdp::serverTask1, this, std::placeholders::_1,
+        std::placeholders::_2, std::placeholders::_3);
+    this->udpServer = new UdpServer();
+    this->udpClient = new UdpClient(this->udpAddress, this->udpPort);
+}
+
+void TestUdp::TearDown()
+{
+    this->udpServer->disconnect();
+    delete this->udpServer;
+    delete this->udpClient;
+}
+
+
+bool TestUdp::serverTask1(int, char*, size_t)
+{
+    this->task1Count++;
+    return true;
+}
+
+
+int TestUdp::getBusyPoll() const
+{
+    int busyPoll = 0;
+    socklen_t length = sizeof(busyPoll);
+    if (::getsockopt(this->udpServer->sockServer, SOL_SOCKET, SO_BUSY_POLL, (char*)&busyPoll, &length) != 0)
+        return -1;
+    return busyPoll;
+}
+
+
+uint64_t TestUdp::overflowServer()
+{
+    char buff[64] = {0};
+    for (int i = 0; i < 1000; i++)
+        this->udpClient->send(buff, sizeof(buff));
+
+    // The kernel only stamps the drop count on datagrams queued after the
+    // drops happened
+    uint64_t received = 0;
+    while (this->udpServer->receiveUdp(buff, sizeof(buff)) == 64)
+        received++;
+    EXPECT_GT(received, 0u);
+    EXPECT_LT(received, 1000u);
+
+    EXPECT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    usleep(10000);
+    EXPECT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 64);
+    return 1000 - received;
+}
+
+
+TEST_F(TestUdp, TestUdpServerCountsTraffic)
+{
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    ASSERT_TRUE(this->udpServer->runInThread(this->task1, 256, 0.1));
+
+    char buff[32] = {0};
+    for (int i = 0; i < 10; i++)
+        ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    for (int i = 0; i < 100 && this->task1Count < 10; i++)
+        usleep(10000);
+
+    SocketStats::Snapshot stats = this->udpServer->getStats();
+    ASSERT_EQ(this->task1Count, 10);
+    ASSERT_EQ(stats.rxPackets, 10u);
+    ASSERT_EQ(stats.rxBytes, 320u);
+    ASSERT_EQ(stats.handlerCalls, 10u);
+    ASSERT_EQ(stats.rxErrors, 0u);
+    ASSERT_EQ(stats.kernelDrops, 0u);
+
+    // Reply goes back to the client that spoke last
+    ASSERT_EQ(this->udpServer->send(buff, 8), 8);
+    ASSERT_EQ(this->udpServer->getStats().txBytes, 8u);
+
+    this->udpServer->resetStats();
+    ASSERT_EQ(this->udpServer->getStats().rxPackets, 0u);
+}
+
+
+TEST_F(TestUdp, TestUdpServerKernelDrops)
+{
+    // Smallest receive buffer the kernel allows and nobody reading it
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 1));
+    ASSERT_GT(this->udpServer->getReceiveBufferSize(), 0);
+
+    char buff[64] = {0};
+    for (int i = 0; i < 1000; i++)
+        this->udpClient->send(buff, sizeof(buff));
+
+    // Drain what fit, the kernel only stamps the drop count on datagrams
+    // queued after the drops happened
+    int received = 0;
+    while (this->udpServer->receiveUdp(buff, sizeof(buff)) == 64)
+        received++;
+    ASSERT_GT(received, 0);
+    ASSERT_LT(received, 1000);
+    ASSERT_EQ(this->udpServer->getStats().kernelDrops, 0u);
+
+    ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 64);
+    SocketStats::Snapshot stats = this->udpServer->getStats();
+    ASSERT_EQ(stats.rxPackets, (uint64_t)received + 1);
+    ASSERT_EQ(stats.kernelDrops, (uint64_t)(1000 - received));
+}
+
+
+TEST_F(TestUdp, TestUdpServerKernelDropsAccumulate)
+{
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 1));
+    uint64_t dropped = this->overflowServer();
+    ASSERT_EQ(this->udpServer->getStats().kernelDrops, dropped);
+
+    // The socket's running count does not bring back what was reset
+    this->udpServer->resetStats();
+    char buff[64] = {0};
+    ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 64);
+    ASSERT_EQ(this->udpServer->getStats().kernelDrops, 0u);
+
+    dropped = this->overflowServer();
+    ASSERT_EQ(this->udpServer->getStats().kernelDrops, dropped);
+
+    // A new socket counts from 0 again, what the old one dropped is kept
+    ASSERT_TRUE(this->udpServer->disconnect());
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 1));
+    dropped += this->overflowServer();
+    ASSERT_EQ(this->udpServer->getStats().kernelDrops, dropped);
+}
+
+
+TEST_F(TestUdp, TestUdpServerTruncation)
+{
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+
+    char buff[64] = {0};
+    ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    usleep(10000);
+
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, 16), 16);
+    SocketStats::Snapshot stats = this->udpServer->getStats();
+    ASSERT_EQ(stats.rxErrors, 1u);
+    ASSERT_EQ(stats.errors[EMSGSIZE], 1u);
+}
+
+
+TEST_F(TestUdp, TestUdpServerDisconnectWakesReceive)
+{
+    // Read timeout of 0 blocks until a datagram or a wakeup
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    ASSERT_TRUE(this->udpServer->runInThread(this->task1, 256, 0));
+    usleep(100000);
+
+    const double start = Networking::getWallTime();
+    ASSERT_TRUE(this->udpServer->disconnect());
+    ASSERT_LT(Networking::getWallTime() - start, 0.05);
+    ASSERT_FALSE(this->udpServer->isRunning());
+
+    // The server runs again after a reconnect
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    ASSERT_TRUE(this->udpServer->runInThread(this->task1, 256, 0));
+    char buff[8] = {0};
+    ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    for (int i = 0; i < 100 && this->task1Count < 1; i++)
+        usleep(10000);
+    ASSERT_EQ(this->task1Count, 1);
+}
+
+
+TEST_F(TestUdp, TestUdpServerClearLowLatency)
+{
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    const int before = this->getBusyPoll();
+    ASSERT_GE(before, 0);
+
+    // Raising busy polling needs CAP_NET_ADMIN, nothing to undo without it
+    UdpServer::LowLatencyOptions options;
+    options.busyPoll_us = before + 25;
+    options.preferBusyPoll = false;
+    if (!this->udpServer->setLowLatency(options))
+        return;
+    ASSERT_EQ(this->getBusyPoll(), before + 25);
+
+    this->udpServer->clearLowLatency();
+    ASSERT_EQ(this->getBusyPoll(), before);
+}
+
+
+TEST_F(TestUdp, TestUdpServerConnectedPeer)
+{
+    // Nothing listens on the peer port, so the kernel answers with ICMP
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    ASSERT_TRUE(this->udpServer->setClientInfo(this->udpAddress, this->udpPort + 1, true));
+    ASSERT_FALSE(this->udpServer->isPeerUnreachable());
+
+    char buff[8] = {0};
+    ASSERT_EQ(this->udpServer->send(buff, sizeof(buff)), 8);
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), -1);
+    ASSERT_EQ(errno, ECONNREFUSED);
+    ASSERT_TRUE(this->udpServer->isPeerUnreachable());
+
+    // Datagrams from anyone but the peer are dropped by the kernel
+    ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), -1);
+    ASSERT_EQ(this->udpServer->getStats().rxPackets, 0u);
+
+    // Reconnecting the socket forgets the peer
+    this->udpServer->disconnect();
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    ASSERT_FALSE(this->udpServer->isPeerUnreachable());
+    ASSERT_TRUE(this->udpClient->send(buff, sizeof(buff)));
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 8);
+}
+
+
+TEST_F(TestUdp, TestUdpServerPeerTable)
+{
+    ASSERT_TRUE(this->udpServer->connect(this->udpAddress, this->udpPort, 0));
+    this->udpServer->setPeerTable(16, 10.0);
+
+    // Two peers that can also receive
+    UdpServer peerA, peerB;
+    ASSERT_TRUE(peerA.connect(this->udpAddress, this->udpPort + 1, 0));
+    ASSERT_TRUE(peerB.connect(this->udpAddress, this->udpPort + 2, 0));
+    ASSERT_TRUE(peerA.setClientInfo(this->udpAddress, this->udpPort));
+    ASSERT_TRUE(peerB.setClientInfo(this->udpAddress, this->udpPort));
+
+    char buff[16] = {0};
+    ASSERT_EQ(peerA.send(buff, 4), 4);
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 4);
+    PeerTable::PeerId idA = this->udpServer->getLastPeer();
+
+    ASSERT_EQ(peerB.send(buff, 6), 6);
+    ASSERT_EQ(peerB.send(buff, 6), 6);
+    usleep(10000);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 6);
+    ASSERT_EQ(this->udpServer->receiveUdp(buff, sizeof(buff)), 6);
+    PeerTable::PeerId idB = this->udpServer->getLastPeer();
+    ASSERT_NE(idA, 0u);
+    ASSERT_NE(idB, 0u);
+    ASSERT_NE(idA, idB);
+
+    std::vector<PeerTable::Peer> peers = this->udpServer->getPeers();
+    ASSERT_EQ(peers.size(), 2u);
+    for (size_t i = 0; i < peers.size(); i++)
+    {
+        if (peers[i].id == idA)
+            ASSERT_EQ(peers[i].rxBytes, 4u);
+        else
+            ASSERT_EQ(peers[i].rxPackets, 2u);
+    }
+
+    // Replies go to the chosen peer, not to whoever spoke last
+    ASSERT_EQ(this->udpServer->sendToPeer(idA, buff, 3), 3);
+    usleep(10000);
+    ASSERT_EQ(peerA.receiveUdp(buff, sizeof(buff)), 3);
+    ASSERT_EQ(peerB.receiveUdp(buff, sizeof(buff)), -1);
+
+    ASSERT_TRUE(this->udpServer->removePeer(idA));
+    ASSERT_EQ(this->udpServer->sendToPeer(idA, buff, 3), -1);
+    ASSERT_EQ(this->udpServer->getPeers().size(), 1u);
+}
+
+
+/** Task type handed to BasicUdpServer at compile time.
+ */
+struct SumLengths
+{
+    std::atomic<int>* count;
+    std::atomic<size_t>* bytes;
+
+    bool operator()(int, char*, size_t length) const
+    {
+        count->fetch_add(1);
+        bytes->fetch_add(length);
+        return true;
+    }
+};
+
+
+TEST_F(TestUdp, TestBasicUdpServerHandlerType)
+{
+    std::atomic<int> count(0);
+    std::atomic<size_t> bytes(0);
+    SumLengths task = {&count, &bytes};
+
+    BasicUdpServer<SumLengths> server(task, this->udpAddress, this->udpPort, 256, 0, 0.1);
+    ASSERT_TRUE(server.isRunning());
+
+    char buff[32] = {0};
+    for (int i = 1; i <= 4; i++)
+        ASSERT_TRUE(this->udpClient->send(buff, i * 8));
+    for (int i = 0; i < 100 && count < 4; i++)
+        usleep(10000);
+
+    ASSERT_EQ(count, 4);
+    ASSERT_EQ(bytes, 80u);
+    ASSERT_EQ(server.getStats().handlerCalls, 4u);
+    ASSERT_TRUE(server.disconnect());
+    ASSERT_FALSE(server.isRunning());
+}
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
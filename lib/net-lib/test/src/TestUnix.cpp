@@ -0,0 +1,202 @@
+/**
+ * @file TestUnix.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "TestUnix.h"
+
+
+TestUnix::TestUnix()
+    : abstractPath("@netlib-test-" + std::to_string(getpid())),
+      filePath("/tmp/netlib-test-" + std::to_string(getpid()) + ".sock")
+{}
+
+TestUnix::~TestUnix()
+{
+    ::unlink(this->filePath.c_str());
+}
+
+
+bool TestUnix::waitFor(const std::atomic<int>& counter, int value)
+{
+    for (int i = 0; i < 100 && counter < value; i++)
+        usleep(10000);
+    return counter >= value;
+}
+
+
+TEST_F(TestUnix, TestDatagramAbstractCredentials)
+{
+    UnixDatagramServer server;
+    ASSERT_TRUE(server.connect(this->abstractPath));
+
+    UnixClient client(this->abstractPath, SOCK_DGRAM);
+    ASSERT_TRUE(client.isAlive());
+    ASSERT_TRUE(client.send("ping", 4));
+    usleep(10000);
+
+    char buff[16];
+    ASSERT_EQ(server.receive(buff, sizeof(buff)), 4);
+    ASSERT_EQ(std::string(buff, 4), "ping");
+
+    // The kernel vouches for who sent it
+    struct ucred credentials = server.getLastCredentials();
+    ASSERT_EQ(credentials.pid, getpid());
+    ASSERT_EQ(credentials.uid, getuid());
+    ASSERT_EQ(credentials.gid, getgid());
+
+    // The client bound a reply address
+    ASSERT_EQ(server.send("pong", 4), 4);
+    ASSERT_EQ(client.receive(buff, sizeof(buff), NULL, 1.0), 4);
+    ASSERT_EQ(std::string(buff, 4), "pong");
+}
+
+
+TEST_F(TestUnix, TestDatagramPassesFds)
+{
+    std::atomic<int> count(0);
+    int passed = -1;
+    UnixDatagramServer server;
+    ASSERT_TRUE(server.connect(this->abstractPath));
+    ASSERT_TRUE(server.runInThread([&](int, char*, size_t) {
+            std::vector<int> fds;
+            if (server.takeFds(fds) == 1)
+                passed = fds[0];
+            count++;
+            return true;
+        }, 64, 0));
+
+    int pipeFds[2];
+    ASSERT_EQ(::pipe(pipeFds), 0);
+
+    UnixClient client(this->abstractPath, SOCK_DGRAM);
+    ASSERT_TRUE(client.send("fd", 2, &pipeFds[1], 1));
+    ASSERT_TRUE(waitFor(count, 1));
+    server.disconnect();
+
+    // The server writes through its own copy of the pipe
+    ASSERT_NE(passed, -1);
+    ASSERT_NE(passed, pipeFds[1]);
+    ASSERT_EQ(::write(passed, "x", 1), 1);
+    char c = 0;
+    ASSERT_EQ(::read(pipeFds[0], &c, 1), 1);
+    ASSERT_EQ(c, 'x');
+    ASSERT_NE(::fcntl(passed, F_GETFD) & FD_CLOEXEC, 0);
+
+    ::close(passed);
+    ::close(pipeFds[0]);
+    ::close(pipeFds[1]);
+}
+
+
+TEST_F(TestUnix, TestDatagramFilesystemPath)
+{
+    // Leave a file behind like a server that crashed
+    struct sockaddr_un address;
+    socklen_t addressLength;
+    ASSERT_TRUE(Networking::makeUnixAddress(this->filePath, address, addressLength));
+    int crashed = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    ASSERT_EQ(::bind(crashed, (struct sockaddr*)&address, addressLength), 0);
+    ::close(crashed);
+
+    // The next server replaces it
+    UnixDatagramServer server;
+    ASSERT_TRUE(server.connect(this->filePath));
+    struct stat status;
+    ASSERT_EQ(::lstat(this->filePath.c_str(), &status), 0);
+    ASSERT_TRUE(S_ISSOCK(status.st_mode));
+
+    // A second server cannot take the path of a running one
+    UnixDatagramServer second;
+    ASSERT_FALSE(second.connect(this->filePath));
+    second.disconnect();
+
+    UnixClient client(this->filePath, SOCK_DGRAM);
+    ASSERT_TRUE(client.send("a", 1));
+    usleep(10000);
+    char buff[4];
+    ASSERT_EQ(server.receive(buff, sizeof(buff)), 1);
+
+    server.disconnect();
+    ASSERT_EQ(::lstat(this->filePath.c_str(), &status), -1);
+}
+
+
+TEST_F(TestUnix, TestDatagramDisconnectWakesReceive)
+{
+    UnixDatagramServer server;
+    ASSERT_TRUE(server.connect(this->abstractPath));
+    ASSERT_TRUE(server.runInThread([](int, char*, size_t) { return true; }, 64, 0));
+    usleep(10000);
+
+    // Blocked with no timeout, only the wakeup gets the loop out
+    double start = Networking::getWallTime();
+    ASSERT_TRUE(server.disconnect());
+    ASSERT_LT(Networking::getWallTime() - start, 0.1);
+}
+
+
+TEST_F(TestUnix, TestStreamCredentialsAndFds)
+{
+    std::atomic<int> count(0);
+    struct ucred credentials;
+    memset(&credentials, 0, sizeof(credentials));
+    UnixStreamServer server;
+    ASSERT_TRUE(server.connect(this->abstractPath));
+    ASSERT_TRUE(server.runInThread([&](int fd) {
+            credentials = server.getClientCredentials();
+
+            // Echo the message back with a descriptor of our own
+            char buff[16];
+            std::vector<int> fds;
+            ssize_t length = Networking::receiveWithRights(fd, buff, sizeof(buff), fds);
+            int devNull = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+            bool okay = length > 0 && Networking::sendWithRights(fd, buff, length, &devNull, 1) == length;
+            ::close(devNull);
+            count++;
+            return okay;
+        }, 0));
+
+    UnixClient client(this->abstractPath, SOCK_STREAM);
+    ASSERT_TRUE(client.send("hello", 5));
+
+    char buff[16];
+    std::vector<int> fds;
+    ASSERT_EQ(client.receive(buff, sizeof(buff), &fds, 1.0), 5);
+    ASSERT_EQ(std::string(buff, 5), "hello");
+    ASSERT_EQ(fds.size(), 1u);
+    ASSERT_EQ(::write(fds[0], "x", 1), 1);
+    ::close(fds[0]);
+
+    ASSERT_TRUE(waitFor(count, 1));
+    ASSERT_EQ(credentials.pid, getpid());
+    ASSERT_EQ(credentials.uid, getuid());
+    ASSERT_TRUE(server.disconnect());
+}
+
+
+TEST_F(TestUnix, TestInvalidPath)
+{
+    UnixDatagramServer server;
+    ASSERT_FALSE(server.connect(""));
+    ASSERT_FALSE(server.connect("@" + std::string(200, 'x')));
+
+    UnixClient client;
+    ASSERT_FALSE(client.connect(this->abstractPath, SOCK_DGRAM));
+}
+
+
+/** Application main entry point.
+ */
+int main(int argc, char* argv[])
+{
+    // Initiate testing
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file captureReplay.cpp
+ * @brief Replays a traffic capture against a server with its original timing
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "captureReplay.h"
+
+//System
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+
+
+
+/** Constructor, nothing is sent until a capture is loaded and replayed
+
+ */
+captureReplay::captureReplay(std::string ipAddr_, int port_)
+	: ipAddr(ipAddr_),
+	port(port_),
+	tcpClient(NULL),
+	isRunning(false),
+	sentCount(0),
+	sentBytes(0)
+{
+}
+
+/** Default Destructor
+
+ */
+captureReplay::~captureReplay()
+{
+	this->stop();
+	delete this->tcpClient;
+}
+
+bool captureReplay::load(std::string path)
+{
+	if (!this->reader.open(path))
+		return false;
+
+	this->sentCount = 0;
+	this->sentBytes = 0;
+	this->latenessHistogram.reset();
+	return true;
+}
+
+bool captureReplay::replay(double speed)
+{
+	if (speed < 0 || this->isRunning.exchange(true))
+		return false;
+
+	this->reader.rewind();
+	if (!this->udpClient.isAlive() && !this->udpClient.connect(this->ipAddr, this->port))
+	{
+		this->isRunning = false;
+		return false;
+	}
+
+	//The first message is sent straight away, the rest keep their offsets to it
+	Capture::Record record;
+	uint64_t firstTimestamp_ns = 0;
+	uint64_t start_ns = this->getTime_ns();
+	bool first = true;
+	bool okay = true;
+	while (this->isRunning && this->reader.next(record))
+	{
+		if (first)
+		{
+			firstTimestamp_ns = record.header.timestamp_ns;
+			first = false;
+		}
+
+		uint64_t due_ns = start_ns;
+		if (speed > 0 && record.header.timestamp_ns > firstTimestamp_ns)
+			due_ns += (record.header.timestamp_ns - firstTimestamp_ns) / speed;
+
+		//Sleep to an absolute time so scheduling errors do not add up
+		struct timespec due;
+		due.tv_sec = due_ns / 1000000000ull;
+		due.tv_nsec = due_ns % 1000000000ull;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR && this->isRunning);
+		if (!this->isRunning)
+			break;
+
+		uint64_t now_ns = this->getTime_ns();
+		this->latenessHistogram.record(now_ns > due_ns ? (now_ns - due_ns) / 1000 : 0);
+
+		if (!this->sendRecord(record))
+		{
+			okay = false;
+			break;
+		}
+	}
+
+	if (this->tcpClient)
+		this->tcpClient->disconnect();
+	this->isRunning = false;
+	return okay;
+}
+
+void captureReplay::stop()
+{
+	this->isRunning = false;
+}
+
+const LatencyHistogram& captureReplay::getHistogram() const
+{
+	return this->latenessHistogram;
+}
+
+uint64_t captureReplay::getSentCount() const
+{
+	return this->sentCount;
+}
+
+uint64_t captureReplay::getSentBytes() const
+{
+	return this->sentBytes;
+}
+
+bool captureReplay::sendRecord(const Capture::Record& record)
+{
+	if (record.header.protocol == Capture::protocolUdp)
+	{
+		if (!this->udpClient.send((char*)record.data, record.header.length))
+			return false;
+	}
+	else if (record.header.protocol == Capture::protocolTcp)
+	{
+		//Reconnect where the capture saw a client connect, or when the capture
+		//started on a connection that was already open
+		if ((record.header.flags & Capture::flagConnect) || !this->tcpClient)
+		{
+			delete this->tcpClient;
+			this->tcpClient = new TcpClient(this->ipAddr, this->port);
+		}
+		if (!this->tcpClient->isAlive())
+			return false;
+
+		size_t written = 0;
+		while (written < record.header.length)
+		{
+			ssize_t lenSent = ::send(this->tcpClient->getSocket(), record.data + written,
+				record.header.length - written, MSG_NOSIGNAL);
+			if (lenSent == -1)
+			{
+				std::cerr << "Failed to send: " << strerror(errno) << std::endl;
+				return false;
+			}
+			written += lenSent;
+		}
+	}
+	else
+	{
+		std::cerr << "Skipping record of unknown protocol " << (int)record.header.protocol << std::endl;
+		return true;
+	}
+
+	if (!(record.header.flags & Capture::flagConnect))
+	{
+		this->sentCount++;
+		this->sentBytes += record.header.length;
+	}
+	return true;
+}
+
+uint64_t captureReplay::getTime_ns()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
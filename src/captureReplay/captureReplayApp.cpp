@@ -0,0 +1,110 @@
+/**
+ * @file captureReplayApp.cpp
+ * @brief Application entry point for replaying traffic captures
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+//System
+#include<iostream>
+#include<signal.h>
+#include<unistd.h>
+
+//Ours
+#include "captureReplay.h"
+
+//local functions
+static void print_usage();
+static void onSignal(int);
+
+static volatile sig_atomic_t time2Exit = 0;
+static captureReplay* replayer = NULL;
+
+
+//Application Entry Point
+int main(int argc, char *argv[])
+{
+	int c;
+	std::string path = "";
+	std::string serverIP = "127.0.0.1";
+	int port = 0;
+	double speed = 1.0;
+	int repeat = 1;
+	while ((c = getopt (argc, argv, "f:i:p:s:n:h")) != -1)
+	{
+		switch (c)
+		{
+			case 'f':
+				path = optarg;
+				break;
+			case 'i':
+				serverIP = optarg;
+				break;
+			case 'p':
+				port = atoi(optarg);
+				break;
+			case 's':
+				speed = atof(optarg);
+				break;
+			case 'n':
+				repeat = atoi(optarg);
+				break;
+			case 'h':
+				print_usage();
+				return 0;
+			default:
+				print_usage();
+				return 1;
+		}
+	}
+
+	if (path.empty() || port <= 0)
+	{
+		print_usage();
+		return 1;
+	}
+
+	captureReplay replay(serverIP, port);
+	if (!replay.load(path))
+		return 1;
+
+	replayer = &replay;
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+
+	//A repeat count of 0 loops until interrupted
+	bool okay = true;
+	for (int pass = 0; okay && !time2Exit && (repeat == 0 || pass < repeat); pass++)
+	{
+		okay = replay.replay(speed);
+		std::cout << "pass " << pass + 1 << " sent=" << replay.getSentCount()
+			<< " bytes=" << replay.getSentBytes()
+			<< " late " << LatencyHistogram::toString(replay.getHistogram().getSummary()) << std::endl;
+	}
+
+	replayer = NULL;
+	return okay ? 0 : 1;
+}
+
+static void onSignal(int)
+{
+	time2Exit = 1;
+	if (replayer)
+		replayer->stop();
+}
+
+static void print_usage(){
+	std::cout <<"\n Usage:\n";
+	std::cout <<"./captureReplay -f {capture} -p {port} [-OPTION OPTION_VALUE]\n";
+	std::cout <<"\n";
+	std::cout <<"Options:\n";
+	std::cout <<"-f {capture}               Capture file written by hostReceiver/remoteSender -c\n";
+	std::cout <<"-i {ip Address}            IP address of the server to replay to. Default: 127.0.0.1 (localhost)\n";
+	std::cout <<"-p {port}                  Port of the server to replay to\n";
+	std::cout <<"-s {speed}                 Timing factor, 1 original, 2 twice as fast, 0 as fast as possible. Default: 1\n";
+	std::cout <<"-n {count}                 Times to replay the capture, 0 until interrupted. Default: 1\n";
+	std::cout <<"-h {help}                  Print this usage text\n";
+
+	return;
+}
@@ -18,32 +18,71 @@ hostReceiver::hostReceiver()
 	isRunning(true),
 	useBluetooth(true),
 	useUDP(false),
-	needsReset(false),
-	hostState(DISCONNECTED)
+	fd(-1),
+	reopen_us(0),
+	hostState(DISCONNECTED),
+	lastTimestampReceived_us(0),
+	lastReceivedAt_us(0),
+	sndSequence(0),
+	badFrames(0),
+	ackCommandId(0),
+	statusDue(false),
+	ackDue(false),
+	keepalive_us(HEARTBEAT_PERIOD_US),
+	keepaliveCeiling_us(0),
+	peerKeepalive_us(0),
+	framer(MessageEnvelope::maxLinkFrameSize, MessageEnvelope::headerSize,
+		MessageEnvelope::linkMagic, sizeof(MessageEnvelope::linkMagic),
+		&MessageEnvelope::getLinkFrameSize, &MessageEnvelope::isValidLinkFrame),
+	writeWakeFd(Networking::createWakeup()),
+	negotiation(MessageEnvelope::supportedFeatures, MessageEnvelope::telemetryRecorder),
+	envelopeSequence(0),
+	prewarm(false),
+	recorderArmed(false),
+	nextArm_us(0),
+	recorder(RECORDING_DIR, RECORDER_PROCESS, RECORDER_PROGRESS),
+	recorderStarted(false),
+	telemetryLength(0),
+	startCommand_us(0),
+	telemetryWakeFd(Networking::createWakeup())
 {
+	this->dispatcher.setHandler(MessageEnvelope::typeHello,
+		[this](const MessageEnvelope::Header& header) { this->onHello(header); });
+
 	printf("Bluetooth!\n"); 
-	struct termios  config;
 
-	const char *device = "/dev/rfcomm0";
+	struct stat buf;
+	while (stat(BLUETOOTH_DEVICE, &buf))
+		sleep(1);
+
+	if (!this->openSerial())
+		return;
+
+	this->readThread_h = std::thread(&hostReceiver::readThread, this);
+	this->writeThread_h = std::thread(&hostReceiver::writeThread, this);
+	this->telemetryThread_h = std::thread(&hostReceiver::telemetryThread, this);	
+}
 
-   struct stat buf;
-    while (stat(device, &buf))
-    	sleep(1);
+/** Opens the bluetooth serial port and sets it up for raw bytes
 
+ */
+bool hostReceiver::openSerial()
+{
+	struct termios  config;
 
-	this->fd = open(device, (O_RDWR | O_NOCTTY | O_NDELAY | O_NONBLOCK));
-	if(this->fd == -1) {
+	int fd = open(BLUETOOTH_DEVICE, (O_RDWR | O_NOCTTY | O_NDELAY | O_NONBLOCK | O_CLOEXEC));
+	if(fd == -1) {
 		printf( "failed to open port\n" );
-		return;
+		return false;
 	}
 
 	//Check if the serial port is a tty device
-	if(!isatty(this->fd))
+	if(!isatty(fd))
 	{ 
 		printf("Error, invalid serial device\n"); 
 	}
 
-	if(tcgetattr(this->fd, &config) < 0) 
+	if(tcgetattr(fd, &config) < 0) 
 	{ 
 		printf("Error reading config from serial device\n"); 
 	}
@@ -53,8 +92,8 @@ hostReceiver::hostReceiver()
 	config.c_lflag &= ~(ECHO | ECHONL | ICANON | IEXTEN | ISIG);
 	config.c_cflag &= ~(CSIZE | PARENB);
 	config.c_cflag |= CS8;
-	config.c_cc[VMIN]  = 23; //Miniumum size of 10 bytes to return from read
-	config.c_cc[VTIME] = 0; //return from read after 100 microseconds
+	config.c_cc[VMIN]  = 0; //The port is non-blocking, the framer collects whatever arrived
+	config.c_cc[VTIME] = 0;
 
 	//Set the read and write speeds
 	if(cfsetispeed(&config, B115200) < 0 || cfsetospeed(&config, B115200) < 0) 
@@ -63,12 +102,16 @@ hostReceiver::hostReceiver()
 	}
 
 	//Apply the settings we have made
-	if(tcsetattr(this->fd, TCSAFLUSH, &config) < 0) 
+	if(tcsetattr(fd, TCSAFLUSH, &config) < 0) 
 	{
 		printf("Error setting termios attributes\n");
 	}
-	this->readThread_h = std::thread(&hostReceiver::readThread, this);
-	this->writeThread_h = std::thread(&hostReceiver::writeThread, this);	
+
+	//Bytes of a frame cut off by the old link are no start of one on the new
+	std::lock_guard<std::mutex> lock(this->serialMutex);
+	this->framer.clear();
+	this->fd = fd;
+	return true;
 }
 
 /** UDP communication interface Constructor
@@ -79,22 +122,50 @@ hostReceiver::hostReceiver(std::string ipAddr)
 	isRunning(true),
 	useBluetooth(false),
 	useUDP(true),
-	needsReset(false),
-	hostState(DISCONNECTED)
+	fd(-1),
+	reopen_us(0),
+	hostState(DISCONNECTED),
+	lastTimestampReceived_us(0),
+	lastReceivedAt_us(0),
+	sndSequence(0),
+	badFrames(0),
+	ackCommandId(0),
+	statusDue(false),
+	ackDue(false),
+	keepalive_us(HEARTBEAT_PERIOD_US),
+	keepaliveCeiling_us(0),
+	peerKeepalive_us(0),
+	framer(MessageEnvelope::maxLinkFrameSize, MessageEnvelope::headerSize,
+		MessageEnvelope::linkMagic, sizeof(MessageEnvelope::linkMagic),
+		&MessageEnvelope::getLinkFrameSize, &MessageEnvelope::isValidLinkFrame),
+	writeWakeFd(Networking::createWakeup()),
+	negotiation(MessageEnvelope::supportedFeatures, MessageEnvelope::telemetryRecorder),
+	envelopeSequence(0),
+	prewarm(false),
+	recorderArmed(false),
+	nextArm_us(0),
+	recorder(RECORDING_DIR, RECORDER_PROCESS, RECORDER_PROGRESS),
+	recorderStarted(false),
+	telemetryLength(0),
+	startCommand_us(0),
+	telemetryWakeFd(Networking::createWakeup())
 {
+	this->dispatcher.setHandler(MessageEnvelope::typeHello,
+		[this](const MessageEnvelope::Header& header) { this->onHello(header); });
+
 	printf("Network!\n"); 
 	//Port to read from the headless machine
 	int portRemote = 200;
 	int portHost = 201;
 
-	this->server = UdpServer();
-
 	//Connect to Any available local IP address and listen on given port 
 	this->server.connect("", portHost, 256);
-	this->server.setClientInfo(ipAddr, portRemote);
+	//Only talk to the remote, so a refused heartbeat tells us it is gone right away
+	this->server.setClientInfo(ipAddr, portRemote, true);
 
 	this->readThread_h = std::thread(&hostReceiver::readThread, this);
 	this->writeThread_h = std::thread(&hostReceiver::writeThread, this);
+	this->telemetryThread_h = std::thread(&hostReceiver::telemetryThread, this);
 	
 }
 
@@ -104,26 +175,50 @@ hostReceiver::hostReceiver(std::string ipAddr)
 hostReceiver::~hostReceiver()
 {
 	this->isRunning = false;
+	this->statusCondition.notify_one();
+	Networking::signalWakeup(this->writeWakeFd);
+	Networking::signalWakeup(this->telemetryWakeFd);
 	if(this->readThread_h.joinable())
 		this->readThread_h.join();
 	if(this->writeThread_h.joinable())
 		this->writeThread_h.join();
+	if(this->telemetryThread_h.joinable())
+		this->telemetryThread_h.join();
+
+	if (this->fd != -1)
+		close(this->fd);
+
+	//Let the recorder finish its file rather than be killed with us
+	if (this->recorderProcess.stop(RECORDER_STOP_SIGNAL, RECORDER_STOP_TIMEOUT_S))
+	{
+		while (!this->recorderProcess.update())
+			Networking::waitForInput(this->recorderProcess.getFd(), -1, 0.1);
+	}
+	close(this->writeWakeFd);
+	close(this->telemetryWakeFd);
 
 }
 
 /** Function that reads data from the other device
 
  */
-ssize_t hostReceiver::receiveData()
+const uint8_t* hostReceiver::receiveFrame(size_t* length)
 {
 	if (this->useBluetooth)
 	{
-		return read(this->fd, reinterpret_cast<char*>(this->rcvbuf), sizeof(this->rcvbuf));
+		//Read until a whole frame is buffered, a read may hold several frames or part of one
+		const uint8_t* frame = this->framer.next(length);
+		while (frame == nullptr && this->framer.readFrom(this->fd) > 0)
+			frame = this->framer.next(length);
+		return frame;
 	}
 	else if(this->useUDP)
 	{
-		return server.receiveUdp(reinterpret_cast<char*>(this->rcvbuf), sizeof(this->rcvbuf));
+		ssize_t ret = server.receiveUdp(reinterpret_cast<char*>(this->rcvbuf), sizeof(this->rcvbuf));
+		*length = ret > 0 ? ret : 0;
+		return ret > 0 ? this->rcvbuf : nullptr;
 	}
+	return nullptr;
 }
 
 /** Function that manages the UDP responses from the host and updates the LED's accordingly
@@ -131,45 +226,99 @@ ssize_t hostReceiver::receiveData()
  */
 int hostReceiver::readThread()
 {
-	uint64_t previousTimeStamp_us;
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("read");
+
+	uint64_t previousTimeStamp_us = 0;
 	while(this->isRunning)
 	{
-		//Read the data in from the comminication interface
-
-		ssize_t ret = this->receiveData();
-
-		//Parse this message, return true if succeeded
-		if(ret > 0 && this->onMessageReceived())
+		//Sleep until a frame arrives, so a command is acted on right away,
+		//or until the link would time out without one
+		uint64_t timeout_us = this->getLinkTimeout();
+		uint64_t now_us = this->getTimeUsec();
+		uint64_t deadline_us = previousTimeStamp_us + timeout_us;
+		this->waitForData((deadline_us > now_us ? deadline_us - now_us : timeout_us) / 1e6);
+
+		//Read the data in from the comminication interface until it is drained
+		const uint8_t* frame;
+		size_t length;
+		while((frame = this->receiveFrame(&length)) != nullptr)
 		{
+			//Parse this message, return true if succeeded
+			if(!this->onMessageReceived(frame, length))
+				continue;
+
 			previousTimeStamp_us = this->getTimeUsec();
 
-			//Trigger to start recording
-			if(this->commandedState == RECORDING && this->hostState == STANDBY)
+			//Trigger to start or stop recording
+			this->applyCommandedState();
+
+			//Acknowledge a new command once it is acted on, so the remote sees the new mode with it
+			if(this->ackDue)
 			{
-				this->startRecording();
+				this->ackDue = false;
+				this->sendStatusNow();
 			}
-			else if (this->commandedState == STANDBY && this->hostState == RECORDING)
+		}
+
+		//The read thread also wakes when the recorder exits. One that exits on its own
+		//ends the recording, one that was stopped lets a pending start go ahead
+		if (this->recorderProcess.update())
+		{
+			//One that fails while armed is not armed again right away
+			if (this->recorderArmed)
+				this->nextArm_us = this->getTimeUsec() + RECORDER_REARM_PERIOD_US;
+			this->recorderArmed = false;
+			ProcessSupervisor::Snapshot recorder = this->recorderProcess.getSnapshot();
+			std::cout << "Recorder exited: " << recorder.toString() << std::endl;
+			if (recorder.state == ProcessSupervisor::EXITED && this->hostState == RECORDING)
 			{
-				this->stopRecording();
+				this->stream.stop();
+				this->hostState = STANDBY;
+				this->commandedState = STANDBY;
+				this->sendStatusNow();
 			}
+			else
+				this->applyCommandedState();
 		}
+
+		//Keep a recorder armed while in standby, or stop it once pre-warming is off
+		this->updateArmedRecorder();
+
+		//Open the serial port again once rfcomm had time to restart
+		struct stat device;
+		if (this->useBluetooth && this->fd == -1 && this->getTimeUsec() >= this->reopen_us
+			&& stat(BLUETOOTH_DEVICE, &device) == 0 && this->openSerial())
+			std::cout << "Serial port opened again" << std::endl;
 	
-		//Check if we have received the heartbeat status message in a reasonable amount of time
-		if (abs(this->getTimeUsec() - previousTimeStamp_us) > 1e6)
+		//Check if we have received the heartbeat status message in a reasonable amount of time,
+		//or if our last one was refused because nothing listens on the remote anymore
+		bool peerUnreachable = this->useUDP && this->server.isPeerUnreachable();
+		if (peerUnreachable || this->getTimeUsec() - previousTimeStamp_us >= this->getLinkTimeout())
 		{
 			//Check if this is the first time we have moved into the DISCONNECTED state
 			if (this->hostState != DISCONNECTED)
+			{
+				//Log what the link saw so a lossy or noisy link can be told from a dead one
+				std::cout << "Link lost: " << this->getLinkStats() << std::endl;
 				this->resetConnection();
+				this->negotiation.reset();
+
+				//A remote that restarted numbers its frames and commands from the start again
+				this->rcvSequence.reset();
+				this->forgetCommands();
+			}
 
 			this->hostState = DISCONNECTED;
 		}
 		else if (this->hostState == DISCONNECTED)
 		{
-			this->hostState = STANDBY;
+			//Tell the remote right away rather than at the next keepalive, with
+			//a recording that went on while the link was down
+			this->hostState = this->recorderProcess.getState() == ProcessSupervisor::RUNNING
+				&& !this->recorderArmed ? RECORDING : STANDBY;
+			this->sendStatusNow();
 		}
-
-		//Run at 10Hz
-		usleep(100000);
 	}
 	return 0;
 }
@@ -179,22 +328,217 @@ int hostReceiver::readThread()
  */
 int hostReceiver::writeThread()
 {
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("write");
+
 	//thread whih keeps the heartbeat sending
+	SendQueue::Result sendResult = SendQueue::FLUSHED;
+	bool changed = false;
+	std::unique_lock<std::mutex> lock(this->statusMutex);
 	while(this->isRunning)
 	{
+		uint64_t interval_us = this->keepalive_us;
 		this->createSendMessage();
+		this->keepalive_us = this->getNextKeepalive(interval_us);
 
+		//Let the read thread in while the frame goes out
+		lock.unlock();
 		if(this->useBluetooth)
-			write(this->fd, reinterpret_cast<char*>(this->sndbuf), sizeof(this->sndMessage));
+		{
+			//Queued, so a full serial port delays the frame rather than truncating it. A frame
+			//sent on a change goes ahead of plain status, a newer one replaces one still waiting
+			this->sendQueue.push(changed ? SendQueue::URGENT : SendQueue::STATUS, this->sndbuf, MessageCodec::frameSize, true);
+			this->sendHelloIfDue();
+			this->sendTelemetryIfDue();
+			std::lock_guard<std::mutex> serialLock(this->serialMutex);
+			sendResult = this->flushSerial();
+		}
 		else if(this->useUDP)
-			this->server.send(reinterpret_cast<char*>(this->sndbuf), sizeof(this->sndMessage));
+		{
+			this->server.send(reinterpret_cast<char*>(this->sndbuf), MessageCodec::frameSize);
+			this->sendHelloIfDue();
+			this->sendTelemetryIfDue();
+		}
+		lock.lock();
 
-		//Send a command message at 10Hz
-		usleep(100000);
+		//While the serial port is full, also wake once it has room for the rest
+		uint64_t deadline_us = this->getTimeUsec() + interval_us;
+		uint64_t now_us;
+		while (sendResult == SendQueue::BLOCKED && !this->statusDue && this->isRunning
+			&& (now_us = this->getTimeUsec()) < deadline_us)
+		{
+			lock.unlock();
+			int fd;
+			{
+				std::lock_guard<std::mutex> serialLock(this->serialMutex);
+				fd = this->fd;
+			}
+			Networking::waitForOutput(fd, this->writeWakeFd, (deadline_us - now_us) / 1e6);
+			Networking::clearWakeup(this->writeWakeFd);
+			{
+				std::lock_guard<std::mutex> serialLock(this->serialMutex);
+				sendResult = this->flushSerial();
+			}
+			lock.lock();
+		}
+
+		//Send a status message once the announced interval is up, or right away on a change
+		now_us = this->getTimeUsec();
+		if (now_us < deadline_us)
+			this->statusCondition.wait_for(lock, std::chrono::microseconds(deadline_us - now_us),
+				[this]() { return this->statusDue || !this->isRunning; });
+		changed = this->statusDue;
+		this->statusDue = false;
 	}
 	return 0;
 }
 
+/** Wakes the write thread to send a status frame now
+
+ */
+void hostReceiver::sendStatusNow()
+{
+	std::lock_guard<std::mutex> lock(this->statusMutex);
+	this->statusDue = true;
+
+	//Something changed, so keepalives start over from the heartbeat
+	this->keepalive_us = HEARTBEAT_PERIOD_US;
+	this->statusCondition.notify_one();
+	Networking::signalWakeup(this->writeWakeFd);
+}
+
+void hostReceiver::sendEnvelope(uint8_t type, const uint8_t* payload, size_t length, SendQueue::Priority priority)
+{
+	//Nothing is agreed before the HELLO, so it always carries a CRC
+	uint8_t flags = MessageEnvelope::getFlags(this->negotiation.getFeatures());
+	if (type == MessageEnvelope::typeHello)
+		flags |= MessageEnvelope::flagCrc;
+
+	size_t frameLength = MessageEnvelope::encode(type, flags, this->envelopeSequence++,
+		payload, length, this->envelopeBuf);
+	if (frameLength == 0)
+		return;
+
+	if(this->useBluetooth)
+		this->sendQueue.push(priority, this->envelopeBuf, frameLength);
+	else if(this->useUDP)
+		this->server.send(reinterpret_cast<char*>(this->envelopeBuf), frameLength);
+}
+
+void hostReceiver::sendHelloIfDue()
+{
+	//Only a live link is offered our features, each link up negotiates again
+	MessageEnvelope::Hello hello;
+	if (this->hostState == DISCONNECTED || !this->negotiation.takeHelloDue(hello))
+		return;
+
+	uint8_t payload[MessageEnvelope::helloSize];
+	this->sendEnvelope(MessageEnvelope::typeHello, payload, MessageEnvelope::encodeHello(hello, payload), SendQueue::STATUS);
+}
+
+void hostReceiver::sendTelemetryIfDue()
+{
+	uint8_t payload[MessageEnvelope::maxTelemetrySize];
+	size_t length;
+	{
+		std::lock_guard<std::mutex> lock(this->telemetryMutex);
+		length = this->telemetryLength;
+		memcpy(payload, this->telemetryPayload, length);
+		this->telemetryLength = 0;
+	}
+
+	//Bulk, so a full serial port holds it back behind acknowledgements and status
+	if (length > 0)
+		this->sendEnvelope(MessageEnvelope::typeTelemetry, payload, length, SendQueue::BULK);
+}
+
+/** Samples the recorder once a period while the remote asks for telemetry
+
+ */
+int hostReceiver::telemetryThread()
+{
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("telemetry");
+
+	uint64_t nextSample_us = 0;
+	while(this->isRunning)
+	{
+		if (this->recorderStarted.exchange(false))
+			this->recorder.restart();
+
+		//The first write to the recording directory after a start command is taken as the
+		//first recorded frame. The directory is watched in standby already, so the watch
+		//is in place when an armed recorder resumes, and stops being watched once that
+		//write is seen, so a recording does not wake this thread at every write
+		uint64_t command_us = this->startCommand_us;
+		if (command_us != 0 || this->hostState == STANDBY)
+			this->recorder.watchOutput();
+		else
+			this->recorder.unwatchOutput();
+		if (this->recorder.readWrites() && command_us != 0
+			&& this->startCommand_us.compare_exchange_strong(command_us, 0))
+		{
+			uint64_t latency_us = this->getTimeUsec() - command_us;
+			this->startLatency.record(latency_us);
+			std::cout << "First frame " << latency_us << " us after the start command" << std::endl;
+		}
+
+		//The sample rides along with the next frame the write thread sends
+		uint64_t now_us = this->getTimeUsec();
+		if (now_us >= nextSample_us)
+		{
+			nextSample_us = now_us + TELEMETRY_PERIOD_US;
+			if (this->hostState != DISCONNECTED
+				&& (this->negotiation.getTelemetryTypes() & MessageEnvelope::telemetryRecorder))
+			{
+				MessageEnvelope::Telemetry telemetry = this->recorder.sample();
+				std::lock_guard<std::mutex> lock(this->telemetryMutex);
+				this->telemetryLength = MessageEnvelope::encodeTelemetry(telemetry, this->telemetryPayload);
+			}
+		}
+
+		//Sleep until the next sample, a start command or a write to the watched directory
+		now_us = this->getTimeUsec();
+		Networking::waitForInput(this->recorder.getWatchFd(), this->telemetryWakeFd,
+			nextSample_us > now_us ? (nextSample_us - now_us) / 1e6 : 0.001);
+		Networking::clearWakeup(this->telemetryWakeFd);
+	}
+	return 0;
+}
+
+void hostReceiver::onHello(const MessageEnvelope::Header& header)
+{
+	MessageEnvelope::Hello hello;
+	if (MessageEnvelope::decodeHello(header.payload, header.payloadLength, hello))
+		this->negotiation.onHello(hello);
+}
+
+void hostReceiver::setKeepaliveCeiling(uint64_t ceiling_us)
+{
+	this->keepaliveCeiling_us = ceiling_us;
+}
+
+uint64_t hostReceiver::getNextKeepalive(uint64_t interval_us)
+{
+	//Only an idle link backs off, a lost one keeps calling at the heartbeat
+	uint64_t ceiling_us = this->keepaliveCeiling_us;
+	if (ceiling_us <= HEARTBEAT_PERIOD_US || this->hostState == DISCONNECTED)
+		return HEARTBEAT_PERIOD_US;
+	return std::min(interval_us * 2, ceiling_us);
+}
+
+uint64_t hostReceiver::getLinkTimeout() const
+{
+	return std::max<uint64_t>(LINK_TIMEOUT_US, KEEPALIVES_MISSED * static_cast<uint64_t>(this->peerKeepalive_us));
+}
+
+bool hostReceiver::waitForData(double timeout)
+{
+	//The exit of the recorder wakes us as well
+	int readFd = this->useUDP ? this->server.getServer() : this->fd;
+	return Networking::waitForInput(readFd, this->recorderProcess.getFd(), timeout);
+}
+
 /** Fill Message to send
 
  */
@@ -203,61 +547,193 @@ int hostReceiver::createSendMessage()
 	//Manually fill out the contents of the message to sent
 	this->sndMessage.magicHeader1 = MAGIC_H1;
 	this->sndMessage.magicHeader2 = MAGIC_H2;
+	this->sndMessage.timestamp_us = this->getTimeUsec();
 	this->sndMessage.isCommandMsg = 0u;
 	this->sndMessage.isStatusMsg = 1u;
 	if (this->hostState == RECORDING)
 		this->sndMessage.mode = MODE_RECORDING;
 	else if (this->hostState == STANDBY)
 		this->sndMessage.mode = MODE_STANDBY;
+	this->sndMessage.sequence = this->sndSequence++;
+	this->sndMessage.commandId = 0u;
+	this->sndMessage.ackCommandId = this->ackCommandId;
+	this->sndMessage.keepalive_us = this->keepalive_us;
+
+	//Hand the peer back its newest timestamp and how long we held it
+	{
+		std::lock_guard<std::mutex> lock(this->echoMutex);
+		this->sndMessage.echoTimestamp_us = this->lastTimestampReceived_us;
+		this->sndMessage.echoDelay_us = this->lastReceivedAt_us ? this->sndMessage.timestamp_us - this->lastReceivedAt_us : 0;
+	}
 	this->sndMessage.magicFooter1 = MAGIC_F1;
 	this->sndMessage.magicFooter2 = MAGIC_F2;
 
-	//Copy the message into our buffer for sending
-	memcpy(this->sndbuf, &this->sndMessage, sizeof(this->sndMessage));
+	//Lay the message out in our buffer for sending
+	MessageCodec::encode(this->sndMessage, this->sndbuf);
 	return 0;
 }
 
-bool hostReceiver::onMessageReceived()
+bool hostReceiver::onMessageReceived(const uint8_t* frame, size_t length)
 {
-	//Copy the buffer into the messge predefined message
-	memcpy(&this->rcvMessage, this->rcvbuf, sizeof(this->rcvMessage));
+	//Envelopes go to the handler of their type, a type we do not know is skipped
+	if (MessageEnvelope::isEnvelope(frame, length))
+	{
+		if (this->dispatcher.dispatch(frame, length))
+			return true;
+		this->badFrames++;
+		return false;
+	}
 
-	//Check the magic numbers
-	if( 
-		this->rcvMessage.magicHeader1 == MAGIC_H1
-		&& this->rcvMessage.magicHeader2 == MAGIC_H2
-		&& this->rcvMessage.magicFooter1 == MAGIC_F1
-		&& this->rcvMessage.magicFooter2 == MAGIC_F2
-		)
+	//Check the length and magic numbers of the frame where it was received
+	if (MessageCodec::isValidFrame(frame, length))
 	{
+		//A late or repeated frame still shows the link is up, but must not
+		//undo the state of a newer one
+		SequenceStats::Result result = this->rcvSequence.record(MessageCodec::getSequence(frame));
+		if (result == SequenceStats::DUPLICATE || result == SequenceStats::REORDERED)
+			return true;
+
+		//A remote that restarted within the link timeout numbers its commands from 1 again
+		if (result == SequenceStats::RESTARTED)
+			this->forgetCommands();
+
+		//Our own timestamp came back, less the time the peer held it
+		uint64_t now_us = this->getTimeUsec();
+		uint64_t echo_us = MessageCodec::getEchoTimestamp(frame);
+		uint64_t echoDelay_us = MessageCodec::getEchoDelay(frame);
+		if (echo_us != 0 && echo_us + echoDelay_us <= now_us)
+			this->rttHistogram.record(now_us - echo_us - echoDelay_us);
+
 		//Update our local variables with the contents of the new message
-		this->lastTimestampReceived_us = this->rcvMessage.timestamp_us;
-		this->lastModeReceived = this->rcvMessage.mode;
-	
-		if(this->lastModeReceived == MODE_RECORDING)
 		{
-			this->commandedState = RECORDING;
+			std::lock_guard<std::mutex> lock(this->echoMutex);
+			this->lastTimestampReceived_us = MessageCodec::getTimestamp(frame);
+			this->lastReceivedAt_us = now_us;
 		}
-		else if(this->lastModeReceived == MODE_STANDBY)
+		this->lastModeReceived = MessageCodec::getMode(frame);
+		this->peerKeepalive_us = MessageCodec::getKeepalive(frame);
+
+		//Only a command not seen before changes the state, a retransmission is
+		//acknowledged again by the next status
+		uint32_t commandId = MessageCodec::getCommandId(frame);
+		if(commandId != 0 && commandId != this->ackCommandId)
 		{
-			this->commandedState = STANDBY;
+			if(this->lastModeReceived == MODE_RECORDING)
+			{
+				this->commandedState = RECORDING;
+			}
+			else if(this->lastModeReceived == MODE_STANDBY)
+			{
+				this->commandedState = STANDBY;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(this->statusMutex);
+				this->ackCommandId = commandId;
+			}
+			this->ackDue = true;
 		}
 		return true;
 	}
+	this->badFrames++;
 	return false;
 }
 
+void hostReceiver::forgetCommands()
+{
+	std::lock_guard<std::mutex> lock(this->statusMutex);
+	this->ackCommandId = 0;
+}
+
+void hostReceiver::applyCommandedState()
+{
+	//A start waits for a recorder still stopping, its exit wakes the read thread
+	if(this->commandedState == RECORDING && this->hostState == STANDBY
+		&& this->recorderProcess.getState() != ProcessSupervisor::STOPPING)
+	{
+		this->startRecording();
+	}
+	else if (this->commandedState == STANDBY && this->hostState == RECORDING)
+	{
+		this->stopRecording();
+	}
+}
+
+
 int hostReceiver::startRecording()
 {
-	system("/home/msardonini/Videos/record_on_boot.sh &");
+	uint64_t command_us = this->getTimeUsec();
+	if (this->recorderArmed)
+	{
+		//An armed recorder has its devices open and only waits to be told to go ahead
+		this->recorderArmed = false;
+		if (!this->recorderProcess.writeInput(RECORDER_RESUME, strlen(RECORDER_RESUME)))
+		{
+			//It is gone, a cold start follows once it is reaped
+			this->recorderProcess.stop(SIGKILL, 0);
+			return -1;
+		}
+	}
+	else if (!this->recorderProcess.start({RECORDER_COMMAND}))
+	{
+		//Spawned without a shell, so the state follows the recorder rather than the command
+		this->commandedState = STANDBY;
+		return -1;
+	}
 	this->hostState = RECORDING;
+	this->recorderStarted = true;
+
+	//The stream file begins with the pre-roll kept from before the command
+	this->stream.start(STREAM_DIR);
+
+	//The telemetry thread times the first frame from here
+	this->startCommand_us = command_us;
+	Networking::signalWakeup(this->telemetryWakeFd);
+	std::cout << "Recorder started: " << this->recorderProcess.getSnapshot().toString() << std::endl;
+	return 0;
 }
 
 
 int hostReceiver::stopRecording()
 {
-	system("/home/msardonini/Videos/stopProgram.sh &");
+	//Returns at once, the read thread reaps the recorder or kills it after the timeout,
+	//then arms the next one if pre-warming is on
+	this->recorderProcess.stop(RECORDER_STOP_SIGNAL, RECORDER_STOP_TIMEOUT_S);
+	this->stream.stop();
 	this->hostState = STANDBY;
+	this->startCommand_us = 0;
+	return 0;
+}
+
+
+void hostReceiver::updateArmedRecorder()
+{
+	if (!this->prewarm)
+	{
+		if (this->recorderArmed && this->recorderProcess.stop(RECORDER_STOP_SIGNAL, RECORDER_STOP_TIMEOUT_S))
+			this->recorderArmed = false;
+		return;
+	}
+
+	//Not while a start waits for the previous recorder, nor right after one failed
+	ProcessSupervisor::State state = this->recorderProcess.getState();
+	uint64_t now_us = this->getTimeUsec();
+	if (this->hostState == RECORDING || this->commandedState == RECORDING
+		|| state == ProcessSupervisor::RUNNING || state == ProcessSupervisor::STOPPING
+		|| now_us < this->nextArm_us)
+		return;
+
+	this->recorderArmed = this->recorderProcess.start({RECORDER_COMMAND, RECORDER_ARMED_ARG}, true);
+	if (this->recorderArmed)
+		std::cout << "Recorder armed: " << this->recorderProcess.getSnapshot().toString() << std::endl;
+	else
+		this->nextArm_us = now_us + RECORDER_REARM_PERIOD_US;
+}
+
+
+void hostReceiver::setPrewarm(bool enable)
+{
+	this->prewarm = enable;
 }
 
 
@@ -266,28 +742,81 @@ int hostReceiver::resetConnection()
 	//We only need to reset the connection when talking over bluetooth
 	if(this->useBluetooth)
 	{
-		close(this->fd);
-
-		//Get the PID number of the process running the bluetooth server
-		char line[50];
-		FILE *cmd = popen("pidof -xs hostBluetoothServer.sh", "r");
-
-		fgets(line, 50, cmd);
-		pid_t pid = strtoul(line, NULL, 10);
-		pclose(cmd);
+		{
+			std::lock_guard<std::mutex> lock(this->serialMutex);
+			close(this->fd);
+			this->fd = -1;
+		}
+		//Only the serial port is reset, the recorder and its stream go on
+		this->reopen_us = this->getTimeUsec() + BLUETOOTH_REOPEN_DELAY_US;
 
 		//Send the SIGUSER1, the custom signal meaning we need to restart the server
-		kill(pid, 10);
+		pid_t pid = ProcessSupervisor::findByName(BLUETOOTH_SERVER_SCRIPT);
+		if (pid > 0)
+			kill(pid, SIGUSR1);
 
-		this->needsReset = true;
 		std::cout<<" resetting the connection " << std::endl;
 	}
 	return 0;
 }
 
-bool hostReceiver::getNeedsReset()
+/** Writes the queued frames to the serial port, called by the write thread with serialMutex held
+
+ */
+SendQueue::Result hostReceiver::flushSerial()
+{
+	//Frames queued while the port is closed would only be stale once it is open again
+	if (this->fd == -1)
+	{
+		this->sendQueue.clear();
+		return SendQueue::FLUSHED;
+	}
+	return this->sendQueue.flush(this->fd);
+}
+
+
+bool hostReceiver::startCapture(std::string path)
+{
+	if (!this->useUDP)
+	{
+		std::cerr << "Capture is only supported over UDP" << std::endl;
+		return false;
+	}
+	return this->server.startCapture(path);
+}
+
+
+bool hostReceiver::startStreamCapture(int port, double preroll_s)
+{
+	return this->stream.open(port, preroll_s);
+}
+
+
+uint64_t hostReceiver::getBadFrames() const
 {
-	return this->needsReset;
+	return this->badFrames;
+}
+
+
+std::string hostReceiver::getLinkStats()
+{
+	std::ostringstream out;
+	out << "badFrames=" << this->badFrames
+		<< " " << this->rcvSequence.getSnapshot().toString()
+		<< " rtt " << LatencyHistogram::toString(this->rttHistogram.getSummary())
+		<< " protocol=" << static_cast<int>(this->negotiation.getVersion())
+		<< " features=" << this->negotiation.getFeatures()
+		<< " unknownMessages=" << this->dispatcher.getUnknown()
+		<< " recorder " << this->recorderProcess.getSnapshot().toString()
+		<< " start " << LatencyHistogram::toString(this->startLatency.getSummary());
+	if (this->stream.isOpen())
+		out << " " << this->stream.getStats();
+	if (this->useBluetooth)
+		out << " " << this->framer.getSnapshot().toString()
+			<< " " << this->sendQueue.getSnapshot().toString();
+	if (this->useUDP)
+		out << " " << this->server.getStats().toString();
+	return out.str();
 }
 
 
@@ -0,0 +1,298 @@
+/**
+ * @file recorderMonitor.cpp
+ * @brief Samples the progress of the video recorder for the telemetry sent to the remote
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "recorderMonitor.h"
+
+//System Includes
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+
+recorderMonitor::recorderMonitor(std::string outputDir, std::string processName, std::string progressPath)
+	: outputDir(outputDir),
+	processName(processName),
+	progressPath(progressPath),
+	outputFd(-1),
+	lastSize(0),
+	lastSample_us(0),
+	outputGrowing(false),
+	recorderPid(-1),
+	lastTicks(0),
+	ticksPerSecond(sysconf(_SC_CLK_TCK)),
+	nextRecorderSearch_us(0),
+	droppedFrames(0),
+	watchFd(-1),
+	watch(-1)
+{
+}
+
+recorderMonitor::~recorderMonitor()
+{
+	if (this->outputFd >= 0)
+		close(this->outputFd);
+	if (this->watchFd >= 0)
+		close(this->watchFd);
+}
+
+MessageEnvelope::Telemetry recorderMonitor::sample()
+{
+	MessageEnvelope::Telemetry telemetry = {};
+	uint64_t now_us = this->getTimeUsec();
+	uint64_t elapsed_us = this->lastSample_us ? now_us - this->lastSample_us : 0;
+	this->lastSample_us = now_us;
+
+	//A file just opened has no rate yet
+	uint64_t fileElapsed_us = elapsed_us;
+	if (this->outputFd < 0 && this->openOutputFile())
+		fileElapsed_us = 0;
+	struct stat status;
+	if (this->outputFd >= 0 && fstat(this->outputFd, &status) == 0)
+	{
+		uint64_t size = status.st_size;
+		telemetry.flags |= MessageEnvelope::Telemetry::flagOutputFound;
+		telemetry.bytesWritten = size;
+		if (fileElapsed_us > 0 && size > this->lastSize)
+		{
+			telemetry.writeRate_Bps = (size - this->lastSize) * 1000000 / fileElapsed_us;
+			this->outputGrowing = true;
+		}
+		else if (fileElapsed_us > 0 && this->outputGrowing)
+		{
+			//It stopped growing, the recorder may have moved on to a new file
+			this->restart();
+		}
+		this->lastSize = size;
+	}
+
+	struct statvfs disk;
+	if (statvfs(this->outputDir.c_str(), &disk) == 0)
+	{
+		telemetry.flags |= MessageEnvelope::Telemetry::flagFreeSpaceKnown;
+		telemetry.freeSpace_MiB = static_cast<uint64_t>(disk.f_bavail) * disk.f_frsize >> 20;
+	}
+
+	//The pid is kept while the process lives, /proc is only scanned now and then for a new one
+	uint64_t ticks = 0;
+	bool running = this->recorderPid > 0 && this->readCpuTicks(this->recorderPid, ticks);
+	if (running && elapsed_us > 0 && ticks >= this->lastTicks && this->ticksPerSecond > 0)
+		telemetry.recorderCpu_permille = (ticks - this->lastTicks) * 1000000000 / this->ticksPerSecond / elapsed_us;
+	else if (!running && now_us >= this->nextRecorderSearch_us)
+	{
+		this->nextRecorderSearch_us = now_us + RECORDER_SEARCH_PERIOD_US;
+		this->recorderPid = this->findRecorder();
+		running = this->recorderPid > 0 && this->readCpuTicks(this->recorderPid, ticks);
+	}
+	if (running)
+	{
+		telemetry.flags |= MessageEnvelope::Telemetry::flagRecorderRunning;
+		this->lastTicks = ticks;
+	}
+	else
+		this->recorderPid = -1;
+
+	this->readDroppedFrames(this->droppedFrames);
+	telemetry.droppedFrames = this->droppedFrames;
+	return telemetry;
+}
+
+void recorderMonitor::restart()
+{
+	if (this->outputFd >= 0)
+		close(this->outputFd);
+	this->outputFd = -1;
+	this->lastSize = 0;
+	this->outputGrowing = false;
+	this->nextRecorderSearch_us = 0;
+}
+
+bool recorderMonitor::watchOutput()
+{
+	if (this->watchFd < 0)
+		this->watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (this->watchFd >= 0 && this->watch < 0)
+		this->watch = inotify_add_watch(this->watchFd, this->outputDir.c_str(), IN_MODIFY);
+	return this->watch >= 0;
+}
+
+void recorderMonitor::unwatchOutput()
+{
+	if (this->watch >= 0)
+	{
+		inotify_rm_watch(this->watchFd, this->watch);
+		this->watch = -1;
+
+		//Events queued before the watch went away would wake the next one
+		this->readWrites();
+	}
+}
+
+int recorderMonitor::getWatchFd() const
+{
+	return this->watch >= 0 ? this->watchFd : -1;
+}
+
+bool recorderMonitor::readWrites()
+{
+	if (this->watchFd < 0)
+		return false;
+
+	//Only the kind of event matters, not which file
+	bool written = false;
+	alignas(struct inotify_event) char buf[4096];
+	ssize_t ret;
+	while ((ret = read(this->watchFd, buf, sizeof(buf))) > 0)
+	{
+		for (char* p = buf; p < buf + ret; p += sizeof(struct inotify_event) + reinterpret_cast<struct inotify_event*>(p)->len)
+		{
+			if (reinterpret_cast<struct inotify_event*>(p)->mask & IN_MODIFY)
+				written = true;
+		}
+	}
+	return written;
+}
+
+bool recorderMonitor::openOutputFile()
+{
+	DIR* dir = opendir(this->outputDir.c_str());
+	if (dir == NULL)
+		return false;
+
+	std::string newest;
+	struct timespec newestTime = {0, 0};
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		struct stat status;
+		if (fstatat(dirfd(dir), entry->d_name, &status, 0) != 0 || !S_ISREG(status.st_mode))
+			continue;
+		if (status.st_mtim.tv_sec > newestTime.tv_sec
+			|| (status.st_mtim.tv_sec == newestTime.tv_sec && status.st_mtim.tv_nsec > newestTime.tv_nsec))
+		{
+			newest = entry->d_name;
+			newestTime = status.st_mtim;
+		}
+	}
+
+	if (!newest.empty())
+		this->outputFd = openat(dirfd(dir), newest.c_str(), O_RDONLY | O_CLOEXEC);
+	closedir(dir);
+
+	struct stat status;
+	if (this->outputFd >= 0 && fstat(this->outputFd, &status) == 0)
+		this->lastSize = status.st_size;
+	return this->outputFd >= 0;
+}
+
+pid_t recorderMonitor::findRecorder()
+{
+	DIR* proc = opendir("/proc");
+	if (proc == NULL)
+		return -1;
+
+	pid_t pid = -1;
+	struct dirent* entry;
+	while (pid < 0 && (entry = readdir(proc)) != NULL)
+	{
+		if (!isdigit(static_cast<unsigned char>(entry->d_name[0])))
+			continue;
+		pid_t candidate = strtol(entry->d_name, NULL, 10);
+
+		char path[64];
+		snprintf(path, sizeof(path), "/proc/%d/comm", static_cast<int>(candidate));
+		int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			continue;
+		char comm[32];
+		ssize_t ret = read(fd, comm, sizeof(comm) - 1);
+		close(fd);
+		if (ret <= 0)
+			continue;
+		comm[ret] = '\0';
+		comm[strcspn(comm, "\n")] = '\0';
+		if (this->processName == comm)
+			pid = candidate;
+	}
+	closedir(proc);
+	return pid;
+}
+
+bool recorderMonitor::readCpuTicks(pid_t pid, uint64_t& ticks)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/stat", static_cast<int>(pid));
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+	char buf[512];
+	ssize_t ret = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (ret <= 0)
+		return false;
+	buf[ret] = '\0';
+
+	//The name in parentheses may hold spaces, fields are counted from after it.
+	//utime and stime are the 14th and 15th fields, the 12th and 13th after the name
+	const char* field = strrchr(buf, ')');
+	if (field == NULL)
+		return false;
+	for (int i = 0; i < 12 && field != NULL; i++)
+		field = strchr(field + 1, ' ');
+	if (field == NULL)
+		return false;
+	char* end;
+	uint64_t utime = strtoull(field + 1, &end, 10);
+	uint64_t stime = strtoull(end, NULL, 10);
+	ticks = utime + stime;
+	return true;
+}
+
+bool recorderMonitor::readDroppedFrames(uint64_t& droppedFrames)
+{
+	if (this->progressPath.empty())
+		return false;
+	int fd = open(this->progressPath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	//Progress is appended in blocks, the newest count is near the end
+	char buf[1024];
+	struct stat status;
+	off_t offset = 0;
+	if (fstat(fd, &status) == 0 && status.st_size > static_cast<off_t>(sizeof(buf) - 1))
+		offset = status.st_size - (sizeof(buf) - 1);
+	ssize_t ret = pread(fd, buf, sizeof(buf) - 1, offset);
+	close(fd);
+	if (ret <= 0)
+		return false;
+	buf[ret] = '\0';
+
+	const char* key = "drop_frames=";
+	const char* found = NULL;
+	for (const char* p = strstr(buf, key); p != NULL; p = strstr(p + 1, key))
+		found = p;
+	if (found == NULL)
+		return false;
+	droppedFrames = strtoull(found + strlen(key), NULL, 10);
+	return true;
+}
+
+uint64_t recorderMonitor::getTimeUsec()
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_MONOTONIC, &tv);
+	return tv.tv_sec*(uint64_t)1E6 + tv.tv_nsec/(uint64_t)1E3;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file streamCapture.cpp
+ * @brief Keeps the last seconds of an incoming stream so a recording starts before the command
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "streamCapture.h"
+#include "ThreadConfig.h"
+
+//System Includes
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+
+streamCapture::streamCapture()
+	: preroll_ns(0),
+	opened(false),
+	isRunning(false),
+	startDue(false),
+	stopDue(false),
+	startAt_ns(0),
+	stopPosition(0),
+	position(0),
+	endPosition(UINT64_MAX),
+	files(0),
+	bytesWritten(0),
+	prerollBytes(0),
+	writeErrors(0)
+{
+}
+
+streamCapture::~streamCapture()
+{
+	//Nothing arrives once the ingest thread is gone, the writer then finishes the segments
+	this->server.disconnect();
+	{
+		std::lock_guard<std::mutex> lock(this->commandMutex);
+		this->isRunning = false;
+	}
+	this->commandCondition.notify_one();
+	if (this->writerThread_h.joinable())
+		this->writerThread_h.join();
+}
+
+bool streamCapture::open(int port, double preroll_s)
+{
+	if (this->opened)
+		return false;
+
+	//Sized once for the pre-roll at the highest rate, with as much again for a slow disk
+	this->preroll_ns = preroll_s * 1e9;
+	this->ring.reset(new PrerollRing(PrerollRing::getSlotCount(preroll_s, STREAM_MAX_RATE_BPS, STREAM_MIN_DATAGRAM),
+		STREAM_MAX_DATAGRAM));
+	this->datagram.reset(new char[STREAM_MAX_DATAGRAM]);
+	if (!this->ring->isValid() || !this->server.connect("", port, STREAM_RECEIVE_BUFFER))
+		return false;
+
+	this->isRunning = true;
+	this->writerThread_h = std::thread(&streamCapture::writerThread, this);
+
+	//The task only stamps and copies, a datagram too long for a slot is counted by the ring
+	PrerollRing* ring_ = this->ring.get();
+	this->server.setThreadRole("stream");
+	if (!this->server.runInThread([ring_](int, char* data, size_t length)
+		{
+			ring_->push(data, length, getTimeNsec());
+			return true;
+		}, STREAM_MAX_DATAGRAM, 0))
+		return false;
+
+	std::cout << "Capturing the stream on port " << port << " with " << preroll_s << " s of pre-roll in "
+		<< this->ring->getSlotCount() << " slots" << std::endl;
+	this->opened = true;
+	return true;
+}
+
+bool streamCapture::isOpen() const
+{
+	return this->opened;
+}
+
+void streamCapture::start(const std::string& directory)
+{
+	if (!this->opened)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->commandMutex);
+		this->nextDirectory = directory;
+		this->startAt_ns = getTimeNsec();
+		this->startDue = true;
+	}
+	this->commandCondition.notify_one();
+}
+
+void streamCapture::stop()
+{
+	if (!this->opened)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->commandMutex);
+		//A start not taken up yet never began
+		this->stopPosition = this->ring->getHead();
+		this->stopDue = true;
+		this->startDue = false;
+	}
+	this->commandCondition.notify_one();
+}
+
+std::string streamCapture::getStats()
+{
+	std::ostringstream out;
+	out << "stream " << this->ring->getSnapshot().toString()
+		<< " " << this->server.getStats().toString()
+		<< " " << this->segments.getSnapshot().toString()
+		<< " files=" << this->files
+		<< " bytesWritten=" << this->bytesWritten
+		<< " prerollBytes=" << this->prerollBytes
+		<< " writeErrors=" << this->writeErrors;
+	return out.str();
+}
+
+int streamCapture::writerThread()
+{
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("capture");
+
+	while (true)
+	{
+		//Idle until a command, drain the ring now and then while writing
+		bool startNow;
+		bool running;
+		std::string directory;
+		uint64_t since_ns = 0;
+		{
+			std::unique_lock<std::mutex> lock(this->commandMutex);
+			auto commandDue = [this]() { return this->startDue || this->stopDue || !this->isRunning; };
+			if (this->segments.isOpen())
+				this->commandCondition.wait_for(lock, std::chrono::milliseconds(STREAM_WRITE_PERIOD_MS), commandDue);
+			else
+				this->commandCondition.wait(lock, commandDue);
+
+			if (this->stopDue)
+				this->endPosition = this->stopPosition;
+			startNow = this->startDue;
+			if (startNow)
+			{
+				directory = this->nextDirectory;
+				since_ns = this->startAt_ns > this->preroll_ns ? this->startAt_ns - this->preroll_ns : 0;
+			}
+			this->startDue = false;
+			this->stopDue = false;
+			running = this->isRunning;
+		}
+
+		//A new recording or shutting down ends the current one with what has arrived so far
+		if (this->segments.isOpen())
+		{
+			if (startNow || !running)
+				this->endPosition = std::min(this->endPosition, this->ring->getHead());
+			this->drain(this->endPosition);
+			if (this->position >= this->endPosition)
+			{
+				this->segments.close();
+				std::cout << "Stream capture stopped: " << this->segments.getSnapshot().toString() << std::endl;
+			}
+		}
+
+		if (startNow)
+		{
+			//Opened here, so a slow disk holds up neither the ingest nor the command
+			SegmentWriter::Options options;
+			options.directory = directory;
+			options.prefix = "stream";
+			options.extension = ".ts";
+			options.bufferSize = STREAM_BUFFER_SIZE;
+			options.segmentSize = STREAM_SEGMENT_SIZE;
+			options.segmentDuration = STREAM_SEGMENT_SECONDS;
+			options.directIo = STREAM_DIRECT_IO;
+			options.threadRole = "disk";
+			if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+				std::cerr << "Could not create " << directory << ": " << strerror(errno) << std::endl;
+			if (!this->segments.open(options))
+			{
+				std::cerr << "Could not record the stream to " << directory << std::endl;
+				this->writeErrors++;
+			}
+			else
+			{
+				//Everything received before the command is the pre-roll
+				this->files++;
+				this->position = this->ring->seek(since_ns);
+				this->endPosition = UINT64_MAX;
+				uint64_t written = this->bytesWritten;
+				this->drain(this->ring->getHead());
+				this->prerollBytes += this->bytesWritten - written;
+				std::cout << "Stream capture to " << directory << " started with "
+					<< this->bytesWritten - written << " bytes of pre-roll" << std::endl;
+			}
+		}
+
+		if (!running)
+			break;
+	}
+	return 0;
+}
+
+void streamCapture::drain(uint64_t end)
+{
+	//Copied into the segment buffers, the disk is written by the writer's own thread
+	uint64_t timestamp_ns;
+	while (this->position < end)
+	{
+		ssize_t length = this->ring->read(this->position, this->datagram.get(), timestamp_ns);
+		if (length < 0)
+			break;
+		this->segments.append(this->datagram.get(), length);
+		this->bytesWritten += length;
+	}
+}
+
+uint64_t streamCapture::getTimeNsec()
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_MONOTONIC, &tv);
+	return tv.tv_sec*(uint64_t)1E9 + tv.tv_nsec;
+}
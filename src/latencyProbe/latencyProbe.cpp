@@ -0,0 +1,168 @@
+/**
+ * @file latencyProbe.cpp
+ * @brief Measures round trip latency of the control link with heartbeat sized frames
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+#include "latencyProbe.h"
+
+
+
+/** Constructor, nothing is opened until echo or probe mode is started
+
+ */
+latencyProbe::latencyProbe(std::string ipAddrPeer_, int portLocal_, int portPeer_)
+	: ipAddrPeer(ipAddrPeer_),
+	portLocal(portLocal_),
+	portPeer(portPeer_),
+	isRunning(false),
+	rateHz(10.0),
+	sentCount(0),
+	receivedCount(0)
+{
+}
+
+/** Default Destructor
+
+ */
+latencyProbe::~latencyProbe()
+{
+	this->stop();
+}
+
+bool latencyProbe::startEcho()
+{
+	if (this->isRunning || !this->server.connect("", this->portLocal, 256))
+		return false;
+
+	if (!this->server.runInThread(std::bind(&latencyProbe::onEchoReceived, this,
+		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), 256, 0))
+	{
+		this->server.disconnect();
+		return false;
+	}
+
+	this->isRunning = true;
+	return true;
+}
+
+bool latencyProbe::startProbe(double rateHz_)
+{
+	if (this->isRunning || rateHz_ <= 0 || !this->server.connect("", this->portLocal, 256))
+		return false;
+	this->server.setClientInfo(this->ipAddrPeer, this->portPeer);
+
+	this->rateHz = rateHz_;
+	this->sentCount = 0;
+	this->receivedCount = 0;
+	this->rttHistogram.reset();
+	this->isRunning = true;
+
+	if (!this->server.runInThread(std::bind(&latencyProbe::onProbeReceived, this,
+		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), 256, 0))
+	{
+		this->isRunning = false;
+		this->server.disconnect();
+		return false;
+	}
+
+	this->sendThread_h = std::thread(&latencyProbe::sendThread, this);
+	return true;
+}
+
+void latencyProbe::stop()
+{
+	this->isRunning = false;
+	if (this->sendThread_h.joinable())
+		this->sendThread_h.join();
+	this->server.disconnect();
+}
+
+/** Sends the heartbeat frames, stamped with the time they leave
+
+ */
+int latencyProbe::sendThread()
+{
+	messageStructure_t sndMessage;
+	memset(&sndMessage, 0, sizeof(sndMessage));
+	sndMessage.mode = MODE_STANDBY;
+	uint8_t sndbuf[MessageCodec::frameSize];
+
+	const uint64_t period_us = static_cast<uint64_t>(1e6 / this->rateHz);
+	uint64_t nextSend_us = this->getTimeUsec();
+	while(this->isRunning)
+	{
+		//Neither a command nor a status, the peer only echoes it
+		sndMessage.timestamp_us = this->getTimeUsec();
+		MessageCodec::encode(sndMessage, sndbuf);
+		this->server.send(reinterpret_cast<char*>(sndbuf), sizeof(sndbuf));
+		this->sentCount++;
+
+		//Keep a fixed rate rather than a fixed gap so send time does not drift
+		nextSend_us += period_us;
+		uint64_t now_us = this->getTimeUsec();
+		if (nextSend_us > now_us)
+			usleep(nextSend_us - now_us);
+		else
+			nextSend_us = now_us;
+	}
+	return 0;
+}
+
+bool latencyProbe::onEchoReceived(int, char* buff, size_t length)
+{
+	if (!this->isValidFrame(buff, length))
+		return true;
+
+	//Sends back to the address of the frame we just received
+	this->server.send(buff, length);
+	this->receivedCount++;
+	return true;
+}
+
+bool latencyProbe::onProbeReceived(int, char* buff, size_t length)
+{
+	if (!this->isValidFrame(buff, length))
+		return true;
+
+	uint64_t sent_us = MessageCodec::getTimestamp(reinterpret_cast<const uint8_t*>(buff));
+	uint64_t now_us = this->getTimeUsec();
+	if (sent_us <= now_us)
+		this->rttHistogram.record(now_us - sent_us);
+	this->receivedCount++;
+	return true;
+}
+
+bool latencyProbe::isValidFrame(const char* buff, size_t length)
+{
+	return MessageCodec::isValidFrame(reinterpret_cast<const uint8_t*>(buff), length);
+}
+
+const LatencyHistogram& latencyProbe::getHistogram() const
+{
+	return this->rttHistogram;
+}
+
+LatencyHistogram::Summary latencyProbe::getSummary() const
+{
+	return this->rttHistogram.getSummary();
+}
+
+uint64_t latencyProbe::getSentCount() const
+{
+	return this->sentCount;
+}
+
+uint64_t latencyProbe::getReceivedCount() const
+{
+	return this->receivedCount;
+}
+
+uint64_t latencyProbe::getTimeUsec()
+{
+	struct timespec tv;
+	clock_gettime(CLOCK_MONOTONIC, &tv);
+	return tv.tv_sec*(uint64_t)1E6 + tv.tv_nsec/(uint64_t)1E3;
+}
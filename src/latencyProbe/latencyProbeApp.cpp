@@ -0,0 +1,119 @@
+/**
+ * @file latencyProbeApp.cpp
+ * @brief Application entry point for the control link latency probe
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+//System
+#include<iostream>
+#include<signal.h>
+#include<unistd.h>
+
+//Ours
+#include "latencyProbe.h"
+
+//local functions
+static void print_usage();
+static void onSignal(int);
+
+static volatile sig_atomic_t time2Exit = 0;
+
+
+//Application Entry Point
+int main(int argc, char *argv[])
+{
+	int c;
+	std::string peerIP = "127.0.0.1";
+	bool echoMode = false;
+	double rateHz = 10.0;
+	int duration_s = 0;
+	int portLocal = LATENCY_PROBE_PORT;
+	int portPeer = LATENCY_PROBE_PORT;
+	while ((c = getopt (argc, argv, "i:er:n:l:p:h")) != -1)
+	{
+		switch (c)
+		{
+			case 'i':
+				peerIP = optarg;
+				break;
+			case 'e':
+				echoMode = true;
+				break;
+			case 'r':
+				rateHz = atof(optarg);
+				break;
+			case 'n':
+				duration_s = atoi(optarg);
+				break;
+			case 'l':
+				portLocal = atoi(optarg);
+				break;
+			case 'p':
+				portPeer = atoi(optarg);
+				break;
+			case 'h':
+				print_usage();
+				return 0;
+			default:
+				print_usage();
+				return 1;
+		}
+	}
+
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+
+	latencyProbe probe(peerIP, portLocal, portPeer);
+	if (echoMode)
+	{
+		if (!probe.startEcho())
+		{
+			std::cerr << "Failed to start echo on port " << portLocal << std::endl;
+			return 1;
+		}
+		std::cout << "Echoing frames on port " << portLocal << std::endl;
+	}
+	else if (!probe.startProbe(rateHz))
+	{
+		std::cerr << "Failed to start probe on port " << portLocal << std::endl;
+		return 1;
+	}
+
+	//Report once a second until stopped or the duration has elapsed
+	for (int elapsed_s = 0; !time2Exit && (duration_s == 0 || elapsed_s < duration_s); elapsed_s++)
+	{
+		sleep(1);
+		if (echoMode)
+			std::cout << "echoed=" << probe.getReceivedCount() << std::endl;
+		else
+			std::cout << "rtt " << LatencyHistogram::toString(probe.getSummary())
+				<< " sent=" << probe.getSentCount()
+				<< " lost=" << probe.getSentCount() - probe.getReceivedCount() << std::endl;
+	}
+
+	probe.stop();
+	return 0;
+}
+
+static void onSignal(int)
+{
+	time2Exit = 1;
+}
+
+static void print_usage(){
+	std::cout <<"\n Usage:\n";
+	std::cout <<"./latencyProbe [-OPTION OPTION_VALUE]\n";
+	std::cout <<"\n";
+	std::cout <<"Options:\n";
+	std::cout <<"-i {ip Address}            IP address of the peer running in echo mode. Default: 127.0.0.1 (localhost)\n";
+	std::cout <<"-e {echo}                  Echo frames back to their sender instead of probing\n";
+	std::cout <<"-r {rate}                  Probe frames per second. Default: 10\n";
+	std::cout <<"-n {seconds}               Stop after this many seconds. Default: run until interrupted\n";
+	std::cout <<"-l {port}                  Local port. Default: 202\n";
+	std::cout <<"-p {port}                  Peer port. Default: 202\n";
+	std::cout <<"-h {help}                  Print this usage text\n";
+
+	return;
+}
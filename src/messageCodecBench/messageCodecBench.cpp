@@ -0,0 +1,140 @@
+/**
+ * @file messageCodecBench.cpp
+ * @brief Cost of laying out and parsing control frames, codec against the old struct copies
+ *
+ * @author Mike Sardonini
+ * @date 10/18/2026
+ */
+
+//System
+#include <string.h>
+
+//Packages
+#include <benchmark/benchmark.h>
+
+//Ours
+#include "messageCodec.h"
+
+
+//Fills a command message the way the apps do before sending
+static void fillMessage(messageStructure_t& message, uint64_t timestamp_us)
+{
+	message.magicHeader1 = MAGIC_H1;
+	message.magicHeader2 = MAGIC_H2;
+	message.timestamp_us = timestamp_us;
+	message.isCommandMsg = 1u;
+	message.isStatusMsg = 0u;
+	message.mode = MODE_RECORDING;
+	message.sequence = static_cast<uint32_t>(timestamp_us);
+	message.echoTimestamp_us = timestamp_us - 5000;
+	message.echoDelay_us = 1000;
+	message.commandId = 1u;
+	message.ackCommandId = 0u;
+	message.keepalive_us = HEARTBEAT_PERIOD_US;
+	message.magicFooter1 = MAGIC_F1;
+	message.magicFooter2 = MAGIC_F2;
+}
+
+
+//The struct copied as is into the send buffer, as before the codec
+static void BM_StructEncode(benchmark::State& state)
+{
+	messageStructure_t message;
+	uint8_t sndbuf[256];
+	uint64_t timestamp_us = 0;
+	for (auto _ : state)
+	{
+		fillMessage(message, timestamp_us++);
+		memcpy(sndbuf, &message, sizeof(message));
+		benchmark::DoNotOptimize(sndbuf);
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * sizeof(messageStructure_t));
+}
+BENCHMARK(BM_StructEncode);
+
+
+static void BM_CodecEncode(benchmark::State& state)
+{
+	messageStructure_t message;
+	uint8_t sndbuf[256];
+	uint64_t timestamp_us = 0;
+	for (auto _ : state)
+	{
+		fillMessage(message, timestamp_us++);
+		benchmark::DoNotOptimize(MessageCodec::encode(message, sndbuf));
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * MessageCodec::frameSize);
+}
+BENCHMARK(BM_CodecEncode);
+
+
+//The receive buffer copied into a struct and the magic numbers compared, as before the codec
+static void BM_StructDecode(benchmark::State& state)
+{
+	messageStructure_t message;
+	fillMessage(message, 0x0102030405060708ull);
+	uint8_t rcvbuf[256];
+	memcpy(rcvbuf, &message, sizeof(message));
+
+	messageStructure_t rcvMessage;
+	uint64_t checksum = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(rcvbuf);
+		memcpy(&rcvMessage, rcvbuf, sizeof(rcvMessage));
+		if (rcvMessage.magicHeader1 == MAGIC_H1
+			&& rcvMessage.magicHeader2 == MAGIC_H2
+			&& rcvMessage.magicFooter1 == MAGIC_F1
+			&& rcvMessage.magicFooter2 == MAGIC_F2)
+			checksum += rcvMessage.timestamp_us + rcvMessage.mode;
+	}
+	benchmark::DoNotOptimize(checksum);
+	state.SetBytesProcessed(state.iterations() * sizeof(messageStructure_t));
+}
+BENCHMARK(BM_StructDecode);
+
+
+//Fields read out of the receive buffer where they landed
+static void BM_CodecDecode(benchmark::State& state)
+{
+	messageStructure_t message;
+	fillMessage(message, 0x0102030405060708ull);
+	uint8_t rcvbuf[256];
+	MessageCodec::encode(message, rcvbuf);
+
+	uint64_t checksum = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(rcvbuf);
+		if (MessageCodec::isValidFrame(rcvbuf, MessageCodec::frameSize))
+			checksum += MessageCodec::getTimestamp(rcvbuf) + MessageCodec::getMode(rcvbuf);
+	}
+	benchmark::DoNotOptimize(checksum);
+	state.SetBytesProcessed(state.iterations() * MessageCodec::frameSize);
+}
+BENCHMARK(BM_CodecDecode);
+
+
+//Full parse into a message, for code that wants the struct
+static void BM_CodecDecodeStruct(benchmark::State& state)
+{
+	messageStructure_t message;
+	fillMessage(message, 0x0102030405060708ull);
+	uint8_t rcvbuf[256];
+	MessageCodec::encode(message, rcvbuf);
+
+	messageStructure_t rcvMessage;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(rcvbuf);
+		benchmark::DoNotOptimize(MessageCodec::decode(rcvbuf, MessageCodec::frameSize, rcvMessage));
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * MessageCodec::frameSize);
+}
+BENCHMARK(BM_CodecDecodeStruct);
+
+
+BENCHMARK_MAIN();
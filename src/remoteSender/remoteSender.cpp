@@ -20,8 +20,34 @@ remoteSender::remoteSender()
 	buttonState(DISCONNECTED),
 	isRunning(true),
 	useBluetooth(true),
-	useUDP(false)
+	useUDP(false),
+	lastTimestampReceived_us(0),
+	lastReceivedAt_us(0),
+	sndSequence(0),
+	badFrames(0),
+	commandId(0),
+	commandPending(false),
+	commandIssued_us(0),
+	commandRetransmit_us(0),
+	commandBackoff_us(COMMAND_RETRANSMIT_MIN_US),
+	keepalive_us(HEARTBEAT_PERIOD_US),
+	keepaliveCeiling_us(0),
+	peerKeepalive_us(0),
+	framer(MessageEnvelope::maxLinkFrameSize, MessageEnvelope::headerSize,
+		MessageEnvelope::linkMagic, sizeof(MessageEnvelope::linkMagic),
+		&MessageEnvelope::getLinkFrameSize, &MessageEnvelope::isValidLinkFrame),
+	writeWakeFd(Networking::createWakeup()),
+	negotiation(MessageEnvelope::supportedFeatures, MessageEnvelope::telemetryRecorder),
+	envelopeSequence(0),
+	hasTelemetry(false),
+	stalledSamples(0),
+	recorderWarning(false)
 {
+	this->dispatcher.setHandler(MessageEnvelope::typeHello,
+		[this](const MessageEnvelope::Header& header) { this->onHello(header); });
+	this->dispatcher.setHandler(MessageEnvelope::typeTelemetry,
+		[this](const MessageEnvelope::Header& header) { this->onTelemetry(header); });
+
 	printf("Bluetooth!\n"); 
 	struct termios  config;
 
@@ -53,8 +79,8 @@ remoteSender::remoteSender()
 	config.c_lflag &= ~(ECHO | ECHONL | ICANON | IEXTEN | ISIG);
 	config.c_cflag &= ~(CSIZE | PARENB);
 	config.c_cflag |= CS8;
-	config.c_cc[VMIN]  = 10; //Miniumum size of 10 bytes to return from read
-	config.c_cc[VTIME] = 100; //return from read after 100 microseconds
+	config.c_cc[VMIN]  = 0; //The port is non-blocking, the framer collects whatever arrived
+	config.c_cc[VTIME] = 0;
 
 	//Set the read and write speeds
 	if(cfsetispeed(&config, B115200) < 0 || cfsetospeed(&config, B115200) < 0) 
@@ -101,17 +127,42 @@ remoteSender::remoteSender(std::string ipAddr)
 	buttonState(DISCONNECTED),
 	isRunning(true),
 	useBluetooth(false),
-	useUDP(true)
+	useUDP(true),
+	lastTimestampReceived_us(0),
+	lastReceivedAt_us(0),
+	sndSequence(0),
+	badFrames(0),
+	commandId(0),
+	commandPending(false),
+	commandIssued_us(0),
+	commandRetransmit_us(0),
+	commandBackoff_us(COMMAND_RETRANSMIT_MIN_US),
+	keepalive_us(HEARTBEAT_PERIOD_US),
+	keepaliveCeiling_us(0),
+	peerKeepalive_us(0),
+	framer(MessageEnvelope::maxLinkFrameSize, MessageEnvelope::headerSize,
+		MessageEnvelope::linkMagic, sizeof(MessageEnvelope::linkMagic),
+		&MessageEnvelope::getLinkFrameSize, &MessageEnvelope::isValidLinkFrame),
+	writeWakeFd(Networking::createWakeup()),
+	negotiation(MessageEnvelope::supportedFeatures, MessageEnvelope::telemetryRecorder),
+	envelopeSequence(0),
+	hasTelemetry(false),
+	stalledSamples(0),
+	recorderWarning(false)
 {
+	this->dispatcher.setHandler(MessageEnvelope::typeHello,
+		[this](const MessageEnvelope::Header& header) { this->onHello(header); });
+	this->dispatcher.setHandler(MessageEnvelope::typeTelemetry,
+		[this](const MessageEnvelope::Header& header) { this->onTelemetry(header); });
+
 	//Port to read from the headless machine
 	int portRemote = 200;
 	int portHost = 201;
 
-	this->server = UdpServer();
-
 	//Connect to Any available local IP address and listen on given port 
 	this->server.connect("", portRemote, 256);
-	this->server.setClientInfo(ipAddr, portHost);
+	//Only talk to the host, so a refused heartbeat tells us it is gone right away
+	this->server.setClientInfo(ipAddr, portHost, true);
 
 	//Start the thread that handles our LEDs
 	this->redLedThread = std::thread(&remoteSender::LedControlThread, this, RED);
@@ -147,16 +198,23 @@ remoteSender::~remoteSender()
 /** Function that reads data from the other device
 
  */
-ssize_t remoteSender::receiveData()
+const uint8_t* remoteSender::receiveFrame(size_t* length)
 {
 	if (this->useBluetooth)
 	{
-		return read(this->fd, reinterpret_cast<char*>(this->rcvbuf), sizeof(this->rcvbuf));
+		//Read until a whole frame is buffered, a read may hold several frames or part of one
+		const uint8_t* frame = this->framer.next(length);
+		while (frame == nullptr && this->framer.readFrom(this->fd) > 0)
+			frame = this->framer.next(length);
+		return frame;
 	}
 	else if(this->useUDP)
 	{
-		return server.receiveUdp(reinterpret_cast<char*>(this->rcvbuf), sizeof(this->rcvbuf));
+		ssize_t ret = server.receiveUdp(reinterpret_cast<char*>(this->rcvbuf), sizeof(this->rcvbuf));
+		*length = ret > 0 ? ret : 0;
+		return ret > 0 ? this->rcvbuf : nullptr;
 	}
+	return nullptr;
 }
 
 /** Function that manages the UDP responses from the host and updates the LED's accordingly
@@ -164,21 +222,46 @@ ssize_t remoteSender::receiveData()
  */
 int remoteSender::readThread()
 {
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("read");
 
-	uint64_t previousTimeStamp_us;
+
+	uint64_t previousTimeStamp_us = 0;
 	while(this->isRunning)
 	{
-		//Read the data in from the UDP interface
-		if(this->receiveData() > 0)
+		//Sleep until a frame arrives, so an acknowledgement shows on the LEDs right away,
+		//or until the link would time out without one
+		uint64_t timeout_us = this->getLinkTimeout();
+		uint64_t now_us = this->getTimeUsec();
+		uint64_t deadline_us = previousTimeStamp_us + timeout_us;
+		this->waitForData((deadline_us > now_us ? deadline_us - now_us : timeout_us) / 1e6);
+
+		//Parse everything that arrived. Update the timestamp for every message parsed correctly
+		const uint8_t* frame;
+		size_t length;
+		while((frame = this->receiveFrame(&length)) != nullptr)
 		{
-			//Parse the message we read in. Update the timestamp if it was parsed correctly
-			if(this->onMessageReceived())
+			if(this->onMessageReceived(frame, length))
 				previousTimeStamp_us = this->getTimeUsec();
 		}
 
-		//Check if we have received the heartbeat status message in a reasonable amount of time
-		if (abs(this->getTimeUsec() - previousTimeStamp_us) > 1e6)
+		//Check if we have received the heartbeat status message in a reasonable amount of time,
+		//or if our last one was refused because nothing listens on the host anymore
+		bool peerUnreachable = this->useUDP && this->server.isPeerUnreachable();
+		if (peerUnreachable || this->getTimeUsec() - previousTimeStamp_us >= this->getLinkTimeout())
 		{
+			//Log what the link saw so a lossy or noisy link can be told from a dead one
+			if (this->hostState != DISCONNECTED)
+			{
+				std::cout << "Link lost: " << this->getLinkStats() << std::endl;
+				this->negotiation.reset();
+				this->hasTelemetry = false;
+				this->stalledSamples = 0;
+				this->recorderWarning = false;
+
+				//A host that restarted numbers its frames from the start again
+				this->rcvSequence.reset();
+			}
 			this->hostState = DISCONNECTED;
 		}
 		else if (this->hostState == DISCONNECTED)
@@ -194,16 +277,22 @@ int remoteSender::readThread()
 				this->setLedOff(RED);
 				break;
 			case STANDBY:
+				//A flashing red while in standby says the host disk is nearly full
 				this->setLedOn(GREEN);
-				this->setLedOff(RED);
+				if (this->recorderWarning)
+					this->setLedFlashing(RED);
+				else
+					this->setLedOff(RED);
 				break;
 			case RECORDING:
+				//A flashing red while recording says the recording is stalled or the disk nearly full
 				this->setLedOff(GREEN);
-				this->setLedOn(RED);
+				if (this->recorderWarning)
+					this->setLedFlashing(RED);
+				else
+					this->setLedOn(RED);
 				break;
 		}
-		//Run at 10Hz
-		usleep(100000);
 	}
 	return 0;
 }
@@ -213,25 +302,203 @@ int remoteSender::readThread()
  */
 int remoteSender::writeThread()
 {
-	//thread whih keeps the heartbeat sending
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("write");
+
+	//thread whih keeps the heartbeat sending, and sends commands as soon as they are issued
+	uint64_t nextHeartbeat_us = this->getTimeUsec();
+	SendQueue::Result sendResult = SendQueue::FLUSHED;
+	std::unique_lock<std::mutex> lock(this->commandMutex);
 	while(this->isRunning)
 	{
-		this->createSendMessage();
+		//Sleep until the next heartbeat or retransmission, or until a new command wakes us
+		uint64_t wake_us = nextHeartbeat_us;
+		if (this->commandPending && this->commandRetransmit_us < wake_us)
+			wake_us = this->commandRetransmit_us;
+		uint64_t now_us = this->getTimeUsec();
+		if (wake_us > now_us && sendResult == SendQueue::BLOCKED)
+		{
+			//The serial port is full, also wake once it has room for the rest
+			lock.unlock();
+			Networking::waitForOutput(this->fd, this->writeWakeFd, (wake_us - now_us) / 1e6);
+			Networking::clearWakeup(this->writeWakeFd);
+			lock.lock();
+		}
+		else if (wake_us > now_us)
+			this->commandCondition.wait_for(lock, std::chrono::microseconds(wake_us - now_us));
+
+		now_us = this->getTimeUsec();
+		bool commandDue = this->commandPending && now_us >= this->commandRetransmit_us;
+		bool frameDue = commandDue || now_us >= nextHeartbeat_us;
+		if (!frameDue && sendResult != SendQueue::BLOCKED)
+			continue;
+
+		//Every frame carries the newest command, so a heartbeat retransmits it too
+		SendQueue::Priority priority = this->commandPending ? SendQueue::URGENT : SendQueue::STATUS;
+		if (frameDue)
+		{
+			if (this->commandPending)
+			{
+				this->commandRetransmit_us = now_us + this->commandBackoff_us;
+				this->commandBackoff_us = std::min<uint64_t>(this->commandBackoff_us * 2, COMMAND_RETRANSMIT_MAX_US);
+			}
+			this->createSendMessage();
+			nextHeartbeat_us = now_us + this->keepalive_us;
+			this->keepalive_us = this->getNextKeepalive(this->keepalive_us);
+		}
 
+		//Let the button and read threads in while the frame goes out
+		lock.unlock();
 		if(this->useBluetooth)
 		{
-			ssize_t ret = write(this->fd, reinterpret_cast<char*>(this->sndbuf), sizeof(this->sndMessage));
-		
+			//Queued, so a full serial port delays the frame rather than truncating it.
+			//A newer frame replaces one still waiting, it carries everything the old one did
+			if (frameDue)
+			{
+				this->sendQueue.push(priority, this->sndbuf, MessageCodec::frameSize, true);
+				this->sendHelloIfDue();
+			}
+			sendResult = this->sendQueue.flush(this->fd);
 		}
-		else if(this->useUDP)
-			this->server.send(reinterpret_cast<char*>(this->sndbuf), sizeof(this->sndMessage));
-
-		//Send a command message at 10Hz
-		usleep(100000);
+		else if(this->useUDP && frameDue)
+		{
+			this->server.send(reinterpret_cast<char*>(this->sndbuf), MessageCodec::frameSize);
+			this->sendHelloIfDue();
+		}
+		lock.lock();
 	}
 	return 0;
 }
 
+/** Issues a new command and wakes the write thread to send it
+
+ */
+void remoteSender::sendCommand(enum REMOTE_STATES_t state)
+{
+	std::lock_guard<std::mutex> lock(this->commandMutex);
+	this->buttonState = state;
+
+	//0 means no command was issued yet
+	if (++this->commandId == 0)
+		this->commandId = 1;
+	this->commandPending = true;
+	this->commandIssued_us = this->getTimeUsec();
+	this->commandRetransmit_us = this->commandIssued_us;
+	this->commandBackoff_us = COMMAND_RETRANSMIT_MIN_US;
+
+	//Something changed, so keepalives start over from the heartbeat
+	this->keepalive_us = HEARTBEAT_PERIOD_US;
+	this->commandCondition.notify_one();
+	Networking::signalWakeup(this->writeWakeFd);
+}
+
+void remoteSender::sendEnvelope(uint8_t type, const uint8_t* payload, size_t length, SendQueue::Priority priority)
+{
+	//Nothing is agreed before the HELLO, so it always carries a CRC
+	uint8_t flags = MessageEnvelope::getFlags(this->negotiation.getFeatures());
+	if (type == MessageEnvelope::typeHello)
+		flags |= MessageEnvelope::flagCrc;
+
+	size_t frameLength = MessageEnvelope::encode(type, flags, this->envelopeSequence++,
+		payload, length, this->envelopeBuf);
+	if (frameLength == 0)
+		return;
+
+	if(this->useBluetooth)
+		this->sendQueue.push(priority, this->envelopeBuf, frameLength);
+	else if(this->useUDP)
+		this->server.send(reinterpret_cast<char*>(this->envelopeBuf), frameLength);
+}
+
+void remoteSender::sendHelloIfDue()
+{
+	//Only a live link is offered our features, each link up negotiates again
+	MessageEnvelope::Hello hello;
+	if (this->hostState == DISCONNECTED || !this->negotiation.takeHelloDue(hello))
+		return;
+
+	uint8_t payload[MessageEnvelope::helloSize];
+	this->sendEnvelope(MessageEnvelope::typeHello, payload, MessageEnvelope::encodeHello(hello, payload), SendQueue::STATUS);
+}
+
+void remoteSender::onHello(const MessageEnvelope::Header& header)
+{
+	MessageEnvelope::Hello hello;
+	if (MessageEnvelope::decodeHello(header.payload, header.payloadLength, hello))
+		this->negotiation.onHello(hello);
+}
+
+void remoteSender::onTelemetry(const MessageEnvelope::Header& header)
+{
+	MessageEnvelope::Telemetry telemetry;
+	if (!MessageEnvelope::decodeTelemetry(header.payload, header.payloadLength, telemetry))
+		return;
+
+	//A file only just opened has no rate yet, so only a few samples in a row
+	//writing nothing count as a stalled recording
+	bool writing = (telemetry.flags & MessageEnvelope::Telemetry::flagRecorderRunning) && telemetry.writeRate_Bps > 0;
+	if (this->hostState != RECORDING || writing)
+		this->stalledSamples = 0;
+	else
+		this->stalledSamples++;
+
+	//A host that could not read its free space reports 0, which is no reason to warn
+	bool diskLow = (telemetry.flags & MessageEnvelope::Telemetry::flagFreeSpaceKnown)
+		&& telemetry.freeSpace_MiB < LOW_DISK_MIB;
+	bool warning = diskLow || this->stalledSamples >= TELEMETRY_STALL_SAMPLES;
+	bool dropped = this->hasTelemetry && telemetry.droppedFrames > this->telemetry.droppedFrames;
+
+	this->telemetry = telemetry;
+	this->hasTelemetry = true;
+
+	//Log the changes worth a look rather than every sample
+	if (warning != this->recorderWarning || dropped)
+	{
+		std::cout << "Recorder" << (diskLow ? " disk low" : "")
+			<< (this->stalledSamples >= TELEMETRY_STALL_SAMPLES ? " stalled" : "")
+			<< (dropped ? " dropping frames" : "")
+			<< (warning ? "" : " ok") << ": " << this->getTelemetryString() << std::endl;
+	}
+	this->recorderWarning = warning;
+}
+
+std::string remoteSender::getTelemetryString() const
+{
+	std::ostringstream out;
+	out << "running=" << ((this->telemetry.flags & MessageEnvelope::Telemetry::flagRecorderRunning) ? 1 : 0)
+		<< " bytesWritten=" << this->telemetry.bytesWritten
+		<< " writeRate_Bps=" << this->telemetry.writeRate_Bps
+		<< " freeSpace_MiB=" << this->telemetry.freeSpace_MiB
+		<< " cpu_permille=" << this->telemetry.recorderCpu_permille
+		<< " droppedFrames=" << this->telemetry.droppedFrames;
+	return out.str();
+}
+
+void remoteSender::setKeepaliveCeiling(uint64_t ceiling_us)
+{
+	this->keepaliveCeiling_us = ceiling_us;
+}
+
+uint64_t remoteSender::getNextKeepalive(uint64_t interval_us)
+{
+	//Only an idle link backs off, a lost one keeps calling at the heartbeat
+	uint64_t ceiling_us = this->keepaliveCeiling_us;
+	if (ceiling_us <= HEARTBEAT_PERIOD_US || this->hostState == DISCONNECTED)
+		return HEARTBEAT_PERIOD_US;
+	return std::min(interval_us * 2, ceiling_us);
+}
+
+uint64_t remoteSender::getLinkTimeout() const
+{
+	return std::max<uint64_t>(LINK_TIMEOUT_US, KEEPALIVES_MISSED * static_cast<uint64_t>(this->peerKeepalive_us));
+}
+
+bool remoteSender::waitForData(double timeout)
+{
+	int readFd = this->useUDP ? this->server.getServer() : this->fd;
+	return Networking::waitForInput(readFd, -1, timeout);
+}
+
 /** Fill Message to send
 
  */
@@ -240,38 +507,79 @@ int remoteSender::createSendMessage()
 	//Manually fill out the contents of the message to sent
 	this->sndMessage.magicHeader1 = MAGIC_H1;
 	this->sndMessage.magicHeader2 = MAGIC_H2;
+	this->sndMessage.timestamp_us = this->getTimeUsec();
 	this->sndMessage.isCommandMsg = 1u;
 	this->sndMessage.isStatusMsg = 0u;
 	if (this->buttonState == RECORDING)
 		this->sndMessage.mode = MODE_RECORDING;
 	else
 		this->sndMessage.mode = MODE_STANDBY;
+	this->sndMessage.sequence = this->sndSequence++;
+	this->sndMessage.commandId = this->commandId;
+	this->sndMessage.ackCommandId = 0u;
+	this->sndMessage.keepalive_us = this->keepalive_us;
+
+	//Hand the peer back its newest timestamp and how long we held it
+	{
+		std::lock_guard<std::mutex> lock(this->echoMutex);
+		this->sndMessage.echoTimestamp_us = this->lastTimestampReceived_us;
+		this->sndMessage.echoDelay_us = this->lastReceivedAt_us ? this->sndMessage.timestamp_us - this->lastReceivedAt_us : 0;
+	}
 	this->sndMessage.magicFooter1 = MAGIC_F1;
 	this->sndMessage.magicFooter2 = MAGIC_F2;
 
-	//Copy the message into our buffer for sending
-	memcpy(this->sndbuf, &this->sndMessage, sizeof(this->sndMessage));
+	//Lay the message out in our buffer for sending
+	MessageCodec::encode(this->sndMessage, this->sndbuf);
 	return 0;
 }
 
 
 
-bool remoteSender::onMessageReceived()
+bool remoteSender::onMessageReceived(const uint8_t* frame, size_t length)
 {
-	//Copy the buffer into the messge predefined message
-	memcpy(&this->rcvMessage, this->rcvbuf, sizeof(this->rcvMessage));
-
-	//Check the magic numbers
-	if( 
-		this->rcvMessage.magicHeader1 == MAGIC_H1
-		&& this->rcvMessage.magicHeader2 == MAGIC_H2
-		&& this->rcvMessage.magicFooter1 == MAGIC_F1
-		&& this->rcvMessage.magicFooter2 == MAGIC_F2
-		)
+	//Envelopes go to the handler of their type, a type we do not know is skipped
+	if (MessageEnvelope::isEnvelope(frame, length))
 	{
+		if (this->dispatcher.dispatch(frame, length))
+			return true;
+		this->badFrames++;
+		return false;
+	}
+
+	//Check the length and magic numbers of the frame where it was received
+	if (MessageCodec::isValidFrame(frame, length))
+	{
+		//A late or repeated frame still shows the link is up, but must not
+		//undo the state of a newer one
+		SequenceStats::Result result = this->rcvSequence.record(MessageCodec::getSequence(frame));
+		if (result == SequenceStats::DUPLICATE || result == SequenceStats::REORDERED)
+			return true;
+
+		//Our own timestamp came back, less the time the peer held it
+		uint64_t now_us = this->getTimeUsec();
+		uint64_t echo_us = MessageCodec::getEchoTimestamp(frame);
+		uint64_t echoDelay_us = MessageCodec::getEchoDelay(frame);
+		if (echo_us != 0 && echo_us + echoDelay_us <= now_us)
+			this->rttHistogram.record(now_us - echo_us - echoDelay_us);
+
 		//Update our local variables with the contents of the new message
-		this->lastTimestampReceived_us = this->rcvMessage.timestamp_us;
-		this->lastModeReceived = this->rcvMessage.mode;
+		{
+			std::lock_guard<std::mutex> lock(this->echoMutex);
+			this->lastTimestampReceived_us = MessageCodec::getTimestamp(frame);
+			this->lastReceivedAt_us = now_us;
+		}
+		this->lastModeReceived = MessageCodec::getMode(frame);
+		this->peerKeepalive_us = MessageCodec::getKeepalive(frame);
+
+		//The host applied our newest command, stop retransmitting it
+		{
+			std::lock_guard<std::mutex> lock(this->commandMutex);
+			if (this->commandPending && MessageCodec::getAckCommandId(frame) == this->commandId)
+			{
+				this->commandPending = false;
+				this->commandHistogram.record(now_us - this->commandIssued_us);
+			}
+		}
 	
 		if(this->lastModeReceived == MODE_RECORDING)
 		{
@@ -283,11 +591,15 @@ bool remoteSender::onMessageReceived()
 		}
 		return true;
 	}
+	this->badFrames++;
 	return false;
 }
 
 int remoteSender::buttonThread()
 {
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("button");
+
 	bool firstIterationButton = true;
 
 	int redButtonState = 0;
@@ -309,7 +621,7 @@ int remoteSender::buttonThread()
 		if (greenButtonState != previousGreenButtonState)
 		{
 			// std::cout << "green push detected \n";
-			this->buttonState = STANDBY;
+			this->sendCommand(STANDBY);
 		}
 
 		if(firstIterationButton)
@@ -326,7 +638,7 @@ int remoteSender::buttonThread()
 		if (redButtonState != previousRedButtonState)
 		{
 			std::cout << "red push detected \n";
-			this->buttonState = RECORDING;
+			this->sendCommand(RECORDING);
 		}
 
 		//Run at 100hz to catch quick button pushes
@@ -338,6 +650,9 @@ int remoteSender::buttonThread()
 
 int remoteSender::LedControlThread(enum LED_COLORS_t color)
 {
+	//Apply the scheduling, pinning and name set up for this thread
+	Threading::configureThread("led");
+
 	enum LED_STATUS_t status;
 	bool isLedOn = false;
 
@@ -424,6 +739,44 @@ int remoteSender::setLedOff(enum LED_COLORS_t color)
 }
 
 
+bool remoteSender::startCapture(std::string path)
+{
+	if (!this->useUDP)
+	{
+		std::cerr << "Capture is only supported over UDP" << std::endl;
+		return false;
+	}
+	return this->server.startCapture(path);
+}
+
+
+uint64_t remoteSender::getBadFrames() const
+{
+	return this->badFrames;
+}
+
+
+std::string remoteSender::getLinkStats()
+{
+	std::ostringstream out;
+	out << "badFrames=" << this->badFrames
+		<< " " << this->rcvSequence.getSnapshot().toString()
+		<< " rtt " << LatencyHistogram::toString(this->rttHistogram.getSummary())
+		<< " cmd " << LatencyHistogram::toString(this->commandHistogram.getSummary())
+		<< " protocol=" << static_cast<int>(this->negotiation.getVersion())
+		<< " features=" << this->negotiation.getFeatures()
+		<< " unknownMessages=" << this->dispatcher.getUnknown();
+	if (this->hasTelemetry)
+		out << " recorder " << this->getTelemetryString();
+	if (this->useBluetooth)
+		out << " " << this->framer.getSnapshot().toString()
+			<< " " << this->sendQueue.getSnapshot().toString();
+	if (this->useUDP)
+		out << " " << this->server.getStats().toString();
+	return out.str();
+}
+
+
 uint64_t remoteSender::getTimeUsec()
 {
 	struct timespec tv;
@@ -11,10 +11,13 @@
 #include<vector>
 #include<memory>
 #include<unistd.h>
+#include<stdlib.h>
+#include<stdint.h>
 
 //Packages
 
 //Ours
+#include "ThreadConfig.h"
 #ifdef REMOTE_SENDER
     #include "remoteSender.h"
 #elif HOST_RECEIVER
@@ -23,6 +26,20 @@
 
 //local functions
 static void print_usage();
+static void setRealtimeProfile();
+
+//Pre-roll of the stream capture unless given with -s
+#define STREAM_PREROLL_S 5.0
+
+//Command line options, -w only means something to the host
+#ifdef HOST_RECEIVER
+    #define APP_OPTIONS "i:hbrt:c:k:ws:"
+#else
+    #define APP_OPTIONS "i:hbrt:c:k:s:"
+#endif
+
+//Stack size of each thread in the realtime profile, every page of it gets locked
+#define REALTIME_STACK_SIZE (256 * 1024)
 
 
 //Application Entry Point
@@ -31,7 +48,16 @@ int main(int argc, char *argv[])
     int c;
     char* hostIP = NULL;
     bool useBluetooth = false;
-    while ((c = getopt (argc, argv, "i:hb")) != -1)
+    bool useRealtime = false;
+    std::string threadSpec;
+    std::string capturePath;
+    uint64_t keepaliveCeiling_us = 0;
+#ifdef HOST_RECEIVER
+    bool prewarm = false;
+#endif
+    int streamPort = 0;
+    double preroll_s = STREAM_PREROLL_S;
+    while ((c = getopt (argc, argv, APP_OPTIONS)) != -1)
     {
         switch (c)
         {
@@ -53,6 +79,49 @@ int main(int argc, char *argv[])
             case 'b':
                 useBluetooth = true;
                 break;
+
+            //Run the control threads with realtime scheduling
+            case 'r':
+                useRealtime = true;
+                break;
+
+            //Per thread overrides of the realtime profile
+            case 't':
+                threadSpec = optarg;
+                break;
+
+            //Record received frames for captureReplay
+            case 'c':
+                capturePath = optarg;
+                break;
+
+            //Back off the heartbeat while idle, up to this many milliseconds.
+            //Frames carry the period in 32 bits of microseconds
+            case 'k':
+                keepaliveCeiling_us = strtoull(optarg, NULL, 10);
+                if (keepaliveCeiling_us > UINT32_MAX / 1000)
+                {
+                    std::cerr << "The keepalive period can be at most " << UINT32_MAX / 1000 << " ms" << std::endl;
+                    return 1;
+                }
+                keepaliveCeiling_us *= 1000;
+                break;
+
+#ifdef HOST_RECEIVER
+            //Keep a recorder armed in standby on the host
+            case 'w':
+                prewarm = true;
+                break;
+#endif
+
+            //Record the stream arriving on a port on the host, with pre-roll
+            case 's':
+                if (sscanf(optarg, "%d:%lf", &streamPort, &preroll_s) < 1 || streamPort <= 0 || preroll_s < 0)
+                {
+                    std::cerr << "Failed to read the stream port" << std::endl;
+                    return 1;
+                }
+                break;
             //Handle unknown Arguments
             case '?':
                 if (optopt == 'c')
@@ -78,6 +147,15 @@ int main(int argc, char *argv[])
         strcpy(hostIP, "127.0.0.1");
     }
 
+    //Thread settings have to be in place before the threads get created
+    if (useRealtime)
+        setRealtimeProfile();
+    if (!threadSpec.empty() && !Threading::parseConfig(threadSpec))
+    {
+        print_usage();
+        return 1;
+    }
+
 #ifdef REMOTE_SENDER
 
     remoteSender* receiver;
@@ -87,32 +165,31 @@ int main(int argc, char *argv[])
     {
         std::string remoteIPstring(hostIP);
         receiver = new remoteSender(remoteIPstring);
+        if (!capturePath.empty())
+            receiver->startCapture(capturePath);
     }
+    receiver->setKeepaliveCeiling(keepaliveCeiling_us);
 #elif HOST_RECEIVER
     hostReceiver* receiver;
     if(useBluetooth)
     {   
+        //A lost link only reopens the serial port, the recorder keeps running
         receiver = new hostReceiver;
-
-        while(1)
-        {
-            //Check to see if the class needs to be reset
-            if(receiver->getNeedsReset())
-            {
-                delete receiver;
-                sleep(4);
-
-                receiver = new hostReceiver;
-            }
-
-            sleep(1);
-        }
-        // receiver = std::make_unique<hostReceiver>();
+        receiver->setKeepaliveCeiling(keepaliveCeiling_us);
+        receiver->setPrewarm(prewarm);
+        if (streamPort)
+            receiver->startStreamCapture(streamPort, preroll_s);
     }
     else
     {
         std::string remoteIPstring(hostIP);
         receiver = new hostReceiver(remoteIPstring);
+        receiver->setKeepaliveCeiling(keepaliveCeiling_us);
+        receiver->setPrewarm(prewarm);
+        if (streamPort)
+            receiver->startStreamCapture(streamPort, preroll_s);
+        if (!capturePath.empty())
+            receiver->startCapture(capturePath);
     }
 #endif
 
@@ -132,8 +209,42 @@ static void print_usage(){
     std::cout <<"\n";
     std::cout <<"Options:\n";
     std::cout <<"-i {ip Address} 		Manually set the IP address of the host to connect to. Default: 127.0.0.1 (localhost)\n";
+    std::cout <<"-b {bluetooth}             Talk over the rfcomm serial link instead of UDP\n";
+    std::cout <<"-r {realtime}              Run the control threads with SCHED_FIFO priority and locked memory\n";
+    std::cout <<"-t {role:priority[:cpu],...} Override the priority and CPU of a thread role (read, write, button, led, server)\n";
+    std::cout <<"-c {file}                  Capture every frame received over UDP to a file for captureReplay\n";
+    std::cout <<"-k {ms}                    Back off the 100 ms heartbeat while idle, doubling up to this period\n";
+    std::cout <<"-w {pre-warm}              Host only, keep a recorder armed in standby so a start only resumes it\n";
+    std::cout <<"-s {port[:seconds]}        Host only, record the UDP stream on this port with seconds of pre-roll (default 5)\n";
     std::cout <<"-h {help}                  Print this usage text\n";
     
     return;
 }
 
+/** Sets up the realtime profile for the control threads
+
+    Button edges and the heartbeat must not wait behind the LED threads or other
+    load on the Pi, so the control threads run SCHED_FIFO, button first, and the
+    LED threads stay on the default scheduler. On a multicore remote the control
+    threads share the last core. Memory is locked so a page fault never stalls
+    them, with smaller thread stacks to keep the locked footprint down.
+ */
+static void setRealtimeProfile()
+{
+    int controlCpu = -1;
+#ifdef REMOTE_SENDER
+    //Processes started by the host (the recorder) inherit the affinity, so only the remote pins
+    if (Threading::getCpuCount() > 1)
+        controlCpu = Threading::getCpuCount() - 1;
+#endif
+
+    Threading::setConfig("button", ThreadConfig("button", 90, controlCpu));
+    Threading::setConfig("read", ThreadConfig("read", 80, controlCpu));
+    Threading::setConfig("server", ThreadConfig("server", 80, controlCpu));
+    Threading::setConfig("write", ThreadConfig("write", 70, controlCpu));
+    Threading::setConfig("led", ThreadConfig("led", 0));
+
+    Threading::setDefaultStackSize(REALTIME_STACK_SIZE);
+    Threading::lockMemory();
+}
+
@@ -0,0 +1,39 @@
+/**
+ * @file TestMessageCodec.h
+ * @brief Tests the wire layout of the control frames.
+ *
+ * @author Mike Sardonini
+ * @date 10/19/2026
+ */
+
+#ifndef TEST_MESSAGE_CODEC_H
+#define TEST_MESSAGE_CODEC_H
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "messageCodec.h"
+
+
+/** Fixture for control frame tests */
+class TestMessageCodec : public ::testing::Test
+{
+protected:
+
+    /** Default constructor, fills the message of the reference frame.
+     */
+    TestMessageCodec();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestMessageCodec();
+
+    // Message MessageCodec::referenceFrame holds.
+    messageStructure_t message;
+
+};  // TEST_MESSAGE_CODEC
+
+
+#endif  // TEST_MESSAGE_CODEC_H
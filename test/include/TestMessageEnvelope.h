@@ -0,0 +1,54 @@
+/**
+ * @file TestMessageEnvelope.h
+ * @brief Tests the message envelope and the handshake agreeing on its features.
+ *
+ * @author Mike Sardonini
+ * @date 10/19/2026
+ */
+
+#ifndef TEST_MESSAGE_ENVELOPE_H
+#define TEST_MESSAGE_ENVELOPE_H
+
+// STL
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Ours
+#include "messageEnvelope.h"
+
+
+/** Fixture for message envelope tests */
+class TestMessageEnvelope : public ::testing::Test
+{
+protected:
+
+    /** Default constructor.
+     */
+    TestMessageEnvelope();
+
+
+    /** Default destructor.
+     */
+    virtual ~TestMessageEnvelope();
+
+
+    /** Encodes an envelope carrying the payload of the reference envelope.
+     */
+    std::vector<uint8_t> encode(uint8_t flags);
+
+
+    /** Hands the HELLO one end has due to the other.
+     *
+     *  @return     True if a HELLO was due.
+     */
+    static bool exchange(MessageEnvelope::Negotiation& from, MessageEnvelope::Negotiation& to);
+
+    // Payload of MessageEnvelope::referenceFrame.
+    static const uint8_t payload[3];
+
+};  // TEST_MESSAGE_ENVELOPE
+
+
+#endif  // TEST_MESSAGE_ENVELOPE_H
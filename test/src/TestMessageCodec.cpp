@@ -0,0 +1,78 @@
+/**
+ * @file TestMessageCodec.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/19/2026
+ */
+
+#include <cstring>
+
+#include "TestMessageCodec.h"
+
+
+TestMessageCodec::TestMessageCodec()
+{
+    memset(&this->message, 0, sizeof(this->message));
+    this->message.timestamp_us = 0x0102030405060708ull;
+    this->message.isCommandMsg = 1u;
+    this->message.isStatusMsg = 0u;
+    this->message.mode = MODE_RECORDING;
+    this->message.sequence = 0x11223344u;
+    this->message.echoTimestamp_us = 0x1112131415161718ull;
+    this->message.echoDelay_us = 0x21222324u;
+    this->message.commandId = 0x31323334u;
+    this->message.ackCommandId = 0x41424344u;
+    this->message.keepalive_us = 0x51525354u;
+}
+
+TestMessageCodec::~TestMessageCodec() {}
+
+
+TEST_F(TestMessageCodec, TestReferenceFrame)
+{
+    // The static_asserts check every field but the CRC, which covers the
+    // bytes up to the second footer byte
+    ASSERT_EQ(MessageCodec::getCrc(MessageCodec::referenceFrame), 0x35893217u);
+    ASSERT_TRUE(MessageCodec::isValidFrame(MessageCodec::referenceFrame, MessageCodec::frameSize));
+
+    uint8_t buf[MessageCodec::frameSize];
+    ASSERT_EQ(MessageCodec::encode(this->message, buf), MessageCodec::frameSize);
+    ASSERT_EQ(memcmp(buf, MessageCodec::referenceFrame, sizeof(buf)), 0);
+}
+
+
+TEST_F(TestMessageCodec, TestDecode)
+{
+    messageStructure_t decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    ASSERT_TRUE(MessageCodec::decode(MessageCodec::referenceFrame, MessageCodec::frameSize, decoded));
+    ASSERT_EQ(decoded.magicHeader1, MAGIC_H1);
+    ASSERT_EQ(decoded.timestamp_us, this->message.timestamp_us);
+    ASSERT_EQ(decoded.mode, this->message.mode);
+    ASSERT_EQ(decoded.sequence, this->message.sequence);
+    ASSERT_EQ(decoded.echoTimestamp_us, this->message.echoTimestamp_us);
+    ASSERT_EQ(decoded.commandId, this->message.commandId);
+    ASSERT_EQ(decoded.ackCommandId, this->message.ackCommandId);
+    ASSERT_EQ(decoded.keepalive_us, this->message.keepalive_us);
+    ASSERT_EQ(decoded.magicFooter2, MAGIC_F2);
+}
+
+
+TEST_F(TestMessageCodec, TestCorruptFrame)
+{
+    // Any flipped bit fails the CRC, the message is left alone
+    for (size_t i = 0; i < MessageCodec::frameSize; i++)
+    {
+        uint8_t buf[MessageCodec::frameSize];
+        memcpy(buf, MessageCodec::referenceFrame, sizeof(buf));
+        buf[i] ^= 0x10;
+        messageStructure_t decoded = this->message;
+        decoded.sequence = 0;
+        ASSERT_FALSE(MessageCodec::decode(buf, sizeof(buf), decoded)) << "byte " << i;
+        ASSERT_EQ(decoded.sequence, 0u);
+    }
+
+    // Short frames are rejected before the CRC is read
+    ASSERT_FALSE(MessageCodec::isValidFrame(MessageCodec::referenceFrame, MessageCodec::frameSize - 1));
+}
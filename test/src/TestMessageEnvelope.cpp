@@ -0,0 +1,268 @@
+/**
+ * @file TestMessageEnvelope.cpp
+ * @brief Definition file.
+ *
+ * @author Mike Sardonini
+ * @date 10/19/2026
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "StreamFramer.h"
+#include "TestMessageEnvelope.h"
+
+
+const uint8_t TestMessageEnvelope::payload[3] = {0x01, 0x02, 0x03};
+
+
+TestMessageEnvelope::TestMessageEnvelope() {}
+
+TestMessageEnvelope::~TestMessageEnvelope() {}
+
+
+std::vector<uint8_t> TestMessageEnvelope::encode(uint8_t flags)
+{
+    std::vector<uint8_t> frame(MessageEnvelope::maxFrameSize);
+    size_t length = MessageEnvelope::encode(MessageEnvelope::typeHello, flags, 0x11223344u,
+        payload, sizeof(payload), frame.data());
+    EXPECT_GT(length, 0u);
+    frame.resize(length);
+    return frame;
+}
+
+
+bool TestMessageEnvelope::exchange(MessageEnvelope::Negotiation& from, MessageEnvelope::Negotiation& to)
+{
+    MessageEnvelope::Hello hello;
+    if (!from.takeHelloDue(hello))
+        return false;
+
+    uint8_t buf[MessageEnvelope::helloSize];
+    MessageEnvelope::Hello received;
+    EXPECT_TRUE(MessageEnvelope::decodeHello(buf, MessageEnvelope::encodeHello(hello, buf), received));
+    to.onHello(received);
+    return true;
+}
+
+
+TEST_F(TestMessageEnvelope, TestEncodeParse)
+{
+    // Laid out as the reference envelope, whose CRC is left zero
+    std::vector<uint8_t> frame = this->encode(MessageEnvelope::flagSequence | MessageEnvelope::flagCrc);
+    const size_t crcSize = sizeof(uint32_t);
+    ASSERT_EQ(frame.size(), sizeof(MessageEnvelope::referenceFrame));
+    ASSERT_EQ(memcmp(frame.data(), MessageEnvelope::referenceFrame, frame.size() - crcSize), 0);
+    ASSERT_EQ(MessageEnvelope::getFrameSize(frame.data()), frame.size());
+
+    MessageEnvelope::Header header;
+    ASSERT_TRUE(MessageEnvelope::parse(frame.data(), frame.size(), header));
+    ASSERT_EQ(header.version, MessageEnvelope::protocolVersion);
+    ASSERT_EQ(header.type, MessageEnvelope::typeHello);
+    ASSERT_EQ(header.sequence, 0x11223344u);
+    ASSERT_EQ(header.payloadLength, sizeof(payload));
+    ASSERT_EQ(memcmp(header.payload, payload, sizeof(payload)), 0);
+
+    // Without the optional parts there is no sequence to read
+    frame = this->encode(0);
+    ASSERT_EQ(frame.size(), MessageEnvelope::headerSize + sizeof(payload));
+    ASSERT_TRUE(MessageEnvelope::parse(frame.data(), frame.size(), header));
+    ASSERT_EQ(header.sequence, 0u);
+    ASSERT_EQ(memcmp(header.payload, payload, sizeof(payload)), 0);
+
+    // Flags the encoder does not know are not sent
+    frame = this->encode(MessageEnvelope::flagCompressed);
+    ASSERT_EQ(frame[MessageEnvelope::offsetFlags], 0u);
+
+    uint8_t large[MessageEnvelope::maxPayload + 1] = {};
+    uint8_t buf[MessageEnvelope::maxFrameSize + 1];
+    ASSERT_EQ(MessageEnvelope::encode(MessageEnvelope::typeHello, 0, 0, large, sizeof(large), buf), 0u);
+}
+
+
+TEST_F(TestMessageEnvelope, TestCorruptEnvelope)
+{
+    std::vector<uint8_t> frame = this->encode(MessageEnvelope::flagSequence | MessageEnvelope::flagCrc);
+    MessageEnvelope::Header header;
+
+    // Any flipped bit fails the CRC or the size check
+    for (size_t i = 0; i < frame.size(); i++)
+    {
+        std::vector<uint8_t> corrupt = frame;
+        corrupt[i] ^= 0x10;
+        ASSERT_FALSE(MessageEnvelope::parse(corrupt.data(), corrupt.size(), header)) << "byte " << i;
+    }
+
+    // Neither a truncated nor a padded envelope is one
+    ASSERT_FALSE(MessageEnvelope::parse(frame.data(), frame.size() - 1, header));
+    frame.push_back(0);
+    ASSERT_FALSE(MessageEnvelope::parse(frame.data(), frame.size(), header));
+}
+
+
+TEST_F(TestMessageEnvelope, TestLinkFrameSize)
+{
+    std::vector<uint8_t> envelope = this->encode(MessageEnvelope::flagCrc);
+    ASSERT_EQ(MessageEnvelope::getLinkFrameSize(MessageCodec::referenceFrame), MessageCodec::frameSize);
+    ASSERT_EQ(MessageEnvelope::getLinkFrameSize(envelope.data()), envelope.size());
+
+    // A payload longer than any envelope starts no frame
+    envelope[MessageEnvelope::offsetLength] = 0xFF;
+    envelope[MessageEnvelope::offsetLength + 1] = 0xFF;
+    ASSERT_EQ(MessageEnvelope::getLinkFrameSize(envelope.data()), 0u);
+
+    // Nor does a second byte of neither kind
+    uint8_t other[MessageEnvelope::headerSize] = {MAGIC_H1, 0x00};
+    ASSERT_EQ(MessageEnvelope::getLinkFrameSize(other), 0u);
+}
+
+
+TEST_F(TestMessageEnvelope, TestLinkFrameNeedsCrc)
+{
+    ASSERT_TRUE(MessageEnvelope::isValidLinkFrame(MessageCodec::referenceFrame, MessageCodec::frameSize));
+
+    std::vector<uint8_t> withCrc = this->encode(MessageEnvelope::flagCrc);
+    ASSERT_TRUE(MessageEnvelope::isValidLinkFrame(withCrc.data(), withCrc.size()));
+
+    // Valid as an envelope, but not taken from a byte stream
+    std::vector<uint8_t> withoutCrc = this->encode(MessageEnvelope::flagSequence);
+    MessageEnvelope::Header header;
+    ASSERT_TRUE(MessageEnvelope::parse(withoutCrc.data(), withoutCrc.size(), header));
+    ASSERT_FALSE(MessageEnvelope::isValidLinkFrame(withoutCrc.data(), withoutCrc.size()));
+}
+
+
+TEST_F(TestMessageEnvelope, TestLinkFramer)
+{
+    StreamFramer framer(MessageEnvelope::maxLinkFrameSize, MessageEnvelope::headerSize,
+        MessageEnvelope::linkMagic, sizeof(MessageEnvelope::linkMagic),
+        &MessageEnvelope::getLinkFrameSize, &MessageEnvelope::isValidLinkFrame);
+
+    // Noise, a control frame, an envelope without a CRC and one with it
+    std::vector<uint8_t> stream = {0x00, MAGIC_H1};
+    stream.insert(stream.end(), MessageCodec::referenceFrame, MessageCodec::referenceFrame + MessageCodec::frameSize);
+    std::vector<uint8_t> withoutCrc = this->encode(MessageEnvelope::flagSequence);
+    stream.insert(stream.end(), withoutCrc.begin(), withoutCrc.end());
+    std::vector<uint8_t> withCrc = this->encode(MessageEnvelope::flagSequence | MessageEnvelope::flagCrc);
+    stream.insert(stream.end(), withCrc.begin(), withCrc.end());
+
+    std::vector<size_t> sizes;
+    size_t written = 0;
+    while (written < stream.size())
+    {
+        size_t space;
+        uint8_t* buf = framer.getWriteBuffer(&space);
+        ASSERT_GT(space, 0u);
+        space = std::min<size_t>(std::min(space, stream.size() - written), 5);
+        memcpy(buf, &stream[written], space);
+        framer.commitWrite(space);
+        written += space;
+
+        size_t length;
+        while (framer.next(&length) != nullptr)
+            sizes.push_back(length);
+    }
+
+    ASSERT_EQ(sizes, std::vector<size_t>({MessageCodec::frameSize, withCrc.size()}));
+    ASSERT_EQ(framer.getSnapshot().invalidFrames, 1u);
+}
+
+
+TEST_F(TestMessageEnvelope, TestHello)
+{
+    MessageEnvelope::Hello hello;
+    hello.version = 3;
+    hello.features = 0x80000001u;
+    hello.telemetryTypes = 0x00010002u;
+    hello.helloReceived = true;
+
+    uint8_t buf[MessageEnvelope::helloSize + 2] = {};
+    ASSERT_EQ(MessageEnvelope::encodeHello(hello, buf), MessageEnvelope::helloSize);
+
+    // Fields a newer peer appends are ignored
+    MessageEnvelope::Hello decoded;
+    ASSERT_TRUE(MessageEnvelope::decodeHello(buf, sizeof(buf), decoded));
+    ASSERT_EQ(decoded.version, 3u);
+    ASSERT_EQ(decoded.features, 0x80000001u);
+    ASSERT_EQ(decoded.telemetryTypes, 0x00010002u);
+    ASSERT_TRUE(decoded.helloReceived);
+
+    ASSERT_FALSE(MessageEnvelope::decodeHello(buf, MessageEnvelope::helloSize - 1, decoded));
+}
+
+
+TEST_F(TestMessageEnvelope, TestNegotiation)
+{
+    using MessageEnvelope::featureCrc;
+    using MessageEnvelope::featureSequence;
+    MessageEnvelope::Negotiation host(featureCrc | featureSequence, MessageEnvelope::telemetryRecorder);
+    MessageEnvelope::Negotiation remote(featureCrc, MessageEnvelope::telemetryRecorder);
+    ASSERT_FALSE(host.isAgreed());
+    ASSERT_EQ(host.getFeatures(), 0u);
+    ASSERT_EQ(host.getVersion(), 0u);
+
+    // The host says hello, the remote answers that it has the host's, and the
+    // host answers once more so the remote knows it has the remote's
+    ASSERT_TRUE(this->exchange(host, remote));
+    ASSERT_TRUE(this->exchange(remote, host));
+    ASSERT_TRUE(this->exchange(host, remote));
+    ASSERT_FALSE(this->exchange(remote, host));
+    ASSERT_FALSE(this->exchange(host, remote));
+
+    ASSERT_TRUE(host.isAgreed());
+    ASSERT_TRUE(remote.isAgreed());
+    ASSERT_EQ(host.getFeatures(), featureCrc);
+    ASSERT_EQ(remote.getFeatures(), featureCrc);
+    ASSERT_EQ(host.getTelemetryTypes(), MessageEnvelope::telemetryRecorder);
+    ASSERT_EQ(host.getVersion(), MessageEnvelope::protocolVersion);
+
+    // A lost link negotiates again
+    host.reset();
+    ASSERT_FALSE(host.isAgreed());
+    ASSERT_EQ(host.getFeatures(), 0u);
+    ASSERT_TRUE(this->exchange(host, remote));
+}
+
+
+TEST_F(TestMessageEnvelope, TestNegotiationOlderPeer)
+{
+    // A peer that never answers gets a limited number of HELLOs
+    MessageEnvelope::Negotiation host(MessageEnvelope::supportedFeatures, MessageEnvelope::telemetryRecorder);
+    MessageEnvelope::Hello hello;
+    int maxAttempts = MessageEnvelope::Negotiation::maxAttempts;
+    int sent = 0;
+    for (int i = 0; i < 2 * maxAttempts; i++)
+        sent += host.takeHelloDue(hello) ? 1 : 0;
+    ASSERT_EQ(sent, maxAttempts);
+    ASSERT_FALSE(hello.helloReceived);
+    ASSERT_EQ(host.getFeatures(), 0u);
+}
+
+
+TEST_F(TestMessageEnvelope, TestTelemetry)
+{
+    MessageEnvelope::Telemetry telemetry;
+    telemetry.flags = MessageEnvelope::Telemetry::flagRecorderRunning
+        | MessageEnvelope::Telemetry::flagFreeSpaceKnown;
+    telemetry.bytesWritten = 1ull << 40;
+    telemetry.writeRate_Bps = 3000000;
+    telemetry.freeSpace_MiB = 0;
+    telemetry.recorderCpu_permille = 1250;
+    telemetry.droppedFrames = 7;
+
+    uint8_t buf[MessageEnvelope::maxTelemetrySize];
+    size_t length = MessageEnvelope::encodeTelemetry(telemetry, buf);
+    ASSERT_LE(length, sizeof(buf));
+
+    // A disk that is really full is told apart from one that could not be read
+    MessageEnvelope::Telemetry decoded;
+    ASSERT_TRUE(MessageEnvelope::decodeTelemetry(buf, length, decoded));
+    ASSERT_EQ(decoded.flags, telemetry.flags);
+    ASSERT_EQ(decoded.bytesWritten, telemetry.bytesWritten);
+    ASSERT_EQ(decoded.writeRate_Bps, telemetry.writeRate_Bps);
+    ASSERT_EQ(decoded.freeSpace_MiB, 0u);
+    ASSERT_EQ(decoded.recorderCpu_permille, telemetry.recorderCpu_permille);
+    ASSERT_EQ(decoded.droppedFrames, telemetry.droppedFrames);
+
+    ASSERT_FALSE(MessageEnvelope::decodeTelemetry(buf, length - 1, decoded));
+}